@@ -1,9 +1,14 @@
 #include "geMain.h"
 #include <sstream>
+#include <algorithm>
+#include <set>
+#include <cstdlib>
 
 //--------------------------------------------------------------
 graphicsEngine::graphicsEngine() 
-    : deferred_compilation_mode(true) {
+    : deferred_compilation_mode(true)
+    , published_state(nullptr)
+    , frame_snapshot(nullptr) {
     // Constructor: Initialization of managers is deferred to the setup() phase
     // to ensure all openFrameworks systems are ready.
 }
@@ -12,6 +17,11 @@ graphicsEngine::graphicsEngine()
 graphicsEngine::~graphicsEngine() {
     // Destructor: Cleanup is handled automatically by the unique_ptrs,
     // which will delete the managed objects when graphicsEngine is destroyed.
+    // Programs in the process-wide registry are released here, while the GL context still exists.
+    ShaderRegistry& registry = ShaderRegistry::getInstance();
+    for (ShaderHandle handle : registry.getHandles(ShaderEntryKind::PROGRAM)) {
+        registry.remove(handle);
+    }
 }
 
 //--------------------------------------------------------------
@@ -93,6 +103,67 @@ void graphicsEngine::loadAllPlugins() {
     }
 }
 
+//--------------------------------------------------------------
+void graphicsEngine::watchShaderSources() {
+    for (const auto& [plugin_name, path] : plugin_manager->getPluginPaths()) {
+        source_watcher.addDirectory(path);
+    }
+}
+
+//--------------------------------------------------------------
+void graphicsEngine::reloadChangedSources() {
+    std::vector<std::string> changed_files;
+    if (source_watcher.takeChanges(changed_files)) {
+        std::set<std::string> changed(changed_files.begin(), changed_files.end());
+
+        // Queue every live shader that includes a changed file, once
+        auto queueIfAffected = [&](const std::string& id, const std::shared_ptr<ShaderNode>& shader) {
+            for (const auto& [queued_id, queued] : reload_queue) {
+                if (queued_id == id) {
+                    return;
+                }
+            }
+            const ShaderNodeMetadata& metadata = *shader->metadata;
+            if (!metadata.sources.isAvailable()) {
+                return;
+            }
+            std::string directory = metadata.source_directory_path.empty() ? ofToDataPath("", true)
+                                                                           : metadata.source_directory_path;
+            for (const auto& file : ShaderManager::collectIncludedFiles(metadata.sources.getFragment(), directory)) {
+                if (changed.count(file)) {
+                    reload_queue.emplace_back(id, shader);
+                    return;
+                }
+            }
+        };
+        ShaderRegistry& registry = ShaderRegistry::getInstance();
+        for (ShaderHandle handle : registry.getHandles(ShaderEntryKind::PROGRAM)) {
+            queueIfAffected(handle.toString(), registry.getShader(handle));
+        }
+        for (const auto& [id, shader] : composition_outputs) {
+            queueIfAffected(id, shader);
+        }
+        ofLogNotice("graphicsEngine") << changed.size() << " source files changed, "
+                                      << reload_queue.size() << " shaders queued for reload";
+    }
+
+    if (reload_queue.empty()) {
+        return;
+    }
+    auto [id, weak_shader] = reload_queue.front();
+    reload_queue.pop_front();
+
+    std::shared_ptr<ShaderNode> shader = weak_shader.lock();
+    if (!shader || !shader->reload()) {
+        return;
+    }
+    stats.record("reload.compile_ms", shader->metadata->compile_milliseconds + shader->metadata->link_milliseconds);
+    if (heatmaps.count(id)) {
+        setHeatmapEnabled(id, true);
+    }
+    ofLogNotice("graphicsEngine") << "Reloaded shader " << id;
+}
+
 //--------------------------------------------------------------
 void graphicsEngine::displayPluginInfo() {
     ofLogNotice("graphicsEngine") << "=== Loaded Plugins Summary ===";
@@ -121,6 +192,8 @@ void graphicsEngine::initializeShaderSystem() {
     
     shader_manager = std::make_unique<ShaderManager>(plugin_manager.get());
     composition_engine = std::make_unique<ShaderCompositionEngine>(plugin_manager.get());
+    graph_sync = std::make_unique<GraphSync>(composition_engine.get());
+    scene_bank = std::make_unique<SceneBank>(composition_engine.get());
     
     ofLogNotice("graphicsEngine") << "Shader system initialized (deferred mode: " 
                                   << (deferred_compilation_mode ? "enabled" : "disabled") << ")";
@@ -149,7 +222,7 @@ void graphicsEngine::testShaderCreation(std::string function_name, std::vector<s
         if (current_shader->isReady()) {
             ofLogNotice("graphicsEngine") << "Shader created and compiled successfully!";
         } else if (current_shader->has_error) {
-            ofLogError("graphicsEngine") << "Shader creation failed: " << current_shader->error_message;
+            ofLogError("graphicsEngine") << "Shader creation failed: " << current_shader->metadata->error_message;
         } 
         current_shader->printDebugInfo();
     } else {
@@ -158,10 +231,607 @@ void graphicsEngine::testShaderCreation(std::string function_name, std::vector<s
 }
 
 //--------------------------------------------------------------
-void graphicsEngine::updateShaderUniforms() {
-    if (current_shader && current_shader->isReady()) {
-        current_shader->updateAutoUniforms();
+void graphicsEngine::initializeRenderer() {
+    fullscreen_pass = std::make_unique<FullscreenPass>();
+    if (!fullscreen_pass->setup()) {
+        ofLogError("graphicsEngine") << "Failed to initialize fullscreen pass";
+        fullscreen_pass.reset();
+        return;
+    }
+    fullscreen_pass->setTextureSources(&texture_sources);
+}
+
+//--------------------------------------------------------------
+void graphicsEngine::publishRenderSnapshot() {
+    if (isRenderSnapshotCurrent()) {
+        return;
+    }
+
+    auto snapshot = std::make_unique<RenderSnapshot>();
+    snapshot->main = RenderProgram::capture(current_shader);
+    snapshot->heatmap = getActiveHeatmap();
+    if (snapshot->heatmap) {
+        snapshot->heatmap_program = RenderProgram::capture(snapshot->heatmap->getShader());
+    }
+    snapshot->outputs.reserve(outputs.size());
+    for (const auto& [name, output] : outputs) {
+        snapshot->outputs.push_back({name, output, RenderProgram::capture(output->getShader()), output->getWindowRect()});
+    }
+
+    // Only our own publications retire a snapshot, so it stays valid until the next one
+    published_state = snapshot.get();
+    render_snapshots.publish(std::move(snapshot));
+    stats.record("snapshot.retired", static_cast<double>(render_snapshots.getRetiredCount()));
+}
+
+//--------------------------------------------------------------
+bool graphicsEngine::isRenderSnapshotCurrent() const {
+    if (!published_state || !published_state->main.isCurrent(current_shader) ||
+        published_state->outputs.size() != outputs.size()) {
+        return false;
+    }
+
+    std::shared_ptr<HeatmapVariant> heatmap = getActiveHeatmap();
+    if (published_state->heatmap != heatmap ||
+        (heatmap && !published_state->heatmap_program.isCurrent(heatmap->getShader()))) {
+        return false;
+    }
+
+    auto published = published_state->outputs.begin();
+    for (const auto& [name, output] : outputs) {
+        const ofRectangle& rect = published->window_rect;
+        const ofRectangle& window_rect = output->getWindowRect();
+        if (published->name != name || published->target != output || !published->program.isCurrent(output->getShader()) ||
+            rect.x != window_rect.x || rect.y != window_rect.y ||
+            rect.width != window_rect.width || rect.height != window_rect.height) {
+            return false;
+        }
+        ++published;
+    }
+    return true;
+}
+
+//--------------------------------------------------------------
+std::shared_ptr<HeatmapVariant> graphicsEngine::getActiveHeatmap() const {
+    for (const auto& [id, heatmap] : heatmaps) {
+        if (heatmap->isVariantOf(current_shader.get())) {
+            return heatmap;
+        }
+    }
+    return nullptr;
+}
+
+//--------------------------------------------------------------
+void graphicsEngine::latchFrame() {
+    uint64_t start = ofGetElapsedTimeMicros();
+    size_t applied = 0;
+    if (osc_handler) {
+        // Messages other than /param stay queued, in order, for the next updateOSC()
+        osc_handler->latch(frame_clock.getFrameIndex());
+        applied = processParamMessages(true);
+    }
+    if (applied > 0) {
+        publishRenderSnapshot();
+    }
+    frame_clock.latch();
+
+    stats.record("latch.params", static_cast<double>(applied));
+    stats.record("latch.lead_ms", frame_clock.getPresentationLead() * 1000.0);
+    stats.record("latch.cpu_ms", (ofGetElapsedTimeMicros() - start) / 1000.0);
+}
+
+//--------------------------------------------------------------
+void graphicsEngine::beginRenderFrame() {
+    frame_snapshot = render_snapshots.beginRead();
+}
+
+//--------------------------------------------------------------
+void graphicsEngine::endRenderFrame() {
+    frame_snapshot = nullptr;
+    render_snapshots.endRead();
+    render_snapshots.collect();
+}
+
+//--------------------------------------------------------------
+void graphicsEngine::renderCurrentShader(float width, float height) {
+    if (!fullscreen_pass || !frame_snapshot) {
+        return;
+    }
+    const RenderProgram* program = &frame_snapshot->main;
+    if (frame_snapshot->heatmap) {
+        // Counters and color scale are render-thread state of the variant, not part of the snapshot
+        const auto& heatmap = frame_snapshot->heatmap;
+        heatmap->beginFrame();
+        program = &frame_snapshot->heatmap_program;
+        stats.record("heatmap.max_ops", heatmap->getMaxCount());
+        stats.record("heatmap.mean_ops", heatmap->getMeanCount());
+    }
+    bool has_shader = program->shader && program->linked;
+
+    if (tiled_renderer) {
+        if (has_shader) {
+            tiled_renderer->renderFrame(*fullscreen_pass, *program, frame_clock.getTime());
+            stats.record("tiled.frames_per_output", tiled_renderer->getFramesPerOutputFrame());
+            stats.record("tiled.tile_gpu_ms", tiled_renderer->getEstimatedTileMilliseconds());
+        }
+        tiled_renderer->draw(0, 0, width, height);
+        return;
+    }
+
+    if (output_tap) {
+        // The tap keeps publishing (black) frames while no shader is connected.
+        output_tap->beginFrame();
+        if (has_shader) {
+            fullscreen_pass->beginFrame();
+            fullscreen_pass->draw(*program, output_tap->getWidth(), output_tap->getHeight(), frame_clock.getTime());
+            fullscreen_pass->endFrame();
+        }
+        output_tap->endFrame(frame_clock.getFrameIndex());
+        output_tap->draw(0, 0, width, height);
+
+        stats.record("tap.cpu_ms", output_tap->getLastOverheadMicros() / 1000.0);
+        stats.record("tap.dropped_frames", static_cast<double>(output_tap->getDroppedCount()));
+        stats.record("tap.readback_copy_ms", output_tap->getLastReadbackCopyMilliseconds());
+        stats.record("tap.readback_stalls", output_tap->getLastReadbackStallCount());
+        return;
+    }
+
+    if (!has_shader) {
+        return;
+    }
+    fullscreen_pass->beginFrame();
+    fullscreen_pass->draw(*program, width, height, frame_clock.getTime());
+    fullscreen_pass->endFrame();
+}
+
+//--------------------------------------------------------------
+bool graphicsEngine::enableOutputTap(int width, int height, const std::string& shm_name, const std::string& raw_file_path) {
+    auto tap = std::make_unique<OutputTap>();
+    if (!tap->setup(width, height)) {
+        ofLogError("graphicsEngine") << "Failed to set up output tap";
+        return false;
+    }
+
+    bool success = true;
+    if (!shm_name.empty()) {
+        success = tap->addSharedMemorySink(shm_name) && success;
+    }
+    if (!raw_file_path.empty()) {
+        success = tap->addRawFileSink(raw_file_path) && success;
+    }
+
+    output_tap = std::move(tap);
+    return success;
+}
+
+//--------------------------------------------------------------
+bool graphicsEngine::enableTiledOutput(int width, int height, int tile_width, int tile_height, float frame_budget_ms) {
+    auto tiled = std::make_unique<TiledRenderer>();
+    if (!tiled->setup(width, height, tile_width, tile_height)) {
+        ofLogError("graphicsEngine") << "Failed to set up tiled output";
+        return false;
+    }
+    tiled->setFrameBudget(frame_budget_ms);
+    tiled_renderer = std::move(tiled);
+    return true;
+}
+
+//--------------------------------------------------------------
+bool graphicsEngine::enablePreviewAtlas(int tile_width, int tile_height, int columns, int rows,
+                                        float frame_budget_ms, const std::string& shm_name) {
+    auto atlas = std::make_unique<PreviewAtlas>();
+    if (!atlas->setup(tile_width, tile_height, columns, rows)) {
+        ofLogError("graphicsEngine") << "Failed to set up preview atlas";
+        return false;
+    }
+    atlas->setFrameBudget(frame_budget_ms);
+
+    bool success = true;
+    if (!shm_name.empty()) {
+        success = atlas->addSharedMemorySink(shm_name);
+    }
+
+    preview_atlas = std::move(atlas);
+    return success;
+}
+
+//--------------------------------------------------------------
+void graphicsEngine::renderPreviews() {
+    if (!preview_atlas || !fullscreen_pass) {
+        return;
+    }
+
+    std::map<std::string, std::shared_ptr<ShaderNode>> sources = composition_outputs;
+    ShaderRegistry& registry = ShaderRegistry::getInstance();
+    for (ShaderHandle handle : registry.getHandles(ShaderEntryKind::PROGRAM)) {
+        sources[handle.toString()] = registry.getShader(handle);
+    }
+    preview_atlas->setSources(sources);
+    preview_atlas->renderFrame(*fullscreen_pass, frame_clock.getTime(), frame_clock.getFrameIndex());
+
+    stats.record("preview.tiles_per_frame", preview_atlas->getTilesLastFrame());
+    stats.record("preview.tile_gpu_ms", preview_atlas->getEstimatedTileMilliseconds());
+}
+
+//--------------------------------------------------------------
+bool graphicsEngine::addOutput(const std::string& name, int width, int height,
+                               const ofRectangle& window_rect, const std::string& shm_name) {
+    if (!fullscreen_pass) {
+        ofLogError("graphicsEngine") << "Renderer must be initialized before adding outputs";
+        return false;
+    }
+    if (name == "main") {
+        ofLogError("graphicsEngine") << "The output name 'main' is reserved for the window";
+        return false;
+    }
+
+    auto output = std::make_shared<RenderOutput>();
+    if (!output->setup(name, width, height)) {
+        return false;
+    }
+    bool success = shm_name.empty() || output->addSharedMemorySink(shm_name);
+    output->setWindowRect(window_rect);
+
+    auto existing = outputs.find(name);
+    if (existing != outputs.end()) {
+        output->connect(existing->second->getShader(), existing->second->getOutputNodeId());
+    }
+    outputs[name] = std::move(output);
+    return success;
+}
+
+//--------------------------------------------------------------
+bool graphicsEngine::removeOutput(const std::string& name) {
+    return outputs.erase(name) > 0;
+}
+
+//--------------------------------------------------------------
+bool graphicsEngine::connectShaderToNamedOutput(const std::string& output_name, const std::string& shader_id) {
+    auto output_it = outputs.find(output_name);
+    if (output_it == outputs.end()) {
+        ofLogError("graphicsEngine") << "Output not found: " << output_name;
+        return false;
+    }
+
+    std::shared_ptr<ShaderNode> shader = findActiveShader(shader_id);
+    std::string output_node_id;
+    if (!shader && composition_engine && composition_engine->hasNode(shader_id)) {
+        // compileGraph returns the cached program if this graph is already shown elsewhere
+        shader = composition_engine->compileGraph(shader_id);
+        output_node_id = shader_id;
+        if (shader && shader->isReady()) {
+            composition_outputs[shader_id] = shader;
+        }
+    }
+    if (!shader || !shader->isReady()) {
+        ofLogError("graphicsEngine") << "Shader not ready for connection: " << shader_id;
+        return false;
+    }
+
+    output_it->second->connect(shader, output_node_id);
+    shader->setConnectedToOutput(true);
+    ofLogNotice("graphicsEngine") << "Connected " << shader_id << " to output " << output_name;
+    return true;
+}
+
+//--------------------------------------------------------------
+void graphicsEngine::renderOutputs() {
+    if (!fullscreen_pass || !frame_snapshot) {
+        return;
+    }
+    for (const auto& output : frame_snapshot->outputs) {
+        output.target->render(*fullscreen_pass, output.program, frame_clock.getTime(), frame_clock.getFrameIndex());
+        stats.record("output." + output.name + ".gpu_ms", output.target->getLastGpuMilliseconds());
+        stats.record("output." + output.name + ".cpu_ms", output.target->getLastCpuMilliseconds());
+        stats.record("output." + output.name + ".readback_copy_ms", output.target->getTap().getLastReadbackCopyMilliseconds());
+        stats.record("output." + output.name + ".readback_stalls", output.target->getTap().getLastReadbackStallCount());
+    }
+}
+
+//--------------------------------------------------------------
+void graphicsEngine::drawOutputs() {
+    if (!frame_snapshot) {
+        return;
+    }
+    for (const auto& output : frame_snapshot->outputs) {
+        output.target->draw(output.window_rect);
+    }
+}
+
+//--------------------------------------------------------------
+void graphicsEngine::updateScenes() {
+    if (!scene_bank || scene_bank->getSceneCount() == 0) {
+        return;
+    }
+    scene_bank->update();
+    stats.record("scene.resident_programs", static_cast<double>(scene_bank->getResidentProgramCount()));
+    stats.record("scene.program_bytes", static_cast<double>(scene_bank->getResidentProgramBytes()));
+    stats.record("scene.source_bytes", static_cast<double>(scene_bank->getResidentSourceBytes()));
+    stats.record("scene.compile_ms", scene_bank->getLastCompileMilliseconds());
+}
+
+//--------------------------------------------------------------
+bool graphicsEngine::activateScene(const std::string& name) {
+    std::map<std::string, std::pair<std::shared_ptr<ShaderNode>, std::string>> programs;
+    if (!scene_bank || !scene_bank->activate(name, programs)) {
+        return false;
+    }
+
+    // Only program pointers change hands here; everything was linked ahead of the cue
+    for (const std::string& node_id : active_scene_nodes) {
+        composition_outputs.erase(node_id);
+    }
+    active_scene_nodes.clear();
+    for (const auto& [output, program] : programs) {
+        const auto& [shader, node_id] = program;
+        if (output == "main") {
+            current_shader = shader;
+            current_output_node_id = node_id;
+        } else {
+            auto output_it = outputs.find(output);
+            if (output_it == outputs.end()) {
+                ofLogWarning("graphicsEngine") << "Scene " << name << " shows unknown output " << output;
+                continue;
+            }
+            output_it->second->connect(shader, node_id);
+        }
+        shader->setConnectedToOutput(true);
+        composition_outputs[node_id] = shader;
+        active_scene_nodes.push_back(node_id);
+    }
+    ofLogNotice("graphicsEngine") << "Switched to scene " << name;
+    return true;
+}
+
+//--------------------------------------------------------------
+void graphicsEngine::enableSessionSnapshots(const std::string& path, double interval_seconds) {
+    session_writer = std::make_unique<SessionSnapshotWriter>();
+    session_writer->start(path, interval_seconds);
+}
+
+//--------------------------------------------------------------
+void graphicsEngine::updateSessionSnapshot(bool force) {
+    if (!session_writer || !composition_engine || (!force && !session_writer->isDue())) {
+        return;
+    }
+    uint64_t start = ofGetElapsedTimeMicros();
+
+    // Scene programs come back by cueing the scene, immediate-mode shaders are not restorable
+    auto isRestorable = [this](const std::string& node_id) {
+        return !node_id.empty() && composition_engine->hasNode(node_id) &&
+               !(scene_bank && scene_bank->ownsNode(node_id));
+    };
+
+    SessionState session;
+    if (isRestorable(current_output_node_id) && current_shader) {
+        session.main_node_id = current_output_node_id;
+        session.main_program_key = current_shader->getProgramCacheKey();
+    }
+    for (const auto& [name, output] : outputs) {
+        SessionOutput stored;
+        stored.name = name;
+        stored.width = output->getWidth();
+        stored.height = output->getHeight();
+        stored.window_rect = output->getWindowRect();
+        stored.shm_name = output->getSharedMemoryName();
+        if (isRestorable(output->getOutputNodeId()) && output->getShader()) {
+            stored.node_id = output->getOutputNodeId();
+            stored.program_key = output->getShader()->getProgramCacheKey();
+        }
+        session.outputs.push_back(std::move(stored));
+    }
+    if (graph_sync) {
+        session.graph = graph_sync->getAppliedGraph();
+        session.graph_node_ids = graph_sync->getNodeIds();
+    }
+    if (scene_bank) {
+        session.active_scene = scene_bank->getCurrentScene();
+    }
+
+    std::vector<const CompositionNode*> nodes;
+    for (const CompositionNode* node : composition_engine->getNodes()) {
+        if (!scene_bank || !scene_bank->ownsNode(node->node_id.toString())) {
+            nodes.push_back(node);
+        }
+    }
+    session_writer->capture(composition_engine->getRevision(), nodes, std::move(session));
+
+    stats.record("session.capture_ms", (ofGetElapsedTimeMicros() - start) / 1000.0);
+    stats.record("session.bytes", static_cast<double>(session_writer->getLastBytes()));
+    stats.record("session.encoded_nodes", static_cast<double>(session_writer->getLastEncodedNodes()));
+}
+
+//--------------------------------------------------------------
+bool graphicsEngine::restoreSession(const std::string& path, std::string& active_scene) {
+    active_scene.clear();
+    if (!ofFile::doesFileExist(path, false)) {
+        ofLogNotice("graphicsEngine") << "No session snapshot at " << path << ", starting empty";
+        return false;
+    }
+    if (!composition_engine || !deferred_compilation_mode) {
+        ofLogError("graphicsEngine") << "Session restore requires deferred compilation mode";
+        return false;
+    }
+    uint64_t start = ofGetElapsedTimeMicros();
+
+    SessionState session;
+    if (!SessionSnapshot::read(path, session)) {
+        return false;
+    }
+    // The binaries are read from disk while the nodes are being restored
+    ProgramBinaryCache& binary_cache = ProgramBinaryCache::getInstance();
+    binary_cache.prefetch(session.getProgramKeys());
+    size_t hits_before = binary_cache.getHitCount();
+
+    // Restored IDs may grow the registry by one slot per node, so a damaged file cannot allocate billions
+    size_t slot_limit = ShaderRegistry::getInstance().getSlotCount() + session.nodes.size();
+    for (const auto& node : session.nodes) {
+        if (!composition_engine->restoreNode(node.node_id, node.function_name, node.arguments, slot_limit)) {
+            continue;
+        }
+        if (node.compute_scale > 0.0f) {
+            composition_engine->setComputeVariant(node.node_id, node.compute_scale, node.compute_workgroup_size);
+        }
+        for (const auto& [port_name, values] : node.parameter_values) {
+            composition_engine->setParameter(node.node_id, port_name, values);
+        }
     }
+    if (graph_sync && !session.graph.nodes.empty() && !graph_sync->restore(session.graph, session.graph_node_ids)) {
+        ofLogWarning("graphicsEngine") << "Session /graph binding could not be restored";
+    }
+
+    for (const auto& output : session.outputs) {
+        if (!addOutput(output.name, output.width, output.height, output.window_rect, output.shm_name)) {
+            ofLogWarning("graphicsEngine") << "Session output " << output.name << " restored without its sink";
+        }
+        if (!output.node_id.empty()) {
+            connectShaderToNamedOutput(output.name, output.node_id);
+        }
+    }
+    bool connected = !session.main_node_id.empty() && connectGraphToOutput(session.main_node_id);
+    active_scene = session.active_scene;
+
+    double restore_ms = (ofGetElapsedTimeMicros() - start) / 1000.0;
+    stats.record("session.restore_ms", restore_ms);
+    ofLogNotice("graphicsEngine") << "Restored session with " << session.nodes.size() << " nodes and "
+                                  << session.outputs.size() << " outputs in " << restore_ms << " ms ("
+                                  << binary_cache.getHitCount() - hits_before << " programs from the binary cache)";
+    return connected;
+}
+
+//--------------------------------------------------------------
+void graphicsEngine::uploadTextureSources() {
+    if (texture_sources.getSourceCount() == 0) {
+        return;
+    }
+    texture_sources.update(frame_clock.getTime());
+    stats.record("texture.upload_ms", texture_sources.getLastUploadMilliseconds());
+    stats.record("texture.uploads_per_frame", texture_sources.getLastUploadCount());
+}
+
+//--------------------------------------------------------------
+void graphicsEngine::renderBenchmarks() {
+    if (!fullscreen_pass || !benchmark.isBusy()) {
+        return;
+    }
+    benchmark.update(*fullscreen_pass, frame_clock.getTime());
+}
+
+//--------------------------------------------------------------
+bool graphicsEngine::verifyTiledRendering(int width, int height, int tile_width, int tile_height) {
+    if (!fullscreen_pass || !current_shader || !current_shader->isReady()) {
+        ofLogError("graphicsEngine") << "Tiled render check needs a connected, compiled shader";
+        return false;
+    }
+
+    const float check_time = 1.25f;
+
+    // Reference: the whole output in a single framebuffer.
+    ofFbo reference_fbo;
+    reference_fbo.allocate(width, height, GL_RGBA8);
+    reference_fbo.begin();
+    ofClear(0, 0, 0, 255);
+    fullscreen_pass->beginFrame();
+    fullscreen_pass->draw(*current_shader, width, height, check_time);
+    fullscreen_pass->endFrame();
+    reference_fbo.end();
+
+    ofPixels reference_pixels;
+    reference_fbo.readToPixels(reference_pixels);
+
+    // Candidate: the same output assembled from tiles.
+    TiledRenderer tiled;
+    if (!tiled.setup(width, height, tile_width, tile_height)) {
+        return false;
+    }
+    tiled.renderAllTiles(*fullscreen_pass, RenderProgram::capture(current_shader), check_time);
+
+    ofPixels tiled_pixels;
+    tiled.readToPixels(tiled_pixels);
+
+    size_t mismatched = 0;
+    int max_difference = 0;
+    const unsigned char* expected = reference_pixels.getData();
+    const unsigned char* actual = tiled_pixels.getData();
+    size_t byte_count = static_cast<size_t>(width) * height * 4;
+    for (size_t i = 0; i < byte_count; ++i) {
+        int difference = std::abs(static_cast<int>(expected[i]) - static_cast<int>(actual[i]));
+        max_difference = std::max(max_difference, difference);
+        if (difference > 1) {
+            mismatched++;
+        }
+    }
+
+    bool success = (mismatched == 0);
+    if (success) {
+        ofLogNotice("graphicsEngine") << "Tiled render check passed: " << width << "x" << height << " in "
+                                      << tiled.getTileCount() << " tiles, max channel difference " << max_difference;
+    } else {
+        ofLogError("graphicsEngine") << "Tiled render check FAILED: " << mismatched << " of " << byte_count
+                                     << " channels differ, max difference " << max_difference;
+    }
+    return success;
+}
+
+//--------------------------------------------------------------
+bool graphicsEngine::verifyCpuEvaluator(int width, int height, int tolerance) {
+    if (!fullscreen_pass || !current_shader || !current_shader->isReady() || current_output_node_id.empty()) {
+        ofLogError("graphicsEngine") << "CPU evaluator check needs a connected, compiled composition graph";
+        return false;
+    }
+
+    CpuGraphEvaluator evaluator;
+    if (!evaluator.build(*composition_engine, plugin_manager.get(), current_output_node_id)) {
+        return false;
+    }
+
+    const float check_time = 1.25f;
+
+    ofFbo reference_fbo;
+    reference_fbo.allocate(width, height, GL_RGBA8);
+    reference_fbo.begin();
+    ofClear(0, 0, 0, 255);
+    fullscreen_pass->beginFrame();
+    fullscreen_pass->draw(*current_shader, width, height, check_time);
+    fullscreen_pass->endFrame();
+    reference_fbo.end();
+
+    ofPixels reference_pixels;
+    reference_fbo.readToPixels(reference_pixels);
+
+    ofPixels cpu_pixels;
+    if (!evaluator.render(width, height, check_time, cpu_pixels)) {
+        return false;
+    }
+    stats.record("cpu_eval_mpix_per_sec", evaluator.getLastMegapixelsPerSecond());
+
+    size_t mismatched = 0;
+    int max_difference = 0;
+    const unsigned char* expected = reference_pixels.getData();
+    const unsigned char* actual = cpu_pixels.getData();
+    size_t byte_count = static_cast<size_t>(width) * height * 4;
+    for (size_t i = 0; i < byte_count; ++i) {
+        int difference = std::abs(static_cast<int>(expected[i]) - static_cast<int>(actual[i]));
+        max_difference = std::max(max_difference, difference);
+        if (difference > tolerance) {
+            mismatched++;
+        }
+    }
+
+    ofLogNotice("graphicsEngine") << "CPU evaluator: " << width << "x" << height << " in "
+                                  << evaluator.getLastThreadCount() << " threads, "
+                                  << evaluator.getLastMegapixelsPerSecond() << " MP/s";
+
+    bool success = (mismatched == 0);
+    if (success) {
+        ofLogNotice("graphicsEngine") << "CPU evaluator check passed, max channel difference " << max_difference
+                                      << " (tolerance " << tolerance << ")";
+    } else {
+        ofLogError("graphicsEngine") << "CPU evaluator check FAILED: " << mismatched << " of " << byte_count
+                                     << " channels differ by more than " << tolerance << ", max difference "
+                                     << max_difference;
+    }
+    return success;
 }
 
 //--------------------------------------------------------------
@@ -181,11 +851,72 @@ void graphicsEngine::updateOSC() {
         return;
     }
     
-    osc_handler->update();
+    osc_handler->update(frame_clock.getFrameIndex());
     
     processCreateMessages();
     processConnectMessages();
     processFreeMessages();
+    processStatsMessages();
+    processComputeMessages();
+    processPreviewMessages();
+    processHeatmapMessages();
+    processBenchMessages();
+    processTextureMessages();
+    processOutputMessages();
+    processGraphMessages();
+    processSceneMessages();
+    processParamMessages();
+    
+    stats.record("symbols.count", static_cast<double>(SymbolTable::getInstance().size()));
+    stats.record("symbols.bytes", static_cast<double>(SymbolTable::getInstance().getByteSize()));
+    recordAllocationStats();
+}
+
+//--------------------------------------------------------------
+void graphicsEngine::recordAllocationStats() {
+    if (!AllocationTracker::isEnabled()) {
+        return;
+    }
+    for (size_t i = 0; i < AllocationTracker::tag_count; ++i) {
+        AllocationTag tag = static_cast<AllocationTag>(i);
+        AllocationCounters counters = AllocationTracker::getCounters(tag);
+        AllocationCounters& baseline = allocation_baseline[i];
+        if (counters.allocations == 0) {
+            continue;
+        }
+        std::string prefix = std::string("alloc.") + AllocationTracker::getTagName(tag);
+        stats.record(prefix + ".count", static_cast<double>(counters.allocations - baseline.allocations));
+        stats.record(prefix + ".bytes", static_cast<double>(counters.bytes - baseline.bytes));
+        stats.record(prefix + ".live_bytes", static_cast<double>(counters.live_bytes));
+        stats.record(prefix + ".peak_bytes", static_cast<double>(counters.peak_bytes));
+        baseline = counters;
+    }
+}
+
+//--------------------------------------------------------------
+void graphicsEngine::recordRequestAllocations(const std::string& request, const AllocationRequestScope& scope) {
+    if (!AllocationTracker::isEnabled()) {
+        return;
+    }
+    AllocationCounters total = scope.getTotal();
+    stats.record(request + ".alloc_count", static_cast<double>(total.allocations));
+    stats.record(request + ".alloc_bytes", static_cast<double>(total.bytes));
+    stats.record(request + ".alloc_peak_bytes", static_cast<double>(total.peak_bytes));
+
+    std::stringstream breakdown;
+    for (size_t i = 0; i < AllocationTracker::tag_count; ++i) {
+        AllocationTag tag = static_cast<AllocationTag>(i);
+        AllocationCounters counters = scope.getCounters(tag);
+        if (counters.allocations == 0) {
+            continue;
+        }
+        stats.record(request + "." + AllocationTracker::getTagName(tag) + ".alloc_count",
+                     static_cast<double>(counters.allocations));
+        breakdown << " " << AllocationTracker::getTagName(tag) << "=" << counters.allocations;
+    }
+    ofLogNotice("graphicsEngine") << "/" << request << " allocated " << total.allocations << " blocks, "
+                                  << total.bytes << " bytes, peak " << total.peak_bytes << " bytes;"
+                                  << breakdown.str();
 }
 
 //--------------------------------------------------------------
@@ -207,33 +938,34 @@ std::string graphicsEngine::createShaderWithId(const std::string& function_name,
     std::string shader_id = shader_manager->createShaderWithId(function_name, arguments);
     
     if (!shader_id.empty()) {
-        auto shader = shader_manager->getShaderById(shader_id);
-        if (shader) {
-            active_shaders[shader_id] = shader;
-            ofLogNotice("graphicsEngine") << "Created shader with ID: " << shader_id 
-                                         << " for function: " << function_name;
-        }
+        ofLogNotice("graphicsEngine") << "Created shader with ID: " << shader_id 
+                                     << " for function: " << function_name;
     }
     
     return shader_id;
 }
 
+//--------------------------------------------------------------
+std::shared_ptr<ShaderNode> graphicsEngine::findActiveShader(const std::string& shader_id) const {
+    return ShaderRegistry::getInstance().getShader(ShaderHandle::parse(shader_id));
+}
+
 //--------------------------------------------------------------
 bool graphicsEngine::connectShaderToOutput(const std::string& shader_id) {
-    auto it = active_shaders.find(shader_id);
-    if (it == active_shaders.end()) {
+    auto shader = findActiveShader(shader_id);
+    if (!shader) {
         ofLogError("graphicsEngine") << "Shader not found with ID: " << shader_id;
         return false;
     }
     
-    auto shader = it->second;
-    if (!shader || !shader->isReady()) {
+    if (!shader->isReady()) {
         ofLogError("graphicsEngine") << "Shader not ready for connection: " << shader_id;
         return false;
     }
     
     // Connect to output (set as current shader)
     current_shader = shader;
+    current_output_node_id.clear();
     shader->setConnectedToOutput(true);
     
     ofLogNotice("graphicsEngine") << "Connected shader to output: " << shader_id;
@@ -242,21 +974,26 @@ bool graphicsEngine::connectShaderToOutput(const std::string& shader_id) {
 
 //--------------------------------------------------------------
 bool graphicsEngine::freeShader(const std::string& shader_id) {
-    auto it = active_shaders.find(shader_id);
-    if (it == active_shaders.end()) {
+    composition_outputs.erase(shader_id);
+    heatmaps.erase(shader_id);
+    
+    auto shader = findActiveShader(shader_id);
+    if (!shader) {
         ofLogError("graphicsEngine") << "Shader not found with ID: " << shader_id;
         return false;
     }
     
     // Disconnect from output if it's the current shader
-    if (current_shader && current_shader == it->second) {
+    if (current_shader && current_shader == shader) {
         current_shader.reset();
     }
+    for (auto& [name, output] : outputs) {
+        if (output->getShader() == shader) {
+            output->connect(nullptr, "");
+        }
+    }
     
-    // Remove from active shaders
-    active_shaders.erase(it);
-    
-    // Remove from shader manager
+    // Remove from the registry; the ID is stale from here on
     bool removed = shader_manager->removeShaderById(shader_id);
     
     ofLogNotice("graphicsEngine") << "Freed shader: " << shader_id 
@@ -269,6 +1006,7 @@ bool graphicsEngine::freeShader(const std::string& shader_id) {
 void graphicsEngine::processCreateMessages() {
     while (osc_handler->hasCreateMessage()) {
         auto msg = osc_handler->getNextCreateMessage();
+        AllocationRequestScope allocation_request;
         
         if (!msg.is_valid_format) {
             ofLogError("graphicsEngine") << "Invalid create message format: " << msg.format_error;
@@ -307,6 +1045,7 @@ void graphicsEngine::processCreateMessages() {
                 ofLogError("graphicsEngine") << "OSC /create failed for function: " << msg.function_name;
             }
         }
+        recordRequestAllocations("create", allocation_request);
     }
 }
 
@@ -323,20 +1062,19 @@ void graphicsEngine::processConnectMessages() {
         
         ofLogNotice("graphicsEngine") << "Processing OSC /connect: " << msg.shader_id;
         
+        if (!msg.output_name.empty() && msg.output_name != "main") {
+            bool connected = connectShaderToNamedOutput(msg.output_name, msg.shader_id);
+            osc_handler->sendConnectResponse(connected, connected ? "Shader connected to output " + msg.output_name
+                                                                  : "Failed to connect shader to output " + msg.output_name);
+            continue;
+        }
+        
         bool success = false;
         
         if (deferred_compilation_mode && composition_engine) {
             // Deferred compilation: Compile the entire graph now
             if (composition_engine->hasNode(msg.shader_id)) {
-                auto compiled_shader = composition_engine->compileGraph(msg.shader_id);
-                
-                if (compiled_shader && compiled_shader->isReady()) {
-                    current_shader = compiled_shader;
-                    success = true;
-                    ofLogNotice("graphicsEngine") << "Successfully compiled and connected deferred graph: " << msg.shader_id;
-                } else {
-                    ofLogError("graphicsEngine") << "Failed to compile deferred graph for: " << msg.shader_id;
-                }
+                success = connectGraphToOutput(msg.shader_id);
             } else {
                 // Fallback to traditional shader if node not found in composition engine
                 success = connectShaderToOutput(msg.shader_id);
@@ -356,6 +1094,183 @@ void graphicsEngine::processConnectMessages() {
     }
 }
 
+//--------------------------------------------------------------
+bool graphicsEngine::connectGraphToOutput(const std::string& node_id) {
+    auto compiled_shader = composition_engine->compileGraph(node_id);
+    if (!compiled_shader || !compiled_shader->isReady()) {
+        ofLogError("graphicsEngine") << "Failed to compile deferred graph for: " << node_id;
+        return false;
+    }
+    
+    current_shader = compiled_shader;
+    current_output_node_id = node_id;
+    composition_outputs[node_id] = compiled_shader;
+    if (heatmaps.count(node_id)) {
+        setHeatmapEnabled(node_id, true);
+    }
+    ofLogNotice("graphicsEngine") << "Successfully compiled and connected deferred graph: " << node_id;
+    return true;
+}
+
+//--------------------------------------------------------------
+void graphicsEngine::processGraphMessages() {
+    while (osc_handler->hasGraphMessage()) {
+        auto msg = osc_handler->getNextGraphMessage();
+        
+        if (!msg.is_valid_format) {
+            ofLogError("graphicsEngine") << "Invalid graph message format: " << msg.format_error;
+            osc_handler->sendGraphResponse(false, msg.format_error);
+            continue;
+        }
+        if (!deferred_compilation_mode || !graph_sync) {
+            osc_handler->sendGraphResponse(false, "Graph sync requires deferred compilation mode");
+            continue;
+        }
+        
+        GraphDescription desired;
+        for (const auto& node : msg.nodes) {
+            desired.nodes[node.key] = {node.function_name, parseArguments(node.raw_arguments)};
+        }
+        desired.outputs = msg.outputs;
+        
+        // Node edits evict the programs of the graphs they were part of; what remains to drop
+        // are the programs of nodes that are gone or no longer shown
+        std::map<std::string, std::string> previous_outputs;
+        for (const auto& [output, key] : graph_sync->getAppliedGraph().outputs) {
+            previous_outputs[output] = graph_sync->getNodeId(key);
+        }
+        std::map<std::string, std::string> previous_node_ids = graph_sync->getNodeIds();
+        
+        GraphSyncResult result;
+        if (!graph_sync->apply(desired, result)) {
+            ofLogError("graphicsEngine") << "Graph rejected: " << result.error;
+            osc_handler->sendGraphResponse(false, result.error);
+            continue;
+        }
+        
+        for (const auto& [key, node_id] : previous_node_ids) {
+            if (!composition_engine->hasNode(node_id)) {
+                composition_outputs.erase(node_id);
+            }
+        }
+        std::set<std::string> shown;
+        for (const auto& [output, key] : desired.outputs) {
+            shown.insert(graph_sync->getNodeId(key));
+        }
+        for (const auto& [output, node_id] : result.dirty_outputs) {
+            auto previous = previous_outputs.find(output);
+            if (previous != previous_outputs.end() && !shown.count(previous->second)) {
+                composition_engine->releaseCompiledGraph(previous->second);
+                composition_outputs.erase(previous->second);
+            }
+        }
+        
+        // Only outputs whose upstream subgraph changed are recompiled
+        std::vector<std::string> failed;
+        for (const auto& [output, node_id] : result.dirty_outputs) {
+            bool connected = output == "main" ? connectGraphToOutput(node_id)
+                                              : connectShaderToNamedOutput(output, node_id);
+            if (!connected) {
+                failed.push_back(output);
+            }
+        }
+        
+        std::stringstream summary;
+        summary << "added " << result.added << ", updated " << result.updated << ", removed " << result.removed
+                << ", recompiled " << result.dirty_outputs.size() - failed.size() << " outputs";
+        stats.record("graph.edits", static_cast<double>(result.added + result.updated + result.removed));
+        stats.record("graph.recompiled_outputs", static_cast<double>(result.dirty_outputs.size()));
+        if (!failed.empty()) {
+            osc_handler->sendGraphResponse(false, summary.str() + ", failed: " + ofJoinString(failed, ","));
+            continue;
+        }
+        osc_handler->sendGraphResponse(true, summary.str());
+        ofLogNotice("graphicsEngine") << "OSC /graph applied: " << summary.str();
+    }
+}
+
+//--------------------------------------------------------------
+void graphicsEngine::processSceneMessages() {
+    while (osc_handler->hasSceneMessage()) {
+        auto msg = osc_handler->getNextSceneMessage();
+        
+        if (!msg.is_valid_format) {
+            ofLogError("graphicsEngine") << "Invalid scene message format: " << msg.format_error;
+            osc_handler->sendSceneResponse(false, msg.format_error);
+            continue;
+        }
+        if (!deferred_compilation_mode || !scene_bank) {
+            osc_handler->sendSceneResponse(false, "Scenes require deferred compilation mode");
+            continue;
+        }
+        
+        if (msg.action == "cuelist") {
+            scene_bank->setCueList(msg.cue_list);
+            osc_handler->sendSceneResponse(true, "Cue list set with " + ofToString(msg.cue_list.size()) + " scenes");
+        } else if (msg.action == "file") {
+            bool loaded = scene_bank->loadSceneFile(msg.scene_name, msg.path);
+            osc_handler->sendSceneResponse(loaded, loaded ? "Loaded scene " + msg.scene_name
+                                                          : "Failed to load scene file: " + msg.path);
+        } else if (msg.action == "define") {
+            GraphDescription graph;
+            for (const auto& node : msg.nodes) {
+                graph.nodes[node.key] = {node.function_name, parseArguments(node.raw_arguments)};
+            }
+            graph.outputs = msg.outputs;
+            bool defined = scene_bank->defineScene(msg.scene_name, graph);
+            osc_handler->sendSceneResponse(defined, defined ? "Defined scene " + msg.scene_name
+                                                            : "Scene rejected: " + msg.scene_name);
+        } else {
+            uint64_t start = ofGetElapsedTimeMicros();
+            bool switched = activateScene(msg.scene_name);
+            stats.record("scene.switch_ms", (ofGetElapsedTimeMicros() - start) / 1000.0);
+            osc_handler->sendSceneResponse(switched, switched ? "Switched to scene " + msg.scene_name
+                                                              : "Failed to switch to scene " + msg.scene_name);
+        }
+    }
+}
+
+//--------------------------------------------------------------
+size_t graphicsEngine::processParamMessages(bool latching) {
+    size_t applied = 0;
+    std::vector<OscParamMessage> deferred;
+    while (osc_handler->hasParamMessage()) {
+        auto msg = osc_handler->getNextParamMessage();
+        
+        if (!msg.is_valid_format) {
+            ofLogError("graphicsEngine") << "Invalid param message format: " << msg.format_error;
+            osc_handler->sendParamResponse(false, msg.format_error);
+            continue;
+        }
+        if (!composition_engine) {
+            osc_handler->sendParamResponse(false, "Composition engine not initialized");
+            continue;
+        }
+        
+        // Nodes synced with /graph may be addressed by their client key
+        std::string node_id = msg.node_id;
+        if (!composition_engine->hasNode(node_id) && graph_sync && !graph_sync->getNodeId(node_id).empty()) {
+            node_id = graph_sync->getNodeId(node_id);
+        }
+        if (latching && !composition_engine->hasNode(node_id)) {
+            deferred.push_back(msg);
+            continue;
+        }
+        
+        // Only the packed parameter block changes; no program is recompiled
+        if (composition_engine->setParameter(node_id, msg.port_name, msg.values)) {
+            osc_handler->sendParamResponse(true, node_id + "." + msg.port_name);
+            applied++;
+        } else {
+            osc_handler->sendParamResponse(false, "No parameter " + msg.port_name + " on " + msg.node_id);
+        }
+    }
+    for (const auto& msg : deferred) {
+        osc_handler->deferParamMessage(msg);
+    }
+    return applied;
+}
+
 //--------------------------------------------------------------
 void graphicsEngine::processFreeMessages() {
     while (osc_handler->hasFreeMessage()) {
@@ -381,6 +1296,217 @@ void graphicsEngine::processFreeMessages() {
     }
 }
 
+//--------------------------------------------------------------
+void graphicsEngine::processStatsMessages() {
+    while (osc_handler->hasStatsMessage()) {
+        auto msg = osc_handler->getNextStatsMessage();
+        
+        if (!msg.is_valid_format) {
+            ofLogError("graphicsEngine") << "Invalid stats message format: " << msg.format_error;
+            continue;
+        }
+        
+        osc_handler->sendStatsResponse(stats.getAverages());
+        if (msg.reset_after_report) {
+            stats.reset();
+            AllocationTracker::resetPeaks();
+        }
+    }
+}
+
+//--------------------------------------------------------------
+void graphicsEngine::processComputeMessages() {
+    while (osc_handler->hasComputeMessage()) {
+        auto msg = osc_handler->getNextComputeMessage();
+        
+        if (!msg.is_valid_format) {
+            ofLogError("graphicsEngine") << "Invalid compute message format: " << msg.format_error;
+            osc_handler->sendComputeResponse(false, msg.format_error);
+            continue;
+        }
+        
+        if (!composition_engine || !composition_engine->setComputeVariant(msg.shader_id, msg.scale, msg.workgroup_size)) {
+            osc_handler->sendComputeResponse(false, "Failed to set compute variant");
+            continue;
+        }
+        
+        // Recompile the connected graph so the change is visible immediately
+        if (!current_output_node_id.empty()) {
+            auto compiled_shader = composition_engine->compileGraph(current_output_node_id);
+            if (!compiled_shader || !compiled_shader->isReady()) {
+                osc_handler->sendComputeResponse(false, "Failed to recompile connected graph");
+                continue;
+            }
+            current_shader = compiled_shader;
+            composition_outputs[current_output_node_id] = compiled_shader;
+            if (heatmaps.count(current_output_node_id)) {
+                setHeatmapEnabled(current_output_node_id, true);
+            }
+        }
+        for (auto& [name, output] : outputs) {
+            if (!output->getOutputNodeId().empty()) {
+                connectShaderToNamedOutput(name, output->getOutputNodeId());
+            }
+        }
+        
+        osc_handler->sendComputeResponse(true, msg.scale > 0.0f ? "Compute variant enabled" : "Compute variant disabled");
+        ofLogNotice("graphicsEngine") << "OSC /compute success: " << msg.shader_id << " at scale " << msg.scale;
+    }
+}
+
+//--------------------------------------------------------------
+bool graphicsEngine::setHeatmapEnabled(const std::string& shader_id, bool enabled) {
+    if (!enabled) {
+        return heatmaps.erase(shader_id) > 0;
+    }
+
+    std::shared_ptr<ShaderNode> shader = findActiveShader(shader_id);
+    if (!shader) {
+        auto output_it = composition_outputs.find(shader_id);
+        if (output_it != composition_outputs.end()) {
+            shader = output_it->second;
+        }
+    }
+    if (!shader) {
+        ofLogError("graphicsEngine") << "Shader not found with ID: " << shader_id;
+        return false;
+    }
+
+    auto heatmap = std::make_shared<HeatmapVariant>();
+    if (!heatmap->setup(shader)) {
+        return false;
+    }
+    heatmaps[shader_id] = std::move(heatmap);
+    return true;
+}
+
+//--------------------------------------------------------------
+void graphicsEngine::processHeatmapMessages() {
+    while (osc_handler->hasHeatmapMessage()) {
+        auto msg = osc_handler->getNextHeatmapMessage();
+        
+        if (!msg.is_valid_format) {
+            ofLogError("graphicsEngine") << "Invalid heatmap message format: " << msg.format_error;
+            osc_handler->sendHeatmapResponse(false, msg.format_error);
+            continue;
+        }
+        
+        bool enable = msg.toggle ? heatmaps.count(msg.shader_id) == 0 : msg.enable;
+        if (!setHeatmapEnabled(msg.shader_id, enable)) {
+            osc_handler->sendHeatmapResponse(false, enable ? "Failed to build heatmap for " + msg.shader_id
+                                                           : "No heatmap enabled for " + msg.shader_id);
+            continue;
+        }
+        osc_handler->sendHeatmapResponse(true, (enable ? "Heatmap enabled for " : "Heatmap disabled for ") + msg.shader_id);
+    }
+}
+
+//--------------------------------------------------------------
+void graphicsEngine::processBenchMessages() {
+    while (osc_handler->hasBenchMessage()) {
+        auto msg = osc_handler->getNextBenchMessage();
+        
+        if (!msg.is_valid_format) {
+            ofLogError("graphicsEngine") << "Invalid bench message format: " << msg.format_error;
+            osc_handler->sendBenchResponse(false, msg.format_error);
+            continue;
+        }
+        
+        std::shared_ptr<ShaderNode> shader = findActiveShader(msg.shader_id);
+        if (shader) {
+            // Programs created with /create in immediate mode
+        } else if (composition_outputs.count(msg.shader_id)) {
+            shader = composition_outputs[msg.shader_id];
+        } else if (composition_engine && composition_engine->hasNode(msg.shader_id)) {
+            // Compiles through the graph cache, so a later /connect is instant
+            shader = composition_engine->compileGraph(msg.shader_id);
+            if (shader) {
+                composition_outputs[msg.shader_id] = shader;
+            }
+        }
+        
+        if (!benchmark.start(msg.shader_id, shader, msg.width, msg.height, msg.frames)) {
+            osc_handler->sendBenchResponse(false, "Cannot benchmark " + msg.shader_id);
+        }
+    }
+    
+    ShaderBenchmark::Result result;
+    while (benchmark.pollResult(result)) {
+        osc_handler->sendBenchResponse(true, result.id, &result);
+    }
+}
+
+//--------------------------------------------------------------
+void graphicsEngine::processOutputMessages() {
+    while (osc_handler->hasOutputMessage()) {
+        auto msg = osc_handler->getNextOutputMessage();
+        
+        if (!msg.is_valid_format) {
+            ofLogError("graphicsEngine") << "Invalid output message format: " << msg.format_error;
+            osc_handler->sendOutputResponse(false, msg.format_error);
+            continue;
+        }
+        
+        if (msg.width == 0) {
+            bool removed = removeOutput(msg.name);
+            osc_handler->sendOutputResponse(removed, removed ? "Output removed" : "Output not found: " + msg.name);
+            continue;
+        }
+        
+        ofRectangle window_rect = msg.has_window_rect ? msg.window_rect : ofRectangle();
+        if (!addOutput(msg.name, msg.width, msg.height, window_rect, msg.shm_name)) {
+            osc_handler->sendOutputResponse(false, "Failed to set up output " + msg.name);
+            continue;
+        }
+        osc_handler->sendOutputResponse(true, "Output " + msg.name + " at " + ofToString(msg.width) + "x" + ofToString(msg.height));
+    }
+}
+
+//--------------------------------------------------------------
+void graphicsEngine::processTextureMessages() {
+    while (osc_handler->hasTextureMessage()) {
+        auto msg = osc_handler->getNextTextureMessage();
+        
+        if (!msg.is_valid_format) {
+            ofLogError("graphicsEngine") << "Invalid texture message format: " << msg.format_error;
+            osc_handler->sendTextureResponse(false, msg.format_error);
+            continue;
+        }
+        
+        if (msg.path.empty()) {
+            bool removed = texture_sources.removeSource(msg.name);
+            osc_handler->sendTextureResponse(removed, removed ? "Texture source removed" : "Texture source not found: " + msg.name);
+            continue;
+        }
+        
+        if (!texture_sources.addSource(msg.name, msg.path, msg.decode_ahead)) {
+            osc_handler->sendTextureResponse(false, "Failed to open texture source " + msg.name);
+            continue;
+        }
+        osc_handler->sendTextureResponse(true, "Texture source " + msg.name + " loading");
+    }
+}
+
+//--------------------------------------------------------------
+void graphicsEngine::processPreviewMessages() {
+    while (osc_handler->hasPreviewMessage()) {
+        auto msg = osc_handler->getNextPreviewMessage();
+        
+        if (!msg.is_valid_format) {
+            ofLogError("graphicsEngine") << "Invalid preview message format: " << msg.format_error;
+            osc_handler->sendPreviewResponse(false, msg.format_error);
+            continue;
+        }
+        
+        ofPixels preview;
+        if (!preview_atlas || !preview_atlas->getPreview(msg.shader_id, preview, msg.downsample)) {
+            osc_handler->sendPreviewResponse(false, "No preview available for " + msg.shader_id);
+            continue;
+        }
+        osc_handler->sendPreviewResponse(true, msg.shader_id, &preview);
+    }
+}
+
 //--------------------------------------------------------------
 std::vector<std::string> graphicsEngine::parseArguments(const std::string& raw_args) {
     std::vector<std::string> args;
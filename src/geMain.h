@@ -1,13 +1,31 @@
 #pragma once
 
 #include "ofMain.h"
+#include <deque>
 #include <memory>
 #include "pluginSystem/PluginManager.h"
 #include "shaderSystem/ShaderManager.h"
 #include "shaderSystem/ShaderNode.h"
 #include "shaderSystem/ShaderCompositionEngine.h"
+#include "shaderSystem/CpuGraphEvaluator.h"
+#include "shaderSystem/GraphSync.h"
+#include "shaderSystem/SceneBank.h"
+#include "shaderSystem/HeatmapVariant.h"
+#include "shaderSystem/SessionSnapshot.h"
+#include "shaderSystem/ProgramBinaryCache.h"
 #include "oscHandler/oscHandler.h"
 #include "platformUtils/PlatformUtils.h"
+#include "platformUtils/FileWatcher.h"
+#include "renderSystem/FullscreenPass.h"
+#include "renderSystem/FrameClock.h"
+#include "renderSystem/OutputTap.h"
+#include "renderSystem/TiledRenderer.h"
+#include "renderSystem/PreviewAtlas.h"
+#include "renderSystem/RenderOutput.h"
+#include "renderSystem/RenderSnapshot.h"
+#include "renderSystem/ShaderBenchmark.h"
+#include "statsSystem/EngineStats.h"
+#include "statsSystem/AllocationTracker.h"
 
 // Forward declarations to avoid circular dependencies
 class PluginManager;
@@ -38,6 +56,20 @@ public:
      */
     void displayPluginInfo();
 
+    /**
+     * @brief Watches the GLSL directories of all loaded plugins for edits.
+     * @details Changes are picked up by reloadChangedSources().
+     */
+    void watchShaderSources();
+
+    /**
+     * @brief Recompiles live shaders whose sources changed on disk.
+     * @details Affected shaders are queued and recompiled one per call, so a change to a
+     *          widely included file does not stall a single frame. Without pending changes
+     *          this only reads an atomic flag. Call once per frame.
+     */
+    void reloadChangedSources();
+
     /**
      * @brief Scans the plugin directory for all valid plugin files (.so on Linux, .dylib on macOS).
      * @return A vector of strings containing the absolute paths to plugin files.
@@ -61,10 +93,215 @@ public:
      */
     void testShaderCreation(std::string function_name, std::vector<std::string>& args);
 
+    // --- Rendering Methods ---
+    /**
+     * @brief Creates the fullscreen pass used to draw shader output. Requires a GL context.
+     */
+    void initializeRenderer();
+
+    /**
+     * @brief Publishes the current control state as a render snapshot if it changed.
+     * @details Control side: call after OSC and graph processing. Captures the programs of
+     *          the main and named outputs, their parameter values and the output layout.
+     *          Nothing is allocated or copied while the state is unchanged.
+     */
+    void publishRenderSnapshot();
+
+    /**
+     * @brief Late-latches the newest parameter values and the frame time.
+     * @details Call immediately before beginRenderFrame(). Receives OSC that arrived since
+     *          update(), applies its /param messages, republishes the render snapshot and
+     *          fixes the frame time to its predicted presentation time, so parameter edits
+     *          reach the screen one frame earlier. Other messages wait for the next update.
+     */
+    void latchFrame();
+
+    /**
+     * @brief Picks up the latest render snapshot for this frame.
+     * @details Render side: call before any render*() or draw*() method of the frame.
+     */
+    void beginRenderFrame();
+
+    /**
+     * @brief Releases the frame's snapshot and frees snapshots no frame can see anymore.
+     */
+    void endRenderFrame();
+
+    /**
+     * @brief Draws the main program of the frame's snapshot with the fullscreen pass.
+     * @details The shader 'time' uniform is taken from frame_clock.
+     * @param width The width of the render target in pixels.
+     * @param height The height of the render target in pixels.
+     */
+    void renderCurrentShader(float width, float height);
+
+    /**
+     * @brief Routes the final composite through an output tap for asynchronous readback.
+     * @details Once enabled, the composite is rendered at the tap resolution and scaled to
+     *          the window. Must be called after initializeRenderer().
+     * @param width The capture width in pixels.
+     * @param height The capture height in pixels.
+     * @param shm_name Shared-memory ring to publish frames to, or empty for none.
+     * @param raw_file_path Raw RGBA file to write frames to, or empty for none.
+     * @return True if the tap and all requested sinks were created.
+     */
+    bool enableOutputTap(int width, int height, const std::string& shm_name, const std::string& raw_file_path);
+
+    /**
+     * @brief Renders the connected shader as a tiled output of arbitrary size.
+     * @details Tiles are spread across frames within the given GPU budget and the last
+     *          complete output is scaled to the window. Must be called after initializeRenderer().
+     * @param width The full output width in pixels.
+     * @param height The full output height in pixels.
+     * @param tile_width The maximum tile width in pixels.
+     * @param tile_height The maximum tile height in pixels.
+     * @param frame_budget_ms The GPU time per frame available for tiles, 0 for no limit.
+     * @return True if the tiled output was set up.
+     */
+    bool enableTiledOutput(int width, int height, int tile_width, int tile_height, float frame_budget_ms);
+
+    /**
+     * @brief Renders the current shader offscreen once untiled and once tiled and compares the results.
+     * @details Both renders use the same fixed time. The result is logged. Run by --verify.
+     * @param width The output width of the comparison in pixels.
+     * @param height The output height of the comparison in pixels.
+     * @param tile_width The tile width; choose one that does not divide width to cover edge tiles.
+     * @param tile_height The tile height.
+     * @return True if every channel of every pixel matches within one step.
+     */
+    bool verifyTiledRendering(int width, int height, int tile_width, int tile_height);
+
+    /**
+     * @brief Enables live previews of every shader and composition output in a shared atlas.
+     * @details Must be called after initializeRenderer().
+     * @param tile_width The width of one preview in pixels.
+     * @param tile_height The height of one preview in pixels.
+     * @param columns The number of previews per atlas row.
+     * @param rows The number of preview rows.
+     * @param frame_budget_ms The GPU time per frame available for previews.
+     * @param shm_name Shared-memory ring to publish the atlas to, or empty for none.
+     * @return True if the atlas and the requested sink were created.
+     */
+    bool enablePreviewAtlas(int tile_width, int tile_height, int columns, int rows,
+                            float frame_budget_ms, const std::string& shm_name);
+
+    /**
+     * @brief Updates the next previews of the atlas within its budget.
+     * @details Call once per frame before rendering the output.
+     */
+    void renderPreviews();
+
+    /**
+     * @brief Renders the next frames of queued /bench requests offscreen.
+     * @details Call once per frame; the live output is not affected.
+     */
+    void renderBenchmarks();
+
+    /**
+     * @brief Creates or updates a named output, e.g. for one projector.
+     * @details Must be called after initializeRenderer(). An existing output keeps its
+     *          connected shader.
+     * @param name The output name used by /connect; "main" is reserved for the window.
+     * @param width The output width in pixels.
+     * @param height The output height in pixels.
+     * @param window_rect The window rectangle the output is drawn to, empty to keep it offscreen.
+     * @param shm_name Shared-memory ring to publish frames to, or empty for none.
+     * @return True if the output and the requested sink were created.
+     */
+    bool addOutput(const std::string& name, int width, int height,
+                   const ofRectangle& window_rect, const std::string& shm_name);
+
+    /**
+     * @brief Removes a named output.
+     * @return True if the output existed.
+     */
+    bool removeOutput(const std::string& name);
+
+    /**
+     * @brief Connects a shader or composition graph to a named output.
+     * @details Graphs are compiled through the composition cache, so a graph shown on
+     *          several outputs (or on the main output) shares one program.
+     * @param output_name The output name.
+     * @param shader_id The shader or composition node ID.
+     * @return True if the shader was connected.
+     */
+    bool connectShaderToNamedOutput(const std::string& output_name, const std::string& shader_id);
+
+    /**
+     * @brief Renders every named output of the frame's snapshot and records its cost.
+     * @details Call once per frame; the per-output GPU and CPU times are recorded as
+     *          "output.<name>.gpu_ms" and "output.<name>.cpu_ms".
+     */
+    void renderOutputs();
+
+    /**
+     * @brief Draws the named outputs of the frame's snapshot that have a window rectangle.
+     */
+    void drawOutputs();
+
+    /**
+     * @brief Uploads the due frames of all texture sources.
+     * @details Call once per frame before any rendering.
+     */
+    void uploadTextureSources();
+
+    /**
+     * @brief Precompiles the scenes of the cue lookahead window within the frame budget.
+     * @details Call once per frame. Records the bank's residency as "scene.resident_programs",
+     *          "scene.program_bytes", "scene.source_bytes" and "scene.compile_ms".
+     */
+    void updateScenes();
+
+    /**
+     * @brief Switches the main and named outputs to the programs of a scene.
+     * @details Outputs the scene does not mention keep their current shader.
+     * @param name The scene name.
+     * @return True if the scene exists and all its outputs compiled.
+     */
+    bool activateScene(const std::string& name);
+
+    // --- Session Snapshots ---
+    /**
+     * @brief Starts writing the control state to a session snapshot file periodically.
+     * @details Captures happen in updateSessionSnapshot(); encoding and writing run on a
+     *          worker thread, and only nodes changed since the previous capture are encoded.
+     * @param path The snapshot file.
+     * @param interval_seconds Minimum time between captures.
+     */
+    void enableSessionSnapshots(const std::string& path, double interval_seconds);
+
+    /**
+     * @brief Captures the control state for the session writer if the interval elapsed.
+     * @details Call once per frame after publishRenderSnapshot(). Nodes owned by the scene
+     *          bank are left out; the active scene is stored by name instead. Records
+     *          "session.capture_ms", "session.bytes" and "session.encoded_nodes".
+     * @param force Capture regardless of the interval, e.g. on exit.
+     */
+    void updateSessionSnapshot(bool force = false);
+
     /**
-     * @brief Updates the automatic uniforms (e.g., time, resolution) for the current shader.
+     * @brief Restores nodes, /graph binding, outputs and connections from a session snapshot.
+     * @details Must be called after initializeRenderer() and before scenes are loaded, so the
+     *          restored node IDs are still free. The programs of all outputs are read from the
+     *          ProgramBinaryCache in parallel before they are needed. Records "session.restore_ms".
+     * @param path The snapshot file.
+     * @param active_scene Receives the scene that was active, to be cued once scenes are loaded.
+     * @return True if a snapshot was read and its main output is connected again.
      */
-    void updateShaderUniforms();
+    bool restoreSession(const std::string& path, std::string& active_scene);
+
+    /**
+     * @brief Evaluates the connected graph on the CPU and compares it with the GL output.
+     * @details Only graphs of GLSL builtins over st, time and resolution can be evaluated.
+     *          Both renders use the same fixed time; the CPU throughput is logged and
+     *          recorded in the engine stats. Run by --verify-cpu.
+     * @param width The output width of the comparison in pixels.
+     * @param height The output height of the comparison in pixels.
+     * @param tolerance The largest allowed difference per 8-bit channel. GPU transcendentals
+     *                  are less precise than the C library, so 2 is typical.
+     * @return True if every channel of every pixel matches within the tolerance.
+     */
+    bool verifyCpuEvaluator(int width, int height, int tolerance);
     
     // --- OSC System Methods ---
     /**
@@ -76,6 +313,7 @@ public:
     /**
      * @brief Updates the OSC system, processing incoming messages.
      * @details This should be called once per frame in the main update loop.
+     *          The frame index of frame_clock drives OSC recording and replay.
      */
     void updateOSC();
 
@@ -108,6 +346,16 @@ public:
      */
     bool freeShader(const std::string& shader_id);
 
+    /**
+     * @brief Draws a shader as its per-pixel cost heatmap instead of its normal output.
+     * @details The production shader stays untouched; the instrumented variant is only
+     *          drawn while the shader is connected and the heatmap is enabled.
+     * @param shader_id The shader or composition output ID.
+     * @param enabled True to build and enable the heatmap, false to drop it.
+     * @return True if the heatmap state was changed.
+     */
+    bool setHeatmapEnabled(const std::string& shader_id, bool enabled);
+
     // --- Members ---
     /// @brief Manages the lifecycle of all plugins.
     std::unique_ptr<PluginManager> plugin_manager;
@@ -120,20 +368,78 @@ public:
     std::unique_ptr<ShaderManager> shader_manager;
     /// @brief A pointer to the currently active shader being rendered.
     std::shared_ptr<ShaderNode> current_shader;
+    /// @brief The composition node connected to the output, empty for non-deferred shaders.
+    std::string current_output_node_id;
+    /// @brief Draws shader output as a single attribute-less fullscreen triangle.
+    std::unique_ptr<FullscreenPass> fullscreen_pass;
+    /// @brief Supplies shader time, either real-time or deterministic fixed-step.
+    FrameClock frame_clock;
+    /// @brief Optional capture of the final composite for downstream consumers.
+    std::unique_ptr<OutputTap> output_tap;
+    /// @brief Optional tiled rendering of outputs beyond the driver's size limits.
+    std::unique_ptr<TiledRenderer> tiled_renderer;
+    /// @brief Additional named outputs, each with its own shader and resolution.
+    std::map<std::string, std::shared_ptr<RenderOutput>> outputs;
+    /// @brief Optional live previews of all shaders, queried with the /preview OSC command.
+    std::unique_ptr<PreviewAtlas> preview_atlas;
+    /// @brief Offscreen GPU timing of shaders requested with the /bench OSC command.
+    ShaderBenchmark benchmark;
+    /// @brief Image and video inputs, sampled by shaders as 'sampler2D' builtins.
+    TextureSourceBank texture_sources;
+    /// @brief Per-frame measurements, queried with the /stats OSC command.
+    EngineStats stats;
+    /// @brief Allocation counters at the previous frame, for per-frame deltas in the stats.
+    std::array<AllocationCounters, AllocationTracker::tag_count> allocation_baseline;
     
     // --- Composition Engine ---
     /// @brief Manages deferred compilation of shader composition graphs.
     std::unique_ptr<ShaderCompositionEngine> composition_engine;
     /// @brief Flag to enable/disable deferred compilation mode.
     bool deferred_compilation_mode;
+    /// @brief Applies declarative /graph descriptions to the composition engine as diffs.
+    std::unique_ptr<GraphSync> graph_sync;
+    /// @brief Named graphs precompiled ahead of their cue, switched with the /scene OSC command.
+    std::unique_ptr<SceneBank> scene_bank;
+    /// @brief Output node IDs of the active scene, dropped from composition_outputs on the next switch.
+    std::vector<std::string> active_scene_nodes;
     
     // --- OSC System ---
     /// @brief Manages OSC message receiving and sending.
     std::unique_ptr<OscHandler> osc_handler;
-    /// @brief Map of active shaders managed by ID for OSC communication.
-    std::map<std::string, std::shared_ptr<ShaderNode>> active_shaders;
+    /// @brief Compiled composition graphs by output node ID, kept for previews.
+    std::map<std::string, std::shared_ptr<ShaderNode>> composition_outputs;
+    /// @brief Cost heatmap variants by shader ID, toggled with the /heatmap OSC command.
+    std::map<std::string, std::shared_ptr<HeatmapVariant>> heatmaps;
+    
+    // --- Render Snapshots ---
+    /// @brief Hands immutable render state from the control side to the render loop.
+    RenderSnapshotExchange render_snapshots;
+    /// @brief The last published snapshot, to skip unchanged publications; owned by render_snapshots.
+    const RenderSnapshot* published_state;
+    /// @brief Snapshot of the frame being rendered, valid between beginRenderFrame() and endRenderFrame().
+    const RenderSnapshot* frame_snapshot;
+    /// @brief Writes session snapshots for restoreSession(), null until enableSessionSnapshots().
+    std::unique_ptr<SessionSnapshotWriter> session_writer;
+    
+    // --- Live Reload ---
+    /// @brief Reports edits of plugin GLSL files without per-frame polling.
+    FileWatcher source_watcher;
+    /// @brief Shaders waiting to be recompiled after a source change, by ID.
+    std::deque<std::pair<std::string, std::weak_ptr<ShaderNode>>> reload_queue;
     
 private:
+    // --- Render Snapshot Helpers ---
+    /**
+     * @brief Checks whether the last published snapshot still matches the control state.
+     * @details Compares program handles and parameter revisions, so nothing is copied.
+     */
+    bool isRenderSnapshotCurrent() const;
+
+    /**
+     * @brief Gets the heatmap variant of the current shader, or nullptr if none is enabled.
+     */
+    std::shared_ptr<HeatmapVariant> getActiveHeatmap() const;
+
     // --- OSC Message Processing Helpers ---
     /**
      * @brief Processes incoming /create messages from OSC.
@@ -150,6 +456,85 @@ private:
      */
     void processFreeMessages();
 
+    /**
+     * @brief Processes incoming /stats messages from OSC.
+     */
+    void processStatsMessages();
+
+    /**
+     * @brief Processes incoming /compute messages from OSC.
+     */
+    void processComputeMessages();
+
+    /**
+     * @brief Processes incoming /preview messages from OSC.
+     */
+    void processPreviewMessages();
+
+    /**
+     * @brief Processes incoming /heatmap messages from OSC.
+     */
+    void processHeatmapMessages();
+
+    /**
+     * @brief Processes incoming /bench messages from OSC and reports finished benchmarks.
+     */
+    void processBenchMessages();
+
+    /**
+     * @brief Processes incoming /texture messages from OSC.
+     */
+    void processTextureMessages();
+
+    /**
+     * @brief Processes incoming /output messages from OSC.
+     */
+    void processOutputMessages();
+
+    /**
+     * @brief Processes incoming /graph messages from OSC.
+     */
+    void processGraphMessages();
+
+    /**
+     * @brief Compiles a composition graph and connects it to the main output.
+     * @param node_id The output node of the graph.
+     * @return True if the graph compiled and was connected.
+     */
+    bool connectGraphToOutput(const std::string& node_id);
+
+    /**
+     * @brief Processes incoming /scene messages from OSC.
+     */
+    void processSceneMessages();
+
+    /**
+     * @brief Processes incoming /param messages from OSC.
+     * @param latching True at the late latch, where messages for nodes that do not exist yet
+     *                 are deferred until the /create or /graph ahead of them is processed.
+     * @return The number of parameters applied.
+     */
+    size_t processParamMessages(bool latching = false);
+
+    /**
+     * @brief Records the allocations of each subsystem since the previous frame in the stats.
+     * @details Does nothing unless built with GE_TRACK_ALLOCATIONS.
+     */
+    void recordAllocationStats();
+
+    /**
+     * @brief Records the allocations of one request in the stats.
+     * @param request The request name, used as stats prefix, e.g. "create".
+     * @param scope The scope that measured the request.
+     */
+    void recordRequestAllocations(const std::string& request, const AllocationRequestScope& scope);
+
+    /**
+     * @brief Looks up a program created with an ID in the ShaderRegistry.
+     * @return The program, or nullptr if the ID is unknown, stale or names a graph node.
+     */
+    std::shared_ptr<ShaderNode> findActiveShader(const std::string& shader_id) const;
+
     /**
      * @brief Parses comma-separated argument string into vector.
      * @param raw_args String like "st,time,1.0"
@@ -1,11 +1,51 @@
 #include "ofMain.h"
 #include "ofApp.h"
+#include "renderSystem/EglHeadlessWindow.h"
+#include <cstdlib>
+
+namespace {
+
+/// Creates the GL context of --headless: EGL where available, else a hidden GLFW window.
+std::shared_ptr<ofAppBaseWindow> createHeadlessWindow(const ofGLFWWindowSettings& settings,
+                                                      const OfflineRenderSettings& render_settings) {
+#ifdef GE_HAVE_EGL
+	ofInit();
+	auto egl_window = std::make_shared<EglHeadlessWindow>();
+	if (egl_window->createContext(settings.glVersionMajor, settings.glVersionMinor,
+	                              render_settings.width, render_settings.height)) {
+		ofGetMainLoop()->addWindow(egl_window);
+		egl_window->setup(settings);
+		return egl_window;
+	}
+	ofLogWarning("main") << "No EGL context, trying a hidden window instead";
+#endif
+
+	// GLFW cannot create a context without a display server, and would fail less clearly
+	const char* x11_display = std::getenv("DISPLAY");
+	const char* wayland_display = std::getenv("WAYLAND_DISPLAY");
+	if ((!x11_display || !*x11_display) && (!wayland_display || !*wayland_display)) {
+		ofLogError("main") << "--headless needs EGL or a display server: build with libEGL "
+		                   << "(GE_HAVE_EGL) or run under a virtual display such as xvfb-run";
+		return nullptr;
+	}
+	return ofCreateWindow(settings);
+}
+
+} // namespace
 
 /**
  * @brief The main entry point of the application.
- * @return The exit code of the application.
+ * @details Without arguments the engine opens an interactive window. With --headless it
+ *          renders a fixed number of frames offscreen with a fixed-step clock and exits;
+ *          see OfflineRenderer::parseArguments() for all options.
+ * @return The exit code of the application, non-zero if setup or a --verify check failed.
  */
-int main( ){
+int main(int argc, char* argv[]){
+
+	OfflineRenderSettings render_settings;
+	if (!OfflineRenderer::parseArguments(argc, argv, render_settings)) {
+		return 1;
+	}
 
 	// Setup the OpenGL window and context
 	ofGLFWWindowSettings settings;
@@ -14,11 +54,22 @@ int main( ){
 	settings.setSize(1024, 768);
 	settings.windowMode = OF_WINDOW;
 
-	auto window = ofCreateWindow(settings);
+	std::shared_ptr<ofAppBaseWindow> window;
+	if (render_settings.headless) {
+		// The window only provides the GL context; frames go to an offscreen FBO.
+		// On machines without a GPU this runs on a software GL driver (e.g. Mesa llvmpipe).
+		settings.setSize(render_settings.width, render_settings.height);
+		settings.visible = false;
+		settings.decorated = false;
+		window = createHeadlessWindow(settings, render_settings);
+		if (!window) {
+			return 1;
+		}
+	} else {
+		window = ofCreateWindow(settings);
+	}
 
 	// Create an instance of the ofApp class and run it.
-	ofRunApp(window, std::make_shared<ofApp>());
-	ofRunMainLoop();
-
-    return 0; // Ensure a return value.
-}
\ No newline at end of file
+	ofRunApp(window, std::make_shared<ofApp>(render_settings));
+	return ofRunMainLoop(); // The status passed to ofExit()
+}
@@ -1,11 +1,16 @@
 #include "ofApp.h"
 #include "pluginSystem/PluginManager.h"
 #include "shaderSystem/ExpressionParser.h"
+#include "shaderSystem/ShaderSources.h"
+#include "statsSystem/AllocationTracker.h"
 #include <iostream>
 #include <muParser.h>
 
 //--------------------------------------------------------------
-ofApp::ofApp() {
+ofApp::ofApp(const OfflineRenderSettings& settings)
+    : last_frame_time_display(0.0f)
+    , show_preview_atlas(false)
+    , render_settings(settings) {
 
 }
 
@@ -22,82 +27,236 @@ void ofApp::setup(){
     ofBackground(0,0,0);
 
     // --- Initialize Core Systems ---
+    // Hot reload and heatmaps need the sources, a headless render never reads them again
+    SourceRetention retention = render_settings.headless ? SourceRetention::DROP : SourceRetention::COMPRESS;
+    ShaderSources::parseRetention(render_settings.source_retention, retention);
+    ShaderSources::setRetention(retention);
+    ProgramBinaryCache::getInstance().setDirectory(render_settings.program_cache_directory);
+
     ge.plugin_manager = std::make_unique<PluginManager>();
     ge.loadAllPlugins();
     ge.displayPluginInfo();
+    ge.watchShaderSources();
     ge.initializeShaderSystem();
     
     // --- Initialize OSC System ---
     ge.initializeOSC(12345);  // Listen on port 12345
 
-    // --- Setup Rendering Canvas ---
+    if (!render_settings.replay_log_path.empty()) {
+        ge.osc_handler->loadReplayLog(render_settings.replay_log_path);
+    }
+    if (!render_settings.record_log_path.empty()) {
+        ge.osc_handler->startRecording(render_settings.record_log_path);
+    }
+
+    // --- Setup Rendering ---
     width = ofGetWidth();
     height = ofGetHeight();
-    plane.set(width, height, 4, 4);
-    plane.setPosition(width/2, height/2, 0);
-    plane.mapTexCoords(0,0,1,1);
+    ge.initializeRenderer();
+    ge.texture_sources.setDefaultDecodeAhead(render_settings.decode_ahead);
+
+    // The session claims its node IDs before the scenes register theirs
+    std::string restored_scene;
+    if (!render_settings.snapshot_path.empty()) {
+        ge.restoreSession(render_settings.snapshot_path, restored_scene);
+        ge.enableSessionSnapshots(render_settings.snapshot_path, render_settings.snapshot_interval);
+    }
+    if (ge.scene_bank) {
+        ge.scene_bank->setLookahead(render_settings.scene_lookahead);
+        ge.scene_bank->setFrameBudget(render_settings.scene_budget_ms);
+        if (!render_settings.scene_directory.empty()) {
+            ge.scene_bank->loadDirectory(render_settings.scene_directory);
+        }
+        if (!restored_scene.empty() && !ge.activateScene(restored_scene)) {
+            ofLogWarning("ofApp") << "Restored scene " << restored_scene << " is not available";
+        }
+    }
+    hud.setup(640, 40);
+
+    if (render_settings.tap_width > 0 && render_settings.tap_height > 0 && !render_settings.headless) {
+        ge.enableOutputTap(render_settings.tap_width, render_settings.tap_height,
+                           render_settings.tap_shm_name, render_settings.tap_file_path);
+    }
+    if (render_settings.tiled_width > 0 && render_settings.tiled_height > 0 && !render_settings.headless) {
+        if (ge.output_tap) {
+            ofLogWarning("ofApp") << "Tiled output replaces the output tap";
+        }
+        ge.enableTiledOutput(render_settings.tiled_width, render_settings.tiled_height,
+                             render_settings.tile_width, render_settings.tile_height,
+                             render_settings.tile_budget_ms);
+    }
+
+    if (render_settings.preview_budget_ms > 0.0f && !render_settings.headless) {
+        // 64 previews of 128x72 in a 1024x576 atlas
+        ge.enablePreviewAtlas(128, 72, 8, 8, render_settings.preview_budget_ms, render_settings.preview_shm_name);
+    }
+
+    if (render_settings.headless) {
+        // Raw frames on stdout must not be interleaved with log output.
+        if (render_settings.output_path == "-") {
+            ofLogToFile("offline_render.log");
+        }
+        ofSetFrameRate(0); // Render as fast as the backend allows.
+        hud.setEnabled(false);
+        ge.frame_clock.setFixedStep(render_settings.fps);
+        if (!offline_renderer.setup(render_settings)) {
+            ofExit(1);
+        }
+    }
 }
 
 //--------------------------------------------------------------
 void ofApp::update(){
-    ge.updateShaderUniforms();
+    // Auto uniforms are uploaded by the fullscreen pass while the program is bound.
     ge.updateOSC();  // Process OSC messages
+    ge.reloadChangedSources();
+    ge.updateScenes();
+    ge.publishRenderSnapshot();
+    ge.updateSessionSnapshot();
+
+    hud.recordFrameTime(ofGetLastFrameTime() * 1000.0);
+    if (hud.isEnabled()) {
+        updateHud();
+    }
 }
 
 //--------------------------------------------------------------
 void ofApp::draw(){
+    AllocationScope allocation_scope(AllocationTag::RENDER);
+    if (render_settings.headless) {
+        drawOffline();
+        return;
+    }
+
+    // --- Draw Shader Output ---
+    // The fullscreen pass draws first so the UI text stays on top of it.
+    width = ofGetWidth();
+    height = ofGetHeight();
+    ge.uploadTextureSources();
+    ge.renderBenchmarks();
+    ge.renderPreviews();
+    ge.latchFrame();
+    ge.beginRenderFrame();
+    ge.renderOutputs();
+    ge.renderCurrentShader(width, height);
+    ge.drawOutputs();
+    ge.endRenderFrame();
+    ge.frame_clock.advance();
+
+    if (show_preview_atlas && ge.preview_atlas) {
+        ge.preview_atlas->draw(width - 532, height - 300, 512, 288);
+    }
+
     // --- Draw UI and Help Text ---
-    ofDrawBitmapString("GLSL Plugin System Demo", 20, 30);
-    ofDrawBitmapString("Press keys:", 20, 60);
-    ofDrawBitmapString("r - Unload and reload all plugins", 20, 80);
-    ofDrawBitmapString("l - Display plugin info", 20, 100);
-    ofDrawBitmapString("t - Test shader creation (curl)", 20, 120);
-    ofDrawBitmapString("c - Clear current shader", 20, 140);
-    ofDrawBitmapString("m - Test muParser expressions", 20, 160);
-    ofDrawBitmapString("e - Test ExpressionParser", 20, 180);
-    ofDrawBitmapString("", 20, 200);
-    ofDrawBitmapString("OSC Commands (port 12345):", 20, 220);
-    ofDrawBitmapString("/create [function] [args] - Create shader with ID", 20, 240);
-    ofDrawBitmapString("/connect [shader_id] - Connect shader to output", 20, 260);
-    ofDrawBitmapString("/free [shader_id] - Free shader memory", 20, 280);
-
-    int y_offset = 320;
-    ofDrawBitmapString("Loaded Plugins:", 20, y_offset);
-    y_offset += 20;
+    hud.draw(20, 18);
+}
+
+//--------------------------------------------------------------
+void ofApp::drawOffline() {
+    AllocationScope allocation_scope(AllocationTag::RENDER);
+    ge.uploadTextureSources();
+    offline_renderer.beginFrame();
+    ge.latchFrame();
+    ge.beginRenderFrame();
+    ge.renderCurrentShader(offline_renderer.getWidth(), offline_renderer.getHeight());
+    ge.endRenderFrame();
+    offline_renderer.endFrame();
+    ge.frame_clock.advance();
+
+    if (offline_renderer.isFinished()) {
+        offline_renderer.logThroughput();
+        offline_renderer.close();
+        ofExit(runOfflineChecks() ? 0 : 1);
+    }
+}
+
+//--------------------------------------------------------------
+bool ofApp::runOfflineChecks() {
+    bool success = true;
+    if (render_settings.verify) {
+        // 256x128 tiles do not divide 640x360, so partial edge tiles are compared too
+        success = ge.verifyTiledRendering(640, 360, 256, 128) && success;
+    }
+    if (render_settings.cpu_tolerance >= 0) {
+        success = ge.verifyCpuEvaluator(640, 360, render_settings.cpu_tolerance) && success;
+    }
+    return success;
+}
+
+//--------------------------------------------------------------
+void ofApp::updateHud() {
+    static const std::vector<std::string> help_lines = {
+        "GLSL Plugin System Demo",
+        "",
+        "Press keys:",
+        "r - Unload and reload all plugins",
+        "l - Display plugin info",
+        "t - Test shader creation (curl)",
+        "c - Clear current shader",
+        "m - Test muParser expressions",
+        "e - Test ExpressionParser",
+        "h - Toggle this overlay",
+        "a - Toggle preview atlas",
+        "",
+        "OSC Commands (port 12345):",
+        "/create [function] [args] - Create shader with ID",
+        "/connect [output] [shader_id] - Connect shader (output optional)",
+        "/free [shader_id] - Free shader memory",
+        "/compute [shader_id] [scale] [group] - Compute variant",
+        "/preview [shader_id] [downsample] - Preview image",
+        "/heatmap [shader_id] [0|1] - Cost heatmap",
+        "/bench [shader_id] [frames] [WxH] - GPU benchmark",
+        "/texture [name] [path] [decode_ahead] - Image/video input",
+        "/output [name] [WxH] [x y w h] [shm] - Named output",
+        "/graph node [key] [fn] [args] ... output [name] [key] - Sync graph",
+        "/scene [name] | [name] file [path] | [name] node ... | cuelist [names] - Scenes",
+        "/param [node_id] [port] [values] - Set an @port argument",
+        ""
+    };
+
+    size_t line = 0;
+    for (const auto& text : help_lines) {
+        hud.setLine(line++, text);
+    }
 
+    // The frame time changes every frame; refresh its row a few times per second only.
+    float now = ofGetElapsedTimef();
+    if (now - last_frame_time_display >= 0.25f) {
+        last_frame_time_display = now;
+        hud.setLine(line, "Frame: " + ofToString(ofGetLastFrameTime() * 1000.0, 2) + " ms (" +
+                    ofToString(ofGetFrameRate(), 1) + " fps)");
+    }
+    line++;
+    hud.setLine(line++, "");
+
+    hud.setLine(line++, "Loaded Plugins:");
     for (const auto& plugin_name : ge.loaded_plugin_names) {
         auto it = ge.plugin_functions.find(plugin_name);
         if (it != ge.plugin_functions.end()) {
             std::string info = plugin_name + " (" + ofToString(it->second.size()) + " functions)";
-            ofDrawBitmapString("- " + info, 20, y_offset);
-            y_offset += 15;
+            hud.setLine(line++, "- " + info);
         }
     }
+    hud.setLine(line++, "");
 
-    // --- Draw Shader Status and Output ---
-    y_offset += 20;
+    // --- Shader Status ---
     if (ge.current_shader) {
-        ofDrawBitmapString("Current Shader:", 20, y_offset);
-        y_offset += 15;
-        std::string status = "Function: " + ge.current_shader->function_name + " | Status: " + ge.current_shader->getStatusString();
-        ofDrawBitmapString("  " + status, 20, y_offset);
-        
-        // If the shader is compiled and ready, use it to draw the plane.
-        if (ge.current_shader->isReady()) {
-            ge.current_shader->compiled_shader.begin();
-            ge.current_shader->updateAutoUniforms();
-            plane.draw();
-            ge.current_shader->compiled_shader.end();
-        }
+        hud.setLine(line++, "Current Shader:");
+        std::string status = "Function: " + ge.current_shader->function_name.str() + " | Status: " + ge.current_shader->getStatusString();
+        hud.setLine(line++, "  " + status);
     } else {
-        ofDrawBitmapString("No shader loaded", 20, y_offset);
+        hud.setLine(line++, "No shader loaded");
     }
+
+    hud.setLineCount(line);
 }
 
 //--------------------------------------------------------------
 void ofApp::exit(){
     // This is called when the app is about to close.
     ge.shutdownOSC();  // Clean shutdown of OSC system
+    ge.updateSessionSnapshot(true);
+    ge.stats.logReport();
     // Other resources are released automatically by destructors.
 }
 
@@ -147,6 +306,17 @@ void ofApp::keyPressed(int key){
             testExpressionParser();
             break;
         }
+        case 'a':{
+            // Toggle the preview atlas overlay
+            show_preview_atlas = !show_preview_atlas;
+            break;
+        }
+        case 'h':{
+            // Toggle the HUD overlay
+            hud.toggle();
+            ofLogNotice("ofApp") << "HUD " << (hud.isEnabled() ? "enabled" : "disabled");
+            break;
+        }
     }
 }
 
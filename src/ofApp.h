@@ -3,6 +3,8 @@
 #include "ofMain.h"
 #include <memory>
 #include "geMain.h"
+#include "renderSystem/HudOverlay.h"
+#include "renderSystem/OfflineRenderer.h"
 
 /**
  * @class ofApp
@@ -14,7 +16,11 @@
 class ofApp : public ofBaseApp{
 
 public:
-    ofApp();
+    /**
+     * @brief Constructs the application.
+     * @param settings Command-line render options; the defaults run interactively.
+     */
+    explicit ofApp(const OfflineRenderSettings& settings = OfflineRenderSettings());
     ~ofApp();
     
     void setup() override;
@@ -29,8 +35,30 @@ public:
     // expression parser test function
     void testExpressionParser();
 
+    /**
+     * @brief Pushes the current help, plugin and shader status text into the HUD.
+     * @details Only rows whose text changed are redrawn by the overlay.
+     */
+    void updateHud();
+
+    /**
+     * @brief Renders one fixed-step frame offscreen and writes it out (headless mode).
+     */
+    void drawOffline();
+
+    /**
+     * @brief Runs the checks requested on the command line (--verify, --verify-cpu) after a headless render.
+     * @return False if any check failed.
+     */
+    bool runOfflineChecks();
+
     float width, height; ///< The width and height of the application window.
-    ofPlanePrimitive plane; ///< A 3D plane used as a canvas for rendering shaders.
     graphicsEngine ge; ///< The main graphics engine instance.
+    HudOverlay hud; ///< Cached help and status text, toggled with 'h'.
+    float last_frame_time_display; ///< Elapsed time at which the frame-time row was last refreshed.
+    bool show_preview_atlas; ///< Draws the preview atlas over the output, toggled with 'a'.
+
+    OfflineRenderSettings render_settings; ///< Options parsed from the command line.
+    OfflineRenderer offline_renderer; ///< Offscreen target and raw frame output in headless mode.
 
 };
\ No newline at end of file
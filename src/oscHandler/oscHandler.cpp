@@ -1,7 +1,103 @@
 #include "oscHandler.h"
+#include "../shaderSystem/ShaderRegistry.h"
+#include "../statsSystem/AllocationTracker.h"
+#include <sstream>
+#include <algorithm>
+#include <iomanip>
+#include <set>
+
+namespace {
+    /// Largest /preview downsample accepted; the atlas also clamps it to its shorter tile side.
+    const int kMaxPreviewDownsample = 64;
+
+    /// Parses "WxH" into two positive integers without throwing on malformed input.
+    bool parseResolution(const std::string& text, int& width, int& height) {
+        std::istringstream stream(text);
+        char separator = 0;
+        if (!(stream >> width >> separator >> height) || separator != 'x' || !stream.eof()) {
+            return false;
+        }
+        return width > 0 && height > 0;
+    }
+
+    /// Reads a shader ID given as a string or as a packed int64 ShaderHandle.
+    bool parseShaderId(const ofxOscMessage& osc_message, size_t index, std::string& shader_id) {
+        if (osc_message.getArgType(index) == OFXOSC_TYPE_STRING) {
+            shader_id = osc_message.getArgAsString(index);
+            return true;
+        }
+        if (osc_message.getArgType(index) == OFXOSC_TYPE_INT64) {
+            shader_id = ShaderHandle::unpack(static_cast<uint64_t>(osc_message.getArgAsInt64(index))).toString();
+            return true;
+        }
+        return false;
+    }
+
+    /// Parses "node key function args" and "output name key" records starting at an argument index.
+    bool parseGraphRecords(const ofxOscMessage& osc_message, size_t first, std::vector<OscGraphNode>& nodes,
+                           std::map<std::string, std::string>& outputs, std::string& error) {
+        size_t count = osc_message.getNumArgs();
+        std::set<std::string> keys;
+        size_t i = first;
+        while (i < count) {
+            std::string record = osc_message.getArgAsString(i);
+            if (record == "node" && i + 3 < count) {
+                OscGraphNode node;
+                node.key = osc_message.getArgAsString(i + 1);
+                node.function_name = osc_message.getArgAsString(i + 2);
+                node.raw_arguments = osc_message.getArgAsString(i + 3);
+                if (!keys.insert(node.key).second) {
+                    error = "Duplicate node key: " + node.key;
+                    return false;
+                }
+                nodes.push_back(node);
+                i += 4;
+            } else if (record == "output" && i + 2 < count) {
+                outputs[osc_message.getArgAsString(i + 1)] = osc_message.getArgAsString(i + 2);
+                i += 3;
+            } else {
+                error = "Expected 'node key function args' or 'output name key' at argument " + ofToString(i);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// Escapes the characters that delimit fields and records in the replay log.
+    std::string escapeLogField(const std::string& value) {
+        std::string escaped;
+        escaped.reserve(value.size());
+        for (char c : value) {
+            switch (c) {
+                case '\\': escaped += "\\\\"; break;
+                case '\t': escaped += "\\t"; break;
+                case '\n': escaped += "\\n"; break;
+                default: escaped += c; break;
+            }
+        }
+        return escaped;
+    }
+
+    /// Reverses escapeLogField().
+    std::string unescapeLogField(const std::string& value) {
+        std::string result;
+        result.reserve(value.size());
+        for (size_t i = 0; i < value.size(); ++i) {
+            if (value[i] == '\\' && i + 1 < value.size()) {
+                char next = value[++i];
+                result += (next == 't') ? '\t' : (next == 'n') ? '\n' : next;
+            } else {
+                result += value[i];
+            }
+        }
+        return result;
+    }
+}
 
 //--------------------------------------------------------------
-OscHandler::OscHandler() {
+OscHandler::OscHandler()
+    : replay_position(0)
+    , replay_mode(false) {
 }
 
 //--------------------------------------------------------------
@@ -19,26 +115,219 @@ void OscHandler::setup(int receive_port) {
 }
 
 //--------------------------------------------------------------
-void OscHandler::update() {
+void OscHandler::update(uint64_t frame_index) {
+    AllocationScope allocation_scope(AllocationTag::OSC);
+    if (replay_mode) {
+        while (replay_position < replay_entries.size() &&
+               replay_entries[replay_position].frame_index <= frame_index) {
+            dispatchMessage(replay_entries[replay_position].message);
+            replay_position++;
+        }
+        return;
+    }
+    receiveMessages(frame_index, false);
+}
+
+//--------------------------------------------------------------
+void OscHandler::latch(uint64_t frame_index) {
+    AllocationScope allocation_scope(AllocationTag::OSC);
+    if (replay_mode) {
+        return;
+    }
+    receiveMessages(frame_index, true);
+}
+
+//--------------------------------------------------------------
+void OscHandler::receiveMessages(uint64_t frame_index, bool latching) {
     while (receiver.hasWaitingMessages()) {
         ofxOscMessage osc_message;
         receiver.getNextMessage(osc_message);
-        
-        const std::string& address = osc_message.getAddress();
 
-        if (address == "/create") {
-            create_message_queue.push(parseCreateMessage(osc_message));
+        if (record_stream.is_open()) {
+            // Only /param is applied at latch time; everything else runs in the next update()
+            bool deferred = latching && osc_message.getAddress() != "/param";
+            recordMessage(deferred ? frame_index + 1 : frame_index, osc_message);
         }
-        else if (address == "/connect") {
-            connect_message_queue.push(parseConnectMessage(osc_message));
+        dispatchMessage(osc_message);
+    }
+}
+
+//--------------------------------------------------------------
+void OscHandler::dispatchMessage(const ofxOscMessage& osc_message) {
+    const std::string& address = osc_message.getAddress();
+
+    if (address == "/create") {
+        create_message_queue.push(parseCreateMessage(osc_message));
+    }
+    else if (address == "/connect") {
+        connect_message_queue.push(parseConnectMessage(osc_message));
+    }
+    else if (address == "/free") {
+        free_message_queue.push(parseFreeMessage(osc_message));
+    }
+    else if (address == "/stats") {
+        stats_message_queue.push(parseStatsMessage(osc_message));
+    }
+    else if (address == "/compute") {
+        compute_message_queue.push(parseComputeMessage(osc_message));
+    }
+    else if (address == "/preview") {
+        preview_message_queue.push(parsePreviewMessage(osc_message));
+    }
+    else if (address == "/heatmap") {
+        heatmap_message_queue.push(parseHeatmapMessage(osc_message));
+    }
+    else if (address == "/bench") {
+        bench_message_queue.push(parseBenchMessage(osc_message));
+    }
+    else if (address == "/texture") {
+        texture_message_queue.push(parseTextureMessage(osc_message));
+    }
+    else if (address == "/output") {
+        output_message_queue.push(parseOutputMessage(osc_message));
+    }
+    else if (address == "/graph") {
+        graph_message_queue.push(parseGraphMessage(osc_message));
+    }
+    else if (address == "/scene") {
+        scene_message_queue.push(parseSceneMessage(osc_message));
+    }
+    else if (address == "/param") {
+        param_message_queue.push(parseParamMessage(osc_message));
+    }
+    else {
+        ofLogWarning("OscHandler") << "Unknown OSC address: " << address;
+    }
+}
+
+//--------------------------------------------------------------
+bool OscHandler::loadReplayLog(const std::string& log_path) {
+    std::ifstream file(log_path);
+    if (!file.is_open()) {
+        ofLogError("OscHandler") << "Cannot open OSC replay log: " << log_path;
+        return false;
+    }
+
+    replay_entries.clear();
+    replay_position = 0;
+
+    std::string line;
+    size_t line_number = 0;
+    while (std::getline(file, line)) {
+        line_number++;
+        if (line.empty() || line[0] == '#') {
+            continue;
         }
-        else if (address == "/free") {
-            free_message_queue.push(parseFreeMessage(osc_message));
+
+        ReplayEntry entry;
+        if (!parseReplayLine(line, entry)) {
+            ofLogError("OscHandler") << "Invalid OSC replay entry at " << log_path << ":" << line_number;
+            return false;
         }
-        else {
-            ofLogWarning("OscHandler") << "Unknown OSC address: " << address;
+        replay_entries.push_back(entry);
+    }
+
+    // Entries are delivered in frame order; keep file order for messages of the same frame.
+    std::stable_sort(replay_entries.begin(), replay_entries.end(),
+                     [](const ReplayEntry& a, const ReplayEntry& b) { return a.frame_index < b.frame_index; });
+
+    replay_mode = true;
+    ofLogNotice("OscHandler") << "Loaded " << replay_entries.size() << " OSC messages for replay from " << log_path;
+    return true;
+}
+
+//--------------------------------------------------------------
+bool OscHandler::isReplaying() const {
+    return replay_mode;
+}
+
+//--------------------------------------------------------------
+bool OscHandler::isReplayFinished() const {
+    return replay_mode && replay_position >= replay_entries.size();
+}
+
+//--------------------------------------------------------------
+bool OscHandler::startRecording(const std::string& log_path) {
+    record_stream.open(log_path, std::ios::out | std::ios::trunc);
+    if (!record_stream.is_open()) {
+        ofLogError("OscHandler") << "Cannot open OSC record log: " << log_path;
+        return false;
+    }
+    // Enough digits for doubles to round-trip exactly, which keeps replays bit-reproducible.
+    record_stream << std::setprecision(17);
+    record_stream << "# frame\taddress\ttype:value...\n";
+    ofLogNotice("OscHandler") << "Recording OSC messages to " << log_path;
+    return true;
+}
+
+//--------------------------------------------------------------
+void OscHandler::recordMessage(uint64_t frame_index, const ofxOscMessage& osc_message) {
+    record_stream << frame_index << '\t' << escapeLogField(osc_message.getAddress());
+    for (size_t i = 0; i < osc_message.getNumArgs(); ++i) {
+        record_stream << '\t';
+        switch (osc_message.getArgType(i)) {
+            case OFXOSC_TYPE_STRING:
+                record_stream << "s:" << escapeLogField(osc_message.getArgAsString(i));
+                break;
+            case OFXOSC_TYPE_INT32:
+                record_stream << "i:" << osc_message.getArgAsInt32(i);
+                break;
+            case OFXOSC_TYPE_INT64:
+                record_stream << "h:" << osc_message.getArgAsInt64(i);
+                break;
+            case OFXOSC_TYPE_DOUBLE:
+                record_stream << "d:" << osc_message.getArgAsDouble(i);
+                break;
+            case OFXOSC_TYPE_FLOAT:
+                record_stream << "f:" << osc_message.getArgAsFloat(i);
+                break;
+            default:
+                ofLogWarning("OscHandler") << "Argument type not recordable, storing as string: "
+                                           << osc_message.getAddress();
+                record_stream << "s:" << escapeLogField(osc_message.getArgAsString(i));
+                break;
+        }
+    }
+    record_stream << '\n';
+    record_stream.flush();
+}
+
+//--------------------------------------------------------------
+bool OscHandler::parseReplayLine(const std::string& line, ReplayEntry& entry) {
+    std::vector<std::string> fields;
+    std::stringstream stream(line);
+    std::string field;
+    while (std::getline(stream, field, '\t')) {
+        fields.push_back(field);
+    }
+    if (fields.size() < 2) {
+        return false;
+    }
+
+    try {
+        entry.frame_index = std::stoull(fields[0]);
+        entry.message.clear();
+        entry.message.setAddress(unescapeLogField(fields[1]));
+
+        for (size_t i = 2; i < fields.size(); ++i) {
+            const std::string& arg = fields[i];
+            if (arg.size() < 2 || arg[1] != ':') {
+                return false;
+            }
+            std::string value = unescapeLogField(arg.substr(2));
+            switch (arg[0]) {
+                case 's': entry.message.addStringArg(value); break;
+                case 'i': entry.message.addIntArg(std::stoi(value)); break;
+                case 'h': entry.message.addInt64Arg(std::stoll(value)); break;
+                case 'f': entry.message.addFloatArg(std::stof(value)); break;
+                case 'd': entry.message.addDoubleArg(std::stod(value)); break;
+                default: return false;
+            }
         }
+    } catch (const std::exception&) {
+        return false;
     }
+    return true;
 }
 
 //--------------------------------------------------------------
@@ -56,6 +345,56 @@ bool OscHandler::hasFreeMessage() {
     return !free_message_queue.empty();
 }
 
+//--------------------------------------------------------------
+bool OscHandler::hasStatsMessage() {
+    return !stats_message_queue.empty();
+}
+
+//--------------------------------------------------------------
+bool OscHandler::hasComputeMessage() {
+    return !compute_message_queue.empty();
+}
+
+//--------------------------------------------------------------
+bool OscHandler::hasPreviewMessage() {
+    return !preview_message_queue.empty();
+}
+
+//--------------------------------------------------------------
+bool OscHandler::hasHeatmapMessage() {
+    return !heatmap_message_queue.empty();
+}
+
+//--------------------------------------------------------------
+bool OscHandler::hasBenchMessage() {
+    return !bench_message_queue.empty();
+}
+
+//--------------------------------------------------------------
+bool OscHandler::hasTextureMessage() {
+    return !texture_message_queue.empty();
+}
+
+//--------------------------------------------------------------
+bool OscHandler::hasOutputMessage() {
+    return !output_message_queue.empty();
+}
+
+//--------------------------------------------------------------
+bool OscHandler::hasGraphMessage() {
+    return !graph_message_queue.empty();
+}
+
+//--------------------------------------------------------------
+bool OscHandler::hasSceneMessage() {
+    return !scene_message_queue.empty();
+}
+
+//--------------------------------------------------------------
+bool OscHandler::hasParamMessage() {
+    return !param_message_queue.empty();
+}
+
 //--------------------------------------------------------------
 OscCreateMessage OscHandler::getNextCreateMessage() {
     if (create_message_queue.empty()) {
@@ -98,6 +437,164 @@ OscFreeMessage OscHandler::getNextFreeMessage() {
     return message;
 }
 
+//--------------------------------------------------------------
+OscStatsMessage OscHandler::getNextStatsMessage() {
+    if (stats_message_queue.empty()) {
+        OscStatsMessage empty_msg;
+        empty_msg.reset_after_report = false;
+        empty_msg.is_valid_format = false;
+        empty_msg.format_error = "No messages in queue";
+        return empty_msg;
+    }
+    
+    OscStatsMessage message = stats_message_queue.front();
+    stats_message_queue.pop();
+    return message;
+}
+
+//--------------------------------------------------------------
+OscComputeMessage OscHandler::getNextComputeMessage() {
+    if (compute_message_queue.empty()) {
+        OscComputeMessage empty_msg;
+        empty_msg.scale = 0.0f;
+        empty_msg.workgroup_size = 0;
+        empty_msg.is_valid_format = false;
+        empty_msg.format_error = "No messages in queue";
+        return empty_msg;
+    }
+    
+    OscComputeMessage message = compute_message_queue.front();
+    compute_message_queue.pop();
+    return message;
+}
+
+//--------------------------------------------------------------
+OscPreviewMessage OscHandler::getNextPreviewMessage() {
+    if (preview_message_queue.empty()) {
+        OscPreviewMessage empty_msg;
+        empty_msg.downsample = 1;
+        empty_msg.is_valid_format = false;
+        empty_msg.format_error = "No messages in queue";
+        return empty_msg;
+    }
+    
+    OscPreviewMessage message = preview_message_queue.front();
+    preview_message_queue.pop();
+    return message;
+}
+
+//--------------------------------------------------------------
+OscHeatmapMessage OscHandler::getNextHeatmapMessage() {
+    if (heatmap_message_queue.empty()) {
+        OscHeatmapMessage empty_msg;
+        empty_msg.toggle = false;
+        empty_msg.enable = false;
+        empty_msg.is_valid_format = false;
+        empty_msg.format_error = "No messages in queue";
+        return empty_msg;
+    }
+    
+    OscHeatmapMessage message = heatmap_message_queue.front();
+    heatmap_message_queue.pop();
+    return message;
+}
+
+//--------------------------------------------------------------
+OscBenchMessage OscHandler::getNextBenchMessage() {
+    if (bench_message_queue.empty()) {
+        OscBenchMessage empty_msg;
+        empty_msg.frames = 0;
+        empty_msg.width = 0;
+        empty_msg.height = 0;
+        empty_msg.is_valid_format = false;
+        empty_msg.format_error = "No messages in queue";
+        return empty_msg;
+    }
+    
+    OscBenchMessage message = bench_message_queue.front();
+    bench_message_queue.pop();
+    return message;
+}
+
+//--------------------------------------------------------------
+OscTextureMessage OscHandler::getNextTextureMessage() {
+    if (texture_message_queue.empty()) {
+        OscTextureMessage empty_msg;
+        empty_msg.decode_ahead = 0;
+        empty_msg.is_valid_format = false;
+        empty_msg.format_error = "No messages in queue";
+        return empty_msg;
+    }
+    
+    OscTextureMessage message = texture_message_queue.front();
+    texture_message_queue.pop();
+    return message;
+}
+
+//--------------------------------------------------------------
+OscOutputMessage OscHandler::getNextOutputMessage() {
+    if (output_message_queue.empty()) {
+        OscOutputMessage empty_msg;
+        empty_msg.width = 0;
+        empty_msg.height = 0;
+        empty_msg.has_window_rect = false;
+        empty_msg.is_valid_format = false;
+        empty_msg.format_error = "No messages in queue";
+        return empty_msg;
+    }
+    
+    OscOutputMessage message = output_message_queue.front();
+    output_message_queue.pop();
+    return message;
+}
+
+//--------------------------------------------------------------
+OscGraphMessage OscHandler::getNextGraphMessage() {
+    if (graph_message_queue.empty()) {
+        OscGraphMessage empty_msg;
+        empty_msg.is_valid_format = false;
+        empty_msg.format_error = "No messages in queue";
+        return empty_msg;
+    }
+    
+    OscGraphMessage message = graph_message_queue.front();
+    graph_message_queue.pop();
+    return message;
+}
+
+//--------------------------------------------------------------
+OscSceneMessage OscHandler::getNextSceneMessage() {
+    if (scene_message_queue.empty()) {
+        OscSceneMessage empty_msg;
+        empty_msg.is_valid_format = false;
+        empty_msg.format_error = "No messages in queue";
+        return empty_msg;
+    }
+    
+    OscSceneMessage message = scene_message_queue.front();
+    scene_message_queue.pop();
+    return message;
+}
+
+//--------------------------------------------------------------
+OscParamMessage OscHandler::getNextParamMessage() {
+    if (param_message_queue.empty()) {
+        OscParamMessage empty_msg;
+        empty_msg.is_valid_format = false;
+        empty_msg.format_error = "No messages in queue";
+        return empty_msg;
+    }
+    
+    OscParamMessage message = param_message_queue.front();
+    param_message_queue.pop();
+    return message;
+}
+
+//--------------------------------------------------------------
+void OscHandler::deferParamMessage(const OscParamMessage& message) {
+    param_message_queue.push(message);
+}
+
 //--------------------------------------------------------------
 void OscHandler::sendCreateResponse(bool success, const std::string& message, const std::string& shader_id) {
     ofxOscMessage response;
@@ -106,6 +603,11 @@ void OscHandler::sendCreateResponse(bool success, const std::string& message, co
     response.addStringArg(message);
     if (!shader_id.empty()) {
         response.addStringArg(shader_id);
+        // The packed handle lets clients address the shader with a single int64 argument
+        ShaderHandle handle = ShaderHandle::parse(shader_id);
+        if (!handle.isNull()) {
+            response.addInt64Arg(static_cast<int64_t>(handle.pack()));
+        }
     }
     sender.sendMessage(response);
     
@@ -138,6 +640,152 @@ void OscHandler::sendFreeResponse(bool success, const std::string& message) {
                               << " - " << message;
 }
 
+//--------------------------------------------------------------
+void OscHandler::sendStatsResponse(const std::vector<std::pair<std::string, double>>& entries) {
+    ofxOscMessage response;
+    response.setAddress("/stats/response");
+    response.addStringArg("success");
+    for (const auto& entry : entries) {
+        response.addStringArg(entry.first);
+        response.addFloatArg(static_cast<float>(entry.second));
+    }
+    sender.sendMessage(response);
+    
+    ofLogNotice("OscHandler") << "Sent stats response with " << entries.size() << " entries";
+}
+
+//--------------------------------------------------------------
+void OscHandler::sendComputeResponse(bool success, const std::string& message) {
+    ofxOscMessage response;
+    response.setAddress("/compute/response");
+    response.addStringArg(success ? "success" : "error");
+    response.addStringArg(message);
+    sender.sendMessage(response);
+    
+    ofLogNotice("OscHandler") << "Sent compute response: " << (success ? "success" : "error") 
+                              << " - " << message;
+}
+
+//--------------------------------------------------------------
+void OscHandler::sendPreviewResponse(bool success, const std::string& message, const ofPixels* pixels) {
+    ofxOscMessage response;
+    response.setAddress("/preview/response");
+    
+    if (success && pixels) {
+        response.addStringArg("success");
+        response.addStringArg(message);
+        response.addIntArg(static_cast<int32_t>(pixels->getWidth()));
+        response.addIntArg(static_cast<int32_t>(pixels->getHeight()));
+        response.addBlobArg(ofBuffer(reinterpret_cast<const char*>(pixels->getData()), pixels->getTotalBytes()));
+    } else {
+        response.addStringArg("error");
+        response.addStringArg(message);
+    }
+    sender.sendMessage(response);
+    
+    ofLogVerbose("OscHandler") << "Sent preview response: " << (success ? "success" : "error") 
+                               << " - " << message;
+}
+
+//--------------------------------------------------------------
+void OscHandler::sendHeatmapResponse(bool success, const std::string& message) {
+    ofxOscMessage response;
+    response.setAddress("/heatmap/response");
+    response.addStringArg(success ? "success" : "error");
+    response.addStringArg(message);
+    sender.sendMessage(response);
+    
+    ofLogNotice("OscHandler") << "Sent heatmap response: " << (success ? "success" : "error") 
+                              << " - " << message;
+}
+
+//--------------------------------------------------------------
+void OscHandler::sendBenchResponse(bool success, const std::string& message, const ShaderBenchmark::Result* result) {
+    ofxOscMessage response;
+    response.setAddress("/bench/response");
+    
+    if (success && result) {
+        response.addStringArg("success");
+        response.addStringArg(message);
+        response.addFloatArg(static_cast<float>(result->median_ms));
+        response.addFloatArg(static_cast<float>(result->p95_ms));
+        response.addFloatArg(static_cast<float>(result->compile_ms));
+        response.addFloatArg(static_cast<float>(result->link_ms));
+        response.addIntArg(result->frames);
+        response.addIntArg(result->width);
+        response.addIntArg(result->height);
+        response.addFloatArg(static_cast<float>(result->allocations_per_frame));
+        response.addFloatArg(static_cast<float>(result->allocated_bytes_per_frame));
+    } else {
+        response.addStringArg("error");
+        response.addStringArg(message);
+    }
+    sender.sendMessage(response);
+    
+    ofLogNotice("OscHandler") << "Sent bench response: " << (success ? "success" : "error") 
+                              << " - " << message;
+}
+
+//--------------------------------------------------------------
+void OscHandler::sendTextureResponse(bool success, const std::string& message) {
+    ofxOscMessage response;
+    response.setAddress("/texture/response");
+    response.addStringArg(success ? "success" : "error");
+    response.addStringArg(message);
+    sender.sendMessage(response);
+    
+    ofLogNotice("OscHandler") << "Sent texture response: " << (success ? "success" : "error") 
+                              << " - " << message;
+}
+
+//--------------------------------------------------------------
+void OscHandler::sendOutputResponse(bool success, const std::string& message) {
+    ofxOscMessage response;
+    response.setAddress("/output/response");
+    response.addStringArg(success ? "success" : "error");
+    response.addStringArg(message);
+    sender.sendMessage(response);
+    
+    ofLogNotice("OscHandler") << "Sent output response: " << (success ? "success" : "error") 
+                              << " - " << message;
+}
+
+//--------------------------------------------------------------
+void OscHandler::sendGraphResponse(bool success, const std::string& message) {
+    ofxOscMessage response;
+    response.setAddress("/graph/response");
+    response.addStringArg(success ? "success" : "error");
+    response.addStringArg(message);
+    sender.sendMessage(response);
+    
+    ofLogNotice("OscHandler") << "Sent graph response: " << (success ? "success" : "error") 
+                              << " - " << message;
+}
+
+//--------------------------------------------------------------
+void OscHandler::sendSceneResponse(bool success, const std::string& message) {
+    ofxOscMessage response;
+    response.setAddress("/scene/response");
+    response.addStringArg(success ? "success" : "error");
+    response.addStringArg(message);
+    sender.sendMessage(response);
+    
+    ofLogNotice("OscHandler") << "Sent scene response: " << (success ? "success" : "error") 
+                              << " - " << message;
+}
+
+//--------------------------------------------------------------
+void OscHandler::sendParamResponse(bool success, const std::string& message) {
+    ofxOscMessage response;
+    response.setAddress("/param/response");
+    response.addStringArg(success ? "success" : "error");
+    response.addStringArg(message);
+    sender.sendMessage(response);
+    
+    ofLogNotice("OscHandler") << "Sent param response: " << (success ? "success" : "error") 
+                              << " - " << message;
+}
+
 //--------------------------------------------------------------
 OscCreateMessage OscHandler::parseCreateMessage(const ofxOscMessage& osc_message) {
     OscCreateMessage result;
@@ -170,21 +818,27 @@ OscConnectMessage OscHandler::parseConnectMessage(const ofxOscMessage& osc_messa
     OscConnectMessage result;
     result.is_valid_format = false;
     
-    // Expected format: /connect [string:shader_id]
-    if (osc_message.getNumArgs() != 1) {
-        result.format_error = "Expected 1 argument (shader_id)";
+    // Expected format: /connect [string:output_name] [string|int64:shader_id]
+    // The output name is optional; without it the main output is connected.
+    if (osc_message.getNumArgs() != 1 && osc_message.getNumArgs() != 2) {
+        result.format_error = "Expected 1 or 2 arguments ([output_name], shader_id)";
         return result;
     }
     
-    if (osc_message.getArgType(0) != OFXOSC_TYPE_STRING) {
-        result.format_error = "Shader ID must be a string";
+    size_t id_index = osc_message.getNumArgs() - 1;
+    if ((id_index == 1 && osc_message.getArgType(0) != OFXOSC_TYPE_STRING) ||
+        !parseShaderId(osc_message, id_index, result.shader_id)) {
+        result.format_error = "Output name must be a string and shader ID a string or int64 handle";
         return result;
     }
     
-    result.shader_id = osc_message.getArgAsString(0);
+    if (osc_message.getNumArgs() == 2) {
+        result.output_name = osc_message.getArgAsString(0);
+    }
     result.is_valid_format = true;
     
-    ofLogNotice("OscHandler") << "Parsed /connect message: shader_id = " << result.shader_id;
+    ofLogNotice("OscHandler") << "Parsed /connect message: shader_id = " << result.shader_id
+                              << (result.output_name.empty() ? "" : ", output = " + result.output_name);
     
     return result;
 }
@@ -194,21 +848,413 @@ OscFreeMessage OscHandler::parseFreeMessage(const ofxOscMessage& osc_message) {
     OscFreeMessage result;
     result.is_valid_format = false;
     
-    // Expected format: /free [string:shader_id]
+    // Expected format: /free [string|int64:shader_id]
     if (osc_message.getNumArgs() != 1) {
         result.format_error = "Expected 1 argument (shader_id)";
         return result;
     }
     
+    if (!parseShaderId(osc_message, 0, result.shader_id)) {
+        result.format_error = "Shader ID must be a string or int64 handle";
+        return result;
+    }
+    result.is_valid_format = true;
+    
+    ofLogNotice("OscHandler") << "Parsed /free message: shader_id = " << result.shader_id;
+    
+    return result;
+}
+
+//--------------------------------------------------------------
+OscStatsMessage OscHandler::parseStatsMessage(const ofxOscMessage& osc_message) {
+    OscStatsMessage result;
+    result.reset_after_report = false;
+    result.is_valid_format = false;
+    
+    // Expected format: /stats [string:"reset"]
+    if (osc_message.getNumArgs() > 1) {
+        result.format_error = "Expected at most 1 argument (\"reset\")";
+        return result;
+    }
+    
+    if (osc_message.getNumArgs() == 1) {
+        if (osc_message.getArgType(0) != OFXOSC_TYPE_STRING || osc_message.getArgAsString(0) != "reset") {
+            result.format_error = "The only supported argument is \"reset\"";
+            return result;
+        }
+        result.reset_after_report = true;
+    }
+    
+    result.is_valid_format = true;
+    return result;
+}
+
+//--------------------------------------------------------------
+OscComputeMessage OscHandler::parseComputeMessage(const ofxOscMessage& osc_message) {
+    OscComputeMessage result;
+    result.scale = 0.25f;
+    result.workgroup_size = 0;
+    result.is_valid_format = false;
+    
+    // Expected format: /compute [string|int64:shader_id] [float:scale] [int:workgroup_size]
+    if (osc_message.getNumArgs() < 1 || osc_message.getNumArgs() > 3) {
+        result.format_error = "Expected 1 to 3 arguments (shader_id, [scale], [workgroup_size])";
+        return result;
+    }
+    
+    if (!parseShaderId(osc_message, 0, result.shader_id)) {
+        result.format_error = "Shader ID must be a string or int64 handle";
+        return result;
+    }
+    
+    if (osc_message.getNumArgs() > 1) {
+        if (osc_message.getArgType(1) == OFXOSC_TYPE_FLOAT) {
+            result.scale = osc_message.getArgAsFloat(1);
+        } else if (osc_message.getArgType(1) == OFXOSC_TYPE_INT32) {
+            result.scale = static_cast<float>(osc_message.getArgAsInt32(1));
+        } else {
+            result.format_error = "Argument 1 must be a number (scale)";
+            return result;
+        }
+    }
+    
+    if (osc_message.getNumArgs() > 2) {
+        if (osc_message.getArgType(2) != OFXOSC_TYPE_INT32) {
+            result.format_error = "Argument 2 must be an int (workgroup_size)";
+            return result;
+        }
+        result.workgroup_size = osc_message.getArgAsInt32(2);
+    }
+    
+    if (result.shader_id.empty()) {
+        result.format_error = "shader_id cannot be empty";
+        return result;
+    }
+    
+    result.is_valid_format = true;
+    return result;
+}
+
+//--------------------------------------------------------------
+OscPreviewMessage OscHandler::parsePreviewMessage(const ofxOscMessage& osc_message) {
+    OscPreviewMessage result;
+    result.downsample = 2;
+    result.is_valid_format = false;
+    
+    // Expected format: /preview [string|int64:shader_id] [int:downsample]
+    if (osc_message.getNumArgs() < 1 || osc_message.getNumArgs() > 2) {
+        result.format_error = "Expected 1 or 2 arguments (shader_id, [downsample])";
+        return result;
+    }
+    
+    if (!parseShaderId(osc_message, 0, result.shader_id)) {
+        result.format_error = "Shader ID must be a string or int64 handle";
+        return result;
+    }
+    
+    if (osc_message.getNumArgs() > 1) {
+        if (osc_message.getArgType(1) != OFXOSC_TYPE_INT32 || osc_message.getArgAsInt32(1) < 1 ||
+            osc_message.getArgAsInt32(1) > kMaxPreviewDownsample) {
+            result.format_error = "Argument 1 must be an int from 1 to " + std::to_string(kMaxPreviewDownsample) + " (downsample)";
+            return result;
+        }
+        result.downsample = osc_message.getArgAsInt32(1);
+    }
+    
+    if (result.shader_id.empty()) {
+        result.format_error = "shader_id cannot be empty";
+        return result;
+    }
+    
+    result.is_valid_format = true;
+    return result;
+}
+
+//--------------------------------------------------------------
+OscHeatmapMessage OscHandler::parseHeatmapMessage(const ofxOscMessage& osc_message) {
+    OscHeatmapMessage result;
+    result.toggle = true;
+    result.enable = false;
+    result.is_valid_format = false;
+    
+    // Expected format: /heatmap [string|int64:shader_id] [int:enable]
+    if (osc_message.getNumArgs() < 1 || osc_message.getNumArgs() > 2) {
+        result.format_error = "Expected 1 or 2 arguments (shader_id, [enable])";
+        return result;
+    }
+    
+    if (!parseShaderId(osc_message, 0, result.shader_id)) {
+        result.format_error = "Shader ID must be a string or int64 handle";
+        return result;
+    }
+    
+    if (osc_message.getNumArgs() > 1) {
+        if (osc_message.getArgType(1) != OFXOSC_TYPE_INT32) {
+            result.format_error = "Argument 1 must be an int (enable)";
+            return result;
+        }
+        result.toggle = false;
+        result.enable = osc_message.getArgAsInt32(1) != 0;
+    }
+    
+    if (result.shader_id.empty()) {
+        result.format_error = "shader_id cannot be empty";
+        return result;
+    }
+    
+    result.is_valid_format = true;
+    return result;
+}
+
+//--------------------------------------------------------------
+OscBenchMessage OscHandler::parseBenchMessage(const ofxOscMessage& osc_message) {
+    OscBenchMessage result;
+    result.frames = 120;
+    result.width = 1920;
+    result.height = 1080;
+    result.is_valid_format = false;
+    
+    // Expected format: /bench [string|int64:shader_id] [int:frames] [string:WxH]
+    if (osc_message.getNumArgs() < 1 || osc_message.getNumArgs() > 3) {
+        result.format_error = "Expected 1 to 3 arguments (shader_id, [frames], [WxH])";
+        return result;
+    }
+    
+    if (!parseShaderId(osc_message, 0, result.shader_id)) {
+        result.format_error = "Shader ID must be a string or int64 handle";
+        return result;
+    }
+    
+    if (osc_message.getNumArgs() > 1) {
+        if (osc_message.getArgType(1) != OFXOSC_TYPE_INT32 || osc_message.getArgAsInt32(1) < 1) {
+            result.format_error = "Argument 1 must be a positive int (frames)";
+            return result;
+        }
+        result.frames = osc_message.getArgAsInt32(1);
+    }
+    
+    if (osc_message.getNumArgs() > 2) {
+        if (osc_message.getArgType(2) != OFXOSC_TYPE_STRING ||
+            !parseResolution(osc_message.getArgAsString(2), result.width, result.height)) {
+            result.format_error = "Argument 2 must be a string like 1920x1080 (resolution)";
+            return result;
+        }
+    }
+    
+    if (result.shader_id.empty()) {
+        result.format_error = "shader_id cannot be empty";
+        return result;
+    }
+    
+    result.is_valid_format = true;
+    return result;
+}
+
+//--------------------------------------------------------------
+OscTextureMessage OscHandler::parseTextureMessage(const ofxOscMessage& osc_message) {
+    OscTextureMessage result;
+    result.decode_ahead = 0;
+    result.is_valid_format = false;
+    
+    // Expected format: /texture [string:name] [string:path] [int:decode_ahead]
+    if (osc_message.getNumArgs() < 1 || osc_message.getNumArgs() > 3) {
+        result.format_error = "Expected 1 to 3 arguments (name, [path], [decode_ahead])";
+        return result;
+    }
+    
     if (osc_message.getArgType(0) != OFXOSC_TYPE_STRING) {
-        result.format_error = "Shader ID must be a string";
+        result.format_error = "Argument 0 must be a string (name)";
+        return result;
+    }
+    result.name = osc_message.getArgAsString(0);
+    
+    if (osc_message.getNumArgs() > 1) {
+        if (osc_message.getArgType(1) != OFXOSC_TYPE_STRING) {
+            result.format_error = "Argument 1 must be a string (path)";
+            return result;
+        }
+        result.path = osc_message.getArgAsString(1);
+    }
+    
+    if (osc_message.getNumArgs() > 2) {
+        if (osc_message.getArgType(2) != OFXOSC_TYPE_INT32 || osc_message.getArgAsInt32(2) < 1) {
+            result.format_error = "Argument 2 must be a positive int (decode_ahead)";
+            return result;
+        }
+        result.decode_ahead = osc_message.getArgAsInt32(2);
+    }
+    
+    if (result.name.empty()) {
+        result.format_error = "name cannot be empty";
         return result;
     }
     
-    result.shader_id = osc_message.getArgAsString(0);
     result.is_valid_format = true;
+    return result;
+}
+
+//--------------------------------------------------------------
+OscOutputMessage OscHandler::parseOutputMessage(const ofxOscMessage& osc_message) {
+    OscOutputMessage result;
+    result.width = 0;
+    result.height = 0;
+    result.has_window_rect = false;
+    result.is_valid_format = false;
     
-    ofLogNotice("OscHandler") << "Parsed /free message: shader_id = " << result.shader_id;
+    // Expected format: /output [string:name] [string:WxH] [int:x int:y int:w int:h] [string:shm_name]
+    size_t count = osc_message.getNumArgs();
+    if (count < 1 || osc_message.getArgType(0) != OFXOSC_TYPE_STRING) {
+        result.format_error = "Argument 0 must be a string (name)";
+        return result;
+    }
+    result.name = osc_message.getArgAsString(0);
+    if (result.name.empty()) {
+        result.format_error = "name cannot be empty";
+        return result;
+    }
+    if (count == 1) {
+        result.is_valid_format = true;
+        return result;
+    }
+    
+    if (osc_message.getArgType(1) != OFXOSC_TYPE_STRING ||
+        !parseResolution(osc_message.getArgAsString(1), result.width, result.height)) {
+        result.format_error = "Argument 1 must be a string like 1920x1080 (resolution)";
+        return result;
+    }
+    
+    size_t next = 2;
+    if (count >= 6) {
+        for (size_t i = 2; i < 6; ++i) {
+            if (osc_message.getArgType(i) != OFXOSC_TYPE_INT32) {
+                result.format_error = "Arguments 2-5 must be ints (x, y, w, h)";
+                return result;
+            }
+        }
+        result.window_rect.set(osc_message.getArgAsInt32(2), osc_message.getArgAsInt32(3),
+                               osc_message.getArgAsInt32(4), osc_message.getArgAsInt32(5));
+        result.has_window_rect = true;
+        next = 6;
+    }
+    
+    if (next < count) {
+        if (next + 1 != count || osc_message.getArgType(next) != OFXOSC_TYPE_STRING) {
+            result.format_error = "Expected name, WxH, [x y w h] and [shm_name]";
+            return result;
+        }
+        result.shm_name = osc_message.getArgAsString(next);
+    }
+    
+    result.is_valid_format = true;
+    return result;
+}
+
+//--------------------------------------------------------------
+OscGraphMessage OscHandler::parseGraphMessage(const ofxOscMessage& osc_message) {
+    OscGraphMessage result;
+    result.is_valid_format = false;
+    
+    // Expected format: a flat list of records, all strings:
+    //   /graph node [key] [function] [args] ... output [output_name] [key] ...
+    // Node arguments are comma-separated like /create and reference other nodes as $key.
+    size_t count = osc_message.getNumArgs();
+    for (size_t i = 0; i < count; ++i) {
+        if (osc_message.getArgType(i) != OFXOSC_TYPE_STRING) {
+            result.format_error = "All arguments must be strings";
+            return result;
+        }
+    }
+    
+    if (!parseGraphRecords(osc_message, 0, result.nodes, result.outputs, result.format_error)) {
+        return result;
+    }
+    
+    result.is_valid_format = true;
+    return result;
+}
+
+//--------------------------------------------------------------
+OscSceneMessage OscHandler::parseSceneMessage(const ofxOscMessage& osc_message) {
+    OscSceneMessage result;
+    result.is_valid_format = false;
     
+    // Expected formats, all strings:
+    //   /scene [name]                                  - switch to a scene
+    //   /scene [name] file [path]                      - load a scene file
+    //   /scene [name] node [key] [fn] [args] ... output [output_name] [key] ...
+    //   /scene cuelist [name] [name] ...               - set the expected cue order
+    size_t count = osc_message.getNumArgs();
+    if (count < 1) {
+        result.format_error = "Expected at least 1 argument (scene name)";
+        return result;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        if (osc_message.getArgType(i) != OFXOSC_TYPE_STRING) {
+            result.format_error = "All arguments must be strings";
+            return result;
+        }
+    }
+    
+    std::string first = osc_message.getArgAsString(0);
+    if (first == "cuelist") {
+        result.action = "cuelist";
+        for (size_t i = 1; i < count; ++i) {
+            result.cue_list.push_back(osc_message.getArgAsString(i));
+        }
+        result.is_valid_format = true;
+        return result;
+    }
+    
+    result.scene_name = first;
+    if (count == 1) {
+        result.action = "switch";
+    } else if (osc_message.getArgAsString(1) == "file") {
+        if (count != 3) {
+            result.format_error = "Expected 'file [path]' after the scene name";
+            return result;
+        }
+        result.action = "file";
+        result.path = osc_message.getArgAsString(2);
+    } else {
+        result.action = "define";
+        if (!parseGraphRecords(osc_message, 1, result.nodes, result.outputs, result.format_error)) {
+            return result;
+        }
+    }
+    
+    result.is_valid_format = true;
+    return result;
+}
+
+//--------------------------------------------------------------
+OscParamMessage OscHandler::parseParamMessage(const ofxOscMessage& osc_message) {
+    OscParamMessage result;
+    result.is_valid_format = false;
+    
+    // Expected format: /param [string|int64:node_id] [string:port] [value] [value] ...
+    // One value is broadcast to every component; otherwise one per component (up to 4).
+    size_t count = osc_message.getNumArgs();
+    if (count < 3 || count > 6) {
+        result.format_error = "Expected node_id, port and 1 to 4 values";
+        return result;
+    }
+    if (!parseShaderId(osc_message, 0, result.node_id) || osc_message.getArgType(1) != OFXOSC_TYPE_STRING) {
+        result.format_error = "Node ID must be a string or int64 handle and argument 1 a string (port)";
+        return result;
+    }
+    result.port_name = osc_message.getArgAsString(1);
+    
+    for (size_t i = 2; i < count; ++i) {
+        if (osc_message.getArgType(i) == OFXOSC_TYPE_FLOAT) {
+            result.values.push_back(osc_message.getArgAsFloat(i));
+        } else if (osc_message.getArgType(i) == OFXOSC_TYPE_INT32) {
+            result.values.push_back(static_cast<float>(osc_message.getArgAsInt32(i)));
+        } else {
+            result.format_error = "Argument " + ofToString(i) + " must be a number";
+            return result;
+        }
+    }
+    
+    result.is_valid_format = true;
     return result;
-}
\ No newline at end of file
+}
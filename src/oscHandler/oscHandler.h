@@ -1,7 +1,10 @@
 #pragma once
 #include "ofMain.h"
 #include "ofxOsc.h"
+#include "../renderSystem/ShaderBenchmark.h"
 #include <queue>
+#include <fstream>
+#include <map>
 
 /**
  * @struct OscCreateMessage
@@ -19,7 +22,8 @@ struct OscCreateMessage {
  * @brief  Holds the parsed data from a "/connect" OSC message.
  */
 struct OscConnectMessage {
-    std::string shader_id;          ///< The unique ID of the shader to connect.
+    std::string output_name;        ///< The named output to connect to, empty for the main output.
+    std::string shader_id;          ///< The unique ID of the shader to connect, also if sent as an int64 handle.
     bool is_valid_format;           ///< True if the OSC message was parsed successfully.
     std::string format_error;       ///< An error message if parsing failed.
 };
@@ -29,7 +33,140 @@ struct OscConnectMessage {
  * @brief  Holds the parsed data from a "/free" OSC message.
  */
 struct OscFreeMessage {
-    std::string shader_id;          ///< The unique ID of the shader to free.
+    std::string shader_id;          ///< The unique ID of the shader to free, also if sent as an int64 handle.
+    bool is_valid_format;           ///< True if the OSC message was parsed successfully.
+    std::string format_error;       ///< An error message if parsing failed.
+};
+
+/**
+ * @struct OscStatsMessage
+ * @brief  Holds the parsed data from a "/stats" OSC message.
+ */
+struct OscStatsMessage {
+    bool reset_after_report;        ///< True if the statistics should be cleared after reporting.
+    bool is_valid_format;           ///< True if the OSC message was parsed successfully.
+    std::string format_error;       ///< An error message if parsing failed.
+};
+
+/**
+ * @struct OscComputeMessage
+ * @brief  Holds the parsed data from a "/compute" OSC message.
+ */
+struct OscComputeMessage {
+    std::string shader_id;          ///< The node to evaluate with a compute shader.
+    float scale;                    ///< Field resolution relative to the output, 0 to disable.
+    int workgroup_size;             ///< Compute local size in x and y, 0 for the default.
+    bool is_valid_format;           ///< True if the OSC message was parsed successfully.
+    std::string format_error;       ///< An error message if parsing failed.
+};
+
+/**
+ * @struct OscPreviewMessage
+ * @brief  Holds the parsed data from a "/preview" OSC message.
+ */
+struct OscPreviewMessage {
+    std::string shader_id;          ///< The shader or composition output to send the preview of.
+    int downsample;                 ///< Integer reduction factor of the preview tile.
+    bool is_valid_format;           ///< True if the OSC message was parsed successfully.
+    std::string format_error;       ///< An error message if parsing failed.
+};
+
+/**
+ * @struct OscHeatmapMessage
+ * @brief  Holds the parsed data from a "/heatmap" OSC message.
+ */
+struct OscHeatmapMessage {
+    std::string shader_id;          ///< The shader or composition output to diagnose.
+    bool toggle;                    ///< True if no state was given and the heatmap is toggled.
+    bool enable;                    ///< The requested state when toggle is false.
+    bool is_valid_format;           ///< True if the OSC message was parsed successfully.
+    std::string format_error;       ///< An error message if parsing failed.
+};
+
+/**
+ * @struct OscBenchMessage
+ * @brief  Holds the parsed data from a "/bench" OSC message.
+ */
+struct OscBenchMessage {
+    std::string shader_id;          ///< The shader, composition output or graph node to measure.
+    int frames;                     ///< Number of frames to time.
+    int width;                      ///< Render width in pixels.
+    int height;                     ///< Render height in pixels.
+    bool is_valid_format;           ///< True if the OSC message was parsed successfully.
+    std::string format_error;       ///< An error message if parsing failed.
+};
+
+/**
+ * @struct OscTextureMessage
+ * @brief  Holds the parsed data from a "/texture" OSC message.
+ */
+struct OscTextureMessage {
+    std::string name;               ///< The sampler name the source is available under.
+    std::string path;               ///< Image or video file, empty to remove the source.
+    int decode_ahead;               ///< Decoded video frames kept ready, 0 for the default.
+    bool is_valid_format;           ///< True if the OSC message was parsed successfully.
+    std::string format_error;       ///< An error message if parsing failed.
+};
+
+/**
+ * @struct OscOutputMessage
+ * @brief  Holds the parsed data from a "/output" OSC message.
+ */
+struct OscOutputMessage {
+    std::string name;               ///< The output name.
+    int width;                      ///< Output width in pixels, 0 to remove the output.
+    int height;                     ///< Output height in pixels.
+    bool has_window_rect;           ///< True if the output is drawn into the window.
+    ofRectangle window_rect;        ///< Window rectangle the output is drawn to.
+    std::string shm_name;           ///< Shared-memory ring to publish to, empty for none.
+    bool is_valid_format;           ///< True if the OSC message was parsed successfully.
+    std::string format_error;       ///< An error message if parsing failed.
+};
+
+/**
+ * @struct OscGraphNode
+ * @brief  One node record of a "/graph" OSC message.
+ */
+struct OscGraphNode {
+    std::string key;                ///< Client key of the node.
+    std::string function_name;      ///< The GLSL function.
+    std::string raw_arguments;      ///< Comma-separated arguments, "$key" for other nodes.
+};
+
+/**
+ * @struct OscGraphMessage
+ * @brief  Holds the parsed data from a "/graph" OSC message.
+ */
+struct OscGraphMessage {
+    std::vector<OscGraphNode> nodes;                ///< The complete set of desired nodes.
+    std::map<std::string, std::string> outputs;     ///< Node key shown on each output.
+    bool is_valid_format;           ///< True if the OSC message was parsed successfully.
+    std::string format_error;       ///< An error message if parsing failed.
+};
+
+/**
+ * @struct OscSceneMessage
+ * @brief  Holds the parsed data from a "/scene" OSC message.
+ */
+struct OscSceneMessage {
+    std::string scene_name;         ///< The scene to switch to or define; empty for a cue list.
+    std::string action;             ///< "switch", "file", "define" or "cuelist".
+    std::string path;               ///< Scene file for the "file" action.
+    std::vector<OscGraphNode> nodes;                ///< Scene nodes for the "define" action.
+    std::map<std::string, std::string> outputs;     ///< Node key shown on each output.
+    std::vector<std::string> cue_list;              ///< Scene order for the "cuelist" action.
+    bool is_valid_format;           ///< True if the OSC message was parsed successfully.
+    std::string format_error;       ///< An error message if parsing failed.
+};
+
+/**
+ * @struct OscParamMessage
+ * @brief  Holds the parsed data from a "/param" OSC message.
+ */
+struct OscParamMessage {
+    std::string node_id;            ///< The composition node (or /graph key) that declares the port.
+    std::string port_name;          ///< The parameter port.
+    std::vector<float> values;      ///< One value, or one per component of the port type.
     bool is_valid_format;           ///< True if the OSC message was parsed successfully.
     std::string format_error;       ///< An error message if parsing failed.
 };
@@ -55,8 +192,50 @@ public:
     /**
      * @brief Checks for and processes any waiting OSC messages.
      * @details This should be called once per frame in the main update loop.
+     *          In replay mode the live receiver is ignored and the logged messages
+     *          stamped with frames up to and including frame_index are processed instead.
+     * @param frame_index The index of the frame being produced, used for recording and replay.
+     */
+    void update(uint64_t frame_index = 0);
+
+    /**
+     * @brief Receives the messages that arrived since update(), right before a frame is drawn.
+     * @details /param messages are recorded under frame_index, since they are applied to the
+     *          frame about to be drawn; all others are recorded under frame_index + 1, the
+     *          frame whose update() processes them. A replay thus runs every message in the
+     *          same frame as live. Does nothing in replay mode, where update() delivers the
+     *          logged /param messages of the frame.
+     * @param frame_index The index of the frame about to be drawn.
+     */
+    void latch(uint64_t frame_index);
+
+    // --- Recording and Replay ---
+    /**
+     * @brief Loads an OSC log and switches the handler to replay mode.
+     * @details Each non-empty line that does not start with '#' has the form
+     *          "<frame>\t<address>\t<type>:<value>...", as written by startRecording().
+     *          Types are 's' (string), 'i' (int32), 'h' (int64), 'f' (float) and 'd' (double).
+     * @param log_path The path of the log file.
+     * @return True if the log was read, false otherwise.
+     */
+    bool loadReplayLog(const std::string& log_path);
+
+    /**
+     * @brief Checks whether the handler is replaying a log instead of listening live.
      */
-    void update();
+    bool isReplaying() const;
+
+    /**
+     * @brief Checks whether every message of the replay log has been delivered.
+     */
+    bool isReplayFinished() const;
+
+    /**
+     * @brief Starts appending every received message to a log that loadReplayLog() can read.
+     * @param log_path The path of the log file. An existing file is overwritten.
+     * @return True if the file could be opened, false otherwise.
+     */
+    bool startRecording(const std::string& log_path);
     
     // --- Message Queue Management ---
     /**
@@ -76,6 +255,66 @@ public:
      * @return True if a message is available, false otherwise.
      */
     bool hasFreeMessage();
+
+    /**
+     * @brief Checks if there is a new "/stats" message in the queue.
+     * @return True if a message is available, false otherwise.
+     */
+    bool hasStatsMessage();
+
+    /**
+     * @brief Checks if there is a new "/compute" message in the queue.
+     * @return True if a message is available, false otherwise.
+     */
+    bool hasComputeMessage();
+
+    /**
+     * @brief Checks if there is a new "/preview" message in the queue.
+     * @return True if a message is available, false otherwise.
+     */
+    bool hasPreviewMessage();
+
+    /**
+     * @brief Checks if there is a new "/heatmap" message in the queue.
+     * @return True if a message is available, false otherwise.
+     */
+    bool hasHeatmapMessage();
+
+    /**
+     * @brief Checks if there is a new "/bench" message in the queue.
+     * @return True if a message is available, false otherwise.
+     */
+    bool hasBenchMessage();
+
+    /**
+     * @brief Checks if there is a new "/texture" message in the queue.
+     * @return True if a message is available, false otherwise.
+     */
+    bool hasTextureMessage();
+
+    /**
+     * @brief Checks if there is a new "/output" message in the queue.
+     * @return True if a message is available, false otherwise.
+     */
+    bool hasOutputMessage();
+
+    /**
+     * @brief Checks if there is a new "/graph" message in the queue.
+     * @return True if a message is available, false otherwise.
+     */
+    bool hasGraphMessage();
+
+    /**
+     * @brief Checks if there is a new "/scene" message in the queue.
+     * @return True if a message is available, false otherwise.
+     */
+    bool hasSceneMessage();
+
+    /**
+     * @brief Checks if there is a new "/param" message in the queue.
+     * @return True if a message is available, false otherwise.
+     */
+    bool hasParamMessage();
     
     /**
      * @brief Retrieves the next "/create" message from the queue.
@@ -94,13 +333,80 @@ public:
      * @return The parsed OscFreeMessage. Check is_valid_format before use.
      */
     OscFreeMessage getNextFreeMessage();
+
+    /**
+     * @brief Retrieves the next "/stats" message from the queue.
+     * @return The parsed OscStatsMessage. Check is_valid_format before use.
+     */
+    OscStatsMessage getNextStatsMessage();
+
+    /**
+     * @brief Retrieves the next "/compute" message from the queue.
+     * @return The parsed OscComputeMessage. Check is_valid_format before use.
+     */
+    OscComputeMessage getNextComputeMessage();
+
+    /**
+     * @brief Retrieves the next "/preview" message from the queue.
+     * @return The parsed OscPreviewMessage. Check is_valid_format before use.
+     */
+    OscPreviewMessage getNextPreviewMessage();
+
+    /**
+     * @brief Retrieves the next "/heatmap" message from the queue.
+     * @return The parsed OscHeatmapMessage. Check is_valid_format before use.
+     */
+    OscHeatmapMessage getNextHeatmapMessage();
+
+    /**
+     * @brief Retrieves the next "/bench" message from the queue.
+     * @return The parsed OscBenchMessage. Check is_valid_format before use.
+     */
+    OscBenchMessage getNextBenchMessage();
+
+    /**
+     * @brief Retrieves the next "/texture" message from the queue.
+     * @return The parsed OscTextureMessage. Check is_valid_format before use.
+     */
+    OscTextureMessage getNextTextureMessage();
+
+    /**
+     * @brief Retrieves the next "/output" message from the queue.
+     * @return The parsed OscOutputMessage. Check is_valid_format before use.
+     */
+    OscOutputMessage getNextOutputMessage();
+
+    /**
+     * @brief Retrieves the next "/graph" message from the queue.
+     * @return The parsed OscGraphMessage. Check is_valid_format before use.
+     */
+    OscGraphMessage getNextGraphMessage();
+
+    /**
+     * @brief Retrieves the next "/scene" message from the queue.
+     * @return The parsed OscSceneMessage. Check is_valid_format before use.
+     */
+    OscSceneMessage getNextSceneMessage();
+
+    /**
+     * @brief Retrieves the next "/param" message from the queue.
+     * @return The parsed OscParamMessage. Check is_valid_format before use.
+     */
+    OscParamMessage getNextParamMessage();
+
+    /**
+     * @brief Puts a "/param" message back at the end of the queue, for the next update.
+     * @param message A message taken with getNextParamMessage() that cannot be applied yet.
+     */
+    void deferParamMessage(const OscParamMessage& message);
     
     // --- Response Sending ---
     /**
      * @brief Sends a response to a "/create" message.
      * @param success True if the operation was successful, false otherwise.
      * @param message A descriptive message about the result.
-     * @param shader_id The unique ID of the created shader, if successful.
+     * @param shader_id The unique ID of the created shader, if successful. It is sent as a
+     *                  string followed by the packed ShaderHandle as an int64.
      */
     void sendCreateResponse(bool success, const std::string& message, const std::string& shader_id = "");
 
@@ -117,15 +423,143 @@ public:
      * @param message A descriptive message about the result.
      */
     void sendFreeResponse(bool success, const std::string& message);
+
+    /**
+     * @brief Sends the engine statistics as a response to a "/stats" message.
+     * @param entries Pairs of measurement name and value, sent as alternating string/float arguments.
+     */
+    void sendStatsResponse(const std::vector<std::pair<std::string, double>>& entries);
+
+    /**
+     * @brief Sends a response to a "/compute" message.
+     * @param success True if the operation was successful, false otherwise.
+     * @param message A descriptive message about the result.
+     */
+    void sendComputeResponse(bool success, const std::string& message);
+
+    /**
+     * @brief Sends a response to a "/preview" message.
+     * @details On success the arguments are "success", shader_id, width, height and the
+     *          RGBA8 pixels (bottom row first) as a blob; on error "error" and the message.
+     * @param success True if a preview is attached, false otherwise.
+     * @param message The shader ID on success, a descriptive error message otherwise.
+     * @param pixels The preview image, required on success.
+     */
+    void sendPreviewResponse(bool success, const std::string& message, const ofPixels* pixels = nullptr);
+
+    /**
+     * @brief Sends a response to a "/heatmap" message.
+     * @param success True if the heatmap state was changed, false otherwise.
+     * @param message A descriptive message.
+     */
+    void sendHeatmapResponse(bool success, const std::string& message);
+
+    /**
+     * @brief Sends a response to a "/bench" message.
+     * @details On success the arguments are "success", shader_id, median_ms, p95_ms,
+     *          compile_ms, link_ms (floats), frames, width and height (ints), then
+     *          allocations and allocated bytes per frame (floats, 0 unless built with
+     *          GE_TRACK_ALLOCATIONS); on error "error" and the message.
+     * @param success True if a result is attached, false otherwise.
+     * @param message The shader ID on success, a descriptive error message otherwise.
+     * @param result The benchmark result, required on success.
+     */
+    void sendBenchResponse(bool success, const std::string& message, const ShaderBenchmark::Result* result = nullptr);
+
+    /**
+     * @brief Sends a response to a "/texture" message.
+     * @param success True if the source was added or removed, false otherwise.
+     * @param message A descriptive message.
+     */
+    void sendTextureResponse(bool success, const std::string& message);
+
+    /**
+     * @brief Sends a response to a "/output" message.
+     * @param success True if the output was created, updated or removed, false otherwise.
+     * @param message A descriptive message.
+     */
+    void sendOutputResponse(bool success, const std::string& message);
+
+    /**
+     * @brief Sends a response to a "/graph" message.
+     * @param success True if the graph was applied and all changed outputs recompiled, false otherwise.
+     * @param message A descriptive message.
+     */
+    void sendGraphResponse(bool success, const std::string& message);
+
+    /**
+     * @brief Sends a response to a "/scene" message.
+     * @param success True if the scene was switched, loaded or defined.
+     * @param message A descriptive message.
+     */
+    void sendSceneResponse(bool success, const std::string& message);
+
+    /**
+     * @brief Sends a response to a "/param" message.
+     * @param success True if the parameter was set.
+     * @param message A descriptive message.
+     */
+    void sendParamResponse(bool success, const std::string& message);
     
 private:
     ofxOscReceiver receiver; ///< The object that receives OSC messages.
     ofxOscSender sender;     ///< The object that sends OSC messages.
     
+    // --- Recording and Replay ---
+    /**
+     * @struct ReplayEntry
+     * @brief A logged message and the frame at which it was originally received.
+     */
+    struct ReplayEntry {
+        uint64_t frame_index;       ///< The frame at which the message is delivered.
+        ofxOscMessage message;      ///< The reconstructed OSC message.
+    };
+
+    std::vector<ReplayEntry> replay_entries; ///< Messages of the loaded log, in file order.
+    size_t replay_position;                  ///< Index of the next entry to deliver.
+    bool replay_mode;                        ///< True if messages come from the log.
+    std::ofstream record_stream;             ///< Destination of recorded messages, if open.
+
+    /**
+     * @brief Routes a message to the parser and queue matching its address.
+     * @param osc_message The message to dispatch.
+     */
+    void dispatchMessage(const ofxOscMessage& osc_message);
+
+    /**
+     * @brief Dispatches and records every message waiting at the live receiver.
+     * @param frame_index Frame the messages are recorded under.
+     * @param latching True when called from latch(), see there.
+     */
+    void receiveMessages(uint64_t frame_index, bool latching);
+
+    /**
+     * @brief Appends a message to the recording log.
+     */
+    void recordMessage(uint64_t frame_index, const ofxOscMessage& osc_message);
+
+    /**
+     * @brief Parses one line of a replay log.
+     * @param line The line to parse.
+     * @param entry Receives the parsed entry.
+     * @return True if the line was valid, false otherwise.
+     */
+    bool parseReplayLine(const std::string& line, ReplayEntry& entry);
+
     // --- Message Queues ---
     std::queue<OscCreateMessage> create_message_queue;   ///< Queue for parsed "/create" messages.
     std::queue<OscConnectMessage> connect_message_queue; ///< Queue for parsed "/connect" messages.
     std::queue<OscFreeMessage> free_message_queue;       ///< Queue for parsed "/free" messages.
+    std::queue<OscStatsMessage> stats_message_queue;     ///< Queue for parsed "/stats" messages.
+    std::queue<OscComputeMessage> compute_message_queue; ///< Queue for parsed "/compute" messages.
+    std::queue<OscPreviewMessage> preview_message_queue; ///< Queue for parsed "/preview" messages.
+    std::queue<OscHeatmapMessage> heatmap_message_queue; ///< Queue for parsed "/heatmap" messages.
+    std::queue<OscBenchMessage> bench_message_queue; ///< Queue for parsed "/bench" messages.
+    std::queue<OscTextureMessage> texture_message_queue; ///< Queue for parsed "/texture" messages.
+    std::queue<OscOutputMessage> output_message_queue; ///< Queue for parsed "/output" messages.
+    std::queue<OscGraphMessage> graph_message_queue; ///< Queue for parsed "/graph" messages.
+    std::queue<OscSceneMessage> scene_message_queue; ///< Queue for parsed "/scene" messages.
+    std::queue<OscParamMessage> param_message_queue; ///< Queue for parsed "/param" messages.
     
     // --- Parsing Functions ---
     /**
@@ -148,4 +582,74 @@ private:
      * @return An OscFreeMessage struct with the parsed data.
      */
     OscFreeMessage parseFreeMessage(const ofxOscMessage& osc_message);
+
+    /**
+     * @brief Parses an incoming OSC message with the address "/stats".
+     * @param osc_message The raw OSC message.
+     * @return An OscStatsMessage struct with the parsed data.
+     */
+    OscStatsMessage parseStatsMessage(const ofxOscMessage& osc_message);
+
+    /**
+     * @brief Parses a raw ofxOscMessage into an OscComputeMessage struct.
+     * @param osc_message The raw message received from the network.
+     * @return An OscComputeMessage struct with the parsed data.
+     */
+    OscComputeMessage parseComputeMessage(const ofxOscMessage& osc_message);
+
+    /**
+     * @brief Parses a raw ofxOscMessage into an OscPreviewMessage struct.
+     * @param osc_message The raw message received from the network.
+     * @return An OscPreviewMessage struct with the parsed data.
+     */
+    OscPreviewMessage parsePreviewMessage(const ofxOscMessage& osc_message);
+
+    /**
+     * @brief Parses a raw ofxOscMessage into an OscHeatmapMessage struct.
+     * @param osc_message The raw message received from the network.
+     * @return An OscHeatmapMessage struct with the parsed data.
+     */
+    OscHeatmapMessage parseHeatmapMessage(const ofxOscMessage& osc_message);
+
+    /**
+     * @brief Parses a raw ofxOscMessage into an OscBenchMessage struct.
+     * @param osc_message The raw message received from the network.
+     * @return An OscBenchMessage struct with the parsed data.
+     */
+    OscBenchMessage parseBenchMessage(const ofxOscMessage& osc_message);
+
+    /**
+     * @brief Parses a raw ofxOscMessage into an OscTextureMessage struct.
+     * @param osc_message The raw message received from the network.
+     * @return An OscTextureMessage struct with the parsed data.
+     */
+    OscTextureMessage parseTextureMessage(const ofxOscMessage& osc_message);
+
+    /**
+     * @brief Parses a raw ofxOscMessage into an OscOutputMessage struct.
+     * @param osc_message The raw message received from the network.
+     * @return An OscOutputMessage struct with the parsed data.
+     */
+    OscOutputMessage parseOutputMessage(const ofxOscMessage& osc_message);
+
+    /**
+     * @brief Parses a raw ofxOscMessage into an OscGraphMessage struct.
+     * @param osc_message The raw message received from the network.
+     * @return An OscGraphMessage struct with the parsed data.
+     */
+    OscGraphMessage parseGraphMessage(const ofxOscMessage& osc_message);
+
+    /**
+     * @brief Parses a raw ofxOscMessage into an OscSceneMessage struct.
+     * @param osc_message The raw message received from the network.
+     * @return An OscSceneMessage struct with the parsed data.
+     */
+    OscSceneMessage parseSceneMessage(const ofxOscMessage& osc_message);
+
+    /**
+     * @brief Parses a raw ofxOscMessage into an OscParamMessage struct.
+     * @param osc_message The raw message received from the network.
+     * @return An OscParamMessage struct with the parsed data.
+     */
+    OscParamMessage parseParamMessage(const ofxOscMessage& osc_message);
 };
\ No newline at end of file
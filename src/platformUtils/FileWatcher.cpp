@@ -0,0 +1,224 @@
+#include "FileWatcher.h"
+#include "PlatformUtils.h"
+#include <chrono>
+#include <filesystem>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+#ifdef __linux__
+const uint32_t kWatchMask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_CREATE | IN_DELETE;
+#endif
+
+} // namespace
+
+//--------------------------------------------------------------
+FileWatcher::FileWatcher()
+    : inotify_fd(-1)
+    , wake_fd(-1)
+    , running(false)
+    , debounce_ms(100)
+    , has_changes(false) {
+}
+
+//--------------------------------------------------------------
+FileWatcher::~FileWatcher() {
+    stop();
+}
+
+//--------------------------------------------------------------
+bool FileWatcher::addDirectory(const std::string& path, bool recursive) {
+#ifdef __linux__
+    if (inotify_fd < 0) {
+        inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (inotify_fd < 0 || wake_fd < 0) {
+            ofLogError("FileWatcher") << "Failed to create inotify instance";
+            stop();
+            return false;
+        }
+        running = true;
+        worker = std::thread(&FileWatcher::run, this);
+    }
+
+    if (!addWatch(path, recursive)) {
+        ofLogError("FileWatcher") << "Cannot watch directory: " << path;
+        return false;
+    }
+    ofLogNotice("FileWatcher") << "Watching " << path << (recursive ? " recursively" : "");
+    return true;
+#else
+    ofLogWarning("FileWatcher") << "File watching is not supported on " << PlatformUtils::getPlatformName();
+    return false;
+#endif
+}
+
+//--------------------------------------------------------------
+bool FileWatcher::addWatch(const std::string& path, bool recursive) {
+#ifdef __linux__
+    // Stored without a trailing slash so event paths compare equal to normalized paths
+    std::string directory = std::filesystem::path(path).lexically_normal().string();
+    while (directory.size() > 1 && directory.back() == '/') {
+        directory.pop_back();
+    }
+
+    int descriptor = inotify_add_watch(inotify_fd, directory.c_str(), kWatchMask | IN_ONLYDIR);
+    if (descriptor < 0) {
+        return false;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        watched_directories[descriptor] = directory;
+        if (recursive) {
+            recursive_watches.insert(descriptor);
+        }
+    }
+
+    if (recursive) {
+        std::error_code error;
+        for (const auto& entry : std::filesystem::directory_iterator(directory, error)) {
+            if (entry.is_directory(error)) {
+                addWatch(entry.path().string(), true);
+            }
+        }
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+//--------------------------------------------------------------
+void FileWatcher::setDebounce(int milliseconds) {
+    debounce_ms = std::max(milliseconds, 0);
+}
+
+//--------------------------------------------------------------
+bool FileWatcher::takeChanges(std::vector<std::string>& paths) {
+    paths.clear();
+    if (!has_changes.load(std::memory_order_acquire)) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    paths.assign(published_changes.begin(), published_changes.end());
+    published_changes.clear();
+    has_changes = false;
+    return !paths.empty();
+}
+
+//--------------------------------------------------------------
+void FileWatcher::stop() {
+#ifdef __linux__
+    if (worker.joinable()) {
+        running = false;
+        uint64_t wake = 1;
+        if (write(wake_fd, &wake, sizeof(wake)) < 0) {
+            ofLogWarning("FileWatcher") << "Failed to wake watcher thread";
+        }
+        worker.join();
+    }
+    if (inotify_fd >= 0) {
+        close(inotify_fd);
+        inotify_fd = -1;
+    }
+    if (wake_fd >= 0) {
+        close(wake_fd);
+        wake_fd = -1;
+    }
+#endif
+    std::lock_guard<std::mutex> lock(mutex);
+    watched_directories.clear();
+    recursive_watches.clear();
+}
+
+//--------------------------------------------------------------
+size_t FileWatcher::getWatchCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return watched_directories.size();
+}
+
+//--------------------------------------------------------------
+void FileWatcher::run() {
+#ifdef __linux__
+    using Clock = std::chrono::steady_clock;
+    std::set<std::string> pending;
+    Clock::time_point last_event;
+    alignas(struct inotify_event) char buffer[16384];
+
+    while (running) {
+        // Block indefinitely while idle; while changes are pending, wake up when the
+        // debounce interval after the last event has passed.
+        int timeout = -1;
+        if (!pending.empty()) {
+            auto quiet = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - last_event).count();
+            timeout = std::max(0, debounce_ms.load() - static_cast<int>(quiet));
+        }
+
+        pollfd descriptors[2] = {{inotify_fd, POLLIN, 0}, {wake_fd, POLLIN, 0}};
+        int ready = poll(descriptors, 2, timeout);
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            ofLogError("FileWatcher") << "poll failed, stopping watcher";
+            break;
+        }
+        if (descriptors[1].revents & POLLIN) {
+            break;
+        }
+
+        if (ready == 0) {
+            std::lock_guard<std::mutex> lock(mutex);
+            published_changes.insert(pending.begin(), pending.end());
+            has_changes.store(true, std::memory_order_release);
+            pending.clear();
+            continue;
+        }
+
+        ssize_t length;
+        while ((length = read(inotify_fd, buffer, sizeof(buffer))) > 0) {
+            for (char* cursor = buffer; cursor < buffer + length;) {
+                const inotify_event* event = reinterpret_cast<const inotify_event*>(cursor);
+                cursor += sizeof(inotify_event) + event->len;
+
+                std::string directory;
+                bool recursive = false;
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    auto it = watched_directories.find(event->wd);
+                    if (it == watched_directories.end()) {
+                        continue;
+                    }
+                    if (event->mask & IN_IGNORED) {
+                        watched_directories.erase(it);
+                        recursive_watches.erase(event->wd);
+                        continue;
+                    }
+                    directory = it->second;
+                    recursive = recursive_watches.count(event->wd) > 0;
+                }
+                if (event->len == 0) {
+                    continue;
+                }
+
+                std::string path = directory + "/" + event->name;
+                if (event->mask & IN_ISDIR) {
+                    if (recursive && (event->mask & (IN_CREATE | IN_MOVED_TO))) {
+                        addWatch(path, true);
+                    }
+                    continue;
+                }
+                pending.insert(path);
+                last_event = Clock::now();
+            }
+        }
+    }
+#endif
+}
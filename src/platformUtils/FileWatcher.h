@@ -0,0 +1,81 @@
+#pragma once
+#include "ofMain.h"
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @class FileWatcher
+ * @brief Event-driven watcher for source and config directories.
+ * @details On Linux a background thread blocks on inotify and collects the paths of
+ *          written, created, moved and deleted files. Events are coalesced per path and
+ *          only published once no new event arrived for the debounce interval, so an
+ *          editor's save sequence (write, rename, chmod) becomes a single change.
+ *
+ *          takeChanges() only reads an atomic flag while nothing changed, so polling it
+ *          every frame costs no system calls. Other platforms report watching as unsupported.
+ */
+class FileWatcher {
+public:
+    FileWatcher();
+    ~FileWatcher();
+
+    /**
+     * @brief Watches a directory, starting the watcher thread on first use.
+     * @param path The directory to watch.
+     * @param recursive If true, existing and newly created subdirectories are watched too.
+     * @return True if the directory is watched.
+     */
+    bool addDirectory(const std::string& path, bool recursive = true);
+
+    /**
+     * @brief Sets the quiet time after the last event before changes are published.
+     * @param milliseconds The debounce interval, default 100.
+     */
+    void setDebounce(int milliseconds);
+
+    /**
+     * @brief Takes the changes published since the last call.
+     * @param paths Receives the changed file paths, each once.
+     * @return True if there were changes.
+     */
+    bool takeChanges(std::vector<std::string>& paths);
+
+    /**
+     * @brief Stops the watcher thread and removes all watches.
+     */
+    void stop();
+
+    /**
+     * @brief Gets the number of watched directories.
+     */
+    size_t getWatchCount() const;
+
+private:
+    /**
+     * @brief Watcher thread body.
+     */
+    void run();
+
+    /**
+     * @brief Adds a watch for one directory and, if requested, its subdirectories.
+     * @return False if the directory itself could not be watched.
+     */
+    bool addWatch(const std::string& path, bool recursive);
+
+    int inotify_fd;                                 ///< inotify instance, -1 when not started.
+    int wake_fd;                                    ///< eventfd used to wake the thread for shutdown.
+    std::thread worker;                             ///< The watcher thread.
+    std::atomic<bool> running;                      ///< Cleared to stop the thread.
+    std::atomic<int> debounce_ms;                   ///< Quiet time before changes are published.
+
+    mutable std::mutex mutex;                       ///< Guards the watch table and published changes.
+    std::map<int, std::string> watched_directories; ///< Directory of each watch descriptor.
+    std::set<int> recursive_watches;                ///< Watches whose new subdirectories are watched too.
+    std::set<std::string> published_changes;        ///< Changes waiting for takeChanges().
+    std::atomic<bool> has_changes;                  ///< True while published_changes is not empty.
+};
@@ -1,5 +1,6 @@
 #include "PluginManager.h"
 #include "ofMain.h"
+#include "../statsSystem/AllocationTracker.h"
 #include <iostream>
 #include <algorithm>
 #include <string>
@@ -107,6 +108,7 @@ bool PluginManager::isPluginLoaded(const std::string& alias) const {
 }
 
 const GLSLFunction* PluginManager::findFunction(const std::string& function_name) {
+    AllocationScope allocation_scope(AllocationTag::PLUGIN_LOOKUP);
     // Search across all loaded plugins.
     for (const auto& [alias, plugin] : loaded_plugins) {
         if (const GLSLFunction* func = plugin->interface->findFunction(function_name)) {
@@ -117,6 +119,7 @@ const GLSLFunction* PluginManager::findFunction(const std::string& function_name
 }
 
 const GLSLFunction* PluginManager::findFunction(const std::string& plugin_name, const std::string& function_name) {
+    AllocationScope allocation_scope(AllocationTag::PLUGIN_LOOKUP);
     auto it = loaded_plugins.find(plugin_name);
     if (it != loaded_plugins.end()) {
         return it->second->interface->findFunction(function_name);
@@ -144,6 +147,7 @@ std::vector<std::string> PluginManager::getAllFunctions() const {
 }
 
 std::map<std::string, std::vector<std::string>> PluginManager::getFunctionsByPlugin() const {
+    AllocationScope allocation_scope(AllocationTag::PLUGIN_LOOKUP);
     std::map<std::string, std::vector<std::string>> result;
     for (const auto& [alias, plugin] : loaded_plugins) {
         result[alias] = plugin->interface->getAllFunctionNames();
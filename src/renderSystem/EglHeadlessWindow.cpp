@@ -0,0 +1,235 @@
+#include "EglHeadlessWindow.h"
+
+#ifdef GE_HAVE_EGL
+#include <EGL/eglext.h>
+
+namespace {
+
+/// Initializes a display, EGL_NO_DISPLAY if it is unavailable.
+EGLDisplay initializeDisplay(EGLDisplay display) {
+    if (display == EGL_NO_DISPLAY || !eglInitialize(display, nullptr, nullptr)) {
+        return EGL_NO_DISPLAY;
+    }
+    return display;
+}
+
+/// Finds a display that does not need a display server.
+EGLDisplay getHeadlessDisplay() {
+    auto get_platform_display = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+    auto query_devices = reinterpret_cast<PFNEGLQUERYDEVICESEXTPROC>(eglGetProcAddress("eglQueryDevicesEXT"));
+
+    if (get_platform_display && query_devices) {
+        // Mesa lists its software rasterizer as a device too, so this also covers GPU-less machines
+        EGLDeviceEXT devices[8];
+        EGLint device_count = 0;
+        if (query_devices(8, devices, &device_count)) {
+            for (EGLint i = 0; i < device_count; ++i) {
+                EGLDisplay display = initializeDisplay(get_platform_display(EGL_PLATFORM_DEVICE_EXT, devices[i], nullptr));
+                if (display != EGL_NO_DISPLAY) {
+                    return display;
+                }
+            }
+        }
+    }
+    if (get_platform_display) {
+        EGLDisplay display = initializeDisplay(get_platform_display(EGL_PLATFORM_SURFACELESS_MESA, nullptr, nullptr));
+        if (display != EGL_NO_DISPLAY) {
+            return display;
+        }
+    }
+    return initializeDisplay(eglGetDisplay(EGL_DEFAULT_DISPLAY));
+}
+
+} // namespace
+
+//--------------------------------------------------------------
+EglHeadlessWindow::EglHeadlessWindow()
+    : display(EGL_NO_DISPLAY)
+    , surface(EGL_NO_SURFACE)
+    , context(EGL_NO_CONTEXT)
+    , width(0)
+    , height(0) {
+}
+
+//--------------------------------------------------------------
+EglHeadlessWindow::~EglHeadlessWindow() {
+    destroyContext();
+}
+
+//--------------------------------------------------------------
+bool EglHeadlessWindow::createContext(int major, int minor, int surface_width, int surface_height) {
+    display = getHeadlessDisplay();
+    if (display == EGL_NO_DISPLAY) {
+        ofLogError("EglHeadlessWindow") << "No EGL display available";
+        return false;
+    }
+    if (!eglBindAPI(EGL_OPENGL_API)) {
+        ofLogError("EglHeadlessWindow") << "EGL display does not support desktop OpenGL";
+        destroyContext();
+        return false;
+    }
+
+    // Prefer a config with pbuffers; any config will do for a surfaceless context
+    EGLConfig config = nullptr;
+    EGLint config_count = 0;
+    for (EGLint surface_type : {EGL_PBUFFER_BIT, 0}) {
+        const EGLint config_attributes[] = {
+            EGL_SURFACE_TYPE, surface_type,
+            EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+            EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8, EGL_ALPHA_SIZE, 8,
+            EGL_DEPTH_SIZE, 24,
+            EGL_NONE
+        };
+        if (eglChooseConfig(display, config_attributes, &config, 1, &config_count) && config_count > 0) {
+            break;
+        }
+    }
+    if (config_count == 0) {
+        ofLogError("EglHeadlessWindow") << "No EGL config with RGBA8 and a 24-bit depth buffer";
+        destroyContext();
+        return false;
+    }
+
+    const EGLint context_attributes[] = {
+        EGL_CONTEXT_MAJOR_VERSION, major,
+        EGL_CONTEXT_MINOR_VERSION, minor,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE
+    };
+    context = eglCreateContext(display, config, EGL_NO_CONTEXT, context_attributes);
+    if (context == EGL_NO_CONTEXT) {
+        ofLogError("EglHeadlessWindow") << "Cannot create an OpenGL " << major << "." << minor << " core context";
+        destroyContext();
+        return false;
+    }
+
+    const EGLint surface_attributes[] = {
+        EGL_WIDTH, surface_width,
+        EGL_HEIGHT, surface_height,
+        EGL_NONE
+    };
+    surface = eglCreatePbufferSurface(display, config, surface_attributes);
+    if (!eglMakeCurrent(display, surface, surface, context)) {
+        ofLogError("EglHeadlessWindow") << "Cannot make the EGL context current";
+        destroyContext();
+        return false;
+    }
+
+    width = surface_width;
+    height = surface_height;
+    ofLogNotice("EglHeadlessWindow") << "EGL " << eglQueryString(display, EGL_VERSION) << " ("
+                                     << eglQueryString(display, EGL_VENDOR) << "), "
+                                     << (surface != EGL_NO_SURFACE ? "pbuffer" : "surfaceless") << " context";
+    return true;
+}
+
+//--------------------------------------------------------------
+void EglHeadlessWindow::setup(const ofGLWindowSettings& settings) {
+    glewExperimental = GL_TRUE;
+    GLenum error = glewInit();
+#ifdef GLEW_ERROR_NO_GLX_DISPLAY
+    // GLEW built for GLX reports the missing X display after it loaded the GL functions
+    if (error == GLEW_ERROR_NO_GLX_DISPLAY) {
+        error = GLEW_OK;
+    }
+#endif
+    if (error != GLEW_OK) {
+        ofLogError("EglHeadlessWindow") << "Cannot load GL functions: " << glewGetErrorString(error);
+    }
+
+    current_renderer = std::make_shared<ofGLProgrammableRenderer>(this);
+    static_cast<ofGLProgrammableRenderer*>(current_renderer.get())->setup(settings.glVersionMajor, settings.glVersionMinor);
+    core_events.enable();
+}
+
+//--------------------------------------------------------------
+void EglHeadlessWindow::update() {
+    core_events.notifyUpdate();
+}
+
+//--------------------------------------------------------------
+void EglHeadlessWindow::draw() {
+    current_renderer->startRender();
+    current_renderer->setupScreen();
+    core_events.notifyDraw();
+    current_renderer->finishRender();
+    swapBuffers();
+}
+
+//--------------------------------------------------------------
+void EglHeadlessWindow::close() {
+    core_events.disable();
+    current_renderer.reset();
+    destroyContext();
+}
+
+//--------------------------------------------------------------
+void EglHeadlessWindow::makeCurrent() {
+    eglMakeCurrent(display, surface, surface, context);
+}
+
+//--------------------------------------------------------------
+void EglHeadlessWindow::swapBuffers() {
+    if (surface != EGL_NO_SURFACE) {
+        eglSwapBuffers(display, surface);
+    }
+}
+
+//--------------------------------------------------------------
+glm::vec2 EglHeadlessWindow::getWindowPosition() {
+    return glm::vec2(0, 0);
+}
+
+//--------------------------------------------------------------
+glm::vec2 EglHeadlessWindow::getWindowSize() {
+    return glm::vec2(width, height);
+}
+
+//--------------------------------------------------------------
+glm::vec2 EglHeadlessWindow::getScreenSize() {
+    return glm::vec2(width, height);
+}
+
+//--------------------------------------------------------------
+int EglHeadlessWindow::getWidth() {
+    return width;
+}
+
+//--------------------------------------------------------------
+int EglHeadlessWindow::getHeight() {
+    return height;
+}
+
+//--------------------------------------------------------------
+ofWindowMode EglHeadlessWindow::getWindowMode() {
+    return OF_WINDOW;
+}
+
+//--------------------------------------------------------------
+ofCoreEvents& EglHeadlessWindow::events() {
+    return core_events;
+}
+
+//--------------------------------------------------------------
+std::shared_ptr<ofBaseRenderer>& EglHeadlessWindow::renderer() {
+    return current_renderer;
+}
+
+//--------------------------------------------------------------
+void EglHeadlessWindow::destroyContext() {
+    if (display == EGL_NO_DISPLAY) {
+        return;
+    }
+    eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    if (context != EGL_NO_CONTEXT) {
+        eglDestroyContext(display, context);
+        context = EGL_NO_CONTEXT;
+    }
+    if (surface != EGL_NO_SURFACE) {
+        eglDestroySurface(display, surface);
+        surface = EGL_NO_SURFACE;
+    }
+    eglTerminate(display);
+    display = EGL_NO_DISPLAY;
+}
+#endif
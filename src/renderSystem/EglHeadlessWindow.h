@@ -0,0 +1,72 @@
+#pragma once
+#include "ofMain.h"
+
+#ifdef GE_HAVE_EGL
+#include <EGL/egl.h>
+#include <memory>
+
+/**
+ * @class EglHeadlessWindow
+ * @brief A window without a display server for --headless: EGL provides the GL context.
+ * @details The display is taken from the EGL device platform (a GPU, or Mesa's software
+ *          device), then Mesa's surfaceless platform, then the default display, so the
+ *          engine runs on CI machines without X, Wayland or a GPU. Frames are rendered into
+ *          offscreen framebuffers; the context only gets a small pbuffer surface, or none
+ *          where the driver supports surfaceless contexts.
+ *
+ *          Create the context with createContext(), then register the window with the main
+ *          loop and call setup(), in the same order ofCreateWindow() uses for GLFW windows.
+ */
+class EglHeadlessWindow : public ofAppBaseGLWindow {
+public:
+    EglHeadlessWindow();
+    ~EglHeadlessWindow();
+
+    /**
+     * @brief Creates the EGL display, context and surface and makes the context current.
+     * @param major The requested GL major version.
+     * @param minor The requested GL minor version.
+     * @param width The surface width in pixels.
+     * @param height The surface height in pixels.
+     * @return False if no display or no core profile context of that version is available.
+     */
+    bool createContext(int major, int minor, int width, int height);
+
+    using ofAppBaseGLWindow::setup;
+    /**
+     * @brief Loads the GL entry points and sets up the programmable renderer.
+     * @details Requires a successful createContext().
+     */
+    void setup(const ofGLWindowSettings& settings) override;
+
+    void update() override;
+    void draw() override;
+    void close() override;
+    void makeCurrent() override;
+    void swapBuffers() override;
+
+    glm::vec2 getWindowPosition() override;
+    glm::vec2 getWindowSize() override;
+    glm::vec2 getScreenSize() override;
+    int getWidth() override;
+    int getHeight() override;
+    ofWindowMode getWindowMode() override;
+
+    ofCoreEvents& events() override;
+    std::shared_ptr<ofBaseRenderer>& renderer() override;
+
+private:
+    /**
+     * @brief Releases the context, surface and display.
+     */
+    void destroyContext();
+
+    EGLDisplay display;                             ///< The initialized display, EGL_NO_DISPLAY if none.
+    EGLSurface surface;                             ///< Pbuffer surface, EGL_NO_SURFACE if surfaceless.
+    EGLContext context;                             ///< The GL context.
+    int width;                                      ///< Surface width in pixels.
+    int height;                                     ///< Surface height in pixels.
+    ofCoreEvents core_events;                       ///< Setup, update, draw and exit events of the app.
+    std::shared_ptr<ofBaseRenderer> current_renderer; ///< The programmable GL renderer.
+};
+#endif
@@ -0,0 +1,76 @@
+#include "FrameClock.h"
+
+//--------------------------------------------------------------
+FrameClock::FrameClock()
+    : fixed_step(false)
+    , frames_per_second(60.0)
+    , frame_index(0)
+    , latched(false)
+    , latch_wall_time(0.0f)
+    , latched_time(0.0f)
+    , draw_lead(0.0f) {
+}
+
+//--------------------------------------------------------------
+void FrameClock::setRealtime() {
+    fixed_step = false;
+    latched = false;
+}
+
+//--------------------------------------------------------------
+void FrameClock::setFixedStep(double fps) {
+    if (fps <= 0.0) {
+        ofLogError("FrameClock") << "Invalid fixed-step frame rate: " << fps;
+        return;
+    }
+    fixed_step = true;
+    latched = false;
+    frames_per_second = fps;
+    frame_index = 0;
+    ofLogNotice("FrameClock") << "Fixed-step clock at " << fps << " fps";
+}
+
+//--------------------------------------------------------------
+bool FrameClock::isFixedStep() const {
+    return fixed_step;
+}
+
+//--------------------------------------------------------------
+float FrameClock::getTime() const {
+    if (!fixed_step) {
+        return latched ? latched_time : ofGetElapsedTimef();
+    }
+    // Computed from the integer frame index, so no error accumulates over long renders.
+    return static_cast<float>(static_cast<double>(frame_index) / frames_per_second);
+}
+
+//--------------------------------------------------------------
+uint64_t FrameClock::getFrameIndex() const {
+    return frame_index;
+}
+
+//--------------------------------------------------------------
+void FrameClock::latch() {
+    if (fixed_step) {
+        return;
+    }
+    latch_wall_time = ofGetElapsedTimef();
+    latched_time = latch_wall_time + getPresentationLead();
+    latched = true;
+}
+
+//--------------------------------------------------------------
+float FrameClock::getPresentationLead() const {
+    // The swap after the frame waits for the next refresh, on average half an interval
+    return draw_lead + static_cast<float>(ofGetLastFrameTime()) * 0.5f;
+}
+
+//--------------------------------------------------------------
+void FrameClock::advance() {
+    if (latched) {
+        float sample = ofGetElapsedTimef() - latch_wall_time;
+        draw_lead += (sample - draw_lead) * 0.1f;
+        latched = false;
+    }
+    frame_index++;
+}
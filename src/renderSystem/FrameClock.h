@@ -0,0 +1,73 @@
+#pragma once
+#include "ofMain.h"
+#include <cstdint>
+
+/**
+ * @class FrameClock
+ * @brief The single source of the 'time' value fed to shaders.
+ * @details In real-time mode the clock follows ofGetElapsedTimef(), as the engine always
+ *          did. In fixed-step mode the time of frame N is exactly N / fps, independent of
+ *          how long rendering actually takes, so offline renders and replayed sessions
+ *          produce identical frames on every run.
+ *
+ *          In real-time mode latch() fixes the time of a frame right before it is drawn,
+ *          predicted for the moment the frame reaches the screen, so every pass of the
+ *          frame sees the same value.
+ */
+class FrameClock {
+public:
+    FrameClock();
+
+    /**
+     * @brief Switches to real-time mode, where time follows the wall clock.
+     */
+    void setRealtime();
+
+    /**
+     * @brief Switches to fixed-step mode and restarts at frame 0.
+     * @param frames_per_second The number of frames per simulated second. Must be positive.
+     */
+    void setFixedStep(double frames_per_second);
+
+    /**
+     * @brief Checks whether the clock is in fixed-step mode.
+     */
+    bool isFixedStep() const;
+
+    /**
+     * @brief Gets the time of the current frame in seconds.
+     * @details Between latch() and advance() this is the latched presentation time.
+     */
+    float getTime() const;
+
+    /**
+     * @brief Fixes the time of the current frame to its predicted presentation time.
+     * @details The prediction adds the measured time from latch to the end of the frame and
+     *          half a frame interval for the swap wait. No effect in fixed-step mode.
+     */
+    void latch();
+
+    /**
+     * @brief Gets the current estimate of the time from latch() to presentation in seconds.
+     */
+    float getPresentationLead() const;
+
+    /**
+     * @brief Gets the index of the current frame, starting at 0.
+     */
+    uint64_t getFrameIndex() const;
+
+    /**
+     * @brief Moves on to the next frame. Call once after a frame has been rendered.
+     */
+    void advance();
+
+private:
+    bool fixed_step;               ///< True for deterministic N / fps timing.
+    double frames_per_second;      ///< Simulated frame rate in fixed-step mode.
+    uint64_t frame_index;          ///< Index of the frame currently being produced.
+    bool latched;                  ///< True between latch() and advance() in real-time mode.
+    float latch_wall_time;         ///< Wall clock at the last latch().
+    float latched_time;            ///< Predicted presentation time of the latched frame.
+    float draw_lead;               ///< Smoothed time from latch() to advance().
+};
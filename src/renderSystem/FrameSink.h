@@ -0,0 +1,23 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @class FrameSink
+ * @brief Receives completed frames from the output tap.
+ * @details Frames are tightly packed RGBA8 rows, bottom row first as read back from GL.
+ *          The pixel pointer is only valid for the duration of the call.
+ */
+class FrameSink {
+public:
+    virtual ~FrameSink() = default;
+
+    /**
+     * @brief Consumes one frame.
+     * @param pixels The frame data, width * height * 4 bytes.
+     * @param width The frame width in pixels.
+     * @param height The frame height in pixels.
+     * @param frame_index The engine frame at which the frame was rendered.
+     */
+    virtual void consumeFrame(const uint8_t* pixels, int width, int height, uint64_t frame_index) = 0;
+};
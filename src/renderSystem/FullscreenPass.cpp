@@ -0,0 +1,134 @@
+#include "FullscreenPass.h"
+
+//--------------------------------------------------------------
+FullscreenPass::FullscreenPass()
+    : empty_vertex_array(0)
+    , host_program(0)
+    , frame_open(false)
+    , texture_sources(nullptr) {
+}
+
+//--------------------------------------------------------------
+FullscreenPass::~FullscreenPass() {
+    if (empty_vertex_array != 0) {
+        glDeleteVertexArrays(1, &empty_vertex_array);
+        empty_vertex_array = 0;
+    }
+}
+
+//--------------------------------------------------------------
+bool FullscreenPass::setup() {
+    if (empty_vertex_array != 0) {
+        return true;
+    }
+
+    glGenVertexArrays(1, &empty_vertex_array);
+    if (empty_vertex_array == 0) {
+        ofLogError("FullscreenPass") << "Failed to create vertex array object";
+        return false;
+    }
+
+    ofLogNotice("FullscreenPass") << "Fullscreen pass initialized (VAO " << empty_vertex_array << ")";
+    return true;
+}
+
+//--------------------------------------------------------------
+bool FullscreenPass::isSetup() const {
+    return empty_vertex_array != 0;
+}
+
+//--------------------------------------------------------------
+void FullscreenPass::beginFrame() {
+    state_cache.invalidate();
+    state_cache.resetCounters();
+
+    glGetIntegerv(GL_CURRENT_PROGRAM, &host_program);
+    state_cache.assumeProgram(static_cast<GLuint>(host_program));
+    frame_open = true;
+}
+
+//--------------------------------------------------------------
+bool FullscreenPass::draw(ShaderNode& shader_node, float width, float height, float time,
+                          float tile_offset_x, float tile_offset_y) {
+    if (!shader_node.isReady()) {
+        return false;
+    }
+    return drawNode(shader_node, *shader_node.program, nullptr, width, height, time, tile_offset_x, tile_offset_y);
+}
+
+//--------------------------------------------------------------
+bool FullscreenPass::draw(const RenderProgram& program, float width, float height, float time,
+                          float tile_offset_x, float tile_offset_y) {
+    if (!program.shader || !program.linked) {
+        return false;
+    }
+    return drawNode(*program.shader, *program.linked, &program.parameters, width, height, time,
+                    tile_offset_x, tile_offset_y);
+}
+
+//--------------------------------------------------------------
+bool FullscreenPass::drawNode(ShaderNode& shader_node, const LinkedProgram& linked, const std::vector<float>* parameters,
+                              float width, float height, float time, float tile_offset_x, float tile_offset_y) {
+    if (!isSetup()) {
+        return false;
+    }
+
+    if (!frame_open) {
+        ofLogWarning("FullscreenPass") << "draw() called outside beginFrame()/endFrame()";
+    }
+
+    // Evaluate compute fields first; they only re-run when the output size or time changes.
+    for (const auto& field : shader_node.compute_fields) {
+        if (field->needsUpdate(width, height, time)) {
+            state_cache.useProgram(field->getProgramId());
+            field->dispatch(width, height, time);
+            // A resized field recreates its texture outside the cache.
+            state_cache.invalidate();
+        }
+    }
+
+    state_cache.useProgram(linked.id);
+    shader_node.updateAutoUniforms(linked, width, height, time, tile_offset_x, tile_offset_y);
+
+    for (size_t i = 0; i < shader_node.compute_fields.size(); ++i) {
+        state_cache.bindTexture(static_cast<GLuint>(1 + i), GL_TEXTURE_2D, shader_node.compute_fields[i]->getTexture());
+    }
+    for (size_t i = 0; i < shader_node.texture_inputs.size(); ++i) {
+        GLuint texture = texture_sources ? texture_sources->getTexture(shader_node.texture_inputs[i]) : 0;
+        state_cache.bindTexture(shader_node.getTextureInputUnit(i), GL_TEXTURE_2D, texture);
+    }
+    if (shader_node.parameter_block) {
+        if (parameters) {
+            shader_node.parameter_block->bind(*parameters);
+        } else {
+            shader_node.parameter_block->bind();
+        }
+    }
+
+    state_cache.bindVertexArray(empty_vertex_array);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+    return true;
+}
+
+//--------------------------------------------------------------
+void FullscreenPass::endFrame() {
+    if (!frame_open) {
+        return;
+    }
+
+    // openFrameworks assumes its own program, no VAO and texture unit 0 between its draws.
+    state_cache.bindVertexArray(0);
+    glActiveTexture(GL_TEXTURE0);
+    state_cache.useProgram(static_cast<GLuint>(host_program));
+    frame_open = false;
+}
+
+//--------------------------------------------------------------
+GLStateCache& FullscreenPass::getStateCache() {
+    return state_cache;
+}
+
+//--------------------------------------------------------------
+void FullscreenPass::setTextureSources(const TextureSourceBank* bank) {
+    texture_sources = bank;
+}
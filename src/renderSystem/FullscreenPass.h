@@ -0,0 +1,96 @@
+#pragma once
+#include "ofMain.h"
+#include "GLStateCache.h"
+#include "TextureSourceBank.h"
+#include "RenderSnapshot.h"
+#include "../shaderSystem/ShaderNode.h"
+
+/**
+ * @class FullscreenPass
+ * @brief Draws a shader over the whole render target with a single attribute-less triangle.
+ * @details The pass owns one persistent, empty vertex array object. The generated
+ *          vertex stage derives the triangle corners from gl_VertexID, so no vertex
+ *          buffers, matrices or texture coordinates need to be uploaded. Drawing a
+ *          ready ShaderNode costs one program bind, its auto uniforms and one
+ *          glDrawArrays call, with redundant binds filtered by a GLStateCache.
+ *
+ *          openFrameworks keeps its own notion of the bound program, so every frame
+ *          that uses the pass is bracketed by beginFrame()/endFrame(), which restore
+ *          the host program afterwards.
+ */
+class FullscreenPass {
+public:
+    FullscreenPass();
+    ~FullscreenPass();
+
+    /**
+     * @brief Creates the persistent GL objects. Requires a current GL context.
+     * @return True on success, false otherwise.
+     */
+    bool setup();
+
+    /**
+     * @brief Checks whether setup() has completed successfully.
+     */
+    bool isSetup() const;
+
+    /**
+     * @brief Starts a frame of fullscreen drawing.
+     * @details Invalidates the state cache (foreign code may have changed bindings since
+     *          the last frame) and remembers the host program so it can be restored.
+     */
+    void beginFrame();
+
+    /**
+     * @brief Draws a compiled shader node over the current viewport.
+     * @param shader_node The shader to draw. Nothing is drawn if it is not ready.
+     * @param width The width of the render target in pixels, used for 'resolution'.
+     * @param height The height of the render target in pixels, used for 'resolution'.
+     * @param time The shader time in seconds, used for 'time'.
+     * @param tile_offset_x Horizontal offset of the viewport within a tiled output, used for 'st'.
+     * @param tile_offset_y Vertical offset of the viewport within a tiled output, used for 'st'.
+     * @return True if a draw call was issued.
+     */
+    bool draw(ShaderNode& shader_node, float width, float height, float time,
+              float tile_offset_x = 0.0f, float tile_offset_y = 0.0f);
+
+    /**
+     * @brief Draws a program of a render snapshot.
+     * @details Binds the program and parameter values captured in the snapshot instead of the
+     *          live ones. Nothing is drawn if the snapshot holds no linked program.
+     * @return True if a draw call was issued.
+     */
+    bool draw(const RenderProgram& program, float width, float height, float time,
+              float tile_offset_x = 0.0f, float tile_offset_y = 0.0f);
+
+    /**
+     * @brief Ends a frame of fullscreen drawing and hands GL state back to openFrameworks.
+     */
+    void endFrame();
+
+    /**
+     * @brief Gets the state cache shared by all draws of this pass.
+     */
+    GLStateCache& getStateCache();
+
+    /**
+     * @brief Sets the texture sources bound for the texture inputs of drawn shaders.
+     * @param bank The sources, or nullptr to bind nothing. Must outlive the pass.
+     */
+    void setTextureSources(const TextureSourceBank* bank);
+
+private:
+    /**
+     * @brief Shared implementation of draw().
+     * @param linked The program to draw, the node's current one or one captured from it.
+     * @param parameters Parameter block contents to bind, or nullptr for the live values.
+     */
+    bool drawNode(ShaderNode& shader_node, const LinkedProgram& linked, const std::vector<float>* parameters,
+                  float width, float height, float time, float tile_offset_x, float tile_offset_y);
+
+    GLuint empty_vertex_array;  ///< Attribute-less VAO required by core profiles for glDrawArrays.
+    GLStateCache state_cache;   ///< Filters redundant binds within a frame.
+    GLint host_program;         ///< Program bound by openFrameworks when the frame began.
+    bool frame_open;            ///< True between beginFrame() and endFrame().
+    const TextureSourceBank* texture_sources; ///< Supplies the textures of texture inputs, may be null.
+};
@@ -0,0 +1,113 @@
+#include "GLStateCache.h"
+
+//--------------------------------------------------------------
+GLStateCache::GLStateCache()
+    : issued_calls(0)
+    , skipped_calls(0) {
+    invalidate();
+}
+
+//--------------------------------------------------------------
+void GLStateCache::invalidate() {
+    current_program = UNKNOWN_BINDING;
+    current_framebuffer = UNKNOWN_BINDING;
+    current_vertex_array = UNKNOWN_BINDING;
+    active_texture_unit = UNKNOWN_BINDING;
+    bound_textures.fill(UNKNOWN_BINDING);
+    current_viewport.fill(0);
+    viewport_known = false;
+}
+
+//--------------------------------------------------------------
+void GLStateCache::assumeProgram(GLuint program) {
+    current_program = program;
+}
+
+//--------------------------------------------------------------
+void GLStateCache::useProgram(GLuint program) {
+    if (current_program == program) {
+        skipped_calls++;
+        return;
+    }
+    glUseProgram(program);
+    current_program = program;
+    issued_calls++;
+}
+
+//--------------------------------------------------------------
+void GLStateCache::bindTexture(GLuint unit, GLenum target, GLuint texture) {
+    if (unit >= MAX_TEXTURE_UNITS) {
+        // Untracked unit: always issue the bind and forget the active unit.
+        glActiveTexture(GL_TEXTURE0 + unit);
+        glBindTexture(target, texture);
+        active_texture_unit = UNKNOWN_BINDING;
+        issued_calls += 2;
+        return;
+    }
+
+    if (bound_textures[unit] == texture) {
+        skipped_calls++;
+        return;
+    }
+
+    if (active_texture_unit != unit) {
+        glActiveTexture(GL_TEXTURE0 + unit);
+        active_texture_unit = unit;
+        issued_calls++;
+    }
+    glBindTexture(target, texture);
+    bound_textures[unit] = texture;
+    issued_calls++;
+}
+
+//--------------------------------------------------------------
+void GLStateCache::bindFramebuffer(GLuint framebuffer) {
+    if (current_framebuffer == framebuffer) {
+        skipped_calls++;
+        return;
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    current_framebuffer = framebuffer;
+    issued_calls++;
+}
+
+//--------------------------------------------------------------
+void GLStateCache::bindVertexArray(GLuint vertex_array) {
+    if (current_vertex_array == vertex_array) {
+        skipped_calls++;
+        return;
+    }
+    glBindVertexArray(vertex_array);
+    current_vertex_array = vertex_array;
+    issued_calls++;
+}
+
+//--------------------------------------------------------------
+void GLStateCache::setViewport(GLint x, GLint y, GLsizei width, GLsizei height) {
+    if (viewport_known &&
+        current_viewport[0] == x && current_viewport[1] == y &&
+        current_viewport[2] == width && current_viewport[3] == height) {
+        skipped_calls++;
+        return;
+    }
+    glViewport(x, y, width, height);
+    current_viewport = {x, y, width, height};
+    viewport_known = true;
+    issued_calls++;
+}
+
+//--------------------------------------------------------------
+size_t GLStateCache::getIssuedCallCount() const {
+    return issued_calls;
+}
+
+//--------------------------------------------------------------
+size_t GLStateCache::getSkippedCallCount() const {
+    return skipped_calls;
+}
+
+//--------------------------------------------------------------
+void GLStateCache::resetCounters() {
+    issued_calls = 0;
+    skipped_calls = 0;
+}
@@ -0,0 +1,94 @@
+#pragma once
+#include "ofMain.h"
+#include <array>
+
+/**
+ * @class GLStateCache
+ * @brief A tiny shadow of the OpenGL binding state used by the engine's render passes.
+ * @details Every bind request is compared against the last value this cache issued,
+ *          and redundant calls to glUseProgram, glBindTexture, glBindFramebuffer and
+ *          glBindVertexArray are skipped. The cache cannot see GL calls made by other
+ *          code (openFrameworks, addons), so it must be invalidated whenever control
+ *          returns from foreign rendering code, typically once at the start of a frame.
+ */
+class GLStateCache {
+public:
+    /// The number of texture units tracked by the cache.
+    static constexpr size_t MAX_TEXTURE_UNITS = 16;
+
+    GLStateCache();
+
+    /**
+     * @brief Forgets all tracked bindings so the next bind of each kind is always issued.
+     */
+    void invalidate();
+
+    /**
+     * @brief Marks a program as currently bound without issuing a GL call.
+     * @details Used when the caller already knows the bound program (e.g. after querying it).
+     * @param program The program object that is currently bound.
+     */
+    void assumeProgram(GLuint program);
+
+    /**
+     * @brief Binds a shader program if it is not already bound.
+     * @param program The program object to bind, or 0 to unbind.
+     */
+    void useProgram(GLuint program);
+
+    /**
+     * @brief Binds a texture to a texture unit if it is not already bound there.
+     * @param unit The zero-based texture unit index.
+     * @param target The texture target (e.g. GL_TEXTURE_2D).
+     * @param texture The texture object to bind.
+     */
+    void bindTexture(GLuint unit, GLenum target, GLuint texture);
+
+    /**
+     * @brief Binds a framebuffer to GL_FRAMEBUFFER if it is not already bound.
+     * @param framebuffer The framebuffer object to bind, or 0 for the default framebuffer.
+     */
+    void bindFramebuffer(GLuint framebuffer);
+
+    /**
+     * @brief Binds a vertex array object if it is not already bound.
+     * @param vertex_array The vertex array object to bind, or 0 to unbind.
+     */
+    void bindVertexArray(GLuint vertex_array);
+
+    /**
+     * @brief Sets the viewport if it differs from the last one set through the cache.
+     */
+    void setViewport(GLint x, GLint y, GLsizei width, GLsizei height);
+
+    // --- Statistics ---
+    /**
+     * @brief Gets the number of GL bind calls actually issued since the last reset.
+     */
+    size_t getIssuedCallCount() const;
+
+    /**
+     * @brief Gets the number of redundant GL bind calls skipped since the last reset.
+     */
+    size_t getSkippedCallCount() const;
+
+    /**
+     * @brief Resets the issued/skipped call counters.
+     */
+    void resetCounters();
+
+private:
+    /// Sentinel meaning "binding unknown", forcing the next bind to be issued.
+    static constexpr GLuint UNKNOWN_BINDING = 0xFFFFFFFFu;
+
+    GLuint current_program;        ///< The last program bound through the cache.
+    GLuint current_framebuffer;    ///< The last framebuffer bound through the cache.
+    GLuint current_vertex_array;   ///< The last vertex array bound through the cache.
+    GLuint active_texture_unit;    ///< The last texture unit made active through the cache.
+    std::array<GLuint, MAX_TEXTURE_UNITS> bound_textures; ///< The texture bound on each unit.
+    std::array<GLint, 4> current_viewport; ///< The last viewport set through the cache.
+    bool viewport_known;           ///< False until a viewport has been set after invalidation.
+
+    size_t issued_calls;           ///< Number of GL calls issued.
+    size_t skipped_calls;          ///< Number of redundant GL calls skipped.
+};
@@ -0,0 +1,179 @@
+#include "HudOverlay.h"
+#include <algorithm>
+
+namespace {
+    const float GRAPH_WIDTH = 240.0f;       ///< Width of the frame-time graph in pixels.
+    const float GRAPH_HEIGHT = 48.0f;       ///< Height of the frame-time graph in pixels.
+    const float GRAPH_MAX_MS = 50.0f;       ///< Frame time mapped to the top of the graph.
+    const float TARGET_FRAME_MS = 1000.0f / 60.0f; ///< Reference line drawn across the graph.
+    const int TEXT_BASELINE_OFFSET = 12;    ///< Baseline of bitmap text relative to its row top.
+}
+
+//--------------------------------------------------------------
+HudOverlay::HudOverlay()
+    : text_width(0)
+    , capacity_lines(0)
+    , cleared_lines(0)
+    , enabled(true)
+    , frame_times(FRAME_TIME_SAMPLES, 0.0f)
+    , frame_time_head(0) {
+    graph_mesh.setMode(OF_PRIMITIVE_LINE_STRIP);
+}
+
+//--------------------------------------------------------------
+void HudOverlay::setup(int width, int max_lines) {
+    text_width = width;
+    capacity_lines = std::max(max_lines, 1);
+    text_fbo.allocate(text_width, static_cast<int>(capacity_lines) * LINE_HEIGHT, GL_RGBA);
+
+    text_fbo.begin();
+    ofClear(0, 0, 0, 0);
+    text_fbo.end();
+
+    for (auto& line : lines) {
+        line.dirty = true;
+    }
+}
+
+//--------------------------------------------------------------
+void HudOverlay::setLine(size_t index, const std::string& text) {
+    if (index >= lines.size()) {
+        lines.resize(index + 1);
+    }
+
+    HudLine& line = lines[index];
+    if (line.text != text) {
+        line.text = text;
+        line.dirty = true;
+    }
+}
+
+//--------------------------------------------------------------
+void HudOverlay::setLineCount(size_t count) {
+    if (count < lines.size()) {
+        cleared_lines = std::max(cleared_lines, lines.size());
+    }
+    lines.resize(count);
+}
+
+//--------------------------------------------------------------
+size_t HudOverlay::getLineCount() const {
+    return lines.size();
+}
+
+//--------------------------------------------------------------
+void HudOverlay::recordFrameTime(float milliseconds) {
+    frame_times[frame_time_head] = milliseconds;
+    frame_time_head = (frame_time_head + 1) % FRAME_TIME_SAMPLES;
+}
+
+//--------------------------------------------------------------
+void HudOverlay::draw(float x, float y) {
+    if (!enabled || text_width <= 0) {
+        return;
+    }
+
+    ensureCapacity();
+    redrawDirtyLines();
+
+    ofPushStyle();
+    ofSetColor(255, 255, 255, 255);
+    text_fbo.draw(x, y);
+    ofPopStyle();
+
+    drawFrameTimeGraph(x + text_width + 10.0f, y);
+}
+
+//--------------------------------------------------------------
+void HudOverlay::setEnabled(bool enabled_state) {
+    enabled = enabled_state;
+}
+
+//--------------------------------------------------------------
+bool HudOverlay::isEnabled() const {
+    return enabled;
+}
+
+//--------------------------------------------------------------
+void HudOverlay::toggle() {
+    enabled = !enabled;
+}
+
+//--------------------------------------------------------------
+void HudOverlay::ensureCapacity() {
+    if (lines.size() <= capacity_lines && text_fbo.isAllocated()) {
+        return;
+    }
+
+    // Grow geometrically so a slowly growing plugin list does not reallocate every time.
+    size_t new_capacity = std::max(lines.size(), capacity_lines * 2);
+    ofLogNotice("HudOverlay") << "Growing text cache to " << new_capacity << " lines";
+    setup(text_width, static_cast<int>(new_capacity));
+    cleared_lines = 0;
+}
+
+//--------------------------------------------------------------
+void HudOverlay::redrawDirtyLines() {
+    bool any_dirty = cleared_lines > lines.size();
+    for (const auto& line : lines) {
+        if (line.dirty) {
+            any_dirty = true;
+            break;
+        }
+    }
+    if (!any_dirty) {
+        return;
+    }
+
+    text_fbo.begin();
+    ofPushStyle();
+
+    for (size_t i = 0; i < std::max(lines.size(), cleared_lines); ++i) {
+        bool is_stale = i >= lines.size();
+        if (!is_stale && !lines[i].dirty) {
+            continue;
+        }
+
+        float row_top = static_cast<float>(i * LINE_HEIGHT);
+
+        // Clear just this row: blending off so the transparent rectangle replaces the pixels.
+        ofDisableAlphaBlending();
+        ofSetColor(0, 0, 0, 0);
+        ofDrawRectangle(0, row_top, text_width, LINE_HEIGHT);
+        ofEnableAlphaBlending();
+
+        if (!is_stale) {
+            ofSetColor(255, 255, 255, 255);
+            ofDrawBitmapString(lines[i].text, 0, row_top + TEXT_BASELINE_OFFSET);
+            lines[i].dirty = false;
+        }
+    }
+
+    ofPopStyle();
+    text_fbo.end();
+    cleared_lines = 0;
+}
+
+//--------------------------------------------------------------
+void HudOverlay::drawFrameTimeGraph(float x, float y) {
+    graph_mesh.clear();
+    float step = GRAPH_WIDTH / static_cast<float>(FRAME_TIME_SAMPLES - 1);
+    for (size_t i = 0; i < FRAME_TIME_SAMPLES; ++i) {
+        // Oldest sample on the left, newest on the right.
+        float ms = frame_times[(frame_time_head + i) % FRAME_TIME_SAMPLES];
+        float normalized = std::min(ms / GRAPH_MAX_MS, 1.0f);
+        graph_mesh.addVertex(glm::vec3(x + i * step, y + GRAPH_HEIGHT * (1.0f - normalized), 0.0f));
+    }
+
+    ofPushStyle();
+    ofSetColor(0, 0, 0, 160);
+    ofDrawRectangle(x, y, GRAPH_WIDTH, GRAPH_HEIGHT);
+
+    float target_y = y + GRAPH_HEIGHT * (1.0f - TARGET_FRAME_MS / GRAPH_MAX_MS);
+    ofSetColor(80, 80, 80, 255);
+    ofDrawLine(x, target_y, x + GRAPH_WIDTH, target_y);
+
+    ofSetColor(0, 255, 120, 255);
+    graph_mesh.draw();
+    ofPopStyle();
+}
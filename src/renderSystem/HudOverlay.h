@@ -0,0 +1,102 @@
+#pragma once
+#include "ofMain.h"
+#include <string>
+#include <vector>
+
+/**
+ * @class HudOverlay
+ * @brief A cached text overlay for the on-screen help, plugin list and status lines.
+ * @details Bitmap text is tessellated from scratch on every ofDrawBitmapString call.
+ *          The overlay instead keeps its lines in an offscreen framebuffer and only
+ *          redraws the rows whose text actually changed, so an unchanged HUD costs a
+ *          single textured quad per frame. A small frame-time graph is drawn live
+ *          next to the cached text, and the whole overlay can be switched off at runtime.
+ */
+class HudOverlay {
+public:
+    /// Height of one text row in pixels.
+    static constexpr int LINE_HEIGHT = 16;
+    /// Number of frame-time samples kept for the graph.
+    static constexpr size_t FRAME_TIME_SAMPLES = 120;
+
+    HudOverlay();
+
+    /**
+     * @brief Allocates the text framebuffer. Requires a current GL context.
+     * @param width The width of the text area in pixels.
+     * @param max_lines The initial number of rows the text area can hold.
+     */
+    void setup(int width, int max_lines);
+
+    /**
+     * @brief Sets the text of one row, marking it dirty only if the text changed.
+     * @param index The zero-based row index. The row list grows as needed.
+     * @param text The text to display.
+     */
+    void setLine(size_t index, const std::string& text);
+
+    /**
+     * @brief Sets the number of rows in use, clearing any rows past the new count.
+     * @param count The number of rows to keep.
+     */
+    void setLineCount(size_t count);
+
+    /**
+     * @brief Gets the number of rows currently in use.
+     */
+    size_t getLineCount() const;
+
+    /**
+     * @brief Records the duration of the last frame for the frame-time graph.
+     * @param milliseconds The frame duration in milliseconds.
+     */
+    void recordFrameTime(float milliseconds);
+
+    /**
+     * @brief Redraws dirty rows into the cache, then draws the overlay.
+     * @param x The left edge of the overlay in screen pixels.
+     * @param y The top edge of the overlay in screen pixels.
+     */
+    void draw(float x, float y);
+
+    // --- Runtime Toggle ---
+    void setEnabled(bool enabled);
+    bool isEnabled() const;
+    void toggle();
+
+private:
+    /**
+     * @struct HudLine
+     * @brief The cached state of one text row.
+     */
+    struct HudLine {
+        std::string text;   ///< The text currently requested for this row.
+        bool dirty = true;  ///< True if the row must be redrawn into the cache.
+    };
+
+    /**
+     * @brief Reallocates the framebuffer when the rows no longer fit, marking all rows dirty.
+     */
+    void ensureCapacity();
+
+    /**
+     * @brief Redraws all dirty rows into the framebuffer.
+     */
+    void redrawDirtyLines();
+
+    /**
+     * @brief Draws the frame-time graph with its top-left corner at (x, y).
+     */
+    void drawFrameTimeGraph(float x, float y);
+
+    ofFbo text_fbo;                    ///< Cached rendering of all text rows.
+    int text_width;                    ///< Width of the text area in pixels.
+    size_t capacity_lines;             ///< Number of rows the framebuffer can hold.
+    std::vector<HudLine> lines;        ///< The rows currently in use.
+    size_t cleared_lines;              ///< Rows past the end that still need clearing.
+    bool enabled;                      ///< Whether the overlay is drawn at all.
+
+    std::vector<float> frame_times;    ///< Ring buffer of frame durations in milliseconds.
+    size_t frame_time_head;            ///< Index of the next sample to write.
+    ofMesh graph_mesh;                 ///< Reused line strip for the frame-time graph.
+};
@@ -0,0 +1,205 @@
+#include "OfflineRenderer.h"
+#include "../shaderSystem/ShaderSources.h"
+
+namespace {
+    /// Parses "WxH" into two positive integers.
+    bool parseSize(const std::string& text, int& width, int& height) {
+        size_t separator = text.find('x');
+        if (separator == std::string::npos) {
+            return false;
+        }
+        width = std::stoi(text.substr(0, separator));
+        height = std::stoi(text.substr(separator + 1));
+        return width > 0 && height > 0;
+    }
+}
+
+//--------------------------------------------------------------
+OfflineRenderer::OfflineRenderer()
+    : has_output(false)
+    , frames_rendered(0)
+    , start_time_micros(0)
+    , end_time_micros(0) {
+}
+
+//--------------------------------------------------------------
+OfflineRenderer::~OfflineRenderer() {
+    close();
+}
+
+//--------------------------------------------------------------
+bool OfflineRenderer::parseArguments(int argc, char* argv[], OfflineRenderSettings& settings) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool has_value = (i + 1 < argc);
+
+        try {
+            if (arg == "--headless") {
+                settings.headless = true;
+            } else if (arg == "--size" && has_value) {
+                if (!parseSize(argv[++i], settings.width, settings.height)) {
+                    ofLogError("OfflineRenderer") << "Invalid --size, expected WxH: " << argv[i];
+                    return false;
+                }
+            } else if (arg == "--fps" && has_value) {
+                settings.fps = std::stod(argv[++i]);
+            } else if (arg == "--frames" && has_value) {
+                settings.frame_count = std::stoull(argv[++i]);
+            } else if (arg == "--output" && has_value) {
+                settings.output_path = argv[++i];
+            } else if (arg == "--replay" && has_value) {
+                settings.replay_log_path = argv[++i];
+            } else if (arg == "--record" && has_value) {
+                settings.record_log_path = argv[++i];
+            } else if (arg == "--verify") {
+                settings.verify = true;
+            } else if (arg == "--verify-cpu" && has_value) {
+                settings.cpu_tolerance = std::stoi(argv[++i]);
+                if (settings.cpu_tolerance < 0 || settings.cpu_tolerance > 255) {
+                    ofLogError("OfflineRenderer") << "--verify-cpu needs a tolerance of 0 to 255 steps";
+                    return false;
+                }
+            } else if (arg == "--tap" && has_value) {
+                if (!parseSize(argv[++i], settings.tap_width, settings.tap_height)) {
+                    ofLogError("OfflineRenderer") << "Invalid --tap, expected WxH: " << argv[i];
+                    return false;
+                }
+            } else if (arg == "--tap-shm" && has_value) {
+                settings.tap_shm_name = argv[++i];
+            } else if (arg == "--tap-file" && has_value) {
+                settings.tap_file_path = argv[++i];
+            } else if (arg == "--tiled" && has_value) {
+                if (!parseSize(argv[++i], settings.tiled_width, settings.tiled_height)) {
+                    ofLogError("OfflineRenderer") << "Invalid --tiled, expected WxH: " << argv[i];
+                    return false;
+                }
+            } else if (arg == "--tile" && has_value) {
+                if (!parseSize(argv[++i], settings.tile_width, settings.tile_height)) {
+                    ofLogError("OfflineRenderer") << "Invalid --tile, expected WxH: " << argv[i];
+                    return false;
+                }
+            } else if (arg == "--tile-budget" && has_value) {
+                settings.tile_budget_ms = std::stof(argv[++i]);
+            } else if (arg == "--preview-budget" && has_value) {
+                settings.preview_budget_ms = std::stof(argv[++i]);
+            } else if (arg == "--preview-shm" && has_value) {
+                settings.preview_shm_name = argv[++i];
+            } else if (arg == "--decode-ahead" && has_value) {
+                settings.decode_ahead = std::stoi(argv[++i]);
+            } else if (arg == "--scene-dir" && has_value) {
+                settings.scene_directory = argv[++i];
+            } else if (arg == "--scene-lookahead" && has_value) {
+                settings.scene_lookahead = std::stoi(argv[++i]);
+            } else if (arg == "--scene-budget" && has_value) {
+                settings.scene_budget_ms = std::stof(argv[++i]);
+            } else if (arg == "--sources" && has_value) {
+                SourceRetention retention;
+                if (!ShaderSources::parseRetention(argv[++i], retention)) {
+                    ofLogError("OfflineRenderer") << "Invalid --sources, expected drop, keep or compress: " << argv[i];
+                    return false;
+                }
+                settings.source_retention = argv[i];
+            } else if (arg == "--program-cache" && has_value) {
+                settings.program_cache_directory = argv[++i];
+            } else if (arg == "--snapshot" && has_value) {
+                settings.snapshot_path = argv[++i];
+            } else if (arg == "--snapshot-interval" && has_value) {
+                settings.snapshot_interval = std::stod(argv[++i]);
+            } else {
+                ofLogError("OfflineRenderer") << "Unknown or incomplete argument: " << arg;
+                return false;
+            }
+        } catch (const std::exception&) {
+            ofLogError("OfflineRenderer") << "Invalid value for argument: " << arg;
+            return false;
+        }
+    }
+
+    if (settings.width <= 0 || settings.height <= 0 || settings.fps <= 0.0) {
+        ofLogError("OfflineRenderer") << "Frame size and fps must be positive";
+        return false;
+    }
+    if ((settings.verify || settings.cpu_tolerance >= 0) && !settings.headless) {
+        ofLogError("OfflineRenderer") << "--verify and --verify-cpu need --headless";
+        return false;
+    }
+    return true;
+}
+
+//--------------------------------------------------------------
+bool OfflineRenderer::setup(const OfflineRenderSettings& render_settings) {
+    settings = render_settings;
+
+    frame_fbo.allocate(settings.width, settings.height, GL_RGBA);
+    frame_pixels.allocate(settings.width, settings.height, OF_IMAGE_COLOR_ALPHA);
+
+    if (!settings.output_path.empty()) {
+        if (!output.open(settings.output_path)) {
+            return false;
+        }
+        has_output = true;
+    }
+
+    ofLogNotice("OfflineRenderer") << "Offline rendering " << settings.frame_count << " frames at "
+                                   << settings.width << "x" << settings.height << ", " << settings.fps << " fps"
+                                   << (has_output ? " to " + settings.output_path : " (output discarded)");
+    return true;
+}
+
+//--------------------------------------------------------------
+void OfflineRenderer::beginFrame() {
+    if (frames_rendered == 0) {
+        start_time_micros = ofGetElapsedTimeMicros();
+    }
+
+    frame_fbo.begin();
+    ofClear(0, 0, 0, 255);
+}
+
+//--------------------------------------------------------------
+void OfflineRenderer::endFrame() {
+    frame_fbo.end();
+
+    if (has_output) {
+        frame_fbo.readToPixels(frame_pixels);
+        output.consumeFrame(frame_pixels.getData(), settings.width, settings.height, frames_rendered);
+    }
+
+    frames_rendered++;
+    end_time_micros = ofGetElapsedTimeMicros();
+}
+
+//--------------------------------------------------------------
+bool OfflineRenderer::isFinished() const {
+    return frames_rendered >= settings.frame_count;
+}
+
+//--------------------------------------------------------------
+void OfflineRenderer::logThroughput() const {
+    double seconds = (end_time_micros - start_time_micros) / 1000000.0;
+    if (frames_rendered == 0 || seconds <= 0.0) {
+        ofLogNotice("OfflineRenderer") << "No frames rendered";
+        return;
+    }
+
+    ofLogNotice("OfflineRenderer") << "Rendered " << frames_rendered << " frames in " << seconds << " s: "
+                                   << (frames_rendered / seconds) << " fps, "
+                                   << (seconds * 1000.0 / frames_rendered) << " ms/frame, "
+                                   << (output.getBytesWritten() / (1024.0 * 1024.0) / seconds) << " MB/s written";
+}
+
+//--------------------------------------------------------------
+void OfflineRenderer::close() {
+    output.close();
+    has_output = false;
+}
+
+//--------------------------------------------------------------
+float OfflineRenderer::getWidth() const {
+    return static_cast<float>(settings.width);
+}
+
+//--------------------------------------------------------------
+float OfflineRenderer::getHeight() const {
+    return static_cast<float>(settings.height);
+}
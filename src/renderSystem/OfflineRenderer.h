@@ -0,0 +1,132 @@
+#pragma once
+#include "ofMain.h"
+#include "RawFileFrameSink.h"
+#include <string>
+#include <vector>
+
+/**
+ * @struct OfflineRenderSettings
+ * @brief Command-line options of the engine: headless fixed-timestep rendering and the output tap.
+ */
+struct OfflineRenderSettings {
+    bool headless = false;            ///< Render offscreen as fast as possible instead of interactively.
+    int width = 1024;                 ///< Width of the rendered frames in pixels.
+    int height = 768;                 ///< Height of the rendered frames in pixels.
+    double fps = 60.0;                ///< Simulated frame rate of the fixed-step clock.
+    uint64_t frame_count = 600;       ///< Number of frames to render before exiting.
+    std::string output_path;          ///< Raw RGBA output file, "-" for stdout, empty to discard.
+    std::string replay_log_path;      ///< OSC log to replay instead of listening live.
+    std::string record_log_path;      ///< OSC log to record live messages to.
+    bool verify = false;              ///< After the last frame, compare tiled with untiled rendering; a mismatch fails the run.
+    int cpu_tolerance = -1;           ///< After the last frame, compare the CPU evaluator with GL within this many 8-bit steps; -1 to skip.
+
+    // --- Output Tap (interactive mode) ---
+    int tap_width = 0;                ///< Capture width of the output tap, 0 to disable it.
+    int tap_height = 0;               ///< Capture height of the output tap.
+    std::string tap_shm_name;         ///< Shared-memory ring published by the tap.
+    std::string tap_file_path;        ///< Raw RGBA file written by the tap, "-" for stdout.
+
+    // --- Tiled Output (interactive mode) ---
+    int tiled_width = 0;              ///< Width of the tiled output, 0 to render untiled.
+    int tiled_height = 0;             ///< Height of the tiled output.
+    int tile_width = 2048;            ///< Maximum tile width.
+    int tile_height = 2048;           ///< Maximum tile height.
+    float tile_budget_ms = 8.0f;      ///< GPU time per frame available for tiles, 0 for no limit.
+
+    // --- Preview Atlas (interactive mode) ---
+    float preview_budget_ms = 1.0f;   ///< GPU time per frame available for previews, 0 to disable them.
+    std::string preview_shm_name;     ///< Shared-memory ring the preview atlas is published to.
+
+    // --- Texture Sources ---
+    int decode_ahead = 4;             ///< Decoded video frames kept ready per texture source.
+
+    // --- Scenes ---
+    std::string scene_directory;      ///< Directory of *.scene files to preload, empty for none.
+    int scene_lookahead = 2;          ///< Cues after the current scene kept compiled.
+    float scene_budget_ms = 4.0f;     ///< Per-frame CPU time for precompiling scenes.
+
+    // --- Shader Sources ---
+    std::string source_retention;     ///< "drop", "keep" or "compress" after linking; empty drops when headless, compresses otherwise.
+
+    // --- Persistence ---
+    std::string program_cache_directory; ///< Directory of linked program binaries, empty to disable the cache.
+    std::string snapshot_path;        ///< Session snapshot to restore on start and keep updated, empty for none.
+    double snapshot_interval = 1.0;   ///< Minimum seconds between session snapshots.
+};
+
+/**
+ * @class OfflineRenderer
+ * @brief Renders frames into an offscreen framebuffer and streams them as raw RGBA.
+ * @details Used for pre-rendering and for throughput benchmarks. Frames are written
+ *          back to back without headers (width * height * 4 bytes each), so the output
+ *          can be piped straight into tools such as ffmpeg with '-f rawvideo -pix_fmt rgba'.
+ *          Unlike the OutputTap, every frame is read back synchronously: offline output
+ *          must never drop a frame, and the render loop is not paced by a display.
+ */
+class OfflineRenderer {
+public:
+    OfflineRenderer();
+    ~OfflineRenderer();
+
+    /**
+     * @brief Parses the engine's command-line options.
+     * @details Recognized options: --headless, --size WxH, --fps N, --frames N,
+     *          --output PATH|-, --replay LOG, --record LOG, --verify, --verify-cpu STEPS, --tap WxH,
+     *          --tap-shm NAME, --tap-file PATH|-, --tiled WxH, --tile WxH, --tile-budget MS,
+     *          --preview-budget MS, --preview-shm NAME, --decode-ahead N,
+     *          --scene-dir DIR, --scene-lookahead N, --scene-budget MS,
+     *          --sources drop|keep|compress, --program-cache DIR, --snapshot PATH,
+     *          --snapshot-interval S.
+     * @param argc The argument count from main().
+     * @param argv The argument vector from main().
+     * @param settings Receives the parsed options.
+     * @return True if all arguments were valid, false otherwise.
+     */
+    static bool parseArguments(int argc, char* argv[], OfflineRenderSettings& settings);
+
+    /**
+     * @brief Allocates the framebuffer and opens the output. Requires a current GL context.
+     * @param settings The render settings.
+     * @return True on success, false otherwise.
+     */
+    bool setup(const OfflineRenderSettings& settings);
+
+    /**
+     * @brief Binds and clears the offscreen framebuffer for the next frame.
+     */
+    void beginFrame();
+
+    /**
+     * @brief Unbinds the framebuffer and writes the frame to the output.
+     */
+    void endFrame();
+
+    /**
+     * @brief Checks whether the requested number of frames has been rendered.
+     */
+    bool isFinished() const;
+
+    /**
+     * @brief Logs the frame count, frame rate and output bandwidth achieved so far.
+     */
+    void logThroughput() const;
+
+    /**
+     * @brief Flushes and closes the output.
+     */
+    void close();
+
+    float getWidth() const;
+    float getHeight() const;
+
+private:
+    OfflineRenderSettings settings;   ///< The active render settings.
+    ofFbo frame_fbo;                  ///< Offscreen target of every frame.
+    ofPixels frame_pixels;            ///< Reused CPU copy of the last frame.
+    RawFileFrameSink output;          ///< Raw frame destination.
+    bool has_output;                  ///< False if frames are discarded.
+
+    uint64_t frames_rendered;         ///< Frames completed so far.
+    uint64_t start_time_micros;       ///< Time at which the first frame began.
+    uint64_t end_time_micros;         ///< Time at which the last frame ended.
+};
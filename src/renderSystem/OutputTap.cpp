@@ -0,0 +1,98 @@
+#include "OutputTap.h"
+
+//--------------------------------------------------------------
+OutputTap::OutputTap()
+    : width(0)
+    , height(0)
+    , last_overhead_micros(0) {
+}
+
+//--------------------------------------------------------------
+bool OutputTap::setup(int capture_width, int capture_height, size_t ring_size) {
+    width = capture_width;
+    height = capture_height;
+
+    capture_fbo.allocate(width, height, GL_RGBA8);
+    if (!readback_ring.setup(width, height, ring_size)) {
+        return false;
+    }
+
+    ofLogNotice("OutputTap") << "Output tap at " << width << "x" << height;
+    return true;
+}
+
+//--------------------------------------------------------------
+bool OutputTap::addSharedMemorySink(const std::string& name) {
+    auto sink = std::make_unique<ShmFrameSink>();
+    if (!sink->setup(name, width, height)) {
+        return false;
+    }
+    sink_views.push_back(sink.get());
+    sinks.push_back(std::move(sink));
+    return true;
+}
+
+//--------------------------------------------------------------
+bool OutputTap::addRawFileSink(const std::string& path) {
+    auto sink = std::make_unique<RawFileFrameSink>();
+    if (!sink->open(path)) {
+        return false;
+    }
+    sink_views.push_back(sink.get());
+    sinks.push_back(std::move(sink));
+    return true;
+}
+
+//--------------------------------------------------------------
+void OutputTap::beginFrame() {
+    capture_fbo.begin();
+    ofClear(0, 0, 0, 255);
+}
+
+//--------------------------------------------------------------
+void OutputTap::endFrame(uint64_t frame_index) {
+    capture_fbo.end();
+
+    uint64_t start = ofGetElapsedTimeMicros();
+    // Collect first so the slots of finished readbacks are free for this frame.
+    readback_ring.collect(sink_views);
+    if (!sink_views.empty()) {
+        readback_ring.queueReadback(capture_fbo.getId(), frame_index);
+    }
+    last_overhead_micros = ofGetElapsedTimeMicros() - start;
+}
+
+//--------------------------------------------------------------
+void OutputTap::draw(float x, float y, float draw_width, float draw_height) const {
+    capture_fbo.draw(x, y, draw_width, draw_height);
+}
+
+//--------------------------------------------------------------
+float OutputTap::getWidth() const {
+    return static_cast<float>(width);
+}
+
+//--------------------------------------------------------------
+float OutputTap::getHeight() const {
+    return static_cast<float>(height);
+}
+
+//--------------------------------------------------------------
+uint64_t OutputTap::getLastOverheadMicros() const {
+    return last_overhead_micros;
+}
+
+//--------------------------------------------------------------
+uint64_t OutputTap::getDroppedCount() const {
+    return readback_ring.getDroppedCount();
+}
+
+//--------------------------------------------------------------
+double OutputTap::getLastReadbackCopyMilliseconds() const {
+    return readback_ring.getLastCopyMilliseconds();
+}
+
+//--------------------------------------------------------------
+uint32_t OutputTap::getLastReadbackStallCount() const {
+    return readback_ring.getLastStallCount();
+}
@@ -0,0 +1,88 @@
+#pragma once
+#include "ofMain.h"
+#include "PboReadbackRing.h"
+#include "ShmFrameSink.h"
+#include "RawFileFrameSink.h"
+#include <memory>
+
+/**
+ * @class OutputTap
+ * @brief Captures the final composite for downstream systems without stalling rendering.
+ * @details The composite is rendered into the tap's framebuffer at the tap resolution,
+ *          read back asynchronously through a PboReadbackRing and handed to the attached
+ *          sinks (shared-memory ring, raw file) a few frames later. The same framebuffer
+ *          is then drawn to the window, so the tap adds one blit and one asynchronous
+ *          copy per frame.
+ */
+class OutputTap {
+public:
+    OutputTap();
+
+    /**
+     * @brief Allocates the framebuffer and readback ring. Requires a current GL context.
+     * @param width The capture width in pixels.
+     * @param height The capture height in pixels.
+     * @param ring_size The number of readbacks in flight.
+     * @return True on success, false otherwise.
+     */
+    bool setup(int width, int height, size_t ring_size = 3);
+
+    /**
+     * @brief Publishes captured frames into a POSIX shared-memory ring.
+     * @param name The shared-memory name, starting with '/'.
+     * @return True if the ring was created.
+     */
+    bool addSharedMemorySink(const std::string& name);
+
+    /**
+     * @brief Writes captured frames as raw RGBA to a file or stdout ("-").
+     * @param path The output path.
+     * @return True if the file was opened.
+     */
+    bool addRawFileSink(const std::string& path);
+
+    /**
+     * @brief Binds and clears the capture framebuffer.
+     */
+    void beginFrame();
+
+    /**
+     * @brief Unbinds the capture framebuffer, delivers completed frames and queues this one.
+     * @param frame_index The engine frame index stored with the frame.
+     */
+    void endFrame(uint64_t frame_index);
+
+    /**
+     * @brief Draws the captured frame, e.g. to the window.
+     */
+    void draw(float x, float y, float width, float height) const;
+
+    float getWidth() const;
+    float getHeight() const;
+
+    /**
+     * @brief Gets the CPU time spent in the last endFrame() in microseconds.
+     */
+    uint64_t getLastOverheadMicros() const;
+
+    /**
+     * @brief Gets the number of frames dropped because the consumer side fell behind.
+     */
+    uint64_t getDroppedCount() const;
+
+    /**
+     * @brief Gets the readback statistics of the last endFrame().
+     * @details See PboReadbackRing::getLastCopyMilliseconds() and getLastStallCount().
+     */
+    double getLastReadbackCopyMilliseconds() const;
+    uint32_t getLastReadbackStallCount() const;
+
+private:
+    ofFbo capture_fbo;                                  ///< Target of the final composite.
+    PboReadbackRing readback_ring;                      ///< Asynchronous readback of capture_fbo.
+    std::vector<std::unique_ptr<FrameSink>> sinks;      ///< Owned frame consumers.
+    std::vector<FrameSink*> sink_views;                 ///< Non-owning view passed to the ring.
+    int width;                                          ///< Capture width in pixels.
+    int height;                                         ///< Capture height in pixels.
+    uint64_t last_overhead_micros;                      ///< CPU cost of the last endFrame().
+};
@@ -0,0 +1,151 @@
+#include "PboReadbackRing.h"
+
+//--------------------------------------------------------------
+PboReadbackRing::PboReadbackRing()
+    : write_index(0)
+    , read_index(0)
+    , pending_count(0)
+    , width(0)
+    , height(0)
+    , frame_bytes(0)
+    , dropped_count(0)
+    , last_copy_micros(0)
+    , stall_count(0) {
+}
+
+//--------------------------------------------------------------
+PboReadbackRing::~PboReadbackRing() {
+    release();
+}
+
+//--------------------------------------------------------------
+bool PboReadbackRing::setup(int frame_width, int frame_height, size_t ring_size) {
+    release();
+    if (frame_width <= 0 || frame_height <= 0 || ring_size < 2) {
+        ofLogError("PboReadbackRing") << "Invalid readback ring parameters";
+        return false;
+    }
+
+    width = frame_width;
+    height = frame_height;
+    frame_bytes = static_cast<size_t>(width) * height * 4;
+    slots.resize(ring_size);
+
+    for (auto& slot : slots) {
+        glGenBuffers(1, &slot.buffer);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+        glBufferData(GL_PIXEL_PACK_BUFFER, static_cast<GLsizeiptr>(frame_bytes), nullptr, GL_STREAM_READ);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    ofLogNotice("PboReadbackRing") << "Readback ring: " << ring_size << " x " << width << "x" << height
+                                   << " (" << (frame_bytes * ring_size / (1024 * 1024)) << " MB)";
+    return true;
+}
+
+//--------------------------------------------------------------
+void PboReadbackRing::release() {
+    for (auto& slot : slots) {
+        if (slot.fence) {
+            glDeleteSync(slot.fence);
+        }
+        if (slot.buffer != 0) {
+            glDeleteBuffers(1, &slot.buffer);
+        }
+    }
+    slots.clear();
+    write_index = 0;
+    read_index = 0;
+    pending_count = 0;
+}
+
+//--------------------------------------------------------------
+bool PboReadbackRing::queueReadback(GLuint framebuffer, uint64_t frame_index) {
+    if (slots.empty()) {
+        return false;
+    }
+
+    Slot& slot = slots[write_index];
+    if (slot.fence) {
+        // The consumer fell behind; dropping keeps the render thread from blocking.
+        dropped_count++;
+        stall_count++;
+        return false;
+    }
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+
+    slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    slot.frame_index = frame_index;
+    pending_count++;
+    write_index = (write_index + 1) % slots.size();
+    return true;
+}
+
+//--------------------------------------------------------------
+size_t PboReadbackRing::collect(const std::vector<FrameSink*>& sinks) {
+    size_t delivered = 0;
+    last_copy_micros = 0;
+    stall_count = 0;
+
+    // Completed readbacks are delivered in order; stop at the first one still in flight.
+    while (pending_count > 0) {
+        Slot& slot = slots[read_index];
+        GLenum status = glClientWaitSync(slot.fence, 0, 0);
+        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) {
+            if (status == GL_WAIT_FAILED) {
+                ofLogError("PboReadbackRing") << "glClientWaitSync failed, dropping frame " << slot.frame_index;
+            } else {
+                stall_count++;
+                break;
+            }
+        } else {
+            uint64_t map_start = ofGetElapsedTimeMicros();
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+            const void* data = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, static_cast<GLsizeiptr>(frame_bytes), GL_MAP_READ_BIT);
+            if (data) {
+                for (FrameSink* sink : sinks) {
+                    sink->consumeFrame(static_cast<const uint8_t*>(data), width, height, slot.frame_index);
+                }
+                glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+                last_copy_micros += ofGetElapsedTimeMicros() - map_start;
+                delivered++;
+            } else {
+                ofLogError("PboReadbackRing") << "Failed to map readback buffer for frame " << slot.frame_index;
+            }
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        }
+
+        glDeleteSync(slot.fence);
+        slot.fence = nullptr;
+        pending_count--;
+        read_index = (read_index + 1) % slots.size();
+    }
+
+    return delivered;
+}
+
+//--------------------------------------------------------------
+uint64_t PboReadbackRing::getDroppedCount() const {
+    return dropped_count;
+}
+
+//--------------------------------------------------------------
+size_t PboReadbackRing::getPendingCount() const {
+    return pending_count;
+}
+
+//--------------------------------------------------------------
+double PboReadbackRing::getLastCopyMilliseconds() const {
+    return last_copy_micros / 1000.0;
+}
+
+//--------------------------------------------------------------
+uint32_t PboReadbackRing::getLastStallCount() const {
+    return stall_count;
+}
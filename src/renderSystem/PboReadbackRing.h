@@ -0,0 +1,94 @@
+#pragma once
+#include "ofMain.h"
+#include "FrameSink.h"
+#include <vector>
+
+/**
+ * @class PboReadbackRing
+ * @brief Asynchronous framebuffer readback through a ring of pixel-buffer objects.
+ * @details queueReadback() starts a glReadPixels into the next free PBO and inserts a
+ *          fence; the call returns immediately because the copy targets GPU memory.
+ *          collect() maps only the PBOs whose fences have already signalled, so the
+ *          CPU never waits on the GPU. With a ring of N buffers, frames arrive about
+ *          N-1 frames after they were rendered. If every buffer is still in flight, the
+ *          new frame is dropped instead of stalling.
+ */
+class PboReadbackRing {
+public:
+    PboReadbackRing();
+    ~PboReadbackRing();
+
+    /**
+     * @brief Allocates the pixel-buffer objects. Requires a current GL context.
+     * @param width The frame width in pixels.
+     * @param height The frame height in pixels.
+     * @param ring_size The number of buffers in flight (at least 2).
+     * @return True on success, false otherwise.
+     */
+    bool setup(int width, int height, size_t ring_size = 3);
+
+    /**
+     * @brief Releases all GL objects.
+     */
+    void release();
+
+    /**
+     * @brief Starts reading back color attachment 0 of a framebuffer.
+     * @param framebuffer The framebuffer object to read from.
+     * @param frame_index The engine frame index stored with the frame.
+     * @return True if a readback was queued, false if the ring was full and the frame was dropped.
+     */
+    bool queueReadback(GLuint framebuffer, uint64_t frame_index);
+
+    /**
+     * @brief Delivers every completed readback, oldest first, to the given sinks.
+     * @param sinks The sinks receiving each frame.
+     * @return The number of frames delivered.
+     */
+    size_t collect(const std::vector<FrameSink*>& sinks);
+
+    /**
+     * @brief Gets the number of frames dropped because the ring was full.
+     */
+    uint64_t getDroppedCount() const;
+
+    /**
+     * @brief Gets the number of readbacks currently in flight.
+     */
+    size_t getPendingCount() const;
+
+    /**
+     * @brief Gets the time from mapping to unmapping the delivered buffers in the last collect().
+     * @details Includes the copies made by the sinks, which run while the buffer is mapped.
+     */
+    double getLastCopyMilliseconds() const;
+
+    /**
+     * @brief Gets the number of stalls in the last collect() and queueReadback().
+     * @details A stall is a readback that was not finished when collect() reached it (and
+     *          would have blocked a synchronous map) or a frame dropped because the ring was full.
+     */
+    uint32_t getLastStallCount() const;
+
+private:
+    /**
+     * @struct Slot
+     * @brief One pixel-buffer object and the fence of its pending readback.
+     */
+    struct Slot {
+        GLuint buffer = 0;          ///< The pixel-pack buffer object.
+        GLsync fence = nullptr;     ///< Signalled once the readback has completed, nullptr if idle.
+        uint64_t frame_index = 0;   ///< Engine frame stored in this slot.
+    };
+
+    std::vector<Slot> slots;        ///< The ring of buffers.
+    size_t write_index;             ///< Slot used by the next queueReadback().
+    size_t read_index;              ///< Oldest slot that may hold a pending readback.
+    size_t pending_count;           ///< Number of slots with a pending fence.
+    int width;                      ///< Frame width in pixels.
+    int height;                     ///< Frame height in pixels.
+    size_t frame_bytes;             ///< Size of one frame in bytes.
+    uint64_t dropped_count;         ///< Frames dropped because the ring was full.
+    uint64_t last_copy_micros;      ///< Map-to-unmap time of the last collect().
+    uint32_t stall_count;           ///< Stalls since the last collect() began, including its own.
+};
@@ -0,0 +1,302 @@
+#include "PreviewAtlas.h"
+#include <algorithm>
+
+//--------------------------------------------------------------
+PreviewAtlas::PreviewAtlas()
+    : has_pixels(false)
+    , next_slot(0)
+    , warned_full(false)
+    , tile_width(0)
+    , tile_height(0)
+    , columns(0)
+    , rows(0)
+    , timer_query(0)
+    , query_pending(false)
+    , query_tile_count(0)
+    , frame_budget_ms(1.0f)
+    , tile_cost_ms(0.0f)
+    , has_cost_estimate(false)
+    , tiles_last_frame(0) {
+}
+
+//--------------------------------------------------------------
+PreviewAtlas::~PreviewAtlas() {
+    if (timer_query != 0) {
+        glDeleteQueries(1, &timer_query);
+    }
+}
+
+//--------------------------------------------------------------
+bool PreviewAtlas::setup(int preview_width, int preview_height, int atlas_columns, int atlas_rows) {
+    if (preview_width <= 0 || preview_height <= 0 || atlas_columns <= 0 || atlas_rows <= 0) {
+        ofLogError("PreviewAtlas") << "Invalid atlas layout";
+        return false;
+    }
+
+    tile_width = preview_width;
+    tile_height = preview_height;
+    columns = atlas_columns;
+    rows = atlas_rows;
+
+    int atlas_width = tile_width * columns;
+    int atlas_height = tile_height * rows;
+    atlas_fbo.allocate(atlas_width, atlas_height, GL_RGBA8);
+    atlas_fbo.begin();
+    ofClear(0, 0, 0, 255);
+    atlas_fbo.end();
+
+    if (!readback_ring.setup(atlas_width, atlas_height)) {
+        return false;
+    }
+    sink_views = {this};
+
+    if (timer_query == 0) {
+        glGenQueries(1, &timer_query);
+    }
+
+    slots.assign(static_cast<size_t>(columns) * rows, Slot());
+    slot_by_id.clear();
+    next_slot = 0;
+
+    ofLogNotice("PreviewAtlas") << "Preview atlas of " << slots.size() << " tiles at " << tile_width << "x" << tile_height
+                                << " (" << atlas_width << "x" << atlas_height << ")";
+    return true;
+}
+
+//--------------------------------------------------------------
+bool PreviewAtlas::addSharedMemorySink(const std::string& name) {
+    auto sink = std::make_unique<ShmFrameSink>();
+    if (!sink->setup(name, tile_width * columns, tile_height * rows)) {
+        return false;
+    }
+    sink_views.push_back(sink.get());
+    sinks.push_back(std::move(sink));
+    return true;
+}
+
+//--------------------------------------------------------------
+void PreviewAtlas::setFrameBudget(float milliseconds) {
+    frame_budget_ms = std::max(milliseconds, 0.0f);
+}
+
+//--------------------------------------------------------------
+void PreviewAtlas::setSources(const std::map<std::string, std::shared_ptr<ShaderNode>>& sources) {
+    // Release the tiles of sources that no longer exist, refresh the others.
+    for (auto it = slot_by_id.begin(); it != slot_by_id.end();) {
+        auto source = sources.find(it->first);
+        Slot& slot = slots[it->second];
+        if (source == sources.end()) {
+            slot.id.clear();
+            slot.shader.reset();
+            slot.needs_clear = true;
+            it = slot_by_id.erase(it);
+        } else {
+            slot.shader = source->second;
+            ++it;
+        }
+    }
+
+    // Give new sources a free tile.
+    size_t search_start = 0;
+    for (const auto& [id, shader] : sources) {
+        if (slot_by_id.count(id)) {
+            continue;
+        }
+
+        while (search_start < slots.size() && !slots[search_start].id.empty()) {
+            search_start++;
+        }
+        if (search_start == slots.size()) {
+            if (!warned_full) {
+                ofLogWarning("PreviewAtlas") << "Atlas full, " << sources.size() - slots.size() << " sources have no preview";
+                warned_full = true;
+            }
+            break;
+        }
+
+        slots[search_start].id = id;
+        slots[search_start].shader = shader;
+        slot_by_id[id] = search_start;
+    }
+    if (sources.size() <= slots.size()) {
+        warned_full = false;
+    }
+}
+
+//--------------------------------------------------------------
+void PreviewAtlas::renderFrame(FullscreenPass& pass, float time, uint64_t frame_index) {
+    if (slots.empty()) {
+        return;
+    }
+
+    pollTimerQuery();
+
+    // Without an estimate yet, render a single tile so the first frames stay cheap.
+    int budget_tiles = 1;
+    if (has_cost_estimate && tile_cost_ms > 0.0f) {
+        budget_tiles = std::max(1, static_cast<int>(frame_budget_ms / tile_cost_ms));
+    }
+    budget_tiles = std::min(budget_tiles, static_cast<int>(slot_by_id.size()));
+
+    bool cleared = false;
+    int rendered = 0;
+    int x = 0;
+    int y = 0;
+
+    atlas_fbo.begin();
+    pass.beginFrame();
+
+    for (size_t i = 0; i < slots.size(); ++i) {
+        if (slots[i].needs_clear) {
+            getSlotOrigin(i, x, y);
+            glEnable(GL_SCISSOR_TEST);
+            glScissor(x, y, tile_width, tile_height);
+            glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+            glClear(GL_COLOR_BUFFER_BIT);
+            glDisable(GL_SCISSOR_TEST);
+            slots[i].needs_clear = false;
+            cleared = true;
+        }
+    }
+
+    bool start_query = !query_pending && budget_tiles > 0;
+    if (start_query) {
+        glBeginQuery(GL_TIME_ELAPSED, timer_query);
+    }
+
+    for (size_t visited = 0; visited < slots.size() && rendered < budget_tiles; ++visited) {
+        size_t index = next_slot;
+        next_slot = (next_slot + 1) % slots.size();
+
+        const Slot& slot = slots[index];
+        if (slot.id.empty() || !slot.shader || !slot.shader->isReady()) {
+            continue;
+        }
+
+        getSlotOrigin(index, x, y);
+        pass.getStateCache().setViewport(x, y, tile_width, tile_height);
+        // gl_FragCoord is relative to the atlas; the negated origin makes 'st' span the tile.
+        pass.draw(*slot.shader, static_cast<float>(tile_width), static_cast<float>(tile_height), time,
+                  static_cast<float>(-x), static_cast<float>(-y));
+        rendered++;
+    }
+
+    if (start_query) {
+        glEndQuery(GL_TIME_ELAPSED);
+        query_pending = true;
+        query_tile_count = rendered;
+    }
+
+    pass.endFrame();
+    glViewport(0, 0, tile_width * columns, tile_height * rows);
+    atlas_fbo.end();
+
+    tiles_last_frame = rendered;
+
+    readback_ring.collect(sink_views);
+    if (rendered > 0 || cleared) {
+        readback_ring.queueReadback(atlas_fbo.getId(), frame_index);
+    }
+}
+
+//--------------------------------------------------------------
+void PreviewAtlas::pollTimerQuery() {
+    if (!query_pending) {
+        return;
+    }
+
+    GLint available = 0;
+    glGetQueryObjectiv(timer_query, GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available) {
+        return;
+    }
+
+    GLuint64 nanoseconds = 0;
+    glGetQueryObjectui64v(timer_query, GL_QUERY_RESULT, &nanoseconds);
+    query_pending = false;
+
+    if (query_tile_count <= 0) {
+        return;
+    }
+    float ms = static_cast<float>(nanoseconds / 1000000.0) / query_tile_count;
+    tile_cost_ms = has_cost_estimate ? tile_cost_ms + (ms - tile_cost_ms) * 0.2f : ms;
+    has_cost_estimate = true;
+}
+
+//--------------------------------------------------------------
+void PreviewAtlas::getSlotOrigin(size_t slot, int& x, int& y) const {
+    x = static_cast<int>(slot % columns) * tile_width;
+    y = static_cast<int>(slot / columns) * tile_height;
+}
+
+//--------------------------------------------------------------
+bool PreviewAtlas::getPreview(const std::string& id, ofPixels& pixels, int downsample) const {
+    auto it = slot_by_id.find(id);
+    if (it == slot_by_id.end() || !has_pixels) {
+        return false;
+    }
+
+    // Every box has to lie inside the tile, or the filter reads the neighbouring tiles or past the atlas
+    downsample = std::clamp(downsample, 1, std::min(tile_width, tile_height));
+    int width = tile_width / downsample;
+    int height = tile_height / downsample;
+    pixels.allocate(width, height, OF_IMAGE_COLOR_ALPHA);
+
+    int origin_x = 0;
+    int origin_y = 0;
+    getSlotOrigin(it->second, origin_x, origin_y);
+    size_t stride = static_cast<size_t>(tile_width) * columns * 4;
+    unsigned char* destination = pixels.getData();
+
+    // Box filter each downsample x downsample block.
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            unsigned int sum[4] = {0, 0, 0, 0};
+            for (int dy = 0; dy < downsample; ++dy) {
+                const uint8_t* row = latest_pixels.data() + (origin_y + y * downsample + dy) * stride;
+                for (int dx = 0; dx < downsample; ++dx) {
+                    const uint8_t* source = row + static_cast<size_t>(origin_x + x * downsample + dx) * 4;
+                    for (int c = 0; c < 4; ++c) {
+                        sum[c] += source[c];
+                    }
+                }
+            }
+            unsigned char* target = destination + (static_cast<size_t>(y) * width + x) * 4;
+            for (int c = 0; c < 4; ++c) {
+                target[c] = static_cast<unsigned char>(sum[c] / (downsample * downsample));
+            }
+        }
+    }
+    return true;
+}
+
+//--------------------------------------------------------------
+void PreviewAtlas::draw(float x, float y, float width, float height) const {
+    atlas_fbo.draw(x, y, width, height);
+}
+
+//--------------------------------------------------------------
+void PreviewAtlas::consumeFrame(const uint8_t* pixels, int width, int height, uint64_t /*frame_index*/) {
+    latest_pixels.assign(pixels, pixels + static_cast<size_t>(width) * height * 4);
+    has_pixels = true;
+}
+
+//--------------------------------------------------------------
+size_t PreviewAtlas::getSourceCount() const {
+    return slot_by_id.size();
+}
+
+//--------------------------------------------------------------
+size_t PreviewAtlas::getCapacity() const {
+    return slots.size();
+}
+
+//--------------------------------------------------------------
+int PreviewAtlas::getTilesLastFrame() const {
+    return tiles_last_frame;
+}
+
+//--------------------------------------------------------------
+float PreviewAtlas::getEstimatedTileMilliseconds() const {
+    return tile_cost_ms;
+}
@@ -0,0 +1,147 @@
+#pragma once
+#include "ofMain.h"
+#include "FullscreenPass.h"
+#include "FrameSink.h"
+#include "PboReadbackRing.h"
+#include "ShmFrameSink.h"
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @class PreviewAtlas
+ * @brief Renders small live previews of many shaders into one shared atlas framebuffer.
+ * @details Every preview source gets a fixed tile of the atlas for as long as it exists.
+ *          Each frame, tiles are rendered round-robin until the per-frame GPU budget is
+ *          used up; the budget is enforced with an estimate of the cost per tile taken from
+ *          asynchronous timer queries, so the atlas costs a fixed slice of the frame no
+ *          matter how many shaders exist. A tile is drawn with the tile size as 'resolution'
+ *          and the negated tile position as 'tileOffset', so 'st' spans the tile.
+ *
+ *          The atlas is read back asynchronously after each update. The latest CPU copy
+ *          serves single previews (e.g. over OSC) and can be published to a shared-memory
+ *          ring like the output tap.
+ */
+class PreviewAtlas : public FrameSink {
+public:
+    PreviewAtlas();
+    ~PreviewAtlas() override;
+
+    /**
+     * @brief Allocates the atlas. Requires a current GL context.
+     * @param tile_width The width of one preview in pixels.
+     * @param tile_height The height of one preview in pixels.
+     * @param columns The number of tiles per atlas row.
+     * @param rows The number of tile rows.
+     * @return True on success, false otherwise.
+     */
+    bool setup(int tile_width, int tile_height, int columns, int rows);
+
+    /**
+     * @brief Publishes the atlas into a POSIX shared-memory ring.
+     * @param name The shared-memory name, starting with '/'.
+     * @return True if the ring was created.
+     */
+    bool addSharedMemorySink(const std::string& name);
+
+    /**
+     * @brief Sets the GPU time per frame available for previews.
+     * @param milliseconds The budget; at least one tile is rendered per frame regardless.
+     */
+    void setFrameBudget(float milliseconds);
+
+    /**
+     * @brief Assigns tiles to the current set of preview sources.
+     * @details Sources keep their tile while they exist; tiles of removed sources are cleared.
+     * @param sources The shaders to preview, by ID.
+     */
+    void setSources(const std::map<std::string, std::shared_ptr<ShaderNode>>& sources);
+
+    /**
+     * @brief Renders the next tiles within the budget and queues the atlas readback.
+     * @param pass The fullscreen pass used for drawing.
+     * @param time The shader time in seconds.
+     * @param frame_index The engine frame index stored with the readback.
+     */
+    void renderFrame(FullscreenPass& pass, float time, uint64_t frame_index);
+
+    /**
+     * @brief Copies the latest read-back preview of one source.
+     * @param id The source ID.
+     * @param pixels Receives the RGBA8 preview, bottom row first.
+     * @param downsample Integer box-filter factor applied to the tile (1 for full size), clamped
+     *                   to the shorter tile side.
+     * @return True if the source has a tile and the atlas has been read back at least once.
+     */
+    bool getPreview(const std::string& id, ofPixels& pixels, int downsample = 1) const;
+
+    /**
+     * @brief Draws the atlas, e.g. as a debug overlay.
+     */
+    void draw(float x, float y, float width, float height) const;
+
+    /**
+     * @brief Receives completed atlas readbacks.
+     */
+    void consumeFrame(const uint8_t* pixels, int width, int height, uint64_t frame_index) override;
+
+    size_t getSourceCount() const;
+    size_t getCapacity() const;
+
+    /**
+     * @brief Gets the number of tiles rendered in the last frame.
+     */
+    int getTilesLastFrame() const;
+
+    /**
+     * @brief Gets the estimated GPU time of one tile in milliseconds.
+     */
+    float getEstimatedTileMilliseconds() const;
+
+private:
+    /**
+     * @struct Slot
+     * @brief One tile of the atlas.
+     */
+    struct Slot {
+        std::string id;                         ///< Source ID, empty if the slot is free.
+        std::shared_ptr<ShaderNode> shader;     ///< The previewed shader.
+        bool needs_clear = false;               ///< True if a removed source left content behind.
+    };
+
+    /**
+     * @brief Gets the atlas pixel position of a slot (GL orientation).
+     */
+    void getSlotOrigin(size_t slot, int& x, int& y) const;
+
+    /**
+     * @brief Reads a finished timer query without blocking and updates the tile cost estimate.
+     */
+    void pollTimerQuery();
+
+    ofFbo atlas_fbo;                            ///< The shared atlas.
+    PboReadbackRing readback_ring;              ///< Asynchronous readback of the atlas.
+    std::vector<std::unique_ptr<FrameSink>> sinks; ///< Owned external consumers.
+    std::vector<FrameSink*> sink_views;         ///< This atlas and the external consumers.
+    std::vector<uint8_t> latest_pixels;         ///< Last read-back atlas, bottom row first.
+    bool has_pixels;                            ///< True once a readback has arrived.
+
+    std::vector<Slot> slots;                    ///< Tiles, row-major from the bottom left.
+    std::map<std::string, size_t> slot_by_id;   ///< Slot of each source.
+    size_t next_slot;                           ///< Round-robin position.
+    bool warned_full;                           ///< True once a full atlas has been reported.
+
+    int tile_width;                             ///< Preview width in pixels.
+    int tile_height;                            ///< Preview height in pixels.
+    int columns;                                ///< Tiles per row.
+    int rows;                                   ///< Tile rows.
+
+    GLuint timer_query;                         ///< GL_TIME_ELAPSED query of one frame's tiles.
+    bool query_pending;                         ///< True while the query result has not been read.
+    int query_tile_count;                       ///< Tiles measured by the pending query.
+    float frame_budget_ms;                      ///< GPU budget per frame.
+    float tile_cost_ms;                         ///< Moving average of the GPU time of one tile.
+    bool has_cost_estimate;                     ///< False until a timer query has completed.
+    int tiles_last_frame;                       ///< Tiles rendered in the last frame.
+};
@@ -0,0 +1,64 @@
+#include "RawFileFrameSink.h"
+
+//--------------------------------------------------------------
+RawFileFrameSink::RawFileFrameSink()
+    : output(nullptr)
+    , owns_output(false)
+    , bytes_written(0) {
+}
+
+//--------------------------------------------------------------
+RawFileFrameSink::~RawFileFrameSink() {
+    close();
+}
+
+//--------------------------------------------------------------
+bool RawFileFrameSink::open(const std::string& path) {
+    close();
+    if (path == "-") {
+        output = stdout;
+        owns_output = false;
+    } else {
+        output = std::fopen(path.c_str(), "wb");
+        owns_output = true;
+    }
+
+    if (!output) {
+        ofLogError("RawFileFrameSink") << "Cannot open raw frame output: " << path;
+        return false;
+    }
+    ofLogNotice("RawFileFrameSink") << "Writing raw RGBA frames to " << path;
+    return true;
+}
+
+//--------------------------------------------------------------
+void RawFileFrameSink::close() {
+    if (!output) {
+        return;
+    }
+    std::fflush(output);
+    if (owns_output) {
+        std::fclose(output);
+    }
+    output = nullptr;
+}
+
+//--------------------------------------------------------------
+void RawFileFrameSink::consumeFrame(const uint8_t* pixels, int width, int height, uint64_t frame_index) {
+    if (!output) {
+        return;
+    }
+
+    size_t frame_bytes = static_cast<size_t>(width) * height * 4;
+    if (std::fwrite(pixels, 1, frame_bytes, output) != frame_bytes) {
+        ofLogError("RawFileFrameSink") << "Short write on frame " << frame_index << ", closing output";
+        close();
+        return;
+    }
+    bytes_written += frame_bytes;
+}
+
+//--------------------------------------------------------------
+uint64_t RawFileFrameSink::getBytesWritten() const {
+    return bytes_written;
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include "ofMain.h"
+#include "FrameSink.h"
+#include <cstdio>
+
+/**
+ * @class RawFileFrameSink
+ * @brief Appends frames back to back as headerless RGBA8 to a file or stdout.
+ * @details The output can be read with e.g. 'ffmpeg -f rawvideo -pix_fmt rgba -s WxH -i FILE'
+ *          (add '-vf vflip', frames are bottom row first).
+ */
+class RawFileFrameSink : public FrameSink {
+public:
+    RawFileFrameSink();
+    ~RawFileFrameSink() override;
+
+    /**
+     * @brief Opens the output.
+     * @param path The file path, or "-" for stdout.
+     * @return True on success, false otherwise.
+     */
+    bool open(const std::string& path);
+
+    /**
+     * @brief Flushes and closes the output.
+     */
+    void close();
+
+    void consumeFrame(const uint8_t* pixels, int width, int height, uint64_t frame_index) override;
+
+    /**
+     * @brief Gets the number of bytes written so far.
+     */
+    uint64_t getBytesWritten() const;
+
+private:
+    FILE* output;               ///< The open output, or nullptr.
+    bool owns_output;           ///< False when writing to stdout.
+    uint64_t bytes_written;     ///< Bytes written so far.
+};
@@ -0,0 +1,158 @@
+#include "RenderOutput.h"
+
+//--------------------------------------------------------------
+RenderOutput::RenderOutput()
+    : timer_queries{0, 0}
+    , query_pending{false, false}
+    , next_query(0)
+    , last_gpu_ms(0.0)
+    , last_cpu_ms(0.0) {
+}
+
+//--------------------------------------------------------------
+RenderOutput::~RenderOutput() {
+    if (timer_queries[0] != 0) {
+        glDeleteQueries(2, timer_queries);
+    }
+}
+
+//--------------------------------------------------------------
+bool RenderOutput::setup(const std::string& output_name, int width, int height) {
+    if (width <= 0 || height <= 0) {
+        ofLogError("RenderOutput") << "Invalid size for output " << output_name;
+        return false;
+    }
+
+    name = output_name;
+    if (!tap.setup(width, height)) {
+        return false;
+    }
+    if (timer_queries[0] == 0) {
+        glGenQueries(2, timer_queries);
+    }
+
+    ofLogNotice("RenderOutput") << "Output " << name << " at " << width << "x" << height;
+    return true;
+}
+
+//--------------------------------------------------------------
+bool RenderOutput::addSharedMemorySink(const std::string& sink_name) {
+    if (!tap.addSharedMemorySink(sink_name)) {
+        return false;
+    }
+    shm_name = sink_name;
+    return true;
+}
+
+//--------------------------------------------------------------
+void RenderOutput::setWindowRect(const ofRectangle& rect) {
+    window_rect = rect;
+}
+
+//--------------------------------------------------------------
+void RenderOutput::connect(std::shared_ptr<ShaderNode> connected_shader, const std::string& node_id) {
+    shader = std::move(connected_shader);
+    output_node_id = node_id;
+}
+
+//--------------------------------------------------------------
+void RenderOutput::render(FullscreenPass& pass, const RenderProgram& program, float time, uint64_t frame_index) {
+    uint64_t start = ofGetElapsedTimeMicros();
+    pollTimerQuery();
+
+    // Keep publishing (black) frames while nothing is connected, like the output tap.
+    tap.beginFrame();
+    if (program.shader && program.linked) {
+        bool measure = !query_pending[next_query];
+        if (measure) {
+            glBeginQuery(GL_TIME_ELAPSED, timer_queries[next_query]);
+        }
+        pass.beginFrame();
+        pass.draw(program, tap.getWidth(), tap.getHeight(), time);
+        pass.endFrame();
+        if (measure) {
+            glEndQuery(GL_TIME_ELAPSED);
+            query_pending[next_query] = true;
+            next_query = 1 - next_query;
+        }
+    }
+    tap.endFrame(frame_index);
+
+    last_cpu_ms = (ofGetElapsedTimeMicros() - start) / 1000.0;
+}
+
+//--------------------------------------------------------------
+void RenderOutput::pollTimerQuery() {
+    for (int i = 0; i < 2; ++i) {
+        if (!query_pending[i]) {
+            continue;
+        }
+        GLint available = 0;
+        glGetQueryObjectiv(timer_queries[i], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) {
+            continue;
+        }
+        GLuint64 nanoseconds = 0;
+        glGetQueryObjectui64v(timer_queries[i], GL_QUERY_RESULT, &nanoseconds);
+        query_pending[i] = false;
+        last_gpu_ms = nanoseconds / 1000000.0;
+    }
+}
+
+//--------------------------------------------------------------
+void RenderOutput::draw(const ofRectangle& rect) const {
+    if (rect.isEmpty()) {
+        return;
+    }
+    tap.draw(rect.x, rect.y, rect.width, rect.height);
+}
+
+//--------------------------------------------------------------
+const std::string& RenderOutput::getName() const {
+    return name;
+}
+
+//--------------------------------------------------------------
+const ofRectangle& RenderOutput::getWindowRect() const {
+    return window_rect;
+}
+
+//--------------------------------------------------------------
+const std::shared_ptr<ShaderNode>& RenderOutput::getShader() const {
+    return shader;
+}
+
+//--------------------------------------------------------------
+const std::string& RenderOutput::getOutputNodeId() const {
+    return output_node_id;
+}
+
+//--------------------------------------------------------------
+const std::string& RenderOutput::getSharedMemoryName() const {
+    return shm_name;
+}
+
+//--------------------------------------------------------------
+int RenderOutput::getWidth() const {
+    return static_cast<int>(tap.getWidth());
+}
+
+//--------------------------------------------------------------
+int RenderOutput::getHeight() const {
+    return static_cast<int>(tap.getHeight());
+}
+
+//--------------------------------------------------------------
+double RenderOutput::getLastGpuMilliseconds() const {
+    return last_gpu_ms;
+}
+
+//--------------------------------------------------------------
+double RenderOutput::getLastCpuMilliseconds() const {
+    return last_cpu_ms;
+}
+
+//--------------------------------------------------------------
+const OutputTap& RenderOutput::getTap() const {
+    return tap;
+}
@@ -0,0 +1,110 @@
+#pragma once
+#include "ofMain.h"
+#include "FullscreenPass.h"
+#include "OutputTap.h"
+#include <memory>
+#include <string>
+
+/**
+ * @class RenderOutput
+ * @brief A named output with its own connected shader and resolution, e.g. one projector.
+ * @details Every output renders into its own framebuffer through the engine's single GL
+ *          context and fullscreen pass, so shader programs are shared between outputs: a
+ *          shader connected to several outputs is compiled once and drawn once per output.
+ *
+ *          The framebuffer is drawn into a rectangle of the window (for a desktop spanning
+ *          several projectors) and can be published to a shared-memory ring for other
+ *          processes. Each frame's GPU time is measured with a pair of timer queries that
+ *          are read without blocking.
+ */
+class RenderOutput {
+public:
+    RenderOutput();
+    ~RenderOutput();
+
+    /**
+     * @brief Allocates the output. Requires a current GL context.
+     * @param name The output name used by /connect.
+     * @param width The output width in pixels.
+     * @param height The output height in pixels.
+     * @return True on success, false otherwise.
+     */
+    bool setup(const std::string& name, int width, int height);
+
+    /**
+     * @brief Publishes the output into a POSIX shared-memory ring.
+     * @param sink_name The shared-memory name, starting with '/'.
+     * @return True if the ring was created.
+     */
+    bool addSharedMemorySink(const std::string& sink_name);
+
+    /**
+     * @brief Sets the window rectangle the output is drawn to; an empty rectangle hides it.
+     */
+    void setWindowRect(const ofRectangle& rect);
+
+    /**
+     * @brief Connects a shader, replacing the previous one.
+     * @param shader The shader to render, or nullptr to disconnect.
+     * @param output_node_id The composition node the shader was compiled from, empty for plain shaders.
+     */
+    void connect(std::shared_ptr<ShaderNode> shader, const std::string& output_node_id);
+
+    /**
+     * @brief Renders a program into the output framebuffer.
+     * @details The program comes from the render snapshot rather than connect(), so the
+     *          render loop never reads state the control side is changing.
+     * @param pass The fullscreen pass used for drawing.
+     * @param program The program to render; an empty one publishes a black frame.
+     * @param time The shader time in seconds.
+     * @param frame_index The engine frame index stored with published frames.
+     */
+    void render(FullscreenPass& pass, const RenderProgram& program, float time, uint64_t frame_index);
+
+    /**
+     * @brief Draws the output into a window rectangle; an empty rectangle draws nothing.
+     */
+    void draw(const ofRectangle& rect) const;
+
+    const std::string& getName() const;
+    const ofRectangle& getWindowRect() const;
+    const std::shared_ptr<ShaderNode>& getShader() const;
+    const std::string& getOutputNodeId() const;
+    const std::string& getSharedMemoryName() const;
+    int getWidth() const;
+    int getHeight() const;
+
+    /**
+     * @brief Gets the GPU time of the most recently measured frame in milliseconds.
+     */
+    double getLastGpuMilliseconds() const;
+
+    /**
+     * @brief Gets the CPU time of the last render() in milliseconds.
+     */
+    double getLastCpuMilliseconds() const;
+
+    /**
+     * @brief Gets the capture tap, e.g. for its readback statistics.
+     */
+    const OutputTap& getTap() const;
+
+private:
+    /**
+     * @brief Reads the pending timer query if its result is available.
+     */
+    void pollTimerQuery();
+
+    std::string name;                       ///< Output name.
+    OutputTap tap;                          ///< Framebuffer, readback and sinks.
+    ofRectangle window_rect;                ///< Where the output is drawn in the window.
+    std::string shm_name;                   ///< Shared-memory ring of the output, empty for none.
+    std::shared_ptr<ShaderNode> shader;     ///< The connected shader.
+    std::string output_node_id;             ///< Composition node of the connected shader.
+
+    GLuint timer_queries[2];                ///< Alternating GL_TIME_ELAPSED queries.
+    bool query_pending[2];                  ///< True while a query result has not been read.
+    int next_query;                         ///< Query used by the next frame.
+    double last_gpu_ms;                     ///< Last measured GPU time.
+    double last_cpu_ms;                     ///< CPU time of the last render().
+};
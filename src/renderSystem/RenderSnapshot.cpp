@@ -0,0 +1,96 @@
+#include "RenderSnapshot.h"
+#include "RenderOutput.h"
+#include "../shaderSystem/HeatmapVariant.h"
+
+//--------------------------------------------------------------
+RenderProgram RenderProgram::capture(const std::shared_ptr<ShaderNode>& shader) {
+    RenderProgram program;
+    program.shader = shader;
+    if (shader) {
+        program.linked = shader->program;
+        if (shader->parameter_block) {
+            program.parameters = shader->parameter_block->getData();
+            program.parameter_revision = shader->parameter_block->getRevision();
+        }
+    }
+    return program;
+}
+
+//--------------------------------------------------------------
+bool RenderProgram::isCurrent(const std::shared_ptr<ShaderNode>& other) const {
+    if (shader != other) {
+        return false;
+    }
+    if (!shader) {
+        return true;
+    }
+    return linked == shader->program &&
+           (!shader->parameter_block || parameter_revision == shader->parameter_block->getRevision());
+}
+
+//--------------------------------------------------------------
+RenderSnapshotExchange::RenderSnapshotExchange()
+    : current(nullptr)
+    , global_epoch(1)
+    , reader_epoch(quiescent)
+    , next_version(1) {
+}
+
+//--------------------------------------------------------------
+RenderSnapshotExchange::~RenderSnapshotExchange() {
+    delete current.exchange(nullptr);
+    for (const Retired& entry : retired) {
+        delete entry.snapshot;
+    }
+}
+
+//--------------------------------------------------------------
+void RenderSnapshotExchange::publish(std::unique_ptr<RenderSnapshot> snapshot) {
+    snapshot->version = next_version++;
+    RenderSnapshot* previous = current.exchange(snapshot.release());
+
+    // A reader announcing this epoch or a later one started after the exchange
+    uint64_t epoch = global_epoch.fetch_add(1) + 1;
+    if (previous) {
+        std::lock_guard<std::mutex> lock(retired_mutex);
+        retired.push_back({previous, epoch});
+    }
+}
+
+//--------------------------------------------------------------
+const RenderSnapshot* RenderSnapshotExchange::beginRead() {
+    reader_epoch.store(global_epoch.load());
+    return current.load();
+}
+
+//--------------------------------------------------------------
+void RenderSnapshotExchange::endRead() {
+    reader_epoch.store(quiescent);
+}
+
+//--------------------------------------------------------------
+size_t RenderSnapshotExchange::collect() {
+    std::unique_lock<std::mutex> lock(retired_mutex, std::try_to_lock);
+    if (!lock.owns_lock()) {
+        return 0;
+    }
+
+    uint64_t reading = reader_epoch.load();
+    size_t freed = 0;
+    for (auto it = retired.begin(); it != retired.end();) {
+        if (reading == quiescent || reading >= it->epoch) {
+            delete it->snapshot;
+            it = retired.erase(it);
+            freed++;
+        } else {
+            ++it;
+        }
+    }
+    return freed;
+}
+
+//--------------------------------------------------------------
+size_t RenderSnapshotExchange::getRetiredCount() const {
+    std::lock_guard<std::mutex> lock(retired_mutex);
+    return retired.size();
+}
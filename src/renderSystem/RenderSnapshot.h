@@ -0,0 +1,135 @@
+#pragma once
+#include "ofMain.h"
+#include "../shaderSystem/ShaderNode.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class RenderOutput;
+class HeatmapVariant;
+
+/**
+ * @struct RenderProgram
+ * @brief A program as the render loop should draw it.
+ * @details The linked program and the parameter values are taken at publication. Reloading
+ *          the shader or setting parameters afterwards does not change what is drawn.
+ */
+struct RenderProgram {
+    std::shared_ptr<ShaderNode> shader;             ///< Fields, texture inputs and parameter block; null draws nothing.
+    std::shared_ptr<const LinkedProgram> linked;    ///< The shader's program at publication.
+    std::vector<float> parameters;                  ///< Parameter block contents at publication, empty without ports.
+    uint64_t parameter_revision = 0;                ///< ParameterBlock revision the parameters were copied at.
+
+    /**
+     * @brief Takes the current program and parameter values of a shader.
+     * @param shader The shader, or null for an empty program.
+     */
+    static RenderProgram capture(const std::shared_ptr<ShaderNode>& shader);
+
+    /**
+     * @brief Checks whether capture(other) would return the same program, without copying anything.
+     */
+    bool isCurrent(const std::shared_ptr<ShaderNode>& other) const;
+};
+
+/**
+ * @struct RenderSnapshot
+ * @brief Immutable render state published by the control side.
+ * @details Holds everything the render loop needs for a frame: the programs of the main and
+ *          named outputs, copies of their parameter blocks and the output layout. Shared
+ *          pointers keep programs and framebuffers alive while a snapshot references them,
+ *          even if the control side has already dropped or reloaded them.
+ */
+struct RenderSnapshot {
+    /**
+     * @struct Output
+     * @brief One named output.
+     */
+    struct Output {
+        std::string name;                       ///< Output name.
+        std::shared_ptr<RenderOutput> target;   ///< Framebuffer and sinks.
+        RenderProgram program;                  ///< What the output shows.
+        ofRectangle window_rect;                ///< Where the output is drawn in the window.
+    };
+
+    uint64_t version = 0;                       ///< Increases with every publication.
+    RenderProgram main;                         ///< The main output.
+    std::shared_ptr<HeatmapVariant> heatmap;    ///< Cost heatmap of main, if enabled; its counters belong to the render loop.
+    RenderProgram heatmap_program;              ///< The instrumented variant drawn instead of main while heatmap is set.
+    std::vector<Output> outputs;                ///< Named outputs in name order.
+};
+
+/**
+ * @class RenderSnapshotExchange
+ * @brief Hands immutable RenderSnapshots from the control side to the render loop.
+ * @details Read-copy-update with epoch-based reclamation. publish() swaps the current
+ *          snapshot with one atomic exchange and retires the previous one tagged with a
+ *          new epoch. The render loop announces the epoch it reads in, picks up the
+ *          latest snapshot with a single atomic load and leaves the epoch when the frame
+ *          is done. A retired snapshot is freed once the reader is quiescent or has
+ *          entered a later epoch, so a snapshot is never freed while a frame uses it and
+ *          neither side ever waits for the other.
+ *
+ *          Reclamation runs in collect() on the render thread, so the GL objects of
+ *          dropped programs are always destroyed on the thread that owns the context.
+ *          There is exactly one reader, the render loop.
+ */
+class RenderSnapshotExchange {
+public:
+    RenderSnapshotExchange();
+    ~RenderSnapshotExchange();
+
+    RenderSnapshotExchange(const RenderSnapshotExchange&) = delete;
+    RenderSnapshotExchange& operator=(const RenderSnapshotExchange&) = delete;
+
+    /**
+     * @brief Makes a snapshot current. Called on the control side.
+     * @param snapshot The new state; its version is assigned here.
+     */
+    void publish(std::unique_ptr<RenderSnapshot> snapshot);
+
+    /**
+     * @brief Enters the read epoch and returns the latest snapshot. Called by the render loop.
+     * @return The snapshot, valid until endRead(), or nullptr if nothing was published yet.
+     */
+    const RenderSnapshot* beginRead();
+
+    /**
+     * @brief Leaves the read epoch; the snapshot from beginRead() must not be used afterwards.
+     */
+    void endRead();
+
+    /**
+     * @brief Frees retired snapshots the reader can no longer see. Called by the render loop.
+     * @details Never waits: if the control side is publishing at that moment, the work is
+     *          left for the next call.
+     * @return The number of snapshots freed.
+     */
+    size_t collect();
+
+    /**
+     * @brief Gets the number of retired snapshots not freed yet.
+     */
+    size_t getRetiredCount() const;
+
+private:
+    static constexpr uint64_t quiescent = UINT64_MAX;   ///< Reader epoch outside beginRead()/endRead().
+
+    /**
+     * @struct Retired
+     * @brief A replaced snapshot and the epoch in which it was replaced.
+     */
+    struct Retired {
+        RenderSnapshot* snapshot;
+        uint64_t epoch;
+    };
+
+    std::atomic<RenderSnapshot*> current;       ///< The latest published snapshot.
+    std::atomic<uint64_t> global_epoch;         ///< Advanced by every publication.
+    std::atomic<uint64_t> reader_epoch;         ///< Epoch the render loop reads in, or quiescent.
+    uint64_t next_version;                      ///< Version of the next publication (control side).
+    mutable std::mutex retired_mutex;           ///< Guards retired between publisher and collector.
+    std::vector<Retired> retired;               ///< Replaced snapshots waiting to be freed.
+};
@@ -0,0 +1,147 @@
+#include "ShaderBenchmark.h"
+#include "../statsSystem/AllocationTracker.h"
+#include <algorithm>
+#include <cmath>
+
+//--------------------------------------------------------------
+ShaderBenchmark::ShaderBenchmark()
+    : frames_per_update(4) {
+}
+
+//--------------------------------------------------------------
+ShaderBenchmark::~ShaderBenchmark() {
+    for (auto& job : jobs) {
+        if (!job.queries.empty()) {
+            glDeleteQueries(static_cast<GLsizei>(job.queries.size()), job.queries.data());
+        }
+    }
+}
+
+//--------------------------------------------------------------
+bool ShaderBenchmark::start(const std::string& id, std::shared_ptr<ShaderNode> shader, int width, int height, int frames) {
+    if (!shader || !shader->isReady()) {
+        ofLogError("ShaderBenchmark") << "Shader not ready for benchmark: " << id;
+        return false;
+    }
+    if (width <= 0 || height <= 0) {
+        ofLogError("ShaderBenchmark") << "Invalid benchmark resolution " << width << "x" << height;
+        return false;
+    }
+
+    Job job;
+    job.result.id = id;
+    job.result.width = width;
+    job.result.height = height;
+    job.result.frames = std::clamp(frames, 1, 1000);
+    job.result.compile_ms = shader->metadata->compile_milliseconds;
+    job.result.link_ms = shader->metadata->link_milliseconds;
+    job.shader = shader;
+    jobs.push_back(std::move(job));
+
+    ofLogNotice("ShaderBenchmark") << "Queued benchmark of " << id << ": " << jobs.back().result.frames
+                                   << " frames at " << width << "x" << height;
+    return true;
+}
+
+//--------------------------------------------------------------
+void ShaderBenchmark::update(FullscreenPass& pass, float time) {
+    if (jobs.empty()) {
+        return;
+    }
+
+    Job& job = jobs.front();
+    if (job.queries.empty()) {
+        job.queries.resize(job.result.frames);
+        glGenQueries(static_cast<GLsizei>(job.queries.size()), job.queries.data());
+        job.start_time = time;
+        if (!target.isAllocated() || target.getWidth() != job.result.width || target.getHeight() != job.result.height) {
+            target.allocate(job.result.width, job.result.height, GL_RGBA8);
+        }
+    }
+
+    int batch = std::min(frames_per_update, job.result.frames - job.rendered);
+    if (batch > 0) {
+        AllocationRequestScope allocation_request;
+        target.begin();
+        pass.beginFrame();
+        pass.getStateCache().setViewport(0, 0, job.result.width, job.result.height);
+        for (int i = 0; i < batch; ++i, ++job.rendered) {
+            // Advance time like a 60 Hz output so time-dependent shaders do real work
+            float frame_time = job.start_time + job.rendered / 60.0f;
+            glBeginQuery(GL_TIME_ELAPSED, job.queries[job.rendered]);
+            pass.draw(*job.shader, static_cast<float>(job.result.width), static_cast<float>(job.result.height), frame_time);
+            glEndQuery(GL_TIME_ELAPSED);
+        }
+        pass.endFrame();
+        target.end();
+        AllocationCounters allocated = allocation_request.getTotal();
+        job.allocations += allocated.allocations;
+        job.allocated_bytes += allocated.bytes;
+    }
+
+    collectTimings(job);
+    if (static_cast<int>(job.gpu_ms.size()) == job.result.frames) {
+        finish(job);
+        jobs.pop_front();
+    }
+}
+
+//--------------------------------------------------------------
+void ShaderBenchmark::collectTimings(Job& job) {
+    // Queries complete in submission order
+    while (job.gpu_ms.size() < static_cast<size_t>(job.rendered)) {
+        GLuint query = job.queries[job.gpu_ms.size()];
+        GLint available = 0;
+        glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) {
+            return;
+        }
+        GLuint64 nanoseconds = 0;
+        glGetQueryObjectui64v(query, GL_QUERY_RESULT, &nanoseconds);
+        job.gpu_ms.push_back(nanoseconds / 1000000.0);
+    }
+}
+
+//--------------------------------------------------------------
+void ShaderBenchmark::finish(Job& job) {
+    glDeleteQueries(static_cast<GLsizei>(job.queries.size()), job.queries.data());
+    job.queries.clear();
+
+    std::vector<double> sorted = job.gpu_ms;
+    std::sort(sorted.begin(), sorted.end());
+    size_t count = sorted.size();
+    job.result.median_ms = (count % 2 == 1) ? sorted[count / 2] : (sorted[count / 2 - 1] + sorted[count / 2]) * 0.5;
+    // Nearest-rank percentile
+    size_t p95_rank = static_cast<size_t>(std::ceil(0.95 * count));
+    job.result.p95_ms = sorted[std::max<size_t>(p95_rank, 1) - 1];
+    job.result.allocations_per_frame = static_cast<double>(job.allocations) / count;
+    job.result.allocated_bytes_per_frame = static_cast<double>(job.allocated_bytes) / count;
+
+    ofLogNotice("ShaderBenchmark") << "Benchmark of " << job.result.id << ": median " << job.result.median_ms
+                                   << " ms, p95 " << job.result.p95_ms << " ms";
+    if (AllocationTracker::isEnabled()) {
+        ofLogNotice("ShaderBenchmark") << "  " << job.result.allocations_per_frame << " allocations, "
+                                       << job.result.allocated_bytes_per_frame << " bytes per frame";
+    }
+    finished.push_back(job.result);
+}
+
+//--------------------------------------------------------------
+bool ShaderBenchmark::pollResult(Result& result) {
+    if (finished.empty()) {
+        return false;
+    }
+    result = finished.front();
+    finished.pop_front();
+    return true;
+}
+
+//--------------------------------------------------------------
+void ShaderBenchmark::setFramesPerUpdate(int frames) {
+    frames_per_update = std::max(frames, 1);
+}
+
+//--------------------------------------------------------------
+bool ShaderBenchmark::isBusy() const {
+    return !jobs.empty();
+}
@@ -0,0 +1,106 @@
+#pragma once
+#include "ofMain.h"
+#include "FullscreenPass.h"
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @class ShaderBenchmark
+ * @brief Measures the GPU cost of shaders offscreen, without touching the live output.
+ * @details Each benchmark renders its shader into a private framebuffer at a fixed size
+ *          for a number of frames, every frame wrapped in its own GL_TIME_ELAPSED query.
+ *          A few benchmark frames are rendered per engine frame and the queries are read
+ *          without blocking, so a long benchmark is spread over several frames instead of
+ *          stalling one. Benchmarks run one after another in request order.
+ */
+class ShaderBenchmark {
+public:
+    /**
+     * @struct Result
+     * @brief The outcome of one finished benchmark.
+     */
+    struct Result {
+        std::string id;             ///< The benchmarked shader ID.
+        int width = 0;              ///< Render width in pixels.
+        int height = 0;             ///< Render height in pixels.
+        int frames = 0;             ///< Number of measured frames.
+        double median_ms = 0.0;     ///< Median GPU time per frame.
+        double p95_ms = 0.0;        ///< 95th percentile GPU time per frame.
+        double compile_ms = 0.0;    ///< Time spent compiling the shader stages.
+        double link_ms = 0.0;       ///< Time spent linking the program.
+        double allocations_per_frame = 0.0;     ///< CPU heap allocations per drawn frame, with GE_TRACK_ALLOCATIONS.
+        double allocated_bytes_per_frame = 0.0; ///< CPU heap bytes per drawn frame, with GE_TRACK_ALLOCATIONS.
+    };
+
+    ShaderBenchmark();
+    ~ShaderBenchmark();
+
+    /**
+     * @brief Queues a benchmark.
+     * @param id The shader ID reported with the result.
+     * @param shader The compiled shader.
+     * @param width The render width in pixels.
+     * @param height The render height in pixels.
+     * @param frames The number of frames to measure, clamped to [1, 1000].
+     * @return True if the benchmark was queued, false if the shader is not ready.
+     */
+    bool start(const std::string& id, std::shared_ptr<ShaderNode> shader, int width, int height, int frames);
+
+    /**
+     * @brief Renders the next frames of the running benchmark and collects finished timings.
+     * @details Requires a current GL context; call once per frame.
+     * @param pass The fullscreen pass used for drawing.
+     * @param time The shader time of the first benchmark frame.
+     */
+    void update(FullscreenPass& pass, float time);
+
+    /**
+     * @brief Takes the next finished result.
+     * @param result Receives the result.
+     * @return True if a result was available.
+     */
+    bool pollResult(Result& result);
+
+    /**
+     * @brief Sets how many benchmark frames are rendered per engine frame.
+     */
+    void setFramesPerUpdate(int frames);
+
+    /**
+     * @brief Checks whether benchmarks are queued or running.
+     */
+    bool isBusy() const;
+
+private:
+    /**
+     * @struct Job
+     * @brief A queued or running benchmark.
+     */
+    struct Job {
+        Result result;                          ///< Filled in as the benchmark progresses.
+        std::shared_ptr<ShaderNode> shader;     ///< Kept alive until the benchmark finishes.
+        int rendered = 0;                       ///< Frames submitted so far.
+        float start_time = 0.0f;                ///< Shader time of the first frame.
+        std::vector<GLuint> queries;            ///< One timer query per frame.
+        std::vector<double> gpu_ms;             ///< Collected frame times.
+        uint64_t allocations = 0;               ///< Heap allocations while drawing the frames.
+        uint64_t allocated_bytes = 0;           ///< Heap bytes allocated while drawing the frames.
+    };
+
+    /**
+     * @brief Reads the available timer queries of a job without blocking.
+     */
+    void collectTimings(Job& job);
+
+    /**
+     * @brief Computes the statistics of a completed job and releases its queries.
+     */
+    void finish(Job& job);
+
+    std::deque<Job> jobs;                       ///< Pending benchmarks; the front one is running.
+    std::deque<Result> finished;                ///< Results not yet taken.
+    ofFbo target;                               ///< Offscreen render target.
+    int frames_per_update;                      ///< Benchmark frames per engine frame.
+};
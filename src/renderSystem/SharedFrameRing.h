@@ -0,0 +1,246 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @file SharedFrameRing.h
+ * @brief Memory layout of the shared-memory frame ring and a header-only consumer API.
+ * @details The engine publishes frames into a POSIX shared-memory object laid out as
+ *
+ *              [SharedFrameRingHeader][SharedFrameSlot x slot_count][frame data x slot_count]
+ *
+ *          Each slot is protected by a sequence counter (odd while being written, even
+ *          once complete), so readers never block the engine and simply retry when they
+ *          catch a slot mid-write. This header has no engine dependencies; external
+ *          recorders, LED mappers or streamers can include it on its own.
+ */
+
+namespace SharedFrameRing {
+
+/// Identifies a frame ring ("GEFR").
+constexpr uint32_t MAGIC = 0x52464547u;
+/// Incremented whenever the layout changes.
+constexpr uint32_t VERSION = 1;
+/// Alignment of the slot table and of each frame.
+constexpr size_t ALIGNMENT = 64;
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "The shared frame ring requires lock-free 64-bit atomics");
+
+/**
+ * @struct SharedFrameRingHeader
+ * @brief Fixed header at the start of the shared-memory object.
+ */
+struct SharedFrameRingHeader {
+    uint32_t magic;                         ///< MAGIC once the producer finished initializing.
+    uint32_t version;                       ///< Layout version, VERSION.
+    uint32_t width;                         ///< Frame width in pixels.
+    uint32_t height;                        ///< Frame height in pixels.
+    uint32_t channels;                      ///< Bytes per pixel (4, RGBA8).
+    uint32_t slot_count;                    ///< Number of frames in the ring.
+    uint64_t frame_bytes;                   ///< Size of one frame in bytes.
+    uint64_t data_offset;                   ///< Offset of the first frame from the start of the object.
+    std::atomic<uint64_t> published_count;  ///< Number of frames published so far.
+};
+
+/**
+ * @struct SharedFrameSlot
+ * @brief Per-slot metadata guarded by a sequence counter.
+ */
+struct SharedFrameSlot {
+    std::atomic<uint64_t> sequence;         ///< 2n+1 while frame n is written, 2n+2 once complete.
+    uint64_t frame_index;                   ///< Engine frame index of the stored frame.
+    uint64_t timestamp_micros;              ///< Engine time at which the frame was published.
+    uint64_t reserved;
+};
+
+/**
+ * @brief Rounds a size up to ALIGNMENT.
+ */
+inline size_t alignUp(size_t size) {
+    return (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+}
+
+/**
+ * @brief Computes the offset of the first frame for a given slot count.
+ */
+inline size_t dataOffset(uint32_t slot_count) {
+    return alignUp(alignUp(sizeof(SharedFrameRingHeader)) + sizeof(SharedFrameSlot) * slot_count);
+}
+
+/**
+ * @brief Computes the total size of a ring's shared-memory object.
+ */
+inline size_t totalSize(uint32_t slot_count, uint64_t frame_bytes) {
+    return dataOffset(slot_count) + alignUp(static_cast<size_t>(frame_bytes)) * slot_count;
+}
+
+/**
+ * @brief Gets the slot table that follows the header.
+ */
+inline SharedFrameSlot* slotTable(void* base) {
+    return reinterpret_cast<SharedFrameSlot*>(static_cast<uint8_t*>(base) + alignUp(sizeof(SharedFrameRingHeader)));
+}
+
+/**
+ * @struct FrameInfo
+ * @brief Describes a frame copied out by SharedFrameReader.
+ */
+struct FrameInfo {
+    uint64_t sequence = 0;          ///< Position of the frame in the publish order, starting at 0.
+    uint64_t frame_index = 0;       ///< Engine frame index.
+    uint64_t timestamp_micros = 0;  ///< Engine time at publication.
+    uint32_t width = 0;             ///< Frame width in pixels.
+    uint32_t height = 0;            ///< Frame height in pixels.
+};
+
+/**
+ * @class SharedFrameReader
+ * @brief Consumer side of the frame ring.
+ * @details Usage:
+ *          @code
+ *          SharedFrameRing::SharedFrameReader reader;
+ *          if (reader.open("/ofxGe_output")) {
+ *              std::vector<uint8_t> pixels;
+ *              SharedFrameRing::FrameInfo info;
+ *              while (running) {
+ *                  if (reader.readLatest(pixels, info)) { use(pixels, info); }
+ *              }
+ *          }
+ *          @endcode
+ */
+class SharedFrameReader {
+public:
+    SharedFrameReader() : base(nullptr), mapped_size(0), last_sequence(0), has_read(false) {}
+    ~SharedFrameReader() { close(); }
+
+    SharedFrameReader(const SharedFrameReader&) = delete;
+    SharedFrameReader& operator=(const SharedFrameReader&) = delete;
+
+    /**
+     * @brief Maps an existing frame ring read-only.
+     * @param name The shared-memory name, starting with '/'.
+     * @return True if the ring exists and has a compatible layout.
+     */
+    bool open(const std::string& name) {
+        close();
+        int fd = shm_open(name.c_str(), O_RDONLY, 0);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(SharedFrameRingHeader)) {
+            ::close(fd);
+            return false;
+        }
+        void* mapping = mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (mapping == MAP_FAILED) {
+            return false;
+        }
+        base = mapping;
+        mapped_size = static_cast<size_t>(info.st_size);
+
+        const SharedFrameRingHeader* header = getHeader();
+        if (header->magic != MAGIC || header->version != VERSION ||
+            totalSize(header->slot_count, header->frame_bytes) > mapped_size) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Unmaps the ring.
+     */
+    void close() {
+        if (base) {
+            munmap(base, mapped_size);
+            base = nullptr;
+            mapped_size = 0;
+        }
+        has_read = false;
+    }
+
+    /**
+     * @brief Checks whether a ring is mapped.
+     */
+    bool isOpen() const { return base != nullptr; }
+
+    /**
+     * @brief Copies the newest complete frame if it has not been read before.
+     * @param pixels Receives the frame data; resized as needed.
+     * @param info Receives the frame description.
+     * @return True if a new frame was copied, false if there is nothing new.
+     */
+    bool readLatest(std::vector<uint8_t>& pixels, FrameInfo& info) {
+        if (!base) {
+            return false;
+        }
+        const SharedFrameRingHeader* header = getHeader();
+
+        // A slot can be overwritten while it is copied; retry a few times before giving up.
+        for (int attempt = 0; attempt < 4; ++attempt) {
+            uint64_t published = header->published_count.load(std::memory_order_acquire);
+            if (published == 0) {
+                return false;
+            }
+            uint64_t sequence = published - 1;
+            if (has_read && sequence == last_sequence) {
+                return false;
+            }
+
+            const SharedFrameSlot& slot = slotTable(base)[sequence % header->slot_count];
+            uint64_t expected = 2 * sequence + 2;
+            if (slot.sequence.load(std::memory_order_acquire) != expected) {
+                continue;
+            }
+
+            const uint8_t* frame = static_cast<const uint8_t*>(base) + header->data_offset +
+                                   alignUp(static_cast<size_t>(header->frame_bytes)) * (sequence % header->slot_count);
+            pixels.resize(static_cast<size_t>(header->frame_bytes));
+            std::memcpy(pixels.data(), frame, pixels.size());
+            info.frame_index = slot.frame_index;
+            info.timestamp_micros = slot.timestamp_micros;
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) != expected) {
+                continue; // Torn read: the producer lapped us.
+            }
+
+            info.sequence = sequence;
+            info.width = header->width;
+            info.height = header->height;
+            last_sequence = sequence;
+            has_read = true;
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Gets the number of frames the producer has published so far.
+     */
+    uint64_t getPublishedCount() const {
+        return base ? getHeader()->published_count.load(std::memory_order_acquire) : 0;
+    }
+
+private:
+    const SharedFrameRingHeader* getHeader() const {
+        return static_cast<const SharedFrameRingHeader*>(base);
+    }
+
+    void* base;             ///< Start of the mapping.
+    size_t mapped_size;     ///< Size of the mapping in bytes.
+    uint64_t last_sequence; ///< Sequence of the last frame returned.
+    bool has_read;          ///< True once a frame has been returned.
+};
+
+} // namespace SharedFrameRing
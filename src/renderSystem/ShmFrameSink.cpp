@@ -0,0 +1,122 @@
+#include "ShmFrameSink.h"
+#include <cerrno>
+#include <new>
+
+//--------------------------------------------------------------
+ShmFrameSink::ShmFrameSink()
+    : base(nullptr)
+    , mapped_size(0)
+    , header(nullptr) {
+}
+
+//--------------------------------------------------------------
+ShmFrameSink::~ShmFrameSink() {
+    close();
+}
+
+//--------------------------------------------------------------
+bool ShmFrameSink::setup(const std::string& name, int width, int height, uint32_t slot_count) {
+    using namespace SharedFrameRing;
+
+    close();
+    if (name.empty() || name[0] != '/' || width <= 0 || height <= 0 || slot_count == 0) {
+        ofLogError("ShmFrameSink") << "Invalid shared-memory ring parameters: " << name;
+        return false;
+    }
+
+    uint64_t frame_bytes = static_cast<uint64_t>(width) * height * 4;
+    size_t size = totalSize(slot_count, frame_bytes);
+
+    int fd = shm_open(name.c_str(), O_CREAT | O_RDWR, 0644);
+    if (fd < 0) {
+        ofLogError("ShmFrameSink") << "shm_open failed for " << name << ": " << std::strerror(errno);
+        return false;
+    }
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        ofLogError("ShmFrameSink") << "ftruncate failed for " << name << ": " << std::strerror(errno);
+        ::close(fd);
+        shm_unlink(name.c_str());
+        return false;
+    }
+    void* mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        ofLogError("ShmFrameSink") << "mmap failed for " << name << ": " << std::strerror(errno);
+        shm_unlink(name.c_str());
+        return false;
+    }
+
+    shm_name = name;
+    base = mapping;
+    mapped_size = size;
+
+    // Readers check the magic last, so it is written after everything else.
+    header = new (base) SharedFrameRingHeader();
+    header->magic = 0;
+    header->version = VERSION;
+    header->width = static_cast<uint32_t>(width);
+    header->height = static_cast<uint32_t>(height);
+    header->channels = 4;
+    header->slot_count = slot_count;
+    header->frame_bytes = frame_bytes;
+    header->data_offset = dataOffset(slot_count);
+    header->published_count.store(0, std::memory_order_relaxed);
+
+    SharedFrameSlot* slots = slotTable(base);
+    for (uint32_t i = 0; i < slot_count; ++i) {
+        SharedFrameSlot* slot = new (&slots[i]) SharedFrameSlot();
+        slot->sequence.store(0, std::memory_order_relaxed);
+        slot->frame_index = 0;
+        slot->timestamp_micros = 0;
+    }
+
+    std::atomic_thread_fence(std::memory_order_release);
+    header->magic = MAGIC;
+
+    ofLogNotice("ShmFrameSink") << "Publishing " << width << "x" << height << " frames to shared memory "
+                                << name << " (" << slot_count << " slots, " << (size / (1024 * 1024)) << " MB)";
+    return true;
+}
+
+//--------------------------------------------------------------
+void ShmFrameSink::consumeFrame(const uint8_t* pixels, int width, int height, uint64_t frame_index) {
+    using namespace SharedFrameRing;
+
+    if (!header) {
+        return;
+    }
+    if (static_cast<uint32_t>(width) != header->width || static_cast<uint32_t>(height) != header->height) {
+        ofLogWarning("ShmFrameSink") << "Frame size " << width << "x" << height << " does not match ring, skipped";
+        return;
+    }
+
+    uint64_t sequence = header->published_count.load(std::memory_order_relaxed);
+    uint32_t slot_index = static_cast<uint32_t>(sequence % header->slot_count);
+    SharedFrameSlot& slot = slotTable(base)[slot_index];
+    uint8_t* frame = static_cast<uint8_t*>(base) + header->data_offset +
+                     alignUp(static_cast<size_t>(header->frame_bytes)) * slot_index;
+
+    // Odd sequence marks the slot as being written so readers discard torn copies.
+    slot.sequence.store(2 * sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    std::memcpy(frame, pixels, static_cast<size_t>(header->frame_bytes));
+    slot.frame_index = frame_index;
+    slot.timestamp_micros = ofGetElapsedTimeMicros();
+
+    slot.sequence.store(2 * sequence + 2, std::memory_order_release);
+    header->published_count.store(sequence + 1, std::memory_order_release);
+}
+
+//--------------------------------------------------------------
+void ShmFrameSink::close() {
+    if (!base) {
+        return;
+    }
+    munmap(base, mapped_size);
+    shm_unlink(shm_name.c_str());
+    base = nullptr;
+    header = nullptr;
+    mapped_size = 0;
+    ofLogNotice("ShmFrameSink") << "Closed shared-memory ring " << shm_name;
+}
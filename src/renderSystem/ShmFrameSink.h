@@ -0,0 +1,39 @@
+#pragma once
+#include "ofMain.h"
+#include "FrameSink.h"
+#include "SharedFrameRing.h"
+
+/**
+ * @class ShmFrameSink
+ * @brief Publishes frames into a POSIX shared-memory ring (producer side of SharedFrameRing.h).
+ * @details The shared-memory object is created on setup() and unlinked on destruction.
+ *          Consumers map it with SharedFrameRing::SharedFrameReader.
+ */
+class ShmFrameSink : public FrameSink {
+public:
+    ShmFrameSink();
+    ~ShmFrameSink() override;
+
+    /**
+     * @brief Creates and maps the shared-memory ring.
+     * @param name The shared-memory name, starting with '/' (e.g. "/ofxGe_output").
+     * @param width The frame width in pixels.
+     * @param height The frame height in pixels.
+     * @param slot_count The number of frames kept in the ring.
+     * @return True on success, false otherwise.
+     */
+    bool setup(const std::string& name, int width, int height, uint32_t slot_count = 3);
+
+    void consumeFrame(const uint8_t* pixels, int width, int height, uint64_t frame_index) override;
+
+private:
+    /**
+     * @brief Unmaps and unlinks the shared-memory object.
+     */
+    void close();
+
+    std::string shm_name;           ///< Name of the shared-memory object.
+    void* base;                     ///< Start of the mapping.
+    size_t mapped_size;             ///< Size of the mapping in bytes.
+    SharedFrameRing::SharedFrameRingHeader* header; ///< The ring header inside the mapping.
+};
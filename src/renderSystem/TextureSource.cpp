@@ -0,0 +1,362 @@
+#include "TextureSource.h"
+#include <cstdio>
+#include <cstring>
+#include <csignal>
+#include <fcntl.h>
+#include <filesystem>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+    /// Number of pixel-unpack buffers in the upload ring.
+    const size_t kUploadRingSize = 3;
+
+    /**
+     * @brief Runs a program without a shell and reads its standard output.
+     * @param arguments The program name, looked up in PATH, followed by its arguments.
+     * @param child Receives the process ID, to be passed to finishChild().
+     * @return The read end of the child's stdout, or nullptr if it could not be started.
+     */
+    FILE* spawnReader(const std::vector<std::string>& arguments, pid_t& child) {
+        // Everything the child touches is prepared before fork, which is not safe to allocate after
+        std::vector<char*> argv;
+        for (const std::string& argument : arguments) {
+            argv.push_back(const_cast<char*>(argument.c_str()));
+        }
+        argv.push_back(nullptr);
+
+        int pipe_fds[2];
+        if (pipe(pipe_fds) != 0) {
+            return nullptr;
+        }
+        child = fork();
+        if (child < 0) {
+            close(pipe_fds[0]);
+            close(pipe_fds[1]);
+            return nullptr;
+        }
+        if (child == 0) {
+            int null_fd = open("/dev/null", O_RDONLY);
+            if (null_fd >= 0) {
+                dup2(null_fd, STDIN_FILENO);
+            }
+            dup2(pipe_fds[1], STDOUT_FILENO);
+            close(pipe_fds[0]);
+            close(pipe_fds[1]);
+            execvp(argv[0], argv.data());
+            _exit(127);
+        }
+
+        close(pipe_fds[1]);
+        FILE* stream = fdopen(pipe_fds[0], "r");
+        if (!stream) {
+            close(pipe_fds[0]);
+            kill(child, SIGTERM);
+            waitpid(child, nullptr, 0);
+        }
+        return stream;
+    }
+
+    /// Closes the pipe of spawnReader() and reaps the child, stopping it if it still runs.
+    void finishChild(FILE* stream, pid_t child, bool stop) {
+        fclose(stream);
+        if (stop) {
+            kill(child, SIGTERM);
+        }
+        waitpid(child, nullptr, 0);
+    }
+}
+
+//--------------------------------------------------------------
+TextureSource::TextureSource()
+    : running(false)
+    , failed(false)
+    , stream_width(0)
+    , stream_height(0)
+    , frame_duration(0.0)
+    , is_video(false)
+    , texture(0)
+    , texture_width(0)
+    , texture_height(0)
+    , next_buffer(0)
+    , next_frame_time(0.0)
+    , has_frame(false)
+    , last_upload_ms(0.0) {
+}
+
+//--------------------------------------------------------------
+TextureSource::~TextureSource() {
+    running = false;
+    frame_returned.notify_all();
+    if (worker.joinable()) {
+        worker.join();
+    }
+    release();
+}
+
+//--------------------------------------------------------------
+bool TextureSource::openImage(const std::string& path) {
+    if (worker.joinable()) {
+        ofLogError("TextureSource") << "Source is already open";
+        return false;
+    }
+
+    is_video = false;
+    free_frames.push_back(std::make_unique<Frame>());
+    running = true;
+    worker = std::thread(&TextureSource::decodeImage, this, path);
+    return true;
+}
+
+//--------------------------------------------------------------
+bool TextureSource::openVideo(const std::string& path, int decode_ahead) {
+    if (worker.joinable()) {
+        ofLogError("TextureSource") << "Source is already open";
+        return false;
+    }
+
+    is_video = true;
+    for (int i = 0; i < std::max(decode_ahead, 1); ++i) {
+        free_frames.push_back(std::make_unique<Frame>());
+    }
+    running = true;
+    worker = std::thread(&TextureSource::decodeVideo, this, path);
+    return true;
+}
+
+//--------------------------------------------------------------
+void TextureSource::decodeImage(const std::string& path) {
+    ofPixels pixels;
+    if (!ofLoadImage(pixels, path)) {
+        ofLogError("TextureSource") << "Failed to load image: " << path;
+        failed = true;
+        return;
+    }
+    pixels.setImageType(OF_IMAGE_COLOR_ALPHA);
+    pixels.mirror(true, false);
+
+    std::unique_ptr<Frame> frame;
+    if (!acquireFreeFrame(frame)) {
+        return;
+    }
+    frame->pixels.assign(pixels.getData(), pixels.getData() + pixels.getTotalBytes());
+    stream_width = static_cast<int>(pixels.getWidth());
+    stream_height = static_cast<int>(pixels.getHeight());
+
+    std::lock_guard<std::mutex> lock(mutex);
+    ready_frames.push_back(std::move(frame));
+}
+
+//--------------------------------------------------------------
+void TextureSource::decodeVideo(const std::string& path) {
+    // Only regular files reach ffmpeg; "file:" keeps protocols, devices and option-like names out
+    std::string file_path = ofToDataPath(path, true);
+    std::error_code error;
+    if (!std::filesystem::is_regular_file(file_path, error)) {
+        ofLogError("TextureSource") << "Not a video file: " << path;
+        failed = true;
+        return;
+    }
+    std::string input = "file:" + file_path;
+
+    // Probe size and frame rate, e.g. "1920,1080,30000/1001"
+    pid_t probe_child = 0;
+    FILE* probe = spawnReader({"ffprobe", "-v", "error", "-select_streams", "v:0",
+                               "-show_entries", "stream=width,height,r_frame_rate", "-of", "csv=p=0", input},
+                              probe_child);
+    int width = 0;
+    int height = 0;
+    int rate_numerator = 0;
+    int rate_denominator = 1;
+    int fields = probe ? fscanf(probe, "%d,%d,%d/%d", &width, &height, &rate_numerator, &rate_denominator) : 0;
+    if (probe) {
+        finishChild(probe, probe_child, false);
+    }
+    if (fields < 3 || width <= 0 || height <= 0 || rate_numerator <= 0 || rate_denominator <= 0) {
+        ofLogError("TextureSource") << "Failed to probe video (is ffprobe installed?): " << path;
+        failed = true;
+        return;
+    }
+    frame_duration = static_cast<double>(rate_denominator) / rate_numerator;
+
+    pid_t decode_child = 0;
+    FILE* stream = spawnReader({"ffmpeg", "-v", "error", "-nostdin", "-stream_loop", "-1", "-i", input,
+                                "-vf", "vflip", "-f", "rawvideo", "-pix_fmt", "rgba", "-"},
+                               decode_child);
+    if (!stream) {
+        ofLogError("TextureSource") << "Failed to start ffmpeg for: " << path;
+        failed = true;
+        return;
+    }
+
+    stream_width = width;
+    stream_height = height;
+    size_t frame_bytes = static_cast<size_t>(width) * height * 4;
+
+    while (running) {
+        std::unique_ptr<Frame> frame;
+        if (!acquireFreeFrame(frame)) {
+            break;
+        }
+        frame->pixels.resize(frame_bytes);
+        if (fread(frame->pixels.data(), 1, frame_bytes, stream) != frame_bytes) {
+            ofLogError("TextureSource") << "Video stream ended unexpectedly: " << path;
+            failed = true;
+            break;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        ready_frames.push_back(std::move(frame));
+    }
+
+    // The stream loops forever, so ffmpeg is stopped rather than waited for
+    finishChild(stream, decode_child, true);
+}
+
+//--------------------------------------------------------------
+bool TextureSource::acquireFreeFrame(std::unique_ptr<Frame>& frame) {
+    std::unique_lock<std::mutex> lock(mutex);
+    frame_returned.wait(lock, [this] { return !running || !free_frames.empty(); });
+    if (!running) {
+        return false;
+    }
+    frame = std::move(free_frames.back());
+    free_frames.pop_back();
+    return true;
+}
+
+//--------------------------------------------------------------
+bool TextureSource::update(float time) {
+    last_upload_ms = 0.0;
+    if (is_video && has_frame && time < next_frame_time) {
+        return false;
+    }
+
+    uint64_t start_micros = ofGetElapsedTimeMicros();
+    std::unique_ptr<Frame> frame;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (ready_frames.empty()) {
+            return false;
+        }
+        frame = std::move(ready_frames.front());
+        ready_frames.pop_front();
+    }
+
+    int width = stream_width;
+    int height = stream_height;
+    if (width != texture_width || height != texture_height) {
+        allocate(width, height);
+    }
+
+    // Only write into a buffer whose previous upload has completed
+    GLsync& fence = upload_fences[next_buffer];
+    if (fence) {
+        if (glClientWaitSync(fence, 0, 0) == GL_TIMEOUT_EXPIRED) {
+            std::lock_guard<std::mutex> lock(mutex);
+            ready_frames.push_front(std::move(frame));
+            return false;
+        }
+        glDeleteSync(fence);
+        fence = nullptr;
+    }
+
+    size_t frame_bytes = frame->pixels.size();
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, upload_buffers[next_buffer]);
+    void* destination = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, frame_bytes,
+                                         GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+    if (destination) {
+        std::memcpy(destination, frame->pixels.data(), frame_bytes);
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        next_buffer = (next_buffer + 1) % upload_buffers.size();
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        free_frames.push_back(std::move(frame));
+    }
+    frame_returned.notify_one();
+
+    if (is_video) {
+        // Keep the video's own pace; after a hitch, restart the schedule instead of rushing
+        double duration = frame_duration;
+        next_frame_time = (has_frame && time - next_frame_time < duration) ? next_frame_time + duration : time + duration;
+    }
+    has_frame = has_frame || destination != nullptr;
+    last_upload_ms = (ofGetElapsedTimeMicros() - start_micros) / 1000.0;
+    return destination != nullptr;
+}
+
+//--------------------------------------------------------------
+void TextureSource::allocate(int width, int height) {
+    release();
+
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, width, height);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    size_t frame_bytes = static_cast<size_t>(width) * height * 4;
+    upload_buffers.resize(kUploadRingSize);
+    upload_fences.assign(kUploadRingSize, nullptr);
+    glGenBuffers(static_cast<GLsizei>(upload_buffers.size()), upload_buffers.data());
+    for (GLuint buffer : upload_buffers) {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer);
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, frame_bytes, nullptr, GL_STREAM_DRAW);
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    texture_width = width;
+    texture_height = height;
+    next_buffer = 0;
+}
+
+//--------------------------------------------------------------
+void TextureSource::release() {
+    for (GLsync& fence : upload_fences) {
+        if (fence) {
+            glDeleteSync(fence);
+        }
+    }
+    upload_fences.clear();
+    if (!upload_buffers.empty()) {
+        glDeleteBuffers(static_cast<GLsizei>(upload_buffers.size()), upload_buffers.data());
+        upload_buffers.clear();
+    }
+    if (texture != 0) {
+        glDeleteTextures(1, &texture);
+        texture = 0;
+    }
+    texture_width = 0;
+    texture_height = 0;
+}
+
+//--------------------------------------------------------------
+GLuint TextureSource::getTexture() const {
+    return has_frame ? texture : 0;
+}
+
+//--------------------------------------------------------------
+double TextureSource::getLastUploadMilliseconds() const {
+    return last_upload_ms;
+}
+
+//--------------------------------------------------------------
+bool TextureSource::hasFailed() const {
+    return failed;
+}
+
+//--------------------------------------------------------------
+bool TextureSource::isVideo() const {
+    return is_video;
+}
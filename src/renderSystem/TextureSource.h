@@ -0,0 +1,135 @@
+#pragma once
+#include "ofMain.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @class TextureSource
+ * @brief An image or video file decoded on a background thread and streamed into a texture.
+ * @details A worker thread decodes frames into a fixed pool of RGBA8 buffers. Up to
+ *          'decode_ahead' decoded frames wait in a queue; when the queue is full the worker
+ *          blocks until the render thread returns a buffer, so memory use is bounded.
+ *
+ *          On the render thread, update() copies the next due frame into a ring of
+ *          pixel-unpack buffers and starts the texture upload from there. A PBO is only
+ *          reused once the fence of its previous upload has signalled; if none is free the
+ *          frame waits for the next update instead of stalling.
+ *
+ *          Images are decoded with ofLoadImage. Videos are decoded by an 'ffmpeg' child
+ *          process piping raw RGBA frames (size and rate from 'ffprobe') and loop forever.
+ *          The children are started with fork/execvp, without a shell, and only get regular
+ *          files, resolved like image paths and passed as "file:<path>".
+ *          Frames are flipped on the worker so row 0 is the bottom row, like 'st'.
+ */
+class TextureSource {
+public:
+    TextureSource();
+    ~TextureSource();
+
+    /**
+     * @brief Starts decoding a still image.
+     * @param path The image file.
+     * @return True if the decoder thread was started.
+     */
+    bool openImage(const std::string& path);
+
+    /**
+     * @brief Starts decoding a video file.
+     * @param path The video file.
+     * @param decode_ahead The number of decoded frames kept ready, at least 1.
+     * @return True if the decoder thread was started; probe and decode errors set hasFailed().
+     */
+    bool openVideo(const std::string& path, int decode_ahead);
+
+    /**
+     * @brief Uploads the next due frame, if any. Requires a current GL context.
+     * @param time The engine time in seconds, used to pace video frames.
+     * @return True if a frame upload was started.
+     */
+    bool update(float time);
+
+    /**
+     * @brief Gets the texture, 0 until the first frame was uploaded.
+     */
+    GLuint getTexture() const;
+
+    /**
+     * @brief Gets the CPU time of the last update in milliseconds.
+     */
+    double getLastUploadMilliseconds() const;
+
+    /**
+     * @brief Checks whether decoding has failed.
+     */
+    bool hasFailed() const;
+
+    /**
+     * @brief Checks whether the source is a video.
+     */
+    bool isVideo() const;
+
+private:
+    /**
+     * @struct Frame
+     * @brief A decoded frame in the buffer pool.
+     */
+    struct Frame {
+        std::vector<uint8_t> pixels;    ///< RGBA8, bottom row first.
+    };
+
+    /**
+     * @brief Worker body for still images.
+     */
+    void decodeImage(const std::string& path);
+
+    /**
+     * @brief Worker body for videos.
+     */
+    void decodeVideo(const std::string& path);
+
+    /**
+     * @brief Takes a buffer from the pool, waiting while all buffers are queued or uploading.
+     * @return False if the source is shutting down.
+     */
+    bool acquireFreeFrame(std::unique_ptr<Frame>& frame);
+
+    /**
+     * @brief (Re)creates the texture and the PBO ring for the stream size.
+     */
+    void allocate(int width, int height);
+
+    /**
+     * @brief Releases all GL objects.
+     */
+    void release();
+
+    // --- Decoder (worker thread) ---
+    std::thread worker;                             ///< The decoder thread.
+    std::atomic<bool> running;                      ///< Cleared to stop the worker.
+    std::atomic<bool> failed;                       ///< Set when decoding failed.
+    std::mutex mutex;                               ///< Guards the frame queues.
+    std::condition_variable frame_returned;         ///< Signalled when a buffer returns to the pool.
+    std::deque<std::unique_ptr<Frame>> ready_frames; ///< Decoded frames, oldest first.
+    std::vector<std::unique_ptr<Frame>> free_frames; ///< Unused buffers of the pool.
+    std::atomic<int> stream_width;                  ///< Decoded width, 0 until known.
+    std::atomic<int> stream_height;                 ///< Decoded height, 0 until known.
+    std::atomic<double> frame_duration;             ///< Seconds per video frame, 0 for images.
+    bool is_video;                                  ///< True for video sources.
+
+    // --- Upload (render thread) ---
+    GLuint texture;                                 ///< RGBA8 texture sampled by shaders.
+    int texture_width;                              ///< Allocated texture width.
+    int texture_height;                             ///< Allocated texture height.
+    std::vector<GLuint> upload_buffers;             ///< Pixel-unpack buffer ring.
+    std::vector<GLsync> upload_fences;              ///< Fence of the last upload from each buffer.
+    size_t next_buffer;                             ///< Next ring position.
+    double next_frame_time;                         ///< Engine time at which the next video frame is due.
+    bool has_frame;                                 ///< True once a frame has been uploaded.
+    double last_upload_ms;                          ///< CPU time of the last update.
+};
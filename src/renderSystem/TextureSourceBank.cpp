@@ -0,0 +1,106 @@
+#include "TextureSourceBank.h"
+#include "../shaderSystem/BuiltinVariables.h"
+#include <algorithm>
+#include <cctype>
+#include <set>
+
+//--------------------------------------------------------------
+TextureSourceBank::TextureSourceBank()
+    : default_decode_ahead(4)
+    , last_upload_ms(0.0)
+    , last_upload_count(0) {
+}
+
+//--------------------------------------------------------------
+TextureSourceBank::~TextureSourceBank() {
+    for (const auto& [name, source] : sources) {
+        BuiltinVariables::getInstance().unregisterTextureInput(name);
+    }
+}
+
+//--------------------------------------------------------------
+bool TextureSourceBank::addSource(const std::string& name, const std::string& path, int decode_ahead) {
+    if (!isValidName(name)) {
+        ofLogError("TextureSourceBank") << "Invalid texture source name: " << name;
+        return false;
+    }
+
+    static const std::set<std::string> video_extensions = {"mp4", "mov", "mkv", "webm", "avi", "m4v"};
+    std::string extension = ofToLower(ofFilePath::getFileExt(path));
+
+    auto source = std::make_unique<TextureSource>();
+    bool started = video_extensions.count(extension)
+        ? source->openVideo(path, decode_ahead > 0 ? decode_ahead : default_decode_ahead)
+        : source->openImage(path);
+    if (!started) {
+        return false;
+    }
+
+    sources[name] = std::move(source);
+    BuiltinVariables::getInstance().registerTextureInput(name);
+    ofLogNotice("TextureSourceBank") << "Added texture source " << name << " from " << path;
+    return true;
+}
+
+//--------------------------------------------------------------
+bool TextureSourceBank::removeSource(const std::string& name) {
+    if (sources.erase(name) == 0) {
+        return false;
+    }
+    BuiltinVariables::getInstance().unregisterTextureInput(name);
+    return true;
+}
+
+//--------------------------------------------------------------
+void TextureSourceBank::update(float time) {
+    last_upload_ms = 0.0;
+    last_upload_count = 0;
+    for (const auto& [name, source] : sources) {
+        if (source->update(time)) {
+            last_upload_count++;
+        }
+        last_upload_ms += source->getLastUploadMilliseconds();
+    }
+}
+
+//--------------------------------------------------------------
+GLuint TextureSourceBank::getTexture(const std::string& name) const {
+    auto it = sources.find(name);
+    return it != sources.end() ? it->second->getTexture() : 0;
+}
+
+//--------------------------------------------------------------
+void TextureSourceBank::setDefaultDecodeAhead(int frames) {
+    default_decode_ahead = std::max(frames, 1);
+}
+
+//--------------------------------------------------------------
+double TextureSourceBank::getLastUploadMilliseconds() const {
+    return last_upload_ms;
+}
+
+//--------------------------------------------------------------
+int TextureSourceBank::getLastUploadCount() const {
+    return last_upload_count;
+}
+
+//--------------------------------------------------------------
+size_t TextureSourceBank::getSourceCount() const {
+    return sources.size();
+}
+
+//--------------------------------------------------------------
+bool TextureSourceBank::isValidName(const std::string& name) const {
+    if (name.empty() || std::isdigit(static_cast<unsigned char>(name[0])) || name.rfind("gl_", 0) == 0) {
+        return false;
+    }
+    for (char c : name) {
+        if (!std::isalnum(static_cast<unsigned char>(c)) && c != '_') {
+            return false;
+        }
+    }
+
+    // Replacing a source is fine, shadowing 'st' or 'time' is not
+    const BuiltinVariable* existing = BuiltinVariables::getInstance().getBuiltinInfo(name);
+    return !existing || existing->glsl_type == "sampler2D";
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include "ofMain.h"
+#include "TextureSource.h"
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @class TextureSourceBank
+ * @brief The named image and video inputs available to shaders.
+ * @details Each source is registered as a 'sampler2D' builtin under its name, so it can
+ *          be passed as an argument like 'st' or 'time' and is bound automatically when
+ *          a shader using it is drawn. Files ending in a known video extension are
+ *          streamed as video, everything else is loaded as a still image.
+ */
+class TextureSourceBank {
+public:
+    TextureSourceBank();
+    ~TextureSourceBank();
+
+    /**
+     * @brief Adds or replaces a source and starts decoding it.
+     * @param name The GLSL identifier the source is sampled under.
+     * @param path The image or video file.
+     * @param decode_ahead Decoded video frames kept ready, 0 for the default.
+     * @return True if decoding was started.
+     */
+    bool addSource(const std::string& name, const std::string& path, int decode_ahead = 0);
+
+    /**
+     * @brief Removes a source and its builtin.
+     * @return True if the source existed.
+     */
+    bool removeSource(const std::string& name);
+
+    /**
+     * @brief Uploads the due frames of all sources. Requires a current GL context.
+     * @param time The engine time in seconds.
+     */
+    void update(float time);
+
+    /**
+     * @brief Gets the texture of a source.
+     * @return The texture, or 0 if the source is unknown or has no frame yet.
+     */
+    GLuint getTexture(const std::string& name) const;
+
+    /**
+     * @brief Sets the decode-ahead depth used when addSource() is given 0.
+     */
+    void setDefaultDecodeAhead(int frames);
+
+    /**
+     * @brief Gets the CPU time of the last update() in milliseconds.
+     */
+    double getLastUploadMilliseconds() const;
+
+    /**
+     * @brief Gets the number of frames uploaded by the last update().
+     */
+    int getLastUploadCount() const;
+
+    size_t getSourceCount() const;
+
+private:
+    /**
+     * @brief Checks whether a name is a GLSL identifier that is free to use.
+     */
+    bool isValidName(const std::string& name) const;
+
+    std::map<std::string, std::unique_ptr<TextureSource>> sources; ///< Sources by name.
+    int default_decode_ahead;       ///< Decode-ahead depth when none is given.
+    double last_upload_ms;          ///< CPU time of the last update().
+    int last_upload_count;          ///< Frames uploaded by the last update().
+};
@@ -0,0 +1,241 @@
+#include "TiledRenderer.h"
+#include <algorithm>
+
+//--------------------------------------------------------------
+TiledRenderer::TiledRenderer()
+    : output_width(0)
+    , output_height(0)
+    , front_index(0)
+    , next_tile(0)
+    , frame_time(0.0f)
+    , frame_budget_ms(0.0f)
+    , tile_cost_ms(0.0f)
+    , has_cost_estimate(false)
+    , frames_in_progress(0)
+    , frames_per_output_frame(0) {
+}
+
+//--------------------------------------------------------------
+TiledRenderer::~TiledRenderer() {
+    for (auto& tile : tiles) {
+        if (tile.timer_query != 0) {
+            glDeleteQueries(1, &tile.timer_query);
+        }
+    }
+}
+
+//--------------------------------------------------------------
+bool TiledRenderer::setup(int width, int height, int tile_width, int tile_height) {
+    if (width <= 0 || height <= 0 || tile_width <= 0 || tile_height <= 0) {
+        ofLogError("TiledRenderer") << "Invalid tiled output size";
+        return false;
+    }
+
+    // Each tile must be a legal texture and viewport on this driver.
+    GLint max_texture_size = 0;
+    GLint max_viewport[2] = {0, 0};
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &max_texture_size);
+    glGetIntegerv(GL_MAX_VIEWPORT_DIMS, max_viewport);
+    if (max_texture_size > 0) {
+        tile_width = std::min(tile_width, std::min<int>(max_texture_size, max_viewport[0] > 0 ? max_viewport[0] : max_texture_size));
+        tile_height = std::min(tile_height, std::min<int>(max_texture_size, max_viewport[1] > 0 ? max_viewport[1] : max_texture_size));
+    }
+
+    output_width = width;
+    output_height = height;
+    for (auto& tile : tiles) {
+        glDeleteQueries(1, &tile.timer_query);
+    }
+    tiles.clear();
+
+    int columns = (output_width + tile_width - 1) / tile_width;
+    int rows = (output_height + tile_height - 1) / tile_height;
+    tiles.resize(static_cast<size_t>(columns) * rows);
+
+    for (int row = 0; row < rows; ++row) {
+        for (int column = 0; column < columns; ++column) {
+            Tile& tile = tiles[static_cast<size_t>(row) * columns + column];
+            tile.x = column * tile_width;
+            tile.y = row * tile_height;
+            tile.width = std::min(tile_width, output_width - tile.x);
+            tile.height = std::min(tile_height, output_height - tile.y);
+            for (auto& buffer : tile.buffers) {
+                buffer.allocate(tile.width, tile.height, GL_RGBA8);
+            }
+            glGenQueries(1, &tile.timer_query);
+        }
+    }
+
+    front_index = 0;
+    next_tile = 0;
+    frames_in_progress = 0;
+
+    ofLogNotice("TiledRenderer") << "Tiled output " << output_width << "x" << output_height << " as "
+                                 << columns << "x" << rows << " tiles of up to " << tile_width << "x" << tile_height
+                                 << " (GL_MAX_TEXTURE_SIZE " << max_texture_size << ")";
+    return true;
+}
+
+//--------------------------------------------------------------
+void TiledRenderer::setFrameBudget(float milliseconds) {
+    frame_budget_ms = std::max(milliseconds, 0.0f);
+}
+
+//--------------------------------------------------------------
+bool TiledRenderer::renderFrame(FullscreenPass& pass, const RenderProgram& program, float time) {
+    if (tiles.empty()) {
+        return false;
+    }
+
+    pollTimerQueries();
+
+    if (next_tile == 0) {
+        // Latch the time once so every tile of this output frame matches.
+        frame_time = time;
+    }
+    frames_in_progress++;
+
+    // Always make progress, then add tiles while the estimate stays within the budget.
+    float spent_ms = 0.0f;
+    do {
+        renderTile(tiles[next_tile], pass, program, frame_time, true);
+        spent_ms += tile_cost_ms;
+        next_tile++;
+    } while (next_tile < tiles.size() &&
+             (frame_budget_ms <= 0.0f || !has_cost_estimate || spent_ms + tile_cost_ms <= frame_budget_ms));
+
+    if (next_tile < tiles.size()) {
+        return false;
+    }
+
+    swapBuffers();
+    frames_per_output_frame = frames_in_progress;
+    frames_in_progress = 0;
+    next_tile = 0;
+    return true;
+}
+
+//--------------------------------------------------------------
+void TiledRenderer::renderAllTiles(FullscreenPass& pass, const RenderProgram& program, float time) {
+    for (auto& tile : tiles) {
+        renderTile(tile, pass, program, time, false);
+    }
+    swapBuffers();
+    next_tile = 0;
+    frames_in_progress = 0;
+}
+
+//--------------------------------------------------------------
+void TiledRenderer::renderTile(Tile& tile, FullscreenPass& pass, const RenderProgram& program, float time, bool timed) {
+    ofFbo& target = tile.buffers[1 - front_index];
+    bool start_query = timed && !tile.query_pending;
+
+    target.begin();
+    ofClear(0, 0, 0, 255);
+    if (start_query) {
+        glBeginQuery(GL_TIME_ELAPSED, tile.timer_query);
+    }
+
+    pass.beginFrame();
+    pass.draw(program, static_cast<float>(output_width), static_cast<float>(output_height), time,
+              static_cast<float>(tile.x), static_cast<float>(tile.y));
+    pass.endFrame();
+
+    if (start_query) {
+        glEndQuery(GL_TIME_ELAPSED);
+        tile.query_pending = true;
+    }
+    target.end();
+}
+
+//--------------------------------------------------------------
+void TiledRenderer::pollTimerQueries() {
+    for (auto& tile : tiles) {
+        if (!tile.query_pending) {
+            continue;
+        }
+        GLint available = 0;
+        glGetQueryObjectiv(tile.timer_query, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) {
+            continue;
+        }
+
+        GLuint64 nanoseconds = 0;
+        glGetQueryObjectui64v(tile.timer_query, GL_QUERY_RESULT, &nanoseconds);
+        tile.query_pending = false;
+
+        // Scale to a full-size tile so small edge tiles do not drag the estimate down.
+        float ms = static_cast<float>(nanoseconds / 1000000.0);
+        float area_ratio = static_cast<float>(tiles[0].width * tiles[0].height) /
+                           static_cast<float>(std::max(tile.width * tile.height, 1));
+        ms *= area_ratio;
+
+        tile_cost_ms = has_cost_estimate ? tile_cost_ms + (ms - tile_cost_ms) * 0.2f : ms;
+        has_cost_estimate = true;
+    }
+}
+
+//--------------------------------------------------------------
+void TiledRenderer::swapBuffers() {
+    front_index = 1 - front_index;
+}
+
+//--------------------------------------------------------------
+void TiledRenderer::draw(float x, float y, float width, float height) const {
+    if (tiles.empty()) {
+        return;
+    }
+
+    float scale_x = width / output_width;
+    float scale_y = height / output_height;
+    for (const auto& tile : tiles) {
+        // Tiles are placed in GL orientation; the screen's y axis points down.
+        float screen_y = y + (output_height - tile.y - tile.height) * scale_y;
+        tile.buffers[front_index].draw(x + tile.x * scale_x, screen_y, tile.width * scale_x, tile.height * scale_y);
+    }
+}
+
+//--------------------------------------------------------------
+void TiledRenderer::readToPixels(ofPixels& pixels) const {
+    pixels.allocate(output_width, output_height, OF_IMAGE_COLOR_ALPHA);
+    ofPixels tile_pixels;
+
+    for (const auto& tile : tiles) {
+        tile.buffers[front_index].readToPixels(tile_pixels);
+        const unsigned char* source = tile_pixels.getData();
+        unsigned char* destination = pixels.getData();
+        size_t source_stride = static_cast<size_t>(tile.width) * 4;
+        size_t destination_stride = static_cast<size_t>(output_width) * 4;
+
+        for (int row = 0; row < tile.height; ++row) {
+            std::memcpy(destination + (static_cast<size_t>(tile.y) + row) * destination_stride + static_cast<size_t>(tile.x) * 4,
+                        source + static_cast<size_t>(row) * source_stride,
+                        source_stride);
+        }
+    }
+}
+
+//--------------------------------------------------------------
+int TiledRenderer::getOutputWidth() const {
+    return output_width;
+}
+
+//--------------------------------------------------------------
+int TiledRenderer::getOutputHeight() const {
+    return output_height;
+}
+
+//--------------------------------------------------------------
+size_t TiledRenderer::getTileCount() const {
+    return tiles.size();
+}
+
+//--------------------------------------------------------------
+int TiledRenderer::getFramesPerOutputFrame() const {
+    return frames_per_output_frame;
+}
+
+//--------------------------------------------------------------
+float TiledRenderer::getEstimatedTileMilliseconds() const {
+    return tile_cost_ms;
+}
@@ -0,0 +1,123 @@
+#pragma once
+#include "ofMain.h"
+#include "FullscreenPass.h"
+#include <vector>
+
+/**
+ * @class TiledRenderer
+ * @brief Renders an output larger than the driver's texture/viewport limits as a grid of tiles.
+ * @details Each tile is its own framebuffer within the driver limits. A tile is drawn with the
+ *          full output size as 'resolution' and its pixel position as 'tileOffset', so the
+ *          generated 'st' ((gl_FragCoord.xy + tileOffset) / resolution) is continuous across
+ *          tile borders. Arguments that use gl_FragCoord directly are not offset.
+ *
+ *          Tiles are scheduled across frames: every frame renders as many tiles as fit into
+ *          the per-frame GPU budget, estimated from asynchronous timer queries of earlier
+ *          tiles. All tiles of one output frame share the same time value and are rendered
+ *          into a back buffer, which is swapped to the front only once it is complete, so a
+ *          frame spread over several display frames never shows mixed content.
+ */
+class TiledRenderer {
+public:
+    TiledRenderer();
+    ~TiledRenderer();
+
+    /**
+     * @brief Allocates the tile framebuffers. Requires a current GL context.
+     * @param output_width The width of the full output in pixels.
+     * @param output_height The height of the full output in pixels.
+     * @param tile_width The maximum tile width; clamped to the driver limits.
+     * @param tile_height The maximum tile height; clamped to the driver limits.
+     * @return True on success, false otherwise.
+     */
+    bool setup(int output_width, int output_height, int tile_width, int tile_height);
+
+    /**
+     * @brief Sets the GPU time budget per frame.
+     * @param milliseconds The budget; 0 renders every tile every frame.
+     */
+    void setFrameBudget(float milliseconds);
+
+    /**
+     * @brief Renders the next tiles of the current output frame within the frame budget.
+     * @param pass The fullscreen pass used for drawing.
+     * @param program The program to render, taken from a render snapshot.
+     * @param time The shader time used when a new output frame is started.
+     * @return True if an output frame was completed and swapped to the front this call.
+     */
+    bool renderFrame(FullscreenPass& pass, const RenderProgram& program, float time);
+
+    /**
+     * @brief Renders every tile immediately with the given time, ignoring the budget.
+     * @details Used for offline rendering and for verification.
+     */
+    void renderAllTiles(FullscreenPass& pass, const RenderProgram& program, float time);
+
+    /**
+     * @brief Draws the front (last complete) output frame scaled into a rectangle.
+     */
+    void draw(float x, float y, float width, float height) const;
+
+    /**
+     * @brief Assembles the front output frame into one CPU image.
+     * @param pixels Receives the full output, RGBA8, rows in the same order as a single
+     *               framebuffer of the output size would return them.
+     */
+    void readToPixels(ofPixels& pixels) const;
+
+    int getOutputWidth() const;
+    int getOutputHeight() const;
+    size_t getTileCount() const;
+
+    /**
+     * @brief Gets the number of display frames the last complete output frame took.
+     */
+    int getFramesPerOutputFrame() const;
+
+    /**
+     * @brief Gets the estimated GPU time of one tile in milliseconds.
+     */
+    float getEstimatedTileMilliseconds() const;
+
+private:
+    /**
+     * @struct Tile
+     * @brief One tile of the output grid.
+     */
+    struct Tile {
+        int x = 0;                  ///< Left edge in output pixels.
+        int y = 0;                  ///< Bottom edge in output pixels (GL orientation, like gl_FragCoord).
+        int width = 0;              ///< Tile width in pixels.
+        int height = 0;             ///< Tile height in pixels.
+        ofFbo buffers[2];           ///< Front/back framebuffers.
+        GLuint timer_query = 0;     ///< GL_TIME_ELAPSED query of the last render.
+        bool query_pending = false; ///< True while the query result has not been read.
+    };
+
+    /**
+     * @brief Renders one tile into the back buffer.
+     */
+    void renderTile(Tile& tile, FullscreenPass& pass, const RenderProgram& program, float time, bool timed);
+
+    /**
+     * @brief Reads finished timer queries without blocking and updates the tile cost estimate.
+     */
+    void pollTimerQueries();
+
+    /**
+     * @brief Makes the back buffers the front buffers.
+     */
+    void swapBuffers();
+
+    std::vector<Tile> tiles;        ///< The tile grid, row-major.
+    int output_width;               ///< Full output width in pixels.
+    int output_height;              ///< Full output height in pixels.
+    int front_index;                ///< Index of the front buffer in each tile (0 or 1).
+    size_t next_tile;               ///< Next tile of the output frame in progress.
+    float frame_time;               ///< Time value shared by all tiles of the frame in progress.
+    float frame_budget_ms;          ///< GPU budget per frame, 0 for unlimited.
+    float tile_cost_ms;             ///< Moving average of the GPU time of one tile.
+    bool has_cost_estimate;         ///< False until a timer query has completed.
+    int frames_in_progress;         ///< Display frames spent on the output frame in progress.
+    int frames_per_output_frame;    ///< Display frames the last complete output frame took.
+};
@@ -1,4 +1,5 @@
 #include "BuiltinVariables.h"
+#include <cctype>
 
 //--------------------------------------------------------------
 BuiltinVariables& BuiltinVariables::getInstance() {
@@ -13,14 +14,15 @@ BuiltinVariables::BuiltinVariables() {
 
 //--------------------------------------------------------------
 void BuiltinVariables::initializeBuiltins() {
-    // 'st': Normalized screen coordinates (0.0 to 1.0)
+    // 'st': Normalized output coordinates (0.0 to 1.0)
+    // 'tileOffset' is zero unless the output is rendered in tiles.
     builtins["st"] = BuiltinVariable(
         "st", 
         "vec2", 
         2,           // 2 components (x, y)
-        true,        // requires 'resolution' uniform
+        true,        // requires 'resolution' and 'tileOffset' uniforms
         true,        // needs declaration in main()
-        "vec2 st = gl_FragCoord.xy / resolution;"
+        "vec2 st = (gl_FragCoord.xy + tileOffset) / resolution;"
     );
     
     // 'time': Elapsed time in seconds
@@ -54,6 +56,54 @@ void BuiltinVariables::initializeBuiltins() {
     );
 }
 
+//--------------------------------------------------------------
+void BuiltinVariables::registerTextureInput(const std::string& name) {
+    // Texture sources: bound by name when the shader is drawn
+    builtins[name] = BuiltinVariable(
+        name,
+        "sampler2D",
+        1,           // opaque, passed as a whole
+        true,        // requires a 'sampler2D' uniform
+        false,       // no local declaration needed, use uniform directly
+        ""
+    );
+}
+
+//--------------------------------------------------------------
+void BuiltinVariables::unregisterTextureInput(const std::string& name) {
+    auto it = builtins.find(name);
+    if (it != builtins.end() && it->second.glsl_type == "sampler2D") {
+        builtins.erase(it);
+    }
+}
+
+//--------------------------------------------------------------
+std::vector<std::string> BuiltinVariables::findTextureInputs(const std::vector<std::string>& arguments) const {
+    std::set<std::string> names;
+    for (const auto& arg : arguments) {
+        size_t i = 0;
+        while (i < arg.size()) {
+            if (!std::isalpha(static_cast<unsigned char>(arg[i])) && arg[i] != '_') {
+                i++;
+                continue;
+            }
+            size_t end = i;
+            while (end < arg.size() && (std::isalnum(static_cast<unsigned char>(arg[end])) || arg[end] == '_')) {
+                end++;
+            }
+            // Skip swizzles such as the 'x' in "img.x"
+            if (i == 0 || arg[i - 1] != '.') {
+                const BuiltinVariable* info = getBuiltinInfo(arg.substr(i, end - i));
+                if (info && info->glsl_type == "sampler2D") {
+                    names.insert(info->name);
+                }
+            }
+            i = end;
+        }
+    }
+    return std::vector<std::string>(names.begin(), names.end());
+}
+
 //--------------------------------------------------------------
 const BuiltinVariable* BuiltinVariables::getBuiltinInfo(const std::string& name) const {
     auto it = builtins.find(name);
@@ -2,6 +2,7 @@
 #include <string>
 #include <unordered_map>
 #include <set>
+#include <vector>
 
 /**
  * @struct BuiltinVariable
@@ -133,6 +134,27 @@ public:
      */
     bool isComplexExpression(const std::string& expr) const;
 
+    /**
+     * @brief Registers a texture input as a 'sampler2D' builtin.
+     * @param name The sampler name used in arguments.
+     */
+    void registerTextureInput(const std::string& name);
+
+    /**
+     * @brief Removes a texture input registered with registerTextureInput().
+     * @param name The sampler name.
+     */
+    void unregisterTextureInput(const std::string& name);
+
+    /**
+     * @brief Finds the texture inputs referenced by a list of arguments.
+     * @details Every identifier is checked, so samplers inside expressions such as
+     *          "texture(img, st).r" are found as well.
+     * @param arguments The shader arguments.
+     * @return The referenced sampler names, sorted and without duplicates.
+     */
+    std::vector<std::string> findTextureInputs(const std::vector<std::string>& arguments) const;
+
 private:
     /**
      * @brief Private constructor to enforce the singleton pattern.
@@ -0,0 +1,72 @@
+#pragma once
+#include "ofMain.h"
+#include <string>
+
+/**
+ * @class ComputeField
+ * @brief A scalar field evaluated by a compute shader into an image texture.
+ * @details Expensive, smooth nodes (fbm, curl noise, ...) can be evaluated at a fraction
+ *          of the output resolution instead of once per output pixel. The field owns a
+ *          single-channel float texture of scale * output size; the compute shader writes
+ *          it through image unit 0 and the downstream fragment shader samples it with
+ *          linear filtering under the sampler name given at construction.
+ *
+ *          The field is only re-evaluated when the output size or time changes, so all
+ *          tiles of a tiled output share one dispatch.
+ */
+class ComputeField {
+public:
+    /**
+     * @param sampler_name The sampler2D uniform that reads the field in the fragment shader.
+     * @param scale The field resolution relative to the output, in (0, 1].
+     * @param workgroup_size The local size of the compute shader in x and y.
+     */
+    ComputeField(const std::string& sampler_name, float scale, int workgroup_size);
+    ~ComputeField();
+
+    /**
+     * @brief Compiles the compute shader. Requires a current GL 4.3 context.
+     * @param compute_code The compute shader source.
+     * @param source_directory_path Directory used to resolve #include directives.
+     * @return True on success, false otherwise.
+     */
+    bool setup(const std::string& compute_code, const std::string& source_directory_path);
+
+    /**
+     * @brief Checks whether the field must be re-evaluated for the given output.
+     */
+    bool needsUpdate(float width, float height, float time) const;
+
+    /**
+     * @brief Evaluates the field for the given output. The program must be bound.
+     * @param width The output width in pixels, used for 'resolution'.
+     * @param height The output height in pixels, used for 'resolution'.
+     * @param time The shader time in seconds.
+     */
+    void dispatch(float width, float height, float time);
+
+    GLuint getProgramId() const;
+    GLuint getTexture() const;
+    const std::string& getSamplerName() const;
+    float getScale() const;
+
+private:
+    /**
+     * @brief (Re)creates the field texture.
+     */
+    void allocate(int width, int height);
+
+    ofShader program;               ///< The compiled compute shader.
+    std::string sampler_name;       ///< Sampler uniform of the downstream fragment shader.
+    float scale;                    ///< Field resolution relative to the output.
+    int workgroup_size;             ///< Local size in x and y, as compiled into the shader.
+    GLuint texture;                 ///< GL_R32F field texture, 0 until the first dispatch.
+    int texture_width;              ///< Current texture width in texels.
+    int texture_height;             ///< Current texture height in texels.
+    GLint time_location;            ///< Location of 'time', -1 if unused.
+    GLint resolution_location;      ///< Location of 'resolution', -1 if unused.
+    bool has_result;                ///< False until the first dispatch.
+    float last_width;               ///< Output width of the last dispatch.
+    float last_height;              ///< Output height of the last dispatch.
+    float last_time;                ///< Time of the last dispatch.
+};
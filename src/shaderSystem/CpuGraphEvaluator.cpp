@@ -0,0 +1,165 @@
+#include "CpuGraphEvaluator.h"
+#include "ShaderCompositionEngine.h"
+#include "FunctionDependencyAnalyzer.h"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+//--------------------------------------------------------------
+CpuGraphEvaluator::CpuGraphEvaluator()
+    : ready(false)
+    , last_megapixels_per_second(0.0)
+    , last_thread_count(0) {
+}
+
+//--------------------------------------------------------------
+bool CpuGraphEvaluator::build(ShaderCompositionEngine& engine, PluginManager* plugin_manager,
+                              const std::string& output_node_id) {
+    program = CpuShaderProgram();
+    ready = false;
+
+    std::vector<std::string> dependency_chain = engine.analyzeDependencies(output_node_id);
+    if (dependency_chain.empty()) {
+        ofLogError("CpuGraphEvaluator") << "Failed to analyze dependencies for node: " << output_node_id;
+        return false;
+    }
+
+    FunctionDependencyAnalyzer analyzer(plugin_manager);
+    int result = -1;
+
+    for (const std::string& node_id : dependency_chain) {
+        const CompositionNode* node = engine.getNode(node_id);
+        if (!node) {
+            ofLogError("CpuGraphEvaluator") << "Node not found: " << node_id;
+            return false;
+        }
+
+        ClassifiedFunction classification = analyzer.classifyFunction(node->function_name.str());
+        if (classification.classification != FunctionClassification::GLSL_BUILTIN) {
+            ofLogError("CpuGraphEvaluator") << "Graph is not builtin-only: " << node->function_name
+                                            << " in " << node_id << " is not a GLSL builtin";
+            return false;
+        }
+
+        std::string error;
+        std::vector<int> arguments;
+        for (const std::string& argument : node->arguments) {
+            int reg = program.compileExpression(argument, error);
+            if (reg < 0) {
+                ofLogError("CpuGraphEvaluator") << node_id << ": " << error;
+                return false;
+            }
+            arguments.push_back(reg);
+        }
+
+        result = program.compileCall(node->function_name.str(), arguments, error);
+        if (result < 0) {
+            ofLogError("CpuGraphEvaluator") << node_id << ": " << error;
+            return false;
+        }
+        // The unified shader stores every node result in a float.
+        if (program.getRegisterWidth(result) != 1) {
+            ofLogError("CpuGraphEvaluator") << node_id << ": " << node->function_name << " does not return a float";
+            return false;
+        }
+
+        program.bindName("$" + node_id, result);
+        program.bindName(node_id + "_result", result);
+    }
+
+    program.setOutput(result);
+    ready = true;
+
+    ofLogNotice("CpuGraphEvaluator") << "Compiled " << dependency_chain.size() << " nodes into "
+                                     << program.getInstructionCount() << " instructions";
+    return true;
+}
+
+//--------------------------------------------------------------
+bool CpuGraphEvaluator::isReady() const {
+    return ready;
+}
+
+//--------------------------------------------------------------
+bool CpuGraphEvaluator::render(int width, int height, float time, ofPixels& pixels, unsigned int thread_count) {
+    if (!ready || width <= 0 || height <= 0) {
+        ofLogError("CpuGraphEvaluator") << "Nothing to render";
+        return false;
+    }
+
+    if (thread_count == 0) {
+        thread_count = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    pixels.allocate(width, height, OF_IMAGE_COLOR_ALPHA);
+    unsigned char* output = pixels.getData();
+
+    int columns = (width + kTileWidth - 1) / kTileWidth;
+    int rows = (height + kTileHeight - 1) / kTileHeight;
+    int tile_count = columns * rows;
+    thread_count = std::min<unsigned int>(thread_count, tile_count);
+    std::atomic<int> next_tile{0};
+
+    auto worker = [&]() {
+        std::vector<float> scratch(program.getScratchSize());
+        program.prepare(scratch.data(), time, static_cast<float>(width), static_cast<float>(height));
+
+        for (int tile = next_tile++; tile < tile_count; tile = next_tile++) {
+            int x0 = (tile % columns) * kTileWidth;
+            int y0 = (tile / columns) * kTileHeight;
+            int x1 = std::min(x0 + kTileWidth, width);
+            int y1 = std::min(y0 + kTileHeight, height);
+
+            for (int y = y0; y < y1; ++y) {
+                unsigned char* row = output + (static_cast<size_t>(y) * width) * 4;
+                for (int x = x0; x < x1; x += CpuShaderProgram::kLanes) {
+                    // Pixel centers, as gl_FragCoord.
+                    const float* values = program.run(scratch.data(), x + 0.5f, y + 0.5f);
+                    int count = std::min(CpuShaderProgram::kLanes, x1 - x);
+
+                    for (int i = 0; i < count; ++i) {
+                        float value = values[i];
+                        // Same as the unorm conversion of the framebuffer; NaN becomes 0.
+                        unsigned char byte = value > 0.0f ? (value < 1.0f ? static_cast<unsigned char>(value * 255.0f + 0.5f) : 255) : 0;
+                        unsigned char* pixel = row + static_cast<size_t>(x + i) * 4;
+                        pixel[0] = byte;
+                        pixel[1] = byte;
+                        pixel[2] = byte;
+                        pixel[3] = 255;
+                    }
+                }
+            }
+        }
+    };
+
+    uint64_t start_micros = ofGetElapsedTimeMicros();
+
+    std::vector<std::thread> threads;
+    for (unsigned int i = 1; i < thread_count; ++i) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    double seconds = (ofGetElapsedTimeMicros() - start_micros) / 1000000.0;
+    last_megapixels_per_second = seconds > 0.0 ? (static_cast<double>(width) * height / 1000000.0) / seconds : 0.0;
+    last_thread_count = thread_count;
+    return true;
+}
+
+//--------------------------------------------------------------
+double CpuGraphEvaluator::getLastMegapixelsPerSecond() const {
+    return last_megapixels_per_second;
+}
+
+//--------------------------------------------------------------
+unsigned int CpuGraphEvaluator::getLastThreadCount() const {
+    return last_thread_count;
+}
+
+//--------------------------------------------------------------
+size_t CpuGraphEvaluator::getInstructionCount() const {
+    return program.getInstructionCount();
+}
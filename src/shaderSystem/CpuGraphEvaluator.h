@@ -0,0 +1,71 @@
+#pragma once
+
+#include "CpuShaderProgram.h"
+#include "ofMain.h"
+#include <string>
+
+class PluginManager;
+class ShaderCompositionEngine;
+
+/**
+ * @class CpuGraphEvaluator
+ * @brief Evaluates composition graphs that use only GLSL builtins on the CPU.
+ * @details The graph is compiled into one CpuShaderProgram in the same order and with the
+ *          same argument substitution as the unified GLSL shader, so the CPU result is a
+ *          reference for the GL output without any GPU. The image is split into tiles that
+ *          worker threads take from a shared counter; each thread evaluates its tiles in
+ *          batches of CpuShaderProgram::kLanes pixels.
+ */
+class CpuGraphEvaluator {
+public:
+    CpuGraphEvaluator();
+
+    /**
+     * @brief Compiles the graph ending at the given node.
+     * @param engine The composition engine holding the graph.
+     * @param plugin_manager Used to reject graphs that call plugin functions.
+     * @param output_node_id The output node of the graph.
+     * @return True if every node is a supported builtin call, false otherwise.
+     */
+    bool build(ShaderCompositionEngine& engine, PluginManager* plugin_manager, const std::string& output_node_id);
+
+    /**
+     * @brief Checks whether a graph has been built successfully.
+     */
+    bool isReady() const;
+
+    /**
+     * @brief Renders the graph into an image.
+     * @param width The output width in pixels.
+     * @param height The output height in pixels.
+     * @param time The value of the 'time' builtin.
+     * @param pixels Receives RGBA8 output, rows bottom-up like a framebuffer readback.
+     * @param thread_count Worker threads, 0 to use every hardware thread.
+     * @return True on success, false otherwise.
+     */
+    bool render(int width, int height, float time, ofPixels& pixels, unsigned int thread_count = 0);
+
+    /**
+     * @brief Gets the throughput of the last render in megapixels per second.
+     */
+    double getLastMegapixelsPerSecond() const;
+
+    /**
+     * @brief Gets the number of threads used by the last render.
+     */
+    unsigned int getLastThreadCount() const;
+
+    /**
+     * @brief Gets the number of bytecode instructions executed per pixel batch.
+     */
+    size_t getInstructionCount() const;
+
+private:
+    static constexpr int kTileWidth = 64;    ///< Tile width, a multiple of the lane count.
+    static constexpr int kTileHeight = 32;   ///< Tile height.
+
+    CpuShaderProgram program;                ///< The compiled graph.
+    bool ready;                              ///< True once build() succeeded.
+    double last_megapixels_per_second;       ///< Throughput of the last render.
+    unsigned int last_thread_count;          ///< Threads used by the last render.
+};
@@ -0,0 +1,661 @@
+#include "CpuShaderProgram.h"
+#include "MinimalBuiltinChecker.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+    constexpr int kLanes = CpuShaderProgram::kLanes;
+
+    /// d[i] = f(a[i]) over one lane batch.
+    template <typename Function>
+    inline void mapLanes(float* d, const float* a, Function f) {
+        for (int i = 0; i < kLanes; ++i) {
+            d[i] = f(a[i]);
+        }
+    }
+
+    /// d[i] = f(a[i], b[i]) over one lane batch.
+    template <typename Function>
+    inline void mapLanes(float* d, const float* a, const float* b, Function f) {
+        for (int i = 0; i < kLanes; ++i) {
+            d[i] = f(a[i], b[i]);
+        }
+    }
+
+    /// d[i] = f(a[i], b[i], c[i]) over one lane batch.
+    template <typename Function>
+    inline void mapLanes(float* d, const float* a, const float* b, const float* c, Function f) {
+        for (int i = 0; i < kLanes; ++i) {
+            d[i] = f(a[i], b[i], c[i]);
+        }
+    }
+
+    /// Maps a swizzle letter to a component index, -1 if it is not one.
+    int swizzleComponent(char letter) {
+        static const char* sets[] = {"xyzw", "rgba", "stpq"};
+        for (const char* set : sets) {
+            const char* found = std::strchr(set, letter);
+            if (found && letter != '\0') {
+                return static_cast<int>(found - set);
+            }
+        }
+        return -1;
+    }
+}
+
+//--------------------------------------------------------------
+CpuShaderProgram::CpuShaderProgram()
+    : output_register(-1)
+    , token_index(0) {
+    register_widths = {2, 4, 1, 2};
+    names["st"] = kStRegister;
+    names["gl_FragCoord"] = kFragCoordRegister;
+    names["time"] = kTimeRegister;
+    names["resolution"] = kResolutionRegister;
+}
+
+//--------------------------------------------------------------
+const std::unordered_map<std::string, CpuShaderProgram::Builtin>& CpuShaderProgram::builtins() {
+    static const std::unordered_map<std::string, Builtin> table = {
+        {"radians", {OpCode::Radians, 1, 1, false}},
+        {"degrees", {OpCode::Degrees, 1, 1, false}},
+        {"sin", {OpCode::Sin, 1, 1, false}},
+        {"cos", {OpCode::Cos, 1, 1, false}},
+        {"tan", {OpCode::Tan, 1, 1, false}},
+        {"asin", {OpCode::Asin, 1, 1, false}},
+        {"acos", {OpCode::Acos, 1, 1, false}},
+        {"atan", {OpCode::Atan, 1, 2, false}},
+        {"sinh", {OpCode::Sinh, 1, 1, false}},
+        {"cosh", {OpCode::Cosh, 1, 1, false}},
+        {"tanh", {OpCode::Tanh, 1, 1, false}},
+        {"pow", {OpCode::Pow, 2, 2, false}},
+        {"exp", {OpCode::Exp, 1, 1, false}},
+        {"log", {OpCode::Log, 1, 1, false}},
+        {"exp2", {OpCode::Exp2, 1, 1, false}},
+        {"log2", {OpCode::Log2, 1, 1, false}},
+        {"sqrt", {OpCode::Sqrt, 1, 1, false}},
+        {"inversesqrt", {OpCode::InverseSqrt, 1, 1, false}},
+        {"abs", {OpCode::Abs, 1, 1, false}},
+        {"sign", {OpCode::Sign, 1, 1, false}},
+        {"floor", {OpCode::Floor, 1, 1, false}},
+        {"ceil", {OpCode::Ceil, 1, 1, false}},
+        {"trunc", {OpCode::Trunc, 1, 1, false}},
+        {"round", {OpCode::Round, 1, 1, false}},
+        {"fract", {OpCode::Fract, 1, 1, false}},
+        {"mod", {OpCode::Mod, 2, 2, false}},
+        {"min", {OpCode::Min, 2, 2, false}},
+        {"max", {OpCode::Max, 2, 2, false}},
+        {"clamp", {OpCode::Clamp, 3, 3, false}},
+        {"mix", {OpCode::Mix, 3, 3, false}},
+        {"step", {OpCode::Step, 2, 2, false}},
+        {"smoothstep", {OpCode::Smoothstep, 3, 3, false}},
+        {"length", {OpCode::Length, 1, 1, true}},
+        {"distance", {OpCode::Distance, 2, 2, true}},
+        {"dot", {OpCode::Dot, 2, 2, true}},
+        {"normalize", {OpCode::Normalize, 1, 1, false}}
+    };
+    return table;
+}
+
+//--------------------------------------------------------------
+int CpuShaderProgram::compileExpression(const std::string& expression, std::string& error) {
+    if (!tokenize(expression, error)) {
+        return -1;
+    }
+    token_index = 0;
+
+    int reg = parseAdditive(error);
+    if (reg >= 0 && tokens[token_index].kind != Token::End) {
+        error = "Unexpected '" + tokens[token_index].text + "' in '" + expression + "'";
+        return -1;
+    }
+    return reg;
+}
+
+//--------------------------------------------------------------
+int CpuShaderProgram::compileCall(const std::string& function_name, const std::vector<int>& arguments, std::string& error) {
+    auto it = builtins().find(function_name);
+    if (it == builtins().end()) {
+        if (MinimalBuiltinChecker::isBuiltinFunction(function_name)) {
+            error = "Builtin '" + function_name + "' is not supported on the CPU";
+        } else {
+            error = "Unknown function '" + function_name + "'";
+        }
+        return -1;
+    }
+
+    const Builtin& builtin = it->second;
+    int count = static_cast<int>(arguments.size());
+    if (count < builtin.min_arguments || count > builtin.max_arguments) {
+        error = "Wrong number of arguments for '" + function_name + "'";
+        return -1;
+    }
+    for (int reg : arguments) {
+        if (reg < 0) {
+            error = "Invalid argument for '" + function_name + "'";
+            return -1;
+        }
+    }
+
+    int width = resultWidth(arguments, error);
+    if (width < 0) {
+        return -1;
+    }
+
+    OpCode op = builtin.op;
+    if (op == OpCode::Atan && count == 2) {
+        op = OpCode::Atan2;
+    }
+
+    int a = arguments[0];
+    int b = count > 1 ? arguments[1] : -1;
+    int c = count > 2 ? arguments[2] : -1;
+    return emit(op, builtin.reduces ? 1 : width, a, b, c);
+}
+
+//--------------------------------------------------------------
+void CpuShaderProgram::bindName(const std::string& name, int reg) {
+    names[name] = reg;
+}
+
+//--------------------------------------------------------------
+void CpuShaderProgram::setOutput(int reg) {
+    output_register = reg;
+}
+
+//--------------------------------------------------------------
+int CpuShaderProgram::getOutput() const {
+    return output_register;
+}
+
+//--------------------------------------------------------------
+int CpuShaderProgram::getRegisterWidth(int reg) const {
+    return register_widths[reg];
+}
+
+//--------------------------------------------------------------
+size_t CpuShaderProgram::getInstructionCount() const {
+    return instructions.size();
+}
+
+//--------------------------------------------------------------
+size_t CpuShaderProgram::getScratchSize() const {
+    return register_widths.size() * 4 * kLanes;
+}
+
+//--------------------------------------------------------------
+void CpuShaderProgram::prepare(float* scratch, float time, float width, float height) const {
+    std::fill(scratch, scratch + getScratchSize(), 0.0f);
+
+    for (const auto& constant : constants) {
+        std::fill_n(lane(scratch, constant.first, 0), kLanes, constant.second);
+    }
+    std::fill_n(lane(scratch, kTimeRegister, 0), kLanes, time);
+    std::fill_n(lane(scratch, kResolutionRegister, 0), kLanes, width);
+    std::fill_n(lane(scratch, kResolutionRegister, 1), kLanes, height);
+    // The fullscreen triangle lies at depth 0, which maps to window depth 0.5.
+    std::fill_n(lane(scratch, kFragCoordRegister, 2), kLanes, 0.5f);
+    std::fill_n(lane(scratch, kFragCoordRegister, 3), kLanes, 1.0f);
+}
+
+//--------------------------------------------------------------
+const float* CpuShaderProgram::run(float* scratch, float frag_x, float frag_y) const {
+    float* frag_coord_x = lane(scratch, kFragCoordRegister, 0);
+    float* frag_coord_y = lane(scratch, kFragCoordRegister, 1);
+    float* st_x = lane(scratch, kStRegister, 0);
+    float* st_y = lane(scratch, kStRegister, 1);
+    float width = lane(scratch, kResolutionRegister, 0)[0];
+    float height = lane(scratch, kResolutionRegister, 1)[0];
+
+    for (int i = 0; i < kLanes; ++i) {
+        frag_coord_x[i] = frag_x + static_cast<float>(i);
+        frag_coord_y[i] = frag_y;
+        st_x[i] = frag_coord_x[i] / width;
+        st_y[i] = frag_y / height;
+    }
+
+    for (const auto& instruction : instructions) {
+        execute(instruction, scratch);
+    }
+    return lane(scratch, output_register, 0);
+}
+
+// ================================================================================
+// PARSER
+// ================================================================================
+
+//--------------------------------------------------------------
+bool CpuShaderProgram::tokenize(const std::string& expression, std::string& error) {
+    tokens.clear();
+    size_t i = 0;
+
+    while (i < expression.size()) {
+        char ch = expression[i];
+        if (std::isspace(static_cast<unsigned char>(ch))) {
+            i++;
+            continue;
+        }
+
+        bool starts_number = std::isdigit(static_cast<unsigned char>(ch)) ||
+                             (ch == '.' && i + 1 < expression.size() &&
+                              std::isdigit(static_cast<unsigned char>(expression[i + 1])));
+        if (starts_number) {
+            const char* begin = expression.c_str() + i;
+            char* end = nullptr;
+            Token token{Token::Number, "", std::strtof(begin, &end)};
+            token.text.assign(begin, static_cast<size_t>(end - begin));
+            i += static_cast<size_t>(end - begin);
+            if (i < expression.size() && (expression[i] == 'f' || expression[i] == 'F')) {
+                i++;
+            }
+            tokens.push_back(token);
+        } else if (std::isalpha(static_cast<unsigned char>(ch)) || ch == '_' || ch == '$') {
+            size_t start = i++;
+            while (i < expression.size() &&
+                   (std::isalnum(static_cast<unsigned char>(expression[i])) || expression[i] == '_')) {
+                i++;
+            }
+            tokens.push_back({Token::Identifier, expression.substr(start, i - start)});
+        } else if (std::strchr("+-*/(),.", ch)) {
+            tokens.push_back({Token::Symbol, std::string(1, ch)});
+            i++;
+        } else {
+            error = std::string("Unsupported character '") + ch + "' in '" + expression + "'";
+            return false;
+        }
+    }
+
+    tokens.push_back({Token::End, "end of expression"});
+    return true;
+}
+
+//--------------------------------------------------------------
+bool CpuShaderProgram::acceptSymbol(char symbol) {
+    const Token& token = tokens[token_index];
+    if (token.kind == Token::Symbol && token.text[0] == symbol) {
+        token_index++;
+        return true;
+    }
+    return false;
+}
+
+//--------------------------------------------------------------
+int CpuShaderProgram::parseAdditive(std::string& error) {
+    int left = parseMultiplicative(error);
+    while (left >= 0) {
+        OpCode op;
+        if (acceptSymbol('+')) {
+            op = OpCode::Add;
+        } else if (acceptSymbol('-')) {
+            op = OpCode::Subtract;
+        } else {
+            break;
+        }
+        int right = parseMultiplicative(error);
+        if (right < 0) {
+            return -1;
+        }
+        int width = resultWidth({left, right}, error);
+        if (width < 0) {
+            return -1;
+        }
+        left = emit(op, width, left, right);
+    }
+    return left;
+}
+
+//--------------------------------------------------------------
+int CpuShaderProgram::parseMultiplicative(std::string& error) {
+    int left = parseUnary(error);
+    while (left >= 0) {
+        OpCode op;
+        if (acceptSymbol('*')) {
+            op = OpCode::Multiply;
+        } else if (acceptSymbol('/')) {
+            op = OpCode::Divide;
+        } else {
+            break;
+        }
+        int right = parseUnary(error);
+        if (right < 0) {
+            return -1;
+        }
+        int width = resultWidth({left, right}, error);
+        if (width < 0) {
+            return -1;
+        }
+        left = emit(op, width, left, right);
+    }
+    return left;
+}
+
+//--------------------------------------------------------------
+int CpuShaderProgram::parseUnary(std::string& error) {
+    if (acceptSymbol('-')) {
+        int operand = parseUnary(error);
+        return operand < 0 ? -1 : emit(OpCode::Negate, register_widths[operand], operand);
+    }
+    if (acceptSymbol('+')) {
+        return parseUnary(error);
+    }
+    return parsePostfix(error);
+}
+
+//--------------------------------------------------------------
+int CpuShaderProgram::parsePostfix(std::string& error) {
+    int reg = parsePrimary(error);
+    while (reg >= 0 && acceptSymbol('.')) {
+        const Token& token = tokens[token_index];
+        if (token.kind != Token::Identifier) {
+            error = "Expected a swizzle after '.'";
+            return -1;
+        }
+        token_index++;
+        reg = parseSwizzle(reg, token.text, error);
+    }
+    return reg;
+}
+
+//--------------------------------------------------------------
+int CpuShaderProgram::parsePrimary(std::string& error) {
+    const Token token = tokens[token_index];
+
+    if (token.kind == Token::Number) {
+        token_index++;
+        return addConstant(token.value);
+    }
+
+    if (acceptSymbol('(')) {
+        int reg = parseAdditive(error);
+        if (reg >= 0 && !acceptSymbol(')')) {
+            error = "Expected ')'";
+            return -1;
+        }
+        return reg;
+    }
+
+    if (token.kind != Token::Identifier) {
+        error = "Unexpected '" + token.text + "'";
+        return -1;
+    }
+    token_index++;
+
+    if (!acceptSymbol('(')) {
+        auto it = names.find(token.text);
+        if (it == names.end()) {
+            error = "Unknown identifier '" + token.text + "'";
+            return -1;
+        }
+        return it->second;
+    }
+
+    std::vector<int> arguments;
+    if (!acceptSymbol(')')) {
+        do {
+            int argument = parseAdditive(error);
+            if (argument < 0) {
+                return -1;
+            }
+            arguments.push_back(argument);
+        } while (acceptSymbol(','));
+
+        if (!acceptSymbol(')')) {
+            error = "Expected ')' after arguments of '" + token.text + "'";
+            return -1;
+        }
+    }
+
+    if (token.text == "float") {
+        return parseConstructor(1, arguments, error);
+    }
+    if (token.text == "vec2" || token.text == "vec3" || token.text == "vec4") {
+        return parseConstructor(token.text[3] - '0', arguments, error);
+    }
+    if (MinimalBuiltinChecker::isBuiltinDataType(token.text)) {
+        error = "Type '" + token.text + "' is not supported on the CPU";
+        return -1;
+    }
+    return compileCall(token.text, arguments, error);
+}
+
+//--------------------------------------------------------------
+int CpuShaderProgram::parseSwizzle(int reg, const std::string& swizzle, std::string& error) {
+    if (swizzle.empty() || swizzle.size() > 4) {
+        error = "Invalid swizzle '." + swizzle + "'";
+        return -1;
+    }
+
+    int dst = addRegister(static_cast<int>(swizzle.size()));
+    for (size_t i = 0; i < swizzle.size(); ++i) {
+        int component = swizzleComponent(swizzle[i]);
+        if (component < 0 || component >= register_widths[reg]) {
+            error = "Invalid swizzle '." + swizzle + "'";
+            return -1;
+        }
+        emitCopy(dst, static_cast<int>(i), reg, component);
+    }
+    return dst;
+}
+
+//--------------------------------------------------------------
+int CpuShaderProgram::parseConstructor(int width, const std::vector<int>& arguments, std::string& error) {
+    if (arguments.empty()) {
+        error = "Constructor without arguments";
+        return -1;
+    }
+
+    int dst = addRegister(width);
+
+    // A single scalar fills every component.
+    if (arguments.size() == 1 && register_widths[arguments[0]] == 1) {
+        for (int i = 0; i < width; ++i) {
+            emitCopy(dst, i, arguments[0], 0);
+        }
+        return dst;
+    }
+
+    // A single vector may be truncated; otherwise components are consumed in order.
+    int component = 0;
+    for (size_t i = 0; i < arguments.size(); ++i) {
+        if (component >= width) {
+            error = "Too many arguments for constructor";
+            return -1;
+        }
+        for (int j = 0; j < register_widths[arguments[i]] && component < width; ++j) {
+            emitCopy(dst, component++, arguments[i], j);
+        }
+    }
+    if (component < width) {
+        error = "Not enough arguments for constructor";
+        return -1;
+    }
+    return dst;
+}
+
+// ================================================================================
+// CODE GENERATION
+// ================================================================================
+
+//--------------------------------------------------------------
+int CpuShaderProgram::addRegister(int width) {
+    register_widths.push_back(width);
+    return static_cast<int>(register_widths.size()) - 1;
+}
+
+//--------------------------------------------------------------
+int CpuShaderProgram::addConstant(float value) {
+    for (const auto& constant : constants) {
+        if (constant.second == value) {
+            return constant.first;
+        }
+    }
+    int reg = addRegister(1);
+    constants.emplace_back(reg, value);
+    return reg;
+}
+
+//--------------------------------------------------------------
+int CpuShaderProgram::emit(OpCode op, int width, int a, int b, int c) {
+    Instruction instruction;
+    instruction.op = op;
+    instruction.dst = addRegister(width);
+    instruction.a = a;
+    instruction.b = b;
+    instruction.c = c;
+    instruction.width = width;
+    instructions.push_back(instruction);
+    return instruction.dst;
+}
+
+//--------------------------------------------------------------
+int CpuShaderProgram::emitCopy(int dst, int dst_component, int src, int src_component) {
+    Instruction instruction;
+    instruction.op = OpCode::Copy;
+    instruction.dst = dst;
+    instruction.a = src;
+    instruction.width = 1;
+    instruction.dst_component = dst_component;
+    instruction.src_component = src_component;
+    instructions.push_back(instruction);
+    return dst;
+}
+
+//--------------------------------------------------------------
+int CpuShaderProgram::resultWidth(const std::vector<int>& operands, std::string& error) const {
+    int width = 1;
+    for (int reg : operands) {
+        width = std::max(width, register_widths[reg]);
+    }
+    for (int reg : operands) {
+        if (register_widths[reg] != 1 && register_widths[reg] != width) {
+            error = "Mismatched vector sizes";
+            return -1;
+        }
+    }
+    return width;
+}
+
+// ================================================================================
+// EVALUATION
+// ================================================================================
+
+//--------------------------------------------------------------
+float* CpuShaderProgram::lane(float* scratch, int reg, int component) const {
+    return scratch + (static_cast<size_t>(reg) * 4 + component) * kLanes;
+}
+
+//--------------------------------------------------------------
+const float* CpuShaderProgram::operand(const float* scratch, int reg, int component) const {
+    if (register_widths[reg] == 1) {
+        component = 0;
+    }
+    return scratch + (static_cast<size_t>(reg) * 4 + component) * kLanes;
+}
+
+//--------------------------------------------------------------
+void CpuShaderProgram::execute(const Instruction& in, float* scratch) const {
+    // Instructions that combine components.
+    switch (in.op) {
+        case OpCode::Copy:
+            std::memcpy(lane(scratch, in.dst, in.dst_component), lane(scratch, in.a, in.src_component),
+                        sizeof(float) * kLanes);
+            return;
+
+        case OpCode::Length:
+        case OpCode::Distance:
+        case OpCode::Dot:
+        case OpCode::Normalize: {
+            float sum[kLanes] = {};
+            int width = std::max(register_widths[in.a], in.b >= 0 ? register_widths[in.b] : 1);
+            for (int k = 0; k < width; ++k) {
+                const float* a = operand(scratch, in.a, k);
+                if (in.op == OpCode::Dot) {
+                    const float* b = operand(scratch, in.b, k);
+                    for (int i = 0; i < kLanes; ++i) sum[i] += a[i] * b[i];
+                } else if (in.op == OpCode::Distance) {
+                    const float* b = operand(scratch, in.b, k);
+                    for (int i = 0; i < kLanes; ++i) sum[i] += (a[i] - b[i]) * (a[i] - b[i]);
+                } else {
+                    for (int i = 0; i < kLanes; ++i) sum[i] += a[i] * a[i];
+                }
+            }
+            if (in.op == OpCode::Dot) {
+                std::memcpy(lane(scratch, in.dst, 0), sum, sizeof(sum));
+            } else if (in.op == OpCode::Normalize) {
+                for (int k = 0; k < in.width; ++k) {
+                    mapLanes(lane(scratch, in.dst, k), operand(scratch, in.a, k), sum,
+                             [](float x, float s) { return x / std::sqrt(s); });
+                }
+            } else {
+                mapLanes(lane(scratch, in.dst, 0), sum, [](float s) { return std::sqrt(s); });
+            }
+            return;
+        }
+
+        default:
+            break;
+    }
+
+    // Component-wise instructions.
+    for (int k = 0; k < in.width; ++k) {
+        float* d = lane(scratch, in.dst, k);
+        const float* a = operand(scratch, in.a, k);
+        const float* b = in.b >= 0 ? operand(scratch, in.b, k) : nullptr;
+        const float* c = in.c >= 0 ? operand(scratch, in.c, k) : nullptr;
+
+        switch (in.op) {
+            case OpCode::Negate:      mapLanes(d, a, [](float x) { return -x; }); break;
+            case OpCode::Add:         mapLanes(d, a, b, [](float x, float y) { return x + y; }); break;
+            case OpCode::Subtract:    mapLanes(d, a, b, [](float x, float y) { return x - y; }); break;
+            case OpCode::Multiply:    mapLanes(d, a, b, [](float x, float y) { return x * y; }); break;
+            case OpCode::Divide:      mapLanes(d, a, b, [](float x, float y) { return x / y; }); break;
+            case OpCode::Sin:         mapLanes(d, a, [](float x) { return std::sin(x); }); break;
+            case OpCode::Cos:         mapLanes(d, a, [](float x) { return std::cos(x); }); break;
+            case OpCode::Tan:         mapLanes(d, a, [](float x) { return std::tan(x); }); break;
+            case OpCode::Asin:        mapLanes(d, a, [](float x) { return std::asin(x); }); break;
+            case OpCode::Acos:        mapLanes(d, a, [](float x) { return std::acos(x); }); break;
+            case OpCode::Atan:        mapLanes(d, a, [](float x) { return std::atan(x); }); break;
+            case OpCode::Atan2:       mapLanes(d, a, b, [](float y, float x) { return std::atan2(y, x); }); break;
+            case OpCode::Sinh:        mapLanes(d, a, [](float x) { return std::sinh(x); }); break;
+            case OpCode::Cosh:        mapLanes(d, a, [](float x) { return std::cosh(x); }); break;
+            case OpCode::Tanh:        mapLanes(d, a, [](float x) { return std::tanh(x); }); break;
+            case OpCode::Radians:     mapLanes(d, a, [](float x) { return x * 0.017453292519943295f; }); break;
+            case OpCode::Degrees:     mapLanes(d, a, [](float x) { return x * 57.29577951308232f; }); break;
+            case OpCode::Pow:         mapLanes(d, a, b, [](float x, float y) { return std::pow(x, y); }); break;
+            case OpCode::Exp:         mapLanes(d, a, [](float x) { return std::exp(x); }); break;
+            case OpCode::Log:         mapLanes(d, a, [](float x) { return std::log(x); }); break;
+            case OpCode::Exp2:        mapLanes(d, a, [](float x) { return std::exp2(x); }); break;
+            case OpCode::Log2:        mapLanes(d, a, [](float x) { return std::log2(x); }); break;
+            case OpCode::Sqrt:        mapLanes(d, a, [](float x) { return std::sqrt(x); }); break;
+            case OpCode::InverseSqrt: mapLanes(d, a, [](float x) { return 1.0f / std::sqrt(x); }); break;
+            case OpCode::Abs:         mapLanes(d, a, [](float x) { return std::fabs(x); }); break;
+            case OpCode::Sign:        mapLanes(d, a, [](float x) { return static_cast<float>((x > 0.0f) - (x < 0.0f)); }); break;
+            case OpCode::Floor:       mapLanes(d, a, [](float x) { return std::floor(x); }); break;
+            case OpCode::Ceil:        mapLanes(d, a, [](float x) { return std::ceil(x); }); break;
+            case OpCode::Trunc:       mapLanes(d, a, [](float x) { return std::trunc(x); }); break;
+            case OpCode::Round:       mapLanes(d, a, [](float x) { return std::round(x); }); break;
+            case OpCode::Fract:       mapLanes(d, a, [](float x) { return x - std::floor(x); }); break;
+            case OpCode::Mod:         mapLanes(d, a, b, [](float x, float y) { return x - y * std::floor(x / y); }); break;
+            case OpCode::Min:         mapLanes(d, a, b, [](float x, float y) { return y < x ? y : x; }); break;
+            case OpCode::Max:         mapLanes(d, a, b, [](float x, float y) { return x < y ? y : x; }); break;
+            case OpCode::Step:        mapLanes(d, a, b, [](float edge, float x) { return x < edge ? 0.0f : 1.0f; }); break;
+            case OpCode::Clamp:
+                mapLanes(d, a, b, c, [](float x, float lo, float hi) { return std::min(std::max(x, lo), hi); });
+                break;
+            case OpCode::Mix:
+                mapLanes(d, a, b, c, [](float x, float y, float t) { return x * (1.0f - t) + y * t; });
+                break;
+            case OpCode::Smoothstep:
+                mapLanes(d, a, b, c, [](float edge0, float edge1, float x) {
+                    float t = std::min(std::max((x - edge0) / (edge1 - edge0), 0.0f), 1.0f);
+                    return t * t * (3.0f - 2.0f * t);
+                });
+                break;
+            default:
+                break;
+        }
+    }
+}
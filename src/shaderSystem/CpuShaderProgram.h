@@ -0,0 +1,168 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @class CpuShaderProgram
+ * @brief A register bytecode for GLSL expressions over builtin functions, evaluated on the CPU.
+ * @details Expressions are parsed into SSA instructions whose registers hold up to four
+ *          components. Every register component is a batch of kLanes floats, one per pixel,
+ *          so each instruction runs a short fixed-length loop the compiler can vectorize and
+ *          the interpreter dispatch cost is paid once per batch rather than once per pixel.
+ *
+ *          Supported are float literals, +, -, *, /, swizzles, vec2/vec3/vec4/float
+ *          constructors, the builtin variables st, time, resolution and gl_FragCoord, and
+ *          the component-wise, geometric and exponential builtins listed in
+ *          MinimalBuiltinChecker. Everything else (textures, derivatives, matrices,
+ *          integers, booleans) is rejected at compile time.
+ */
+class CpuShaderProgram {
+public:
+    /// Pixels processed per instruction.
+    static constexpr int kLanes = 16;
+
+    CpuShaderProgram();
+
+    /**
+     * @brief Compiles a GLSL expression.
+     * @param expression The expression text, e.g. "sin(st.x * 10.0 + time)".
+     * @param error Receives a description of the problem on failure.
+     * @return The register holding the result, -1 on error.
+     */
+    int compileExpression(const std::string& expression, std::string& error);
+
+    /**
+     * @brief Compiles a builtin function call on already compiled arguments.
+     * @param function_name The GLSL builtin function.
+     * @param arguments Registers of the arguments.
+     * @param error Receives a description of the problem on failure.
+     * @return The register holding the result, -1 on error.
+     */
+    int compileCall(const std::string& function_name, const std::vector<int>& arguments, std::string& error);
+
+    /**
+     * @brief Makes a register visible to later expressions under a name.
+     * @details Used for the results of upstream graph nodes ("$shader_1").
+     */
+    void bindName(const std::string& name, int reg);
+
+    /**
+     * @brief Sets the register whose first component is the program output.
+     */
+    void setOutput(int reg);
+
+    int getOutput() const;
+    int getRegisterWidth(int reg) const;
+    size_t getInstructionCount() const;
+
+    /**
+     * @brief Gets the number of floats of scratch storage one evaluating thread needs.
+     */
+    size_t getScratchSize() const;
+
+    /**
+     * @brief Fills the per-frame registers (constants, time, resolution) of a thread's scratch storage.
+     * @param scratch Storage of getScratchSize() floats.
+     */
+    void prepare(float* scratch, float time, float width, float height) const;
+
+    /**
+     * @brief Evaluates one batch of kLanes horizontally adjacent pixels.
+     * @param scratch Storage initialized with prepare().
+     * @param frag_x gl_FragCoord.x of the first pixel of the batch.
+     * @param frag_y gl_FragCoord.y of all pixels of the batch.
+     * @return Pointer to the kLanes output values.
+     */
+    const float* run(float* scratch, float frag_x, float frag_y) const;
+
+private:
+    enum class OpCode {
+        Copy,           ///< dst[component] = a[source component]
+        Negate,
+        Add, Subtract, Multiply, Divide,
+        Sin, Cos, Tan, Asin, Acos, Atan, Atan2, Sinh, Cosh, Tanh,
+        Radians, Degrees,
+        Pow, Exp, Log, Exp2, Log2, Sqrt, InverseSqrt,
+        Abs, Sign, Floor, Ceil, Trunc, Round, Fract, Mod, Min, Max,
+        Clamp, Mix, Step, Smoothstep,
+        Length, Distance, Dot, Normalize
+    };
+
+    /**
+     * @struct Instruction
+     * @brief One bytecode instruction. Operands of width 1 broadcast to the result width.
+     */
+    struct Instruction {
+        OpCode op;
+        int dst = -1;
+        int a = -1;
+        int b = -1;
+        int c = -1;
+        int width = 1;             ///< Result width.
+        int dst_component = 0;     ///< Copy: destination component.
+        int src_component = 0;     ///< Copy: source component.
+    };
+
+    /**
+     * @struct Builtin
+     * @brief Signature of a supported builtin function.
+     */
+    struct Builtin {
+        OpCode op;
+        int min_arguments;
+        int max_arguments;
+        bool reduces;              ///< True if the result is a scalar (length, dot, ...).
+    };
+
+    /**
+     * @struct Token
+     * @brief A lexical token of an expression.
+     */
+    struct Token {
+        enum Kind { Number, Identifier, Symbol, End } kind;
+        std::string text;
+        float value = 0.0f;
+    };
+
+    // --- Parser ---
+    bool tokenize(const std::string& expression, std::string& error);
+    int parseAdditive(std::string& error);
+    int parseMultiplicative(std::string& error);
+    int parseUnary(std::string& error);
+    int parsePostfix(std::string& error);
+    int parsePrimary(std::string& error);
+    int parseSwizzle(int reg, const std::string& swizzle, std::string& error);
+    int parseConstructor(int width, const std::vector<int>& arguments, std::string& error);
+    bool acceptSymbol(char symbol);
+
+    // --- Code generation ---
+    int addRegister(int width);
+    int addConstant(float value);
+    int emit(OpCode op, int width, int a, int b = -1, int c = -1);
+    int emitCopy(int dst, int dst_component, int src, int src_component);
+    int resultWidth(const std::vector<int>& operands, std::string& error) const;
+
+    // --- Evaluation ---
+    float* lane(float* scratch, int reg, int component) const;
+    const float* operand(const float* scratch, int reg, int component) const;
+    void execute(const Instruction& instruction, float* scratch) const;
+
+    static const std::unordered_map<std::string, Builtin>& builtins();
+
+    std::vector<Instruction> instructions;          ///< The program, in execution order.
+    std::vector<int> register_widths;               ///< Component count of every register.
+    std::vector<std::pair<int, float>> constants;   ///< Constant registers and their values.
+    std::unordered_map<std::string, int> names;     ///< Named registers visible to expressions.
+    int output_register;                            ///< Register of the program output.
+
+    std::vector<Token> tokens;                      ///< Tokens of the expression being compiled.
+    size_t token_index;                             ///< Next token to consume.
+
+    // Reserved registers filled by prepare() and run().
+    static constexpr int kStRegister = 0;
+    static constexpr int kFragCoordRegister = 1;
+    static constexpr int kTimeRegister = 2;
+    static constexpr int kResolutionRegister = 3;
+};
@@ -1,11 +1,13 @@
 #include "ExpressionParser.h"
 #include "BuiltinVariables.h"
 #include "ofMain.h"
+#include "../statsSystem/AllocationTracker.h"
 #include <regex>
 #include <algorithm>
 
 //--------------------------------------------------------------
 ExpressionInfo ExpressionParser::parseExpression(const std::string& expr) {
+    AllocationScope allocation_scope(AllocationTag::EXPRESSION);
     ExpressionInfo info;
     info.original = expr;
     
@@ -21,7 +21,8 @@ enum class GlobalOutputState {
  * @details This singleton-like class handles which shader node is currently
  *          connected to the final output. All created shader nodes start in
  *          an idle state, and only one can be connected to the global output
- *          at a time for final rendering to the screen.
+ *          at a time for final rendering to the screen. Drawing the connected
+ *          shader is left to FullscreenPass.
  */
 class GlobalOutputNode {
 public:
@@ -64,22 +65,6 @@ public:
      */
     std::shared_ptr<ShaderNode> getConnectedShader() const;
     
-    // ================================================================================
-    // RENDERING SYSTEM
-    // ================================================================================
-    
-    /**
-     * @brief Renders the currently connected shader or default output
-     * @param plane The plane primitive to render the shader onto
-     */
-    void render(ofPlanePrimitive& plane);
-    
-    /**
-     * @brief Updates automatic uniforms for the connected shader
-     * @details This should be called every frame before rendering
-     */
-    void updateUniforms();
-    
     // ================================================================================
     // STATE MANAGEMENT
     // ================================================================================
@@ -101,22 +86,6 @@ public:
      * @return Detailed status information including connected shader details
      */
     std::string getDetailedStatus() const;
-    
-    // ================================================================================
-    // FALLBACK RENDERING
-    // ================================================================================
-    
-    /**
-     * @brief Sets the default background color when no shader is connected
-     * @param color The background color to use
-     */
-    void setDefaultBackgroundColor(const ofColor& color);
-    
-    /**
-     * @brief Enables or disables debug visualization
-     * @param enabled True to show debug info, false to hide
-     */
-    void setDebugMode(bool enabled);
 
 private:
     // ================================================================================
@@ -127,14 +96,9 @@ private:
     std::shared_ptr<ShaderNode> connected_shader; ///< Currently connected shader
     std::string connected_shader_id;           ///< ID of the connected shader
     
-    // Rendering settings
-    ofColor default_background_color;          ///< Background color when idle
-    bool debug_mode;                          ///< Whether to show debug information
-    
     // Statistics
     std::string connection_timestamp;          ///< When the current shader was connected
     size_t total_connections;                 ///< Total number of connections made
-    size_t total_renders;                     ///< Total number of render calls
     
     // ================================================================================
     // INTERNAL METHODS
@@ -145,17 +109,6 @@ private:
      */
     void updateState();
     
-    /**
-     * @brief Renders the default output when no shader is connected
-     * @param plane The plane to render onto
-     */
-    void renderDefault(ofPlanePrimitive& plane);
-    
-    /**
-     * @brief Renders debug information overlay
-     */
-    void renderDebugInfo();
-    
     /**
      * @brief Generates a timestamp string for the current time
      * @return Current timestamp as string
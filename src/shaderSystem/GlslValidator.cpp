@@ -0,0 +1,230 @@
+#include "GlslValidator.h"
+#include <filesystem>
+#include <mutex>
+#include <regex>
+#include <sstream>
+
+#ifdef GE_HAVE_GLSLANG
+#include <glslang/Public/ResourceLimits.h>
+#include <glslang/Public/ShaderLang.h>
+#endif
+
+namespace {
+
+/// Name of the generated source in front-end messages.
+const char* kGeneratedSourceName = "generated";
+
+#ifdef GE_HAVE_GLSLANG
+/// Resolves quoted includes relative to the including file, and remembers which top-level
+/// #include of the generated source each file was reached through.
+class GlslIncluder : public glslang::TShader::Includer {
+public:
+    explicit GlslIncluder(const std::string& base_directory)
+        : directory(base_directory) {
+    }
+
+    IncludeResult* includeLocal(const char* header_name, const char* includer_name, size_t) override {
+        bool from_generated = std::string(includer_name) == kGeneratedSourceName;
+        std::string including_directory = from_generated ? directory
+                                                         : ofFilePath::getEnclosingDirectory(includer_name, false);
+        std::string path = std::filesystem::path(ofFilePath::join(including_directory, header_name)).lexically_normal().string();
+
+        ofBuffer buffer = ofBufferFromFile(path);
+        if (buffer.size() == 0) {
+            return nullptr;
+        }
+        top_level_headers[path] = from_generated ? std::string(header_name) : top_level_headers[includer_name];
+
+        std::string* text = new std::string(buffer.getText());
+        return new IncludeResult(path, text->data(), text->size(), text);
+    }
+
+    void releaseInclude(IncludeResult* result) override {
+        if (result) {
+            delete static_cast<std::string*>(result->userData);
+            delete result;
+        }
+    }
+
+    std::map<std::string, std::string> top_level_headers;  ///< Included file -> top-level header name.
+
+private:
+    std::string directory;
+};
+
+/// Maps a GL stage to the front-end's, false for stages the engine does not generate.
+bool getLanguage(GLenum stage, EShLanguage& language) {
+    switch (stage) {
+        case GL_VERTEX_SHADER: language = EShLangVertex; return true;
+        case GL_FRAGMENT_SHADER: language = EShLangFragment; return true;
+        case GL_COMPUTE_SHADER: language = EShLangCompute; return true;
+        default: return false;
+    }
+}
+#endif
+
+} // namespace
+
+//--------------------------------------------------------------
+std::string GlslDiagnostic::toString() const {
+    std::stringstream text;
+    if (!node_id.empty()) {
+        text << "node " << node_id;
+        if (argument_index >= 0) {
+            text << " argument " << argument_index;
+        }
+        text << ": ";
+    }
+    if (line > 0) {
+        text << file << ":" << line << ": ";
+    }
+    text << message;
+    return text.str();
+}
+
+//--------------------------------------------------------------
+bool GlslValidator::isAvailable() {
+#ifdef GE_HAVE_GLSLANG
+    return true;
+#else
+    return false;
+#endif
+}
+
+//--------------------------------------------------------------
+bool GlslValidator::validate(const std::string& source, GLenum stage, const std::string& directory,
+                             const std::vector<GlslSourceRegion>& regions) {
+    diagnostics.clear();
+#ifdef GE_HAVE_GLSLANG
+    static std::once_flag initialized;
+    std::call_once(initialized, [] { glslang::InitializeProcess(); });
+
+    EShLanguage language;
+    if (!getLanguage(stage, language)) {
+        ofLogError("GlslValidator") << "Unsupported shader stage: " << stage;
+        return false;
+    }
+
+    glslang::TShader shader(language);
+    const char* strings[] = { source.c_str() };
+    const int lengths[] = { static_cast<int>(source.size()) };
+    const char* names[] = { kGeneratedSourceName };
+    shader.setStringsWithLengthsAndNames(strings, lengths, names, 1);
+    // ofShader expands includes without an extension, the front-end needs one
+    shader.setPreamble("#extension GL_GOOGLE_include_directive : enable\n");
+
+    // Same fallback as ofShader for sources without a directory
+    GlslIncluder includer(directory.empty() ? ofToDataPath("", true) : directory);
+    EShMessages messages = EShMsgDefault;
+    bool valid = shader.parse(GetDefaultResources(), 330, false, messages, includer);
+    std::string log = shader.getInfoLog();
+    if (valid) {
+        glslang::TProgram program;
+        program.addShader(&shader);
+        valid = program.link(messages);
+        log += program.getInfoLog();
+    }
+
+    if (!valid) {
+        parseLog(log, source, regions, includer.top_level_headers);
+        if (diagnostics.empty()) {
+            GlslDiagnostic diagnostic;
+            diagnostic.message = log.empty() ? "Validation failed" : log;
+            diagnostics.push_back(diagnostic);
+        }
+    }
+    return valid;
+#else
+    (void)source;
+    (void)stage;
+    (void)directory;
+    (void)regions;
+    return true;
+#endif
+}
+
+//--------------------------------------------------------------
+const std::vector<GlslDiagnostic>& GlslValidator::getDiagnostics() const {
+    return diagnostics;
+}
+
+//--------------------------------------------------------------
+std::string GlslValidator::getErrorSummary() const {
+    std::stringstream summary;
+    for (const auto& diagnostic : diagnostics) {
+        summary << diagnostic.toString() << "\n";
+    }
+    return summary.str();
+}
+
+//--------------------------------------------------------------
+void GlslValidator::parseLog(const std::string& log, const std::string& source,
+                             const std::vector<GlslSourceRegion>& regions,
+                             const std::map<std::string, std::string>& top_level_headers) {
+    static const std::regex located_regex(R"(^ERROR: (.+):(\d+): (.*)$)");
+    static const std::regex unlocated_regex(R"(^ERROR: (.*)$)");
+    static const std::regex identifier_regex(R"('([A-Za-z_]\w*)')");
+
+    // Byte offset of every line start, for mapping lines of the generated source to regions
+    std::vector<size_t> line_starts = {0};
+    for (size_t i = 0; i < source.size(); ++i) {
+        if (source[i] == '\n') {
+            line_starts.push_back(i + 1);
+        }
+    }
+
+    std::istringstream lines(log);
+    std::string line;
+    while (std::getline(lines, line)) {
+        std::smatch match;
+        GlslDiagnostic diagnostic;
+        if (std::regex_match(line, match, located_regex)) {
+            diagnostic.file = match[1].str();
+            diagnostic.line = std::stoi(match[2].str());
+            diagnostic.message = match[3].str();
+        } else if (std::regex_match(line, match, unlocated_regex)) {
+            diagnostic.message = match[1].str();
+            // The front-end closes with a count of the errors it already reported
+            if (diagnostic.message.find("compilation errors") != std::string::npos) {
+                continue;
+            }
+        } else {
+            continue;
+        }
+
+        const GlslSourceRegion* region = nullptr;
+        if (diagnostic.file == kGeneratedSourceName && diagnostic.line > 0 &&
+            static_cast<size_t>(diagnostic.line) <= line_starts.size()) {
+            size_t offset = line_starts[diagnostic.line - 1];
+            for (const auto& candidate : regions) {
+                if (offset >= candidate.begin && offset < candidate.end) {
+                    region = &candidate;
+                    break;
+                }
+            }
+        } else if (!diagnostic.file.empty()) {
+            auto header = top_level_headers.find(diagnostic.file);
+            for (const auto& candidate : regions) {
+                if (header != top_level_headers.end() && candidate.include_name == header->second) {
+                    region = &candidate;
+                    break;
+                }
+            }
+        }
+
+        if (region) {
+            diagnostic.node_id = region->node_id;
+            std::smatch identifier;
+            if (std::regex_search(diagnostic.message, identifier, identifier_regex)) {
+                std::regex word("\\b" + identifier[1].str() + "\\b");
+                for (size_t i = 0; i < region->arguments.size(); ++i) {
+                    if (std::regex_search(region->arguments[i], word)) {
+                        diagnostic.argument_index = static_cast<int>(i);
+                        break;
+                    }
+                }
+            }
+        }
+        diagnostics.push_back(diagnostic);
+    }
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "ofMain.h"
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * @struct GlslSourceRegion
+ * @brief The part of a generated source emitted for one composition node.
+ */
+struct GlslSourceRegion {
+    size_t begin = 0;                       ///< First byte of the region in the source.
+    size_t end = 0;                         ///< One past the last byte of the region.
+    std::string node_id;                    ///< The node the region was emitted for.
+    std::vector<std::string> arguments;     ///< The node's arguments as emitted into GLSL.
+    std::string include_name;               ///< Header of an #include emitted in the region, empty if none.
+};
+
+/**
+ * @struct GlslDiagnostic
+ * @brief One error reported by the GLSL front-end, attributed to a node where possible.
+ */
+struct GlslDiagnostic {
+    std::string file;           ///< The generated source or the included file the error is in.
+    int line = 0;               ///< 1-based line in that file, 0 if the error has no location.
+    std::string message;        ///< The front-end's message.
+    std::string node_id;        ///< The node the error belongs to, empty if unknown.
+    int argument_index = -1;    ///< The argument the message refers to, -1 if unknown.
+
+    /**
+     * @brief Formats the diagnostic as "node <id> argument <n>: <file>:<line>: <message>".
+     */
+    std::string toString() const;
+};
+
+/**
+ * @class GlslValidator
+ * @brief Checks generated GLSL with the glslang reference front-end before it reaches the driver.
+ * @details Built with GE_HAVE_GLSLANG, validate() preprocesses, parses and links a single
+ *          stage, resolving quoted #include directives relative to the including file like
+ *          ofShader does. It needs no GL context, so it runs before any program object is
+ *          created and works on machines without a GPU. Errors are mapped back to the
+ *          node regions recorded while generating: by line for the generated source, and
+ *          by the top-level #include for errors inside plugin files. A quoted identifier in
+ *          the message is matched against the node's arguments.
+ *
+ *          Without glslang every source passes and the driver remains the only check.
+ */
+class GlslValidator {
+public:
+    /**
+     * @brief Checks whether this build contains the front-end.
+     */
+    static bool isAvailable();
+
+    /**
+     * @brief Validates one shader stage.
+     * @param source The complete source, starting with #version.
+     * @param stage GL_VERTEX_SHADER, GL_FRAGMENT_SHADER or GL_COMPUTE_SHADER.
+     * @param directory Directory for #include resolution, empty for the data path.
+     * @param regions Node regions of the source, for attributing errors.
+     * @return True if the source is valid or no front-end is available.
+     */
+    bool validate(const std::string& source, GLenum stage, const std::string& directory,
+                  const std::vector<GlslSourceRegion>& regions = {});
+
+    /**
+     * @brief Gets the errors of the last validate() call.
+     */
+    const std::vector<GlslDiagnostic>& getDiagnostics() const;
+
+    /**
+     * @brief Gets the errors of the last validate() call, one per line.
+     */
+    std::string getErrorSummary() const;
+
+private:
+    /**
+     * @brief Turns the front-end's info log into diagnostics.
+     * @param log The info log.
+     * @param source The validated source, for mapping lines to regions.
+     * @param regions Node regions of the source.
+     * @param top_level_headers The top-level #include each included file was reached through.
+     */
+    void parseLog(const std::string& log, const std::string& source,
+                  const std::vector<GlslSourceRegion>& regions,
+                  const std::map<std::string, std::string>& top_level_headers);
+
+    std::vector<GlslDiagnostic> diagnostics;    ///< Errors of the last validation.
+};
@@ -0,0 +1,194 @@
+#include "GraphSync.h"
+#include <regex>
+
+namespace {
+
+bool isValidKey(const std::string& key) {
+    static const std::regex key_regex(R"([A-Za-z_]\w*)");
+    return std::regex_match(key, key_regex);
+}
+
+bool sameNode(const GraphDescription::Node& a, const GraphDescription::Node& b) {
+    return a.function_name == b.function_name && a.arguments == b.arguments;
+}
+
+} // namespace
+
+//--------------------------------------------------------------
+GraphSync::GraphSync(ShaderCompositionEngine* composition_engine)
+    : engine(composition_engine) {
+}
+
+//--------------------------------------------------------------
+bool GraphSync::apply(const GraphDescription& desired, GraphSyncResult& result) {
+    result = GraphSyncResult();
+
+    // --- Validate everything before touching the engine ---
+    std::set<std::string> keys;
+    for (const auto& [key, node] : desired.nodes) {
+        keys.insert(key);
+    }
+    for (const auto& [key, node] : desired.nodes) {
+        if (!isValidKey(key)) {
+            result.error = "Invalid node key: " + key;
+            return false;
+        }
+        auto applied = applied_nodes.find(key);
+        bool function_changed = applied == applied_nodes.end() || applied->second.function_name != node.function_name;
+        if (function_changed && !engine->isFunctionAvailable(node.function_name)) {
+            result.error = "Unknown function '" + node.function_name + "' for node " + key;
+            return false;
+        }
+        std::vector<std::string> rewritten;
+        if (!rewriteReferences(node.arguments, keys, rewritten, result.error)) {
+            return false;
+        }
+    }
+    for (const auto& [output, key] : desired.outputs) {
+        if (!keys.count(key)) {
+            result.error = "Output " + output + " shows unknown node " + key;
+            return false;
+        }
+    }
+
+    // --- Apply the diff ---
+    std::set<std::string> changed_ids;
+
+    for (auto it = node_ids.begin(); it != node_ids.end();) {
+        if (keys.count(it->first)) {
+            ++it;
+            continue;
+        }
+        engine->removeNode(it->second);
+        changed_ids.insert(it->second);
+        applied_nodes.erase(it->first);
+        it = node_ids.erase(it);
+        result.removed++;
+    }
+
+    // Register new keys first so references between new nodes can be rewritten
+    std::set<std::string> new_keys;
+    for (const auto& [key, node] : desired.nodes) {
+        if (node_ids.count(key)) {
+            continue;
+        }
+        std::string node_id = engine->registerNode(node.function_name, {});
+        if (node_id.empty()) {
+            result.error = "Failed to register node " + key;
+            return false;
+        }
+        node_ids[key] = node_id;
+        new_keys.insert(key);
+        result.added++;
+    }
+
+    for (const auto& [key, node] : desired.nodes) {
+        bool is_new = new_keys.count(key) > 0;
+        if (!is_new && sameNode(applied_nodes[key], node)) {
+            continue;
+        }
+        std::vector<std::string> arguments;
+        rewriteReferences(node.arguments, keys, arguments, result.error);
+        engine->updateNode(node_ids[key], node.function_name, arguments);
+        applied_nodes[key] = node;
+        changed_ids.insert(node_ids[key]);
+        if (!is_new) {
+            result.updated++;
+        }
+    }
+
+    // --- Find the outputs whose upstream subgraph changed ---
+    for (const auto& [output, key] : desired.outputs) {
+        const std::string& node_id = node_ids[key];
+        auto applied = applied_outputs.find(output);
+        bool dirty = applied == applied_outputs.end() || applied->second != key;
+        if (!dirty && !changed_ids.empty()) {
+            for (const std::string& upstream : engine->analyzeDependencies(node_id)) {
+                if (changed_ids.count(upstream)) {
+                    dirty = true;
+                    break;
+                }
+            }
+        }
+        if (dirty) {
+            result.dirty_outputs[output] = node_id;
+        }
+    }
+    applied_outputs = desired.outputs;
+    return true;
+}
+
+//--------------------------------------------------------------
+std::string GraphSync::getNodeId(const std::string& key) const {
+    auto it = node_ids.find(key);
+    return it != node_ids.end() ? it->second : "";
+}
+
+//--------------------------------------------------------------
+const std::map<std::string, std::string>& GraphSync::getNodeIds() const {
+    return node_ids;
+}
+
+//--------------------------------------------------------------
+GraphDescription GraphSync::getAppliedGraph() const {
+    GraphDescription applied;
+    applied.nodes = applied_nodes;
+    applied.outputs = applied_outputs;
+    return applied;
+}
+
+//--------------------------------------------------------------
+bool GraphSync::restore(const GraphDescription& applied, const std::map<std::string, std::string>& bound_ids) {
+    for (const auto& [key, node] : applied.nodes) {
+        auto bound = bound_ids.find(key);
+        if (bound == bound_ids.end() || !engine->hasNode(bound->second)) {
+            ofLogError("GraphSync") << "Cannot restore graph, node " << key << " is missing";
+            return false;
+        }
+    }
+    node_ids.clear();
+    for (const auto& [key, node] : applied.nodes) {
+        node_ids[key] = bound_ids.at(key);
+    }
+    applied_nodes = applied.nodes;
+    applied_outputs = applied.outputs;
+    return true;
+}
+
+//--------------------------------------------------------------
+bool GraphSync::rewriteReferences(const std::vector<std::string>& arguments, const std::set<std::string>& keys,
+                                  std::vector<std::string>& rewritten, std::string& error) const {
+    static const std::regex reference_regex(R"(\$(\w+))");
+
+    // Engine IDs of managed keys that are about to be removed must not be referenced directly
+    std::set<std::string> removed_ids;
+    for (const auto& [key, node_id] : node_ids) {
+        if (!keys.count(key)) {
+            removed_ids.insert(node_id);
+        }
+    }
+
+    rewritten.clear();
+    for (const std::string& argument : arguments) {
+        std::string output;
+        auto begin = std::sregex_iterator(argument.begin(), argument.end(), reference_regex);
+        size_t copied = 0;
+        for (auto it = begin; it != std::sregex_iterator(); ++it) {
+            std::string reference = (*it)[1].str();
+            std::string node_id;
+            if (keys.count(reference)) {
+                auto bound = node_ids.find(reference);
+                node_id = bound != node_ids.end() ? bound->second : reference;
+            } else if (engine->hasNode(reference) && !removed_ids.count(reference)) {
+                node_id = reference;
+            } else {
+                error = "Unknown node reference $" + reference;
+                return false;
+            }
+            output += argument.substr(copied, it->position() - copied) + "$" + node_id;
+            copied = it->position() + it->length();
+        }
+        rewritten.push_back(output + argument.substr(copied));
+    }
+    return true;
+}
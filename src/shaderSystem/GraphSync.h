@@ -0,0 +1,107 @@
+#pragma once
+#include "ShaderCompositionEngine.h"
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+/**
+ * @struct GraphDescription
+ * @brief The complete desired state of a client's composition graph.
+ * @details Nodes are named by client keys. Arguments reference other nodes as "$key";
+ *          outputs map an output name ("main" or a named output) to a node key.
+ */
+struct GraphDescription {
+    /**
+     * @struct Node
+     * @brief One desired node.
+     */
+    struct Node {
+        std::string function_name;              ///< The GLSL function.
+        std::vector<std::string> arguments;     ///< Raw arguments, "$key" for other nodes.
+    };
+
+    std::map<std::string, Node> nodes;          ///< Desired nodes by client key.
+    std::map<std::string, std::string> outputs; ///< Node key shown on each output.
+};
+
+/**
+ * @struct GraphSyncResult
+ * @brief What applying a GraphDescription changed.
+ */
+struct GraphSyncResult {
+    size_t added = 0;                                   ///< Nodes registered.
+    size_t updated = 0;                                 ///< Nodes whose function or arguments changed.
+    size_t removed = 0;                                 ///< Nodes removed.
+    std::map<std::string, std::string> dirty_outputs;   ///< Outputs to recompile, with their engine node ID.
+    std::string error;                                  ///< Reason if the description was rejected.
+};
+
+/**
+ * @class GraphSync
+ * @brief Applies declarative graph descriptions to a ShaderCompositionEngine as minimal diffs.
+ * @details Each client key is bound to one engine node for as long as the key exists, so
+ *          re-sending an unchanged graph touches nothing. Applying a description registers
+ *          new keys, updates nodes whose function or arguments changed, removes keys that
+ *          disappeared and reports only the outputs whose upstream subgraph contains a
+ *          changed node (or that now show a different node). The whole description is
+ *          validated before the engine is modified, so a rejected description leaves the
+ *          graph untouched.
+ *
+ *          Nodes registered with /create are not managed here but may be referenced by
+ *          their engine ID ("$shader_N").
+ */
+class GraphSync {
+public:
+    /**
+     * @param engine The composition engine to keep in sync; must outlive this object.
+     */
+    explicit GraphSync(ShaderCompositionEngine* engine);
+
+    /**
+     * @brief Diffs a description against the last applied one and applies the changes.
+     * @param desired The complete desired graph.
+     * @param result Receives the change counts, the outputs to recompile or the error.
+     * @return True if the description was valid and applied.
+     */
+    bool apply(const GraphDescription& desired, GraphSyncResult& result);
+
+    /**
+     * @brief Gets the engine node ID bound to a client key.
+     * @return The node ID, or an empty string if the key is unknown.
+     */
+    std::string getNodeId(const std::string& key) const;
+
+    /**
+     * @brief Gets the engine node ID of every client key.
+     */
+    const std::map<std::string, std::string>& getNodeIds() const;
+
+    /**
+     * @brief Gets the description as last applied.
+     */
+    GraphDescription getAppliedGraph() const;
+
+    /**
+     * @brief Adopts a previously applied description whose nodes the engine already has.
+     * @details Used when restoring a session: the engine nodes are restored under their old
+     *          IDs first, so re-sending the same description afterwards changes nothing.
+     * @param applied The description as it was applied.
+     * @param bound_ids The engine node ID of each of its keys.
+     * @return False if a key has no node in the engine; nothing is adopted then.
+     */
+    bool restore(const GraphDescription& applied, const std::map<std::string, std::string>& bound_ids);
+
+private:
+    /**
+     * @brief Rewrites "$key" references into engine node IDs.
+     * @return False if an argument references a node that neither the description nor the engine has.
+     */
+    bool rewriteReferences(const std::vector<std::string>& arguments, const std::set<std::string>& keys,
+                           std::vector<std::string>& rewritten, std::string& error) const;
+
+    ShaderCompositionEngine* engine;                        ///< The synchronized engine.
+    std::map<std::string, std::string> node_ids;            ///< Engine node ID of each client key.
+    std::map<std::string, GraphDescription::Node> applied_nodes; ///< Nodes as last applied, by key.
+    std::map<std::string, std::string> applied_outputs;     ///< Outputs as last applied.
+};
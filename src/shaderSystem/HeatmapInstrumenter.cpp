@@ -0,0 +1,301 @@
+#include "HeatmapInstrumenter.h"
+#include <cctype>
+#include <filesystem>
+#include <regex>
+#include <vector>
+
+namespace {
+
+// Declarations shared by every instrumented shader. They are added after the counters
+// are inserted, so the color map itself is not counted.
+const char* kHeatmapHeader = R"(#version 430
+layout(std430, binding = 0) buffer GeHeatmapCounters {
+    uint ge_heat_max;
+    uint ge_heat_total;
+    uint ge_heat_pixels;
+};
+uniform float geHeatScale;
+uint ge_heat = 0u;
+
+vec3 ge_heatColor(float level) {
+    // Blue (cheap) through green to red (most expensive pixel of the last frame)
+    return clamp(vec3(1.5) - abs(4.0 * clamp(level, 0.0, 1.0) - vec3(3.0, 2.0, 1.0)), 0.0, 1.0);
+}
+)";
+
+const int kMaxIncludeDepth = 32;
+
+bool isIdentifierStart(char c) {
+    return std::isalpha(static_cast<unsigned char>(c)) || c == '_';
+}
+
+bool isIdentifierChar(char c) {
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+
+std::string trim(const std::string& text) {
+    size_t begin = text.find_first_not_of(" \t\r\n");
+    if (begin == std::string::npos) {
+        return "";
+    }
+    size_t end = text.find_last_not_of(" \t\r\n");
+    return text.substr(begin, end - begin + 1);
+}
+
+// Counts one evaluation of a loop condition and keeps its value.
+std::string tickCondition(const std::string& condition) {
+    std::string trimmed = trim(condition);
+    return "(ge_heat++, " + (trimmed.empty() ? std::string("true") : "(" + trimmed + ")") + ")";
+}
+
+size_t findClosingParenthesis(const std::string& code, size_t open) {
+    int depth = 0;
+    for (size_t i = open; i < code.size(); ++i) {
+        if (code[i] == '(') {
+            depth++;
+        } else if (code[i] == ')' && --depth == 0) {
+            return i;
+        }
+    }
+    return std::string::npos;
+}
+
+// Returns the function name if the emitted code ends in a parameter list, e.g. "float f(vec2 p)".
+std::string findFunctionName(const std::string& emitted) {
+    size_t i = emitted.find_last_not_of(" \t\r\n");
+    if (i == std::string::npos || emitted[i] != ')') {
+        return "";
+    }
+
+    int depth = 0;
+    for (;; --i) {
+        if (emitted[i] == ')') {
+            depth++;
+        } else if (emitted[i] == '(' && --depth == 0) {
+            break;
+        }
+        if (i == 0) {
+            return "";
+        }
+    }
+
+    size_t name_end = emitted.find_last_not_of(" \t\r\n", i == 0 ? std::string::npos : i - 1);
+    if (i == 0 || name_end == std::string::npos || !isIdentifierChar(emitted[name_end])) {
+        return "";
+    }
+    size_t name_begin = name_end;
+    while (name_begin > 0 && isIdentifierChar(emitted[name_begin - 1])) {
+        name_begin--;
+    }
+    return emitted.substr(name_begin, name_end - name_begin + 1);
+}
+
+} // namespace
+
+//--------------------------------------------------------------
+std::string HeatmapInstrumenter::instrument(const std::string& fragment_code, const std::string& source_directory_path) {
+    error.clear();
+
+    // Same fallback as ofShader for sources without a directory
+    std::string directory = source_directory_path.empty() ? ofToDataPath("", true) : source_directory_path;
+    std::set<std::string> included;
+    std::stringstream resolved;
+    if (!resolveIncludes(stripComments(fragment_code), directory, included, resolved, 0)) {
+        ofLogError("HeatmapInstrumenter") << error;
+        return "";
+    }
+    std::string code = resolved.str();
+
+    std::smatch match;
+    if (!std::regex_search(code, match, std::regex(R"(\bout\s+vec4\s+(\w+)\s*;)"))) {
+        error = "No vec4 fragment output found";
+        ofLogError("HeatmapInstrumenter") << error;
+        return "";
+    }
+
+    std::string instrumented = insertCounters(code, match[1].str());
+    if (instrumented.empty()) {
+        ofLogError("HeatmapInstrumenter") << error;
+        return "";
+    }
+    return kHeatmapHeader + instrumented;
+}
+
+//--------------------------------------------------------------
+const std::string& HeatmapInstrumenter::getError() const {
+    return error;
+}
+
+//--------------------------------------------------------------
+bool HeatmapInstrumenter::resolveIncludes(const std::string& code, const std::string& directory,
+                                          std::set<std::string>& included, std::stringstream& output, int depth) {
+    if (depth > kMaxIncludeDepth) {
+        error = "Include depth limit exceeded in " + directory;
+        return false;
+    }
+
+    static const std::regex include_regex(R"re(^\s*#\s*include\s*"([^"]+)")re");
+    static const std::regex version_regex(R"(^\s*#\s*version\b)");
+
+    std::istringstream lines(code);
+    std::string line;
+    while (std::getline(lines, line)) {
+        std::smatch match;
+        if (std::regex_search(line, version_regex)) {
+            // The instrumented shader declares its own version
+            output << "\n";
+            continue;
+        }
+        if (!std::regex_search(line, match, include_regex)) {
+            output << line << "\n";
+            continue;
+        }
+
+        std::string path = std::filesystem::path(ofFilePath::join(directory, match[1].str())).lexically_normal().string();
+        if (!included.insert(path).second) {
+            continue;
+        }
+
+        ofBuffer buffer = ofBufferFromFile(path);
+        if (buffer.size() == 0) {
+            error = "Cannot read include: " + path;
+            return false;
+        }
+        if (!resolveIncludes(stripComments(buffer.getText()), ofFilePath::getEnclosingDirectory(path, false),
+                             included, output, depth + 1)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+//--------------------------------------------------------------
+std::string HeatmapInstrumenter::stripComments(const std::string& code) {
+    std::string result = code;
+    for (size_t i = 0; i + 1 < result.size(); ++i) {
+        if (result[i] == '/' && result[i + 1] == '/') {
+            while (i < result.size() && result[i] != '\n') {
+                result[i++] = ' ';
+            }
+        } else if (result[i] == '/' && result[i + 1] == '*') {
+            size_t end = result.find("*/", i + 2);
+            end = (end == std::string::npos) ? result.size() : end + 2;
+            for (; i < end; ++i) {
+                if (result[i] != '\n') {
+                    result[i] = ' ';
+                }
+            }
+            --i;
+        }
+    }
+    return result;
+}
+
+//--------------------------------------------------------------
+std::string HeatmapInstrumenter::insertCounters(const std::string& code, const std::string& output_variable) {
+    std::string result;
+    result.reserve(code.size() + code.size() / 8);
+
+    int depth = 0;
+    bool in_main = false;
+    bool line_start = true;
+    size_t i = 0;
+
+    while (i < code.size()) {
+        char c = code[i];
+
+        // Preprocessor lines (including continued #defines) are copied untouched
+        if (line_start) {
+            size_t first = code.find_first_not_of(" \t", i);
+            if (first != std::string::npos && code[first] == '#') {
+                size_t end = first;
+                while (end < code.size() && (code[end] != '\n' || code[end - 1] == '\\')) {
+                    end++;
+                }
+                result.append(code, i, end - i);
+                i = end;
+                continue;
+            }
+        }
+        line_start = (c == '\n');
+
+        if (isIdentifierStart(c) && (i == 0 || !isIdentifierChar(code[i - 1]))) {
+            size_t end = i;
+            while (end < code.size() && isIdentifierChar(code[end])) {
+                end++;
+            }
+            std::string word = code.substr(i, end - i);
+            size_t open = code.find_first_not_of(" \t\r\n", end);
+
+            if ((word == "for" || word == "while") && open != std::string::npos && code[open] == '(') {
+                size_t close = findClosingParenthesis(code, open);
+                if (close == std::string::npos) {
+                    error = "Unbalanced parentheses after '" + word + "'";
+                    return "";
+                }
+                std::string header = code.substr(open + 1, close - open - 1);
+
+                if (word == "for") {
+                    // Split "init; condition; increment" at top-level semicolons
+                    std::vector<std::string> clauses(1);
+                    int parentheses = 0;
+                    for (char h : header) {
+                        if (h == '(') parentheses++;
+                        if (h == ')') parentheses--;
+                        if (h == ';' && parentheses == 0) {
+                            clauses.emplace_back();
+                        } else {
+                            clauses.back() += h;
+                        }
+                    }
+                    if (clauses.size() == 3) {
+                        header = clauses[0] + "; " + tickCondition(clauses[1]) + ";" + clauses[2];
+                    }
+                } else {
+                    header = tickCondition(header);
+                }
+
+                result += word + " (" + header + ")";
+                i = close + 1;
+                continue;
+            }
+
+            result += word;
+            i = end;
+            continue;
+        }
+
+        if (c == '{') {
+            if (depth == 0) {
+                std::string function_name = findFunctionName(result);
+                if (function_name == "main") {
+                    in_main = true;
+                } else if (!function_name.empty()) {
+                    result += "{ ge_heat++;";
+                    depth++;
+                    i++;
+                    continue;
+                }
+            }
+            depth++;
+        } else if (c == '}') {
+            depth--;
+            if (depth == 0 && in_main) {
+                result += "    atomicMax(ge_heat_max, ge_heat);\n";
+                result += "    atomicAdd(ge_heat_total, ge_heat);\n";
+                result += "    atomicAdd(ge_heat_pixels, 1u);\n";
+                result += "    " + output_variable + " = vec4(ge_heatColor(float(ge_heat) / max(geHeatScale, 1.0)), 1.0);\n";
+                in_main = false;
+            }
+        }
+
+        result += c;
+        i++;
+    }
+
+    if (depth != 0) {
+        error = "Unbalanced braces in shader source";
+        return "";
+    }
+    return result;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "ofMain.h"
+#include <set>
+#include <sstream>
+#include <string>
+
+/**
+ * @class HeatmapInstrumenter
+ * @brief Rewrites a generated fragment shader into a per-pixel cost diagnostic.
+ * @details The instrumented shader counts work in a per-invocation counter: one tick on
+ *          entry of every function (plugin functions, their helpers and the generated
+ *          wrappers) and one tick per loop condition test. At the end of main() the count
+ *          is accumulated into an SSBO at binding 0 and written as a false color instead
+ *          of the normal output, scaled by the 'geHeatScale' uniform.
+ *
+ *          Includes are resolved here rather than by ofShader, so plugin code is
+ *          instrumented too. The result requires GLSL 4.30; the production source is not
+ *          modified.
+ */
+class HeatmapInstrumenter {
+public:
+    /**
+     * @brief Builds the instrumented variant of a fragment shader.
+     * @param fragment_code The production fragment shader source.
+     * @param source_directory_path Directory used to resolve #include directives.
+     * @return The instrumented source, or an empty string on failure (see getError()).
+     */
+    std::string instrument(const std::string& fragment_code, const std::string& source_directory_path);
+
+    /**
+     * @brief Gets the reason of the last failure.
+     */
+    const std::string& getError() const;
+
+private:
+    /**
+     * @brief Recursively inlines quoted #include directives, each file at most once.
+     */
+    bool resolveIncludes(const std::string& code, const std::string& directory,
+                         std::set<std::string>& included, std::stringstream& output, int depth);
+
+    /**
+     * @brief Replaces comments with whitespace, keeping line breaks.
+     */
+    static std::string stripComments(const std::string& code);
+
+    /**
+     * @brief Inserts the counters into function bodies and loop conditions.
+     * @param code The include-free source without #version.
+     * @param output_variable The fragment output that receives the heat color.
+     */
+    std::string insertCounters(const std::string& code, const std::string& output_variable);
+
+    std::string error;      ///< Reason of the last failure.
+};
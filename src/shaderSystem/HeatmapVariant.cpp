@@ -0,0 +1,124 @@
+#include "HeatmapVariant.h"
+#include "HeatmapInstrumenter.h"
+#include <algorithm>
+
+//--------------------------------------------------------------
+HeatmapVariant::HeatmapVariant()
+    : counter_buffer(0)
+    , scale_location(-1)
+    , has_frame(false)
+    , max_count(0)
+    , mean_count(0.0f) {
+}
+
+//--------------------------------------------------------------
+HeatmapVariant::~HeatmapVariant() {
+    if (counter_buffer != 0) {
+        glDeleteBuffers(1, &counter_buffer);
+    }
+}
+
+//--------------------------------------------------------------
+bool HeatmapVariant::setup(const std::shared_ptr<ShaderNode>& production_shader) {
+    if (!production_shader || !production_shader->isReady()) {
+        ofLogError("HeatmapVariant") << "Production shader is not ready";
+        return false;
+    }
+
+    const ShaderNodeMetadata& production_metadata = *production_shader->metadata;
+    if (!production_metadata.sources.isAvailable()) {
+        ofLogError("HeatmapVariant") << "Sources of " << production_shader->function_name
+                                     << " were dropped after linking, start with --sources keep or compress";
+        return false;
+    }
+
+    HeatmapInstrumenter instrumenter;
+    std::string fragment_code = instrumenter.instrument(production_metadata.sources.getFragment(),
+                                                        production_metadata.source_directory_path);
+    if (fragment_code.empty()) {
+        return false;
+    }
+
+    auto variant = std::make_shared<ShaderNode>(Symbol(production_shader->function_name.str() + "_heatmap"), production_metadata.arguments);
+    variant->setShaderCode(production_metadata.sources.getVertex(), fragment_code);
+    variant->metadata->source_directory_path = production_metadata.source_directory_path;
+    variant->setAutoUpdateTime(production_shader->auto_update_time);
+    variant->setAutoUpdateResolution(production_shader->auto_update_resolution);
+    for (const auto& field : production_shader->compute_fields) {
+        variant->addComputeField(field);
+    }
+    for (const auto& sampler_name : production_shader->texture_inputs) {
+        variant->addTextureInput(sampler_name);
+    }
+    // Shared, so parameter edits show up in the heatmap too
+    variant->parameter_block = production_shader->parameter_block;
+    if (!variant->compile()) {
+        ofLogError("HeatmapVariant") << "Failed to compile heatmap variant of " << production_shader->function_name;
+        return false;
+    }
+
+    if (counter_buffer == 0) {
+        glGenBuffers(1, &counter_buffer);
+    }
+    GLuint zeros[3] = {0, 0, 0};
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, counter_buffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(zeros), zeros, GL_DYNAMIC_READ);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    production = production_shader;
+    shader = variant;
+    scale_location = glGetUniformLocation(shader->getProgramId(), "geHeatScale");
+    has_frame = false;
+    max_count = 0;
+    mean_count = 0.0f;
+
+    ofLogNotice("HeatmapVariant") << "Built heatmap variant of " << production_shader->function_name;
+    return true;
+}
+
+//--------------------------------------------------------------
+bool HeatmapVariant::isVariantOf(const ShaderNode* candidate) const {
+    return candidate && production.lock().get() == candidate;
+}
+
+//--------------------------------------------------------------
+std::shared_ptr<ShaderNode> HeatmapVariant::getShader() const {
+    return shader;
+}
+
+//--------------------------------------------------------------
+void HeatmapVariant::beginFrame() {
+    if (!shader || counter_buffer == 0) {
+        return;
+    }
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, counter_buffer);
+    if (has_frame) {
+        // Diagnostic only: this waits for the previous frame's atomics.
+        GLuint counters[3] = {0, 0, 0};
+        glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+        glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(counters), counters);
+        max_count = counters[0];
+        mean_count = counters[2] > 0 ? static_cast<float>(counters[1]) / counters[2] : 0.0f;
+    }
+
+    GLuint zeros[3] = {0, 0, 0};
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(zeros), zeros);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, counter_buffer);
+
+    if (scale_location >= 0) {
+        glProgramUniform1f(shader->getProgramId(), scale_location, static_cast<float>(std::max(max_count, 1u)));
+    }
+    has_frame = true;
+}
+
+//--------------------------------------------------------------
+unsigned int HeatmapVariant::getMaxCount() const {
+    return max_count;
+}
+
+//--------------------------------------------------------------
+float HeatmapVariant::getMeanCount() const {
+    return mean_count;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "ShaderNode.h"
+#include "ofMain.h"
+#include <memory>
+
+/**
+ * @class HeatmapVariant
+ * @brief The per-pixel cost diagnostic of one production shader.
+ * @details Compiles the source of the production shader through HeatmapInstrumenter into a
+ *          separate ShaderNode, which is drawn in its place while the heatmap is enabled.
+ *          The production shader and its cache entries are never modified. Compute fields
+ *          are shared with the production shader; their cost is not part of the heatmap.
+ *
+ *          The counters of each frame are read at the start of the next one. The maximum
+ *          count of the previous frame becomes the top of the color scale.
+ */
+class HeatmapVariant {
+public:
+    HeatmapVariant();
+    ~HeatmapVariant();
+
+    /**
+     * @brief Builds the instrumented variant. Requires a current GL 4.3 context.
+     * @param production The shader to diagnose.
+     * @return True on success, false otherwise.
+     */
+    bool setup(const std::shared_ptr<ShaderNode>& production);
+
+    /**
+     * @brief Checks whether this variant was built from the given shader.
+     */
+    bool isVariantOf(const ShaderNode* shader) const;
+
+    /**
+     * @brief Gets the instrumented shader that is drawn instead of the production one.
+     */
+    std::shared_ptr<ShaderNode> getShader() const;
+
+    /**
+     * @brief Reads the counters of the last frame, updates the color scale and rebinds
+     *        the cleared counters. Call once per frame before drawing the shader.
+     */
+    void beginFrame();
+
+    /**
+     * @brief Gets the highest per-pixel count of the last frame.
+     */
+    unsigned int getMaxCount() const;
+
+    /**
+     * @brief Gets the mean per-pixel count of the last frame.
+     */
+    float getMeanCount() const;
+
+private:
+    std::weak_ptr<ShaderNode> production;   ///< The diagnosed shader, used for identity only.
+    std::shared_ptr<ShaderNode> shader;     ///< The instrumented shader.
+    GLuint counter_buffer;                  ///< SSBO with max, total and pixel count.
+    GLint scale_location;                   ///< Location of 'geHeatScale'.
+    bool has_frame;                         ///< True once a frame has been counted.
+    unsigned int max_count;                 ///< Highest per-pixel count of the last frame.
+    float mean_count;                       ///< Mean per-pixel count of the last frame.
+};
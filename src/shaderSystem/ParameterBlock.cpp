@@ -0,0 +1,200 @@
+#include "ParameterBlock.h"
+#include <algorithm>
+#include <regex>
+#include <sstream>
+
+namespace {
+
+/// Components and std140 base alignment (in floats) of the supported port types.
+bool getTypeLayout(const std::string& type, size_t& components, size_t& alignment) {
+    if (type == "float") {
+        components = 1;
+        alignment = 1;
+    } else if (type == "vec2") {
+        components = 2;
+        alignment = 2;
+    } else if (type == "vec3") {
+        components = 3;
+        alignment = 4;
+    } else if (type == "vec4") {
+        components = 4;
+        alignment = 4;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+//--------------------------------------------------------------
+ParameterBlock::ParameterBlock()
+    : revision(0)
+    , buffer(0) {
+}
+
+//--------------------------------------------------------------
+ParameterBlock::~ParameterBlock() {
+    if (buffer != 0) {
+        glDeleteBuffers(1, &buffer);
+    }
+}
+
+//--------------------------------------------------------------
+bool ParameterBlock::isPortArgument(const std::string& argument) {
+    return !argument.empty() && argument[0] == '@';
+}
+
+//--------------------------------------------------------------
+bool ParameterBlock::parsePort(const std::string& argument, ParameterPort& port) {
+    static const std::regex port_regex(R"(@([A-Za-z_]\w*)(?::(\w+))?(?:=(.+))?)");
+    std::smatch match;
+    if (!std::regex_match(argument, match, port_regex)) {
+        return false;
+    }
+
+    port.name = match[1].str();
+    port.glsl_type = match[2].matched ? match[2].str() : "float";
+    size_t components = 0;
+    size_t alignment = 0;
+    if (!getTypeLayout(port.glsl_type, components, alignment)) {
+        return false;
+    }
+
+    // Defaults are a single value broadcast to every component, since arguments are comma-separated
+    float value = 0.0f;
+    if (match[3].matched) {
+        std::istringstream stream(match[3].str());
+        if (!(stream >> value) || !stream.eof()) {
+            return false;
+        }
+    }
+    port.default_value.assign(components, value);
+    return true;
+}
+
+//--------------------------------------------------------------
+std::string ParameterBlock::getMemberName(const std::string& node_id, const std::string& port_name) {
+    return node_id + "_" + port_name;
+}
+
+//--------------------------------------------------------------
+bool ParameterBlock::addPort(const ParameterPort& port) {
+    size_t components = 0;
+    size_t alignment = 0;
+    if (findPort(port.node_id, port.name) || !getTypeLayout(port.glsl_type, components, alignment)) {
+        return false;
+    }
+
+    size_t offset = (data.size() + alignment - 1) / alignment * alignment;
+    ParameterPort added = port;
+    added.offset = offset * sizeof(float);
+    added.default_value.resize(components, added.default_value.empty() ? 0.0f : added.default_value.back());
+    ports.push_back(added);
+
+    data.resize(offset + components, 0.0f);
+    std::copy(added.default_value.begin(), added.default_value.end(), data.begin() + offset);
+    revision++;
+    return true;
+}
+
+//--------------------------------------------------------------
+std::string ParameterBlock::generateDeclaration() const {
+    if (ports.empty()) {
+        return "";
+    }
+    std::stringstream declaration;
+    declaration << "layout(std140) uniform " << block_name << " {\n";
+    for (const auto& port : ports) {
+        declaration << "    " << port.glsl_type << " " << getMemberName(port.node_id, port.name) << ";\n";
+    }
+    declaration << "};\n";
+    return declaration.str();
+}
+
+//--------------------------------------------------------------
+bool ParameterBlock::setValue(const std::string& node_id, const std::string& port_name,
+                              const std::vector<float>& values) {
+    const ParameterPort* port = findPort(node_id, port_name);
+    if (!port) {
+        return false;
+    }
+    size_t components = port->default_value.size();
+    if (values.size() != 1 && values.size() != components) {
+        return false;
+    }
+
+    size_t first = port->offset / sizeof(float);
+    for (size_t i = 0; i < components; ++i) {
+        data[first + i] = values.size() == 1 ? values[0] : values[i];
+    }
+    revision++;
+    return true;
+}
+
+//--------------------------------------------------------------
+bool ParameterBlock::hasPort(const std::string& node_id, const std::string& port_name) const {
+    return findPort(node_id, port_name) != nullptr;
+}
+
+//--------------------------------------------------------------
+bool ParameterBlock::isEmpty() const {
+    return ports.empty();
+}
+
+//--------------------------------------------------------------
+const std::vector<ParameterPort>& ParameterBlock::getPorts() const {
+    return ports;
+}
+
+//--------------------------------------------------------------
+size_t ParameterBlock::getByteSize() const {
+    // std140 rounds the block up to a multiple of a vec4
+    return (data.size() + 3) / 4 * 4 * sizeof(float);
+}
+
+//--------------------------------------------------------------
+const std::vector<float>& ParameterBlock::getData() const {
+    return data;
+}
+
+//--------------------------------------------------------------
+uint64_t ParameterBlock::getRevision() const {
+    return revision;
+}
+
+//--------------------------------------------------------------
+void ParameterBlock::bind() {
+    bind(data);
+}
+
+//--------------------------------------------------------------
+void ParameterBlock::bind(const std::vector<float>& values) {
+    if (ports.empty() || values.size() != data.size()) {
+        return;
+    }
+    if (buffer == 0) {
+        glGenBuffers(1, &buffer);
+        glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+        glBufferData(GL_UNIFORM_BUFFER, getByteSize(), nullptr, GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+        uploaded.clear();
+    }
+    if (values != uploaded) {
+        glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, values.size() * sizeof(float), values.data());
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+        uploaded = values;
+    }
+    glBindBufferBase(GL_UNIFORM_BUFFER, binding_point, buffer);
+}
+
+//--------------------------------------------------------------
+const ParameterPort* ParameterBlock::findPort(const std::string& node_id, const std::string& port_name) const {
+    for (const auto& port : ports) {
+        if (port.node_id == node_id && port.name == port_name) {
+            return &port;
+        }
+    }
+    return nullptr;
+}
@@ -0,0 +1,117 @@
+#pragma once
+#include "ofMain.h"
+#include <string>
+#include <vector>
+
+/**
+ * @struct ParameterPort
+ * @brief A named, typed parameter of a composition node.
+ * @details Declared by a node argument of the form "@name", "@name:type" or
+ *          "@name:type=value", e.g. "@amp=0.5" or "@offset:vec2=0".
+ */
+struct ParameterPort {
+    std::string node_id;                ///< The node that declares the port.
+    std::string name;                   ///< Port name, unique within the node.
+    std::string glsl_type;              ///< "float", "vec2", "vec3" or "vec4".
+    std::vector<float> default_value;   ///< One value per component.
+    size_t offset = 0;                  ///< std140 byte offset inside the block.
+};
+
+/**
+ * @class ParameterBlock
+ * @brief The parameter ports of one compiled graph, packed into a std140 uniform block.
+ * @details Each port becomes a block member named "<node_id>_<port>", so ports of different
+ *          nodes never collide. Values are kept in a CPU copy of the block and uploaded with
+ *          a single buffer update the next time the block is bound after a change, so
+ *          parameter edits never touch the program itself.
+ *
+ *          setValue() and getData() belong to the control side; bind() to the render thread,
+ *          which can bind a copy taken with getData() instead of the live values.
+ */
+class ParameterBlock {
+public:
+    static constexpr GLuint binding_point = 0;              ///< Uniform buffer binding used by all graphs.
+    static constexpr const char* block_name = "GraphParameters"; ///< GLSL name of the block.
+
+    ParameterBlock();
+    ~ParameterBlock();
+
+    ParameterBlock(const ParameterBlock&) = delete;
+    ParameterBlock& operator=(const ParameterBlock&) = delete;
+
+    /**
+     * @brief Checks whether an argument declares a parameter port.
+     */
+    static bool isPortArgument(const std::string& argument);
+
+    /**
+     * @brief Parses a "@name[:type][=value]" argument.
+     * @param argument The node argument.
+     * @param port Receives the name, type and default value; node_id is left untouched.
+     * @return False if the argument is not a valid port declaration.
+     */
+    static bool parsePort(const std::string& argument, ParameterPort& port);
+
+    /**
+     * @brief Gets the GLSL name of a port inside the block.
+     */
+    static std::string getMemberName(const std::string& node_id, const std::string& port_name);
+
+    /**
+     * @brief Adds a port at the next std140 offset.
+     * @return False if the node already has a port with that name.
+     */
+    bool addPort(const ParameterPort& port);
+
+    /**
+     * @brief Generates the GLSL declaration of the block, empty if it has no ports.
+     */
+    std::string generateDeclaration() const;
+
+    /**
+     * @brief Sets the value of a port; a single value is broadcast to all components.
+     * @return False if the port does not exist or the value count does not match.
+     */
+    bool setValue(const std::string& node_id, const std::string& port_name, const std::vector<float>& values);
+
+    bool hasPort(const std::string& node_id, const std::string& port_name) const;
+    bool isEmpty() const;
+    const std::vector<ParameterPort>& getPorts() const;
+
+    /**
+     * @brief Gets the std140 size of the block in bytes.
+     */
+    size_t getByteSize() const;
+
+    /**
+     * @brief Gets the current block contents, e.g. to publish them with a render snapshot.
+     */
+    const std::vector<float>& getData() const;
+
+    /**
+     * @brief Gets a counter that changes whenever the block contents change.
+     * @details Lets the control side skip copying unchanged contents into a render snapshot.
+     */
+    uint64_t getRevision() const;
+
+    /**
+     * @brief Uploads pending changes and binds the block to binding_point.
+     * @details Must be called on the GL thread before drawing with the program.
+     */
+    void bind();
+
+    /**
+     * @brief Uploads the given contents if they differ from the last upload and binds the block.
+     * @param values Block contents as returned by getData().
+     */
+    void bind(const std::vector<float>& values);
+
+private:
+    const ParameterPort* findPort(const std::string& node_id, const std::string& port_name) const;
+
+    std::vector<ParameterPort> ports;   ///< Ports in declaration order.
+    std::vector<float> data;            ///< CPU copy of the block contents (control side).
+    std::vector<float> uploaded;        ///< Contents of the buffer (render thread).
+    uint64_t revision;                  ///< Incremented by every change of data (control side).
+    GLuint buffer;                      ///< Uniform buffer, created on the first bind.
+};
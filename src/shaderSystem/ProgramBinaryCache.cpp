@@ -0,0 +1,280 @@
+#include "ProgramBinaryCache.h"
+#include "ShaderManager.h"
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace {
+
+const char kEntryMagic[4] = {'G', 'E', 'P', 'B'};
+const uint32_t kEntryVersion = 1;
+
+/// 64-bit FNV-1a, stable across runs and platforms unlike std::hash.
+void hashBytes(uint64_t& hash, const void* data, size_t size) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+}
+
+void hashString(uint64_t& hash, const std::string& text) {
+    // The terminator keeps "ab"+"c" and "a"+"bc" apart
+    hashBytes(hash, text.c_str(), text.size() + 1);
+}
+
+const uint64_t kHashOffset = 14695981039346656037ull;
+
+template <typename T>
+void writeValue(std::ofstream& file, const T& value) {
+    file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+bool readValue(std::ifstream& file, T& value) {
+    return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+} // namespace
+
+//--------------------------------------------------------------
+ProgramBinaryCache& ProgramBinaryCache::getInstance() {
+    static ProgramBinaryCache instance;
+    return instance;
+}
+
+//--------------------------------------------------------------
+bool ProgramBinaryCache::setDirectory(const std::string& path) {
+    std::lock_guard<std::mutex> lock(mutex);
+    directory.clear();
+    prefetched.clear();
+    if (path.empty()) {
+        return true;
+    }
+
+    std::error_code error;
+    std::filesystem::create_directories(path, error);
+    if (error) {
+        ofLogError("ProgramBinaryCache") << "Cannot create cache directory " << path << ": " << error.message();
+        return false;
+    }
+    directory = path;
+    ofLogNotice("ProgramBinaryCache") << "Caching program binaries in " << directory;
+    return true;
+}
+
+//--------------------------------------------------------------
+bool ProgramBinaryCache::isEnabled() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return !directory.empty();
+}
+
+//--------------------------------------------------------------
+std::string ProgramBinaryCache::makeKey(const std::string& vertex, const std::string& fragment, const std::string& directory) {
+    uint64_t hash = kHashOffset;
+    hashString(hash, vertex);
+    hashString(hash, fragment);
+
+    // Included files are identified by their stamp; reading them again would cost as much as a miss saves
+    std::string include_directory = directory.empty() ? ofToDataPath("", true) : directory;
+    for (const std::string& path : ShaderManager::collectIncludedFiles(vertex + "\n" + fragment, include_directory)) {
+        std::error_code error;
+        uint64_t size = std::filesystem::file_size(path, error);
+        int64_t modified = static_cast<int64_t>(std::filesystem::last_write_time(path, error).time_since_epoch().count());
+        hashString(hash, path);
+        hashBytes(hash, &size, sizeof(size));
+        hashBytes(hash, &modified, sizeof(modified));
+    }
+
+    std::stringstream key;
+    key << std::hex << std::setw(16) << std::setfill('0') << hash;
+    return key.str();
+}
+
+//--------------------------------------------------------------
+bool ProgramBinaryCache::contains(const std::string& key) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (directory.empty()) {
+        return false;
+    }
+    std::error_code error;
+    return std::filesystem::exists(getPath(key), error);
+}
+
+//--------------------------------------------------------------
+void ProgramBinaryCache::prefetch(const std::vector<std::string>& keys) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (directory.empty()) {
+        return;
+    }
+    for (const std::string& key : keys) {
+        std::string path = getPath(key);
+        std::error_code error;
+        if (prefetched.count(key) || !std::filesystem::exists(path, error)) {
+            continue;
+        }
+        prefetched[key] = std::async(std::launch::async, [path] {
+            Entry entry;
+            bool found = readEntry(path, entry);
+            return std::make_pair(found, std::move(entry));
+        });
+    }
+}
+
+//--------------------------------------------------------------
+GLuint ProgramBinaryCache::load(const std::string& key) {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (directory.empty()) {
+        return 0;
+    }
+    std::string path = getPath(key);
+    std::future<std::pair<bool, Entry>> pending;
+    auto prefetch_it = prefetched.find(key);
+    if (prefetch_it != prefetched.end()) {
+        pending = std::move(prefetch_it->second);
+        prefetched.erase(prefetch_it);
+    }
+    uint64_t current_driver = getDriverHash();
+    lock.unlock();
+
+    Entry entry;
+    bool found = false;
+    if (pending.valid()) {
+        auto result = pending.get();
+        found = result.first;
+        entry = std::move(result.second);
+    } else {
+        found = readEntry(path, entry);
+    }
+
+    GLuint program = 0;
+    if (found && entry.driver_hash == current_driver) {
+        program = glCreateProgram();
+        glProgramBinary(program, entry.format, entry.binary.data(), static_cast<GLsizei>(entry.binary.size()));
+        GLint linked = GL_FALSE;
+        glGetProgramiv(program, GL_LINK_STATUS, &linked);
+        if (linked != GL_TRUE) {
+            glDeleteProgram(program);
+            program = 0;
+        }
+    }
+    if (found && !program) {
+        // Written by another driver or rejected by this one; it would fail every time
+        std::error_code error;
+        std::filesystem::remove(path, error);
+        ofLogNotice("ProgramBinaryCache") << "Dropped stale program binary " << key;
+    }
+
+    lock.lock();
+    if (program) {
+        hits++;
+    } else {
+        misses++;
+    }
+    return program;
+}
+
+//--------------------------------------------------------------
+bool ProgramBinaryCache::store(const std::string& key, GLuint program) {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (directory.empty() || !program) {
+        return false;
+    }
+    std::string path = getPath(key);
+    Entry entry;
+    entry.driver_hash = getDriverHash();
+    lock.unlock();
+
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) {
+        ofLogWarning("ProgramBinaryCache") << "Driver returned no binary for program " << program;
+        return false;
+    }
+    entry.binary.resize(static_cast<size_t>(length));
+    GLsizei written = 0;
+    glGetProgramBinary(program, length, &written, &entry.format, entry.binary.data());
+    entry.binary.resize(static_cast<size_t>(std::max<GLsizei>(written, 0)));
+    if (entry.binary.empty()) {
+        return false;
+    }
+
+    // Written under a temporary name so a crash never leaves a truncated entry behind
+    std::string temporary_path = path + ".tmp";
+    {
+        std::ofstream file(temporary_path, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            ofLogError("ProgramBinaryCache") << "Cannot write " << temporary_path;
+            return false;
+        }
+        file.write(kEntryMagic, sizeof(kEntryMagic));
+        writeValue(file, kEntryVersion);
+        writeValue(file, static_cast<uint32_t>(entry.format));
+        writeValue(file, entry.driver_hash);
+        writeValue(file, static_cast<uint32_t>(entry.binary.size()));
+        file.write(entry.binary.data(), static_cast<std::streamsize>(entry.binary.size()));
+        if (!file) {
+            ofLogError("ProgramBinaryCache") << "Failed writing " << temporary_path;
+            return false;
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(temporary_path, path, error);
+    if (error) {
+        ofLogError("ProgramBinaryCache") << "Cannot move " << temporary_path << " into place: " << error.message();
+        std::filesystem::remove(temporary_path, error);
+        return false;
+    }
+    return true;
+}
+
+//--------------------------------------------------------------
+size_t ProgramBinaryCache::getHitCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return hits;
+}
+
+//--------------------------------------------------------------
+size_t ProgramBinaryCache::getMissCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return misses;
+}
+
+//--------------------------------------------------------------
+bool ProgramBinaryCache::readEntry(const std::string& path, Entry& entry) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    char magic[sizeof(kEntryMagic)];
+    uint32_t version = 0;
+    uint32_t format = 0;
+    uint32_t length = 0;
+    if (!file.read(magic, sizeof(magic)) || std::string(magic, sizeof(magic)) != std::string(kEntryMagic, sizeof(kEntryMagic)) ||
+        !readValue(file, version) || version != kEntryVersion ||
+        !readValue(file, format) || !readValue(file, entry.driver_hash) || !readValue(file, length)) {
+        return false;
+    }
+    entry.format = static_cast<GLenum>(format);
+    entry.binary.resize(length);
+    return static_cast<bool>(file.read(entry.binary.data(), length));
+}
+
+//--------------------------------------------------------------
+std::string ProgramBinaryCache::getPath(const std::string& key) const {
+    return ofFilePath::join(directory, key + ".bin");
+}
+
+//--------------------------------------------------------------
+uint64_t ProgramBinaryCache::getDriverHash() {
+    if (driver_hash == 0) {
+        uint64_t hash = kHashOffset;
+        for (GLenum name : {GL_VENDOR, GL_RENDERER, GL_VERSION}) {
+            const GLubyte* value = glGetString(name);
+            hashString(hash, value ? reinterpret_cast<const char*>(value) : "");
+        }
+        driver_hash = hash;
+    }
+    return driver_hash;
+}
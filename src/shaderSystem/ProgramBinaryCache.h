@@ -0,0 +1,123 @@
+#pragma once
+#include "ofMain.h"
+#include <future>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @class ProgramBinaryCache
+ * @brief Persists linked GL programs on disk, so a program seen in an earlier run skips compilation.
+ * @details Each linked program is stored as the driver's program binary under a key hashed
+ *          from its sources and from the path, size and modification time of every file they
+ *          include, so editing a plugin file invalidates the entries that use it. Entries carry
+ *          a hash of the GL vendor, renderer and version; a driver update makes them stale, and
+ *          stale or rejected entries are deleted on the next lookup.
+ *
+ *          load() and store() need the GL context. prefetch() reads entries on worker threads
+ *          ahead of a batch of load() calls, e.g. while a session is being restored.
+ */
+class ProgramBinaryCache {
+public:
+    /**
+     * @brief Gets the singleton instance of the cache.
+     */
+    static ProgramBinaryCache& getInstance();
+
+    ProgramBinaryCache(const ProgramBinaryCache&) = delete;
+    ProgramBinaryCache& operator=(const ProgramBinaryCache&) = delete;
+
+    /**
+     * @brief Sets the directory the binaries are kept in, creating it if needed.
+     * @param path The directory, empty to disable the cache.
+     * @return False if the directory cannot be created; the cache stays disabled.
+     */
+    bool setDirectory(const std::string& path);
+
+    /**
+     * @brief Checks whether a directory is set.
+     */
+    bool isEnabled() const;
+
+    /**
+     * @brief Computes the key of a program.
+     * @param vertex The vertex source.
+     * @param fragment The fragment source.
+     * @param directory Directory the sources' #includes are resolved against, empty for the data path.
+     * @return 16 hex digits.
+     */
+    static std::string makeKey(const std::string& vertex, const std::string& fragment, const std::string& directory);
+
+    /**
+     * @brief Checks whether an entry exists for a key, without validating it.
+     */
+    bool contains(const std::string& key) const;
+
+    /**
+     * @brief Starts reading the entries of the given keys in parallel.
+     * @details Keys without an entry are skipped. A later load() of a prefetched key waits
+     *          for its read instead of reading the file itself.
+     */
+    void prefetch(const std::vector<std::string>& keys);
+
+    /**
+     * @brief Creates a program from the entry of a key.
+     * @return The linked program, or 0 if there is no valid entry.
+     */
+    GLuint load(const std::string& key);
+
+    /**
+     * @brief Stores the binary of a linked program under a key.
+     * @details Set GL_PROGRAM_BINARY_RETRIEVABLE_HINT before linking; some drivers return
+     *          no binary otherwise.
+     * @return True if the entry was written.
+     */
+    bool store(const std::string& key, GLuint program);
+
+    /**
+     * @brief Gets the number of programs created from entries.
+     */
+    size_t getHitCount() const;
+
+    /**
+     * @brief Gets the number of load() calls that found no valid entry.
+     */
+    size_t getMissCount() const;
+
+private:
+    ProgramBinaryCache() = default;
+
+    /**
+     * @struct Entry
+     * @brief One cached program binary.
+     */
+    struct Entry {
+        GLenum format = 0;              ///< Driver-specific binary format.
+        uint64_t driver_hash = 0;       ///< Hash of the driver that produced the binary.
+        std::vector<char> binary;       ///< The program binary.
+    };
+
+    /**
+     * @brief Reads an entry file; safe to call from any thread.
+     * @return False if the file is missing or malformed.
+     */
+    static bool readEntry(const std::string& path, Entry& entry);
+
+    /**
+     * @brief Gets the file of a key.
+     */
+    std::string getPath(const std::string& key) const;
+
+    /**
+     * @brief Gets the hash of the current GL driver, computed once.
+     */
+    uint64_t getDriverHash();
+
+    mutable std::mutex mutex;                                   ///< Guards the members below.
+    std::string directory;                                      ///< Cache directory, empty when disabled.
+    std::map<std::string, std::future<std::pair<bool, Entry>>> prefetched; ///< Reads started by prefetch(), by key.
+    uint64_t driver_hash = 0;                                   ///< Hash of the current driver, 0 until first needed.
+    size_t hits = 0;                                            ///< Programs created from entries.
+    size_t misses = 0;                                          ///< Lookups without a valid entry.
+};
@@ -0,0 +1,321 @@
+#include "SceneBank.h"
+#include <algorithm>
+#include <sstream>
+
+//--------------------------------------------------------------
+SceneBank::SceneBank(ShaderCompositionEngine* composition_engine)
+    : engine(composition_engine)
+    , cue_position(0)
+    , lookahead(2)
+    , frame_budget_ms(4.0f)
+    , compile_estimate_ms(0.0f)
+    , last_compile_ms(0.0f) {
+}
+
+//--------------------------------------------------------------
+bool SceneBank::defineScene(const std::string& name, const GraphDescription& graph) {
+    if (name.empty() || graph.outputs.empty()) {
+        ofLogError("SceneBank") << "A scene needs a name and at least one output";
+        return false;
+    }
+
+    Scene& scene = scenes[name];
+    if (!scene.sync) {
+        scene.sync = std::make_unique<GraphSync>(engine);
+    }
+    release(scene);
+
+    GraphSyncResult result;
+    if (!scene.sync->apply(graph, result)) {
+        ofLogError("SceneBank") << "Scene " << name << " rejected: " << result.error;
+        if (scene.graph.nodes.empty()) {
+            scenes.erase(name);
+        }
+        return false;
+    }
+
+    scene.graph = graph;
+    scene.output_nodes.clear();
+    for (const auto& [output, key] : graph.outputs) {
+        scene.output_nodes[output] = scene.sync->getNodeId(key);
+    }
+    ofLogNotice("SceneBank") << "Defined scene " << name << " with " << graph.nodes.size() << " nodes";
+    return true;
+}
+
+//--------------------------------------------------------------
+bool SceneBank::loadSceneFile(const std::string& name, const std::string& path) {
+    ofBuffer buffer = ofBufferFromFile(path);
+    if (buffer.size() == 0) {
+        ofLogError("SceneBank") << "Cannot read scene file: " << path;
+        return false;
+    }
+
+    GraphDescription graph;
+    std::istringstream lines(buffer.getText());
+    std::string line;
+    int line_number = 0;
+    while (std::getline(lines, line)) {
+        line_number++;
+        line = ofTrim(line.substr(0, line.find('#')));
+        if (line.empty()) {
+            continue;
+        }
+
+        std::istringstream fields(line);
+        std::string record;
+        std::string key;
+        std::string value;
+        fields >> record >> key >> value;
+        if (record == "node" && !value.empty()) {
+            std::string raw_arguments;
+            std::getline(fields, raw_arguments);
+            graph.nodes[key] = {value, ofSplitString(raw_arguments, ",", true, true)};
+        } else if (record == "output" && !value.empty()) {
+            graph.outputs[key] = value;
+        } else {
+            ofLogError("SceneBank") << path << ":" << line_number << ": expected 'node' or 'output' record";
+            return false;
+        }
+    }
+    return defineScene(name, graph);
+}
+
+//--------------------------------------------------------------
+size_t SceneBank::loadDirectory(const std::string& path) {
+    ofDirectory directory(path);
+    directory.allowExt("scene");
+    directory.listDir();
+    directory.sort();
+
+    std::vector<std::string> loaded;
+    for (size_t i = 0; i < directory.size(); ++i) {
+        std::string name = ofFilePath::removeExt(directory.getName(i));
+        if (loadSceneFile(name, directory.getPath(i))) {
+            loaded.push_back(name);
+        }
+    }
+    if (cue_list.empty()) {
+        setCueList(loaded);
+    }
+    ofLogNotice("SceneBank") << "Loaded " << loaded.size() << " scenes from " << path;
+    return loaded.size();
+}
+
+//--------------------------------------------------------------
+void SceneBank::setCueList(const std::vector<std::string>& names) {
+    cue_list = names;
+    auto it = std::find(cue_list.begin(), cue_list.end(), current_scene);
+    cue_position = it != cue_list.end() ? static_cast<size_t>(it - cue_list.begin()) : 0;
+}
+
+//--------------------------------------------------------------
+void SceneBank::setLookahead(int cues) {
+    lookahead = std::max(cues, 0);
+}
+
+//--------------------------------------------------------------
+void SceneBank::setFrameBudget(float milliseconds) {
+    frame_budget_ms = std::max(milliseconds, 0.0f);
+}
+
+//--------------------------------------------------------------
+std::vector<std::string> SceneBank::getWindow() const {
+    std::vector<std::string> window;
+    if (!current_scene.empty()) {
+        window.push_back(current_scene);
+    }
+    // Before the first cue the window starts at the top of the list
+    size_t first = current_scene.empty() ? 0 : cue_position + 1;
+    size_t count = current_scene.empty() ? static_cast<size_t>(lookahead) + 1 : static_cast<size_t>(lookahead);
+    for (size_t i = first; i < cue_list.size() && i < first + count; ++i) {
+        if (scenes.count(cue_list[i]) && std::find(window.begin(), window.end(), cue_list[i]) == window.end()) {
+            window.push_back(cue_list[i]);
+        }
+    }
+    return window;
+}
+
+//--------------------------------------------------------------
+void SceneBank::update() {
+    last_compile_ms = 0.0f;
+    std::vector<std::string> window = getWindow();
+
+    for (auto& [name, scene] : scenes) {
+        if (!scene.programs.empty() && std::find(window.begin(), window.end(), name) == window.end()) {
+            release(scene);
+        }
+    }
+
+    // Start a compile only if the estimate still fits the budget. One compile is the
+    // smallest unit of work, so a graph estimated above the whole budget gets a frame of its own.
+    uint64_t start = ofGetElapsedTimeMicros();
+    bool compiled_any = false;
+    for (const std::string& name : window) {
+        Scene& scene = scenes[name];
+        while (!isComplete(scene)) {
+            float elapsed = (ofGetElapsedTimeMicros() - start) / 1000.0f;
+            if (compiled_any && elapsed + compile_estimate_ms > frame_budget_ms) {
+                last_compile_ms = elapsed;
+                return;
+            }
+            uint64_t compile_start = ofGetElapsedTimeMicros();
+            bool success = compileNext(scene);
+            float ms = (ofGetElapsedTimeMicros() - compile_start) / 1000.0f;
+            compile_estimate_ms = compile_estimate_ms > 0.0f ? compile_estimate_ms + (ms - compile_estimate_ms) * 0.25f : ms;
+            compiled_any = true;
+            if (!success) {
+                break;
+            }
+        }
+    }
+    last_compile_ms = (ofGetElapsedTimeMicros() - start) / 1000.0f;
+}
+
+//--------------------------------------------------------------
+bool SceneBank::compileNext(Scene& scene) {
+    for (const auto& [output, node_id] : scene.output_nodes) {
+        if (scene.programs.count(output)) {
+            continue;
+        }
+        std::shared_ptr<ShaderNode> program = engine->compileGraph(node_id);
+        if (!program || !program->isReady()) {
+            ofLogError("SceneBank") << "Failed to compile output " << output << " of a scene";
+            // Store the failure so the scene is not retried every frame
+            scene.programs[output] = nullptr;
+            return false;
+        }
+
+        GLint binary_length = 0;
+        glGetProgramiv(program->getProgramId(), GL_PROGRAM_BINARY_LENGTH, &binary_length);
+        scene.program_bytes += static_cast<size_t>(std::max(binary_length, 0));
+        scene.programs[output] = program;
+        return true;
+    }
+    return false;
+}
+
+//--------------------------------------------------------------
+void SceneBank::release(Scene& scene) {
+    for (const auto& [output, program] : scene.programs) {
+        if (program) {
+            engine->releaseCompiledGraph(scene.output_nodes[output]);
+        }
+    }
+    scene.programs.clear();
+    scene.program_bytes = 0;
+}
+
+//--------------------------------------------------------------
+bool SceneBank::isComplete(const Scene& scene) {
+    return scene.programs.size() == scene.output_nodes.size();
+}
+
+//--------------------------------------------------------------
+bool SceneBank::activate(const std::string& name,
+                         std::map<std::string, std::pair<std::shared_ptr<ShaderNode>, std::string>>& programs) {
+    auto it = scenes.find(name);
+    if (it == scenes.end()) {
+        ofLogError("SceneBank") << "Scene not found: " << name;
+        return false;
+    }
+
+    Scene& scene = it->second;
+    if (!isComplete(scene)) {
+        ofLogWarning("SceneBank") << "Cold cue: scene " << name << " was not precompiled";
+        while (!isComplete(scene) && compileNext(scene)) {
+        }
+    }
+
+    programs.clear();
+    for (const auto& [output, program] : scene.programs) {
+        if (!program) {
+            // Drop the failure so the next cue retries
+            scene.programs.erase(output);
+            return false;
+        }
+        programs[output] = {program, scene.output_nodes[output]};
+    }
+
+    current_scene = name;
+    auto cue = std::find(cue_list.begin(), cue_list.end(), name);
+    if (cue != cue_list.end()) {
+        cue_position = static_cast<size_t>(cue - cue_list.begin());
+    }
+    return true;
+}
+
+//--------------------------------------------------------------
+bool SceneBank::hasScene(const std::string& name) const {
+    return scenes.count(name) > 0;
+}
+
+//--------------------------------------------------------------
+size_t SceneBank::getSceneCount() const {
+    return scenes.size();
+}
+
+//--------------------------------------------------------------
+const std::string& SceneBank::getCurrentScene() const {
+    return current_scene;
+}
+
+//--------------------------------------------------------------
+bool SceneBank::ownsNode(const std::string& node_id) const {
+    for (const auto& [name, scene] : scenes) {
+        for (const auto& [key, scene_node_id] : scene.sync->getNodeIds()) {
+            if (scene_node_id == node_id) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+//--------------------------------------------------------------
+size_t SceneBank::getResidentProgramCount() const {
+    size_t count = 0;
+    for (const auto& [name, scene] : scenes) {
+        for (const auto& [output, program] : scene.programs) {
+            count += program ? 1 : 0;
+        }
+    }
+    return count;
+}
+
+//--------------------------------------------------------------
+size_t SceneBank::getResidentProgramBytes() const {
+    size_t bytes = 0;
+    for (const auto& [name, scene] : scenes) {
+        bytes += scene.program_bytes;
+    }
+    return bytes;
+}
+
+//--------------------------------------------------------------
+size_t SceneBank::getResidentSourceBytes() const {
+    size_t bytes = 0;
+    for (const auto& [name, scene] : scenes) {
+        for (const auto& [output, program] : scene.programs) {
+            if (program) {
+                bytes += program->metadata->sources.getResidentBytes();
+            }
+        }
+    }
+    return bytes;
+}
+
+//--------------------------------------------------------------
+size_t SceneBank::getPendingCompileCount() const {
+    size_t pending = 0;
+    for (const std::string& name : getWindow()) {
+        const Scene& scene = scenes.at(name);
+        pending += scene.output_nodes.size() - scene.programs.size();
+    }
+    return pending;
+}
+
+//--------------------------------------------------------------
+float SceneBank::getLastCompileMilliseconds() const {
+    return last_compile_ms;
+}
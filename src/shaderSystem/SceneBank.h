@@ -0,0 +1,164 @@
+#pragma once
+#include "ofMain.h"
+#include "GraphSync.h"
+#include "ShaderCompositionEngine.h"
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @class SceneBank
+ * @brief Named graphs that are compiled ahead of their cue, so switching is a program swap.
+ * @details Scenes are defined from OSC or loaded from text files. Each scene owns its nodes
+ *          in the composition engine (through its own GraphSync, so redefining a scene only
+ *          touches what changed).
+ *
+ *          update() keeps the scenes inside a lookahead window over the cue list compiled:
+ *          it compiles one output graph at a time while the per-frame budget allows it,
+ *          using a moving average of past compile times as the estimate, and releases the
+ *          programs of scenes that fell out of the window. A switch to a resident scene only
+ *          hands out already linked programs.
+ *
+ *          Scene file format, one record per line ('#' starts a comment):
+ *          @code
+ *          node <key> <function> <comma-separated args, $key for other nodes>
+ *          output <output name> <key>
+ *          @endcode
+ */
+class SceneBank {
+public:
+    /**
+     * @param engine The composition engine that owns the scene nodes; must outlive the bank.
+     */
+    explicit SceneBank(ShaderCompositionEngine* engine);
+
+    /**
+     * @brief Defines or replaces a scene. Its programs are recompiled on the next update().
+     * @return False if the graph is rejected by the composition engine.
+     */
+    bool defineScene(const std::string& name, const GraphDescription& graph);
+
+    /**
+     * @brief Loads a scene from a scene file.
+     * @return False if the file cannot be read or parsed.
+     */
+    bool loadSceneFile(const std::string& name, const std::string& path);
+
+    /**
+     * @brief Loads every *.scene file of a directory, named after the file.
+     * @details If no cue list has been set, the loaded scenes become the cue list in name order.
+     * @return The number of scenes loaded.
+     */
+    size_t loadDirectory(const std::string& path);
+
+    /**
+     * @brief Sets the order in which scenes are expected to be cued.
+     */
+    void setCueList(const std::vector<std::string>& names);
+
+    /**
+     * @brief Sets how many cues after the current one are kept compiled.
+     */
+    void setLookahead(int cues);
+
+    /**
+     * @brief Sets the CPU time per frame available for compiling scenes.
+     */
+    void setFrameBudget(float milliseconds);
+
+    /**
+     * @brief Compiles scenes of the lookahead window within the budget and releases the others.
+     * @details Call once per frame on the GL thread.
+     */
+    void update();
+
+    /**
+     * @brief Makes a scene current and returns its programs.
+     * @details A scene that is not resident yet is compiled immediately (a cold cue).
+     * @param name The scene name.
+     * @param programs Receives the program and composition node of each output.
+     * @return False if the scene does not exist or fails to compile.
+     */
+    bool activate(const std::string& name,
+                  std::map<std::string, std::pair<std::shared_ptr<ShaderNode>, std::string>>& programs);
+
+    bool hasScene(const std::string& name) const;
+    size_t getSceneCount() const;
+
+    /**
+     * @brief Gets the active scene, empty before the first cue.
+     */
+    const std::string& getCurrentScene() const;
+
+    /**
+     * @brief Checks whether a composition node belongs to one of the scenes.
+     */
+    bool ownsNode(const std::string& node_id) const;
+
+    /**
+     * @brief Gets the number of linked programs held by resident scenes.
+     */
+    size_t getResidentProgramCount() const;
+
+    /**
+     * @brief Gets the driver-reported binary size of all resident programs in bytes.
+     */
+    size_t getResidentProgramBytes() const;
+
+    /**
+     * @brief Gets the bytes of shader source still held by resident scenes after linking.
+     */
+    size_t getResidentSourceBytes() const;
+
+    /**
+     * @brief Gets the number of output graphs in the window that still need compiling.
+     */
+    size_t getPendingCompileCount() const;
+
+    /**
+     * @brief Gets the CPU time spent compiling in the last update() in milliseconds.
+     */
+    float getLastCompileMilliseconds() const;
+
+private:
+    /**
+     * @struct Scene
+     * @brief One named graph and its compiled programs.
+     */
+    struct Scene {
+        GraphDescription graph;                                 ///< The scene as defined.
+        std::unique_ptr<GraphSync> sync;                        ///< Binds the scene keys to engine nodes.
+        std::map<std::string, std::string> output_nodes;        ///< Engine node of each output.
+        std::map<std::string, std::shared_ptr<ShaderNode>> programs; ///< Compiled program of each output.
+        size_t program_bytes = 0;                               ///< Binary size of the programs.
+    };
+
+    /**
+     * @brief Compiles the next missing output program of a scene.
+     * @return False if there was nothing left to compile or compilation failed.
+     */
+    bool compileNext(Scene& scene);
+
+    /**
+     * @brief Releases the compiled programs of a scene; its nodes stay registered.
+     */
+    void release(Scene& scene);
+
+    /**
+     * @brief Gets the names of the scenes that should be resident.
+     */
+    std::vector<std::string> getWindow() const;
+
+    static bool isComplete(const Scene& scene);
+
+    ShaderCompositionEngine* engine;                ///< Owner of the scene nodes.
+    std::map<std::string, Scene> scenes;            ///< Scenes by name.
+    std::vector<std::string> cue_list;              ///< Expected cue order.
+    std::string current_scene;                      ///< The active scene, empty before the first cue.
+    size_t cue_position;                            ///< Index of the current scene in cue_list.
+    int lookahead;                                  ///< Cues after the current one kept compiled.
+    float frame_budget_ms;                          ///< Compile time per frame.
+    float compile_estimate_ms;                      ///< Moving average of one graph compile.
+    float last_compile_ms;                          ///< Compile time of the last update().
+};
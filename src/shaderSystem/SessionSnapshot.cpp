@@ -0,0 +1,521 @@
+#include "SessionSnapshot.h"
+#include "ShaderRegistry.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <set>
+
+namespace {
+
+const char kSnapshotMagic[4] = {'G', 'E', 'S', 'S'};
+const uint8_t kSnapshotVersion = 1;
+
+// --- Encoding ---
+
+void writeVarint(std::string& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+void writeFloat(std::string& out, float value) {
+    char bytes[sizeof(float)];
+    std::memcpy(bytes, &value, sizeof(float));
+    out.append(bytes, sizeof(float));
+}
+
+void writeString(std::string& out, const std::string& value) {
+    writeVarint(out, value.size());
+    out += value;
+}
+
+/// Node IDs are stored as their packed handle, 0 for none.
+void writeNodeId(std::string& out, const std::string& node_id) {
+    writeVarint(out, node_id.empty() ? 0 : ShaderHandle::parse(node_id).pack());
+}
+
+void writeStrings(std::string& out, const std::vector<std::string>& values) {
+    writeVarint(out, values.size());
+    for (const std::string& value : values) {
+        writeString(out, value);
+    }
+}
+
+// --- Decoding ---
+
+/// Sequential reader over a snapshot; every read fails once the data ran out.
+class SnapshotReader {
+public:
+    explicit SnapshotReader(const std::string& snapshot_data)
+        : data(snapshot_data), position(0), valid(true) {
+    }
+
+    bool readVarint(uint64_t& value) {
+        value = 0;
+        for (int shift = 0; shift < 64 && valid; shift += 7) {
+            if (position >= data.size()) {
+                break;
+            }
+            uint8_t byte = static_cast<uint8_t>(data[position++]);
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) {
+                return true;
+            }
+        }
+        valid = false;
+        return false;
+    }
+
+    bool readFloat(float& value) {
+        if (!valid || data.size() - position < sizeof(float)) {
+            valid = false;
+            return false;
+        }
+        std::memcpy(&value, data.data() + position, sizeof(float));
+        position += sizeof(float);
+        return true;
+    }
+
+    bool readString(std::string& value) {
+        uint64_t size = 0;
+        if (!readVarint(size) || data.size() - position < size) {
+            valid = false;
+            return false;
+        }
+        value.assign(data, position, static_cast<size_t>(size));
+        position += static_cast<size_t>(size);
+        return true;
+    }
+
+    bool readNodeId(std::string& node_id) {
+        uint64_t packed = 0;
+        if (!readVarint(packed)) {
+            return false;
+        }
+        node_id = packed == 0 ? "" : ShaderHandle::unpack(packed).toString();
+        return true;
+    }
+
+    bool readStrings(std::vector<std::string>& values) {
+        uint64_t count = 0;
+        if (!readVarint(count)) {
+            return false;
+        }
+        values.clear();
+        for (uint64_t i = 0; i < count && valid; ++i) {
+            std::string value;
+            readString(value);
+            values.push_back(std::move(value));
+        }
+        return valid;
+    }
+
+    bool readBytes(char* destination, size_t size) {
+        if (!valid || data.size() - position < size) {
+            valid = false;
+            return false;
+        }
+        std::memcpy(destination, data.data() + position, size);
+        position += size;
+        return true;
+    }
+
+    bool isValid() const { return valid; }
+    bool isAtEnd() const { return position == data.size(); }
+
+private:
+    const std::string& data;
+    size_t position;
+    bool valid;
+};
+
+bool readNode(SnapshotReader& reader, SessionNode& node) {
+    uint64_t workgroup_size = 0;
+    uint64_t parameter_count = 0;
+    reader.readNodeId(node.node_id);
+    reader.readString(node.function_name);
+    reader.readStrings(node.arguments);
+    reader.readFloat(node.compute_scale);
+    reader.readVarint(workgroup_size);
+    reader.readVarint(parameter_count);
+    node.compute_workgroup_size = static_cast<int>(workgroup_size);
+    for (uint64_t i = 0; i < parameter_count && reader.isValid(); ++i) {
+        std::string port_name;
+        uint64_t value_count = 0;
+        reader.readString(port_name);
+        reader.readVarint(value_count);
+        std::vector<float>& values = node.parameter_values[port_name];
+        for (uint64_t j = 0; j < value_count && reader.isValid(); ++j) {
+            float value = 0.0f;
+            reader.readFloat(value);
+            values.push_back(value);
+        }
+    }
+    return reader.isValid();
+}
+
+bool readSession(SnapshotReader& reader, SessionState& state) {
+    uint64_t output_count = 0;
+    reader.readNodeId(state.main_node_id);
+    reader.readString(state.main_program_key);
+    reader.readVarint(output_count);
+    for (uint64_t i = 0; i < output_count && reader.isValid(); ++i) {
+        SessionOutput output;
+        uint64_t width = 0;
+        uint64_t height = 0;
+        float x = 0.0f, y = 0.0f, w = 0.0f, h = 0.0f;
+        reader.readString(output.name);
+        reader.readVarint(width);
+        reader.readVarint(height);
+        reader.readFloat(x);
+        reader.readFloat(y);
+        reader.readFloat(w);
+        reader.readFloat(h);
+        reader.readString(output.shm_name);
+        reader.readNodeId(output.node_id);
+        reader.readString(output.program_key);
+        output.width = static_cast<int>(width);
+        output.height = static_cast<int>(height);
+        output.window_rect.set(x, y, w, h);
+        state.outputs.push_back(std::move(output));
+    }
+
+    uint64_t graph_node_count = 0;
+    reader.readVarint(graph_node_count);
+    for (uint64_t i = 0; i < graph_node_count && reader.isValid(); ++i) {
+        std::string key;
+        GraphDescription::Node node;
+        std::string node_id;
+        reader.readString(key);
+        reader.readString(node.function_name);
+        reader.readStrings(node.arguments);
+        reader.readNodeId(node_id);
+        state.graph.nodes[key] = std::move(node);
+        state.graph_node_ids[key] = node_id;
+    }
+    uint64_t graph_output_count = 0;
+    reader.readVarint(graph_output_count);
+    for (uint64_t i = 0; i < graph_output_count && reader.isValid(); ++i) {
+        std::string output;
+        std::string key;
+        reader.readString(output);
+        reader.readString(key);
+        state.graph.outputs[output] = key;
+    }
+    reader.readString(state.active_scene);
+    return reader.isValid();
+}
+
+} // namespace
+
+//--------------------------------------------------------------
+std::vector<std::string> SessionState::getProgramKeys() const {
+    std::vector<std::string> keys;
+    if (!main_program_key.empty()) {
+        keys.push_back(main_program_key);
+    }
+    for (const auto& output : outputs) {
+        if (!output.program_key.empty()) {
+            keys.push_back(output.program_key);
+        }
+    }
+    return keys;
+}
+
+//--------------------------------------------------------------
+bool SessionSnapshot::read(const std::string& path, SessionState& state) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        ofLogError("SessionSnapshot") << "Cannot open session snapshot: " << path;
+        return false;
+    }
+    std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    SnapshotReader reader(data);
+    char magic[sizeof(kSnapshotMagic)];
+    char version = 0;
+    uint64_t sequence = 0;
+    uint64_t node_count = 0;
+    if (!reader.readBytes(magic, sizeof(magic)) || std::memcmp(magic, kSnapshotMagic, sizeof(magic)) != 0 ||
+        !reader.readBytes(&version, 1) || static_cast<uint8_t>(version) != kSnapshotVersion) {
+        ofLogError("SessionSnapshot") << "Not a session snapshot of this version: " << path;
+        return false;
+    }
+    reader.readVarint(sequence);
+    reader.readVarint(node_count);
+
+    state = SessionState();
+    for (uint64_t i = 0; i < node_count && reader.isValid(); ++i) {
+        SessionNode node;
+        if (readNode(reader, node)) {
+            state.nodes.push_back(std::move(node));
+        }
+    }
+    if (!readSession(reader, state) || !reader.isAtEnd()) {
+        ofLogError("SessionSnapshot") << "Session snapshot is truncated or corrupt: " << path;
+        return false;
+    }
+    ofLogNotice("SessionSnapshot") << "Read session snapshot " << sequence << " with " << state.nodes.size()
+                                   << " nodes (" << data.size() << " bytes)";
+    return true;
+}
+
+//--------------------------------------------------------------
+std::string SessionSnapshot::encodeNode(const SessionNode& node) {
+    std::string out;
+    writeNodeId(out, node.node_id);
+    writeString(out, node.function_name);
+    writeStrings(out, node.arguments);
+    writeFloat(out, node.compute_scale);
+    writeVarint(out, static_cast<uint64_t>(std::max(node.compute_workgroup_size, 0)));
+    writeVarint(out, node.parameter_values.size());
+    for (const auto& [port_name, values] : node.parameter_values) {
+        writeString(out, port_name);
+        writeVarint(out, values.size());
+        for (float value : values) {
+            writeFloat(out, value);
+        }
+    }
+    return out;
+}
+
+//--------------------------------------------------------------
+std::string SessionSnapshot::encodeSession(const SessionState& state) {
+    std::string out;
+    writeNodeId(out, state.main_node_id);
+    writeString(out, state.main_program_key);
+    writeVarint(out, state.outputs.size());
+    for (const auto& output : state.outputs) {
+        writeString(out, output.name);
+        writeVarint(out, static_cast<uint64_t>(std::max(output.width, 0)));
+        writeVarint(out, static_cast<uint64_t>(std::max(output.height, 0)));
+        writeFloat(out, output.window_rect.x);
+        writeFloat(out, output.window_rect.y);
+        writeFloat(out, output.window_rect.width);
+        writeFloat(out, output.window_rect.height);
+        writeString(out, output.shm_name);
+        writeNodeId(out, output.node_id);
+        writeString(out, output.program_key);
+    }
+
+    writeVarint(out, state.graph.nodes.size());
+    for (const auto& [key, node] : state.graph.nodes) {
+        auto bound = state.graph_node_ids.find(key);
+        writeString(out, key);
+        writeString(out, node.function_name);
+        writeStrings(out, node.arguments);
+        writeNodeId(out, bound != state.graph_node_ids.end() ? bound->second : "");
+    }
+    writeVarint(out, state.graph.outputs.size());
+    for (const auto& [output, key] : state.graph.outputs) {
+        writeString(out, output);
+        writeString(out, key);
+    }
+    writeString(out, state.active_scene);
+    return out;
+}
+
+//--------------------------------------------------------------
+std::string SessionSnapshot::assemble(uint64_t sequence, const std::vector<const std::string*>& node_records,
+                                      const std::string& session_record) {
+    std::string out(kSnapshotMagic, sizeof(kSnapshotMagic));
+    out.push_back(static_cast<char>(kSnapshotVersion));
+    writeVarint(out, sequence);
+    writeVarint(out, node_records.size());
+    for (const std::string* record : node_records) {
+        out += *record;
+    }
+    out += session_record;
+    return out;
+}
+
+//--------------------------------------------------------------
+SessionSnapshotWriter::SessionSnapshotWriter()
+    : interval_micros(0)
+    , last_capture_micros(0)
+    , captured_revision(0)
+    , stopping(false)
+    , sequence(0)
+    , write_count(0)
+    , last_bytes(0)
+    , last_encoded_nodes(0) {
+}
+
+//--------------------------------------------------------------
+SessionSnapshotWriter::~SessionSnapshotWriter() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+//--------------------------------------------------------------
+void SessionSnapshotWriter::start(const std::string& snapshot_path, double interval_seconds) {
+    if (worker.joinable()) {
+        ofLogWarning("SessionSnapshotWriter") << "Already writing to " << path;
+        return;
+    }
+    path = snapshot_path;
+    interval_micros = static_cast<uint64_t>(std::max(interval_seconds, 0.0) * 1000000.0);
+    worker = std::thread(&SessionSnapshotWriter::run, this);
+    ofLogNotice("SessionSnapshotWriter") << "Writing session snapshots to " << path
+                                         << " every " << interval_seconds << " s";
+}
+
+//--------------------------------------------------------------
+bool SessionSnapshotWriter::isDue() const {
+    return worker.joinable() && ofGetElapsedTimeMicros() - last_capture_micros >= interval_micros;
+}
+
+//--------------------------------------------------------------
+void SessionSnapshotWriter::capture(uint64_t engine_revision, const std::vector<const CompositionNode*>& nodes,
+                                    SessionState session) {
+    last_capture_micros = ofGetElapsedTimeMicros();
+
+    auto job = std::make_unique<Job>();
+    job->session = std::move(session);
+    job->session.nodes.clear();
+    job->live_node_ids.reserve(nodes.size());
+    bool nodes_unchanged = engine_revision == captured_revision && nodes.size() == captured_revisions.size();
+    if (!nodes_unchanged) {
+        std::unordered_map<std::string, uint64_t> revisions;
+        for (const CompositionNode* node : nodes) {
+            std::string node_id = node->node_id.toString();
+            job->live_node_ids.push_back(node_id);
+            revisions[node_id] = node->revision;
+            auto captured = captured_revisions.find(node_id);
+            if (captured != captured_revisions.end() && captured->second == node->revision) {
+                continue;
+            }
+
+            SessionNode changed;
+            changed.node_id = node_id;
+            changed.function_name = node->function_name.str();
+            changed.arguments = node->arguments;
+            changed.compute_scale = node->compute_scale;
+            changed.compute_workgroup_size = node->compute_workgroup_size;
+            for (const auto& [port_name, values] : node->parameter_values) {
+                changed.parameter_values[port_name.str()] = values;
+            }
+            job->changed_nodes.push_back(std::move(changed));
+        }
+        captured_revisions = std::move(revisions);
+        captured_revision = engine_revision;
+    } else {
+        for (const auto& [node_id, revision] : captured_revisions) {
+            job->live_node_ids.push_back(node_id);
+        }
+    }
+    std::sort(job->live_node_ids.begin(), job->live_node_ids.end());
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (pending) {
+            // The worker has not taken the previous job; its changes must not be lost
+            std::set<std::string> superseded;
+            for (const auto& node : job->changed_nodes) {
+                superseded.insert(node.node_id);
+            }
+            for (auto& node : pending->changed_nodes) {
+                if (!superseded.count(node.node_id)) {
+                    job->changed_nodes.push_back(std::move(node));
+                }
+            }
+        }
+        pending = std::move(job);
+    }
+    wake.notify_one();
+}
+
+//--------------------------------------------------------------
+uint64_t SessionSnapshotWriter::getWriteCount() const {
+    return write_count.load();
+}
+
+//--------------------------------------------------------------
+uint64_t SessionSnapshotWriter::getLastBytes() const {
+    return last_bytes.load();
+}
+
+//--------------------------------------------------------------
+uint64_t SessionSnapshotWriter::getLastEncodedNodes() const {
+    return last_encoded_nodes.load();
+}
+
+//--------------------------------------------------------------
+void SessionSnapshotWriter::run() {
+    for (;;) {
+        std::unique_ptr<Job> job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this] { return pending || stopping; });
+            if (!pending) {
+                return;
+            }
+            job = std::move(pending);
+        }
+        // A job captured right before stopping is still written, so a planned exit keeps its state
+        write(*job);
+    }
+}
+
+//--------------------------------------------------------------
+void SessionSnapshotWriter::write(Job& job) {
+    std::set<std::string> live(job.live_node_ids.begin(), job.live_node_ids.end());
+    bool changed = !job.changed_nodes.empty();
+    for (auto it = node_records.begin(); it != node_records.end();) {
+        if (live.count(it->first)) {
+            ++it;
+        } else {
+            it = node_records.erase(it);
+            changed = true;
+        }
+    }
+    for (const auto& node : job.changed_nodes) {
+        if (live.count(node.node_id)) {
+            node_records[node.node_id] = SessionSnapshot::encodeNode(node);
+        }
+    }
+    std::string session = SessionSnapshot::encodeSession(job.session);
+    if (!changed && session == session_record && write_count.load() > 0) {
+        return;
+    }
+    session_record = std::move(session);
+
+    std::vector<const std::string*> records;
+    records.reserve(job.live_node_ids.size());
+    for (const std::string& node_id : job.live_node_ids) {
+        auto record = node_records.find(node_id);
+        if (record != node_records.end()) {
+            records.push_back(&record->second);
+        }
+    }
+    std::string data = SessionSnapshot::assemble(sequence++, records, session_record);
+
+    // Replaced atomically, so a crash while writing leaves the previous snapshot intact
+    std::string temporary_path = path + ".tmp";
+    {
+        std::ofstream file(temporary_path, std::ios::binary | std::ios::trunc);
+        file.write(data.data(), static_cast<std::streamsize>(data.size()));
+        if (!file) {
+            ofLogError("SessionSnapshotWriter") << "Failed writing " << temporary_path;
+            return;
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(temporary_path, path, error);
+    if (error) {
+        ofLogError("SessionSnapshotWriter") << "Cannot move " << temporary_path << " into place: " << error.message();
+        return;
+    }
+    write_count++;
+    last_bytes = data.size();
+    last_encoded_nodes = job.changed_nodes.size();
+}
@@ -0,0 +1,195 @@
+#pragma once
+#include "ofMain.h"
+#include "GraphSync.h"
+#include "ShaderCompositionEngine.h"
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @struct SessionNode
+ * @brief One composition node as stored in a session snapshot.
+ * @details Arguments are kept raw; their "$shader_..." references are the edges of the graph.
+ */
+struct SessionNode {
+    std::string node_id;                                        ///< Engine node ID, restored as is.
+    std::string function_name;                                  ///< The GLSL function.
+    std::vector<std::string> arguments;                         ///< Raw arguments.
+    float compute_scale = 0.0f;                                 ///< Compute variant scale, 0 for none.
+    int compute_workgroup_size = 8;                             ///< Compute local size in x and y.
+    std::map<std::string, std::vector<float>> parameter_values; ///< Parameter ports set at runtime.
+};
+
+/**
+ * @struct SessionOutput
+ * @brief One named output as stored in a session snapshot.
+ */
+struct SessionOutput {
+    std::string name;           ///< The output name.
+    int width = 0;              ///< Output width in pixels.
+    int height = 0;             ///< Output height in pixels.
+    ofRectangle window_rect;    ///< Where the output is drawn in the window, empty for none.
+    std::string shm_name;       ///< Shared-memory ring of the output, empty for none.
+    std::string node_id;        ///< Composition node shown on the output, empty for none.
+    std::string program_key;    ///< ProgramBinaryCache key of the output's program.
+};
+
+/**
+ * @struct SessionState
+ * @brief The control state of the engine that a restart has to bring back.
+ */
+struct SessionState {
+    std::vector<SessionNode> nodes;                     ///< Composition nodes outside of scenes.
+    std::string main_node_id;                           ///< Composition node shown on the main output.
+    std::string main_program_key;                       ///< ProgramBinaryCache key of the main program.
+    std::vector<SessionOutput> outputs;                 ///< Named outputs.
+    GraphDescription graph;                             ///< The last /graph description, as applied.
+    std::map<std::string, std::string> graph_node_ids;  ///< Engine node ID of each /graph key.
+    std::string active_scene;                           ///< The cued scene, empty for none.
+
+    /**
+     * @brief Gets the program keys of all outputs, for prefetching.
+     */
+    std::vector<std::string> getProgramKeys() const;
+};
+
+/**
+ * @class SessionSnapshot
+ * @brief Reads and writes the binary session snapshot format.
+ * @details Layout: the magic "GESS", a format version byte and a sequence number, then the
+ *          node records and one session record with the outputs, the /graph binding and the
+ *          active scene. Integers are LEB128 varints, node IDs their packed ShaderHandle,
+ *          floats 4 raw bytes and strings a varint length followed by the bytes. Each node
+ *          record is self-contained, so unchanged nodes are copied into the next snapshot
+ *          without being encoded again.
+ */
+class SessionSnapshot {
+public:
+    /**
+     * @brief Reads a snapshot file.
+     * @return False if the file is missing, truncated or of another format.
+     */
+    static bool read(const std::string& path, SessionState& state);
+
+    /**
+     * @brief Encodes one node record.
+     */
+    static std::string encodeNode(const SessionNode& node);
+
+    /**
+     * @brief Encodes the session record, i.e. everything but the nodes.
+     */
+    static std::string encodeSession(const SessionState& state);
+
+    /**
+     * @brief Assembles a complete file from encoded records.
+     * @param sequence Number of the snapshot, for diagnostics.
+     * @param node_records The encoded nodes.
+     * @param session_record The encoded session.
+     */
+    static std::string assemble(uint64_t sequence, const std::vector<const std::string*>& node_records,
+                                const std::string& session_record);
+};
+
+/**
+ * @class SessionSnapshotWriter
+ * @brief Writes session snapshots periodically and incrementally on a worker thread.
+ * @details capture() runs on the control thread and only copies nodes whose engine revision
+ *          changed since the previous capture. The worker re-encodes just those, reuses the
+ *          records of all other nodes and replaces the file atomically; if neither a node nor
+ *          the session record changed, nothing is written.
+ */
+class SessionSnapshotWriter {
+public:
+    SessionSnapshotWriter();
+
+    /**
+     * @brief Writes the last captured state, if it is still pending, and stops the worker.
+     */
+    ~SessionSnapshotWriter();
+
+    SessionSnapshotWriter(const SessionSnapshotWriter&) = delete;
+    SessionSnapshotWriter& operator=(const SessionSnapshotWriter&) = delete;
+
+    /**
+     * @brief Starts the worker.
+     * @param path The snapshot file.
+     * @param interval_seconds Minimum time between captures.
+     */
+    void start(const std::string& path, double interval_seconds);
+
+    /**
+     * @brief Checks whether the interval since the last capture has elapsed.
+     */
+    bool isDue() const;
+
+    /**
+     * @brief Hands the current state to the worker.
+     * @param engine_revision ShaderCompositionEngine::getRevision() at capture time.
+     * @param nodes The nodes to store, read only when their revision changed.
+     * @param session Everything but the nodes.
+     */
+    void capture(uint64_t engine_revision, const std::vector<const CompositionNode*>& nodes, SessionState session);
+
+    /**
+     * @brief Gets the number of snapshot files written.
+     */
+    uint64_t getWriteCount() const;
+
+    /**
+     * @brief Gets the size of the last snapshot file in bytes.
+     */
+    uint64_t getLastBytes() const;
+
+    /**
+     * @brief Gets how many nodes the last snapshot had to encode.
+     */
+    uint64_t getLastEncodedNodes() const;
+
+private:
+    /**
+     * @struct Job
+     * @brief A captured state waiting for the worker.
+     */
+    struct Job {
+        std::vector<SessionNode> changed_nodes;     ///< Nodes to encode again.
+        std::vector<std::string> live_node_ids;     ///< All stored nodes, in write order.
+        SessionState session;                       ///< Everything but the nodes.
+    };
+
+    /**
+     * @brief Worker loop: encodes and writes jobs until stopped.
+     */
+    void run();
+
+    /**
+     * @brief Encodes a job and replaces the snapshot file if anything changed.
+     */
+    void write(Job& job);
+
+    std::string path;                   ///< The snapshot file.
+    uint64_t interval_micros;           ///< Minimum time between captures.
+    uint64_t last_capture_micros;       ///< Time of the last capture.
+    uint64_t captured_revision;         ///< Engine revision of the last capture.
+    std::unordered_map<std::string, uint64_t> captured_revisions; ///< Node revisions of the last capture.
+
+    std::thread worker;                 ///< Encodes and writes jobs.
+    std::mutex mutex;                   ///< Guards pending and stopping.
+    std::condition_variable wake;       ///< Signals a pending job or stopping.
+    std::unique_ptr<Job> pending;       ///< The newest captured job, null if none.
+    bool stopping;                      ///< Set by the destructor.
+
+    // Worker state
+    std::unordered_map<std::string, std::string> node_records; ///< Encoded record of each stored node.
+    std::string session_record;         ///< Encoded session of the last write.
+    uint64_t sequence;                  ///< Number of the next snapshot.
+
+    std::atomic<uint64_t> write_count;          ///< Snapshot files written.
+    std::atomic<uint64_t> last_bytes;           ///< Size of the last file.
+    std::atomic<uint64_t> last_encoded_nodes;   ///< Nodes encoded for the last file.
+};
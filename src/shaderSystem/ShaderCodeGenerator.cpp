@@ -1,5 +1,6 @@
 #include "ShaderCodeGenerator.h"
 #include "BuiltinVariables.h"
+#include "../statsSystem/AllocationTracker.h"
 #include <sstream>
 #include <set>
 #include <algorithm>
@@ -21,20 +22,17 @@ ShaderCodeGenerator::~ShaderCodeGenerator() {
 
 //--------------------------------------------------------------
 void ShaderCodeGenerator::initializeShaderTemplates() {
-    // Default vertex shader passes through position and texture coordinates.
+    // Default vertex shader emits an attribute-less fullscreen triangle from gl_VertexID.
+    // It is drawn by FullscreenPass with an empty VAO; no matrices or vertex buffers are needed.
     default_vertex_shader = R"(
 #version 150
 
-uniform mat4 modelViewProjectionMatrix;
-
-in vec4 position;
-in vec2 texcoord;
-
 out vec2 vTexCoord;
 
 void main() {
-    vTexCoord = texcoord;
-    gl_Position = modelViewProjectionMatrix * position;
+    vec2 position = vec2(float((gl_VertexID << 1) & 2), float(gl_VertexID & 2));
+    vTexCoord = position;
+    gl_Position = vec4(position * 2.0 - 1.0, 0.0, 1.0);
 }
 )";
 
@@ -68,6 +66,7 @@ std::string ShaderCodeGenerator::generateFragmentShader(
     const std::string& glsl_function_code,
     const std::string& function_name,
     const std::vector<std::string>& arguments) {
+    AllocationScope allocation_scope(AllocationTag::CODEGEN);
     
     // Debug: Log all arguments
     ofLogNotice("ShaderCodeGenerator") << "generateFragmentShader called with function: " << function_name;
@@ -139,9 +138,10 @@ std::string ShaderCodeGenerator::generateUniforms(const std::vector<std::string>
             const BuiltinVariable* builtin_info = builtins.getBuiltinInfo(base_var);
             
             if (builtin_info && builtin_info->needs_uniform) {
-                // 'st' requires the 'resolution' uniform
+                // 'st' requires the 'resolution' and 'tileOffset' uniforms
                 if (base_var == "st") {
                     needed_uniforms.insert("resolution");
+                    needed_uniforms.insert("tileOffset");
                 } else {
                     needed_uniforms.insert(base_var);
                 }
@@ -152,12 +152,22 @@ std::string ShaderCodeGenerator::generateUniforms(const std::vector<std::string>
         }
     }
     
+    // Texture inputs inside expressions muParser cannot parse, e.g. "texture(img, st).r"
+    for (const auto& sampler_name : BuiltinVariables::getInstance().findTextureInputs(arguments)) {
+        needed_uniforms.insert(sampler_name);
+    }
+    
     // Generate uniform declarations
     for (const auto& uniform_name : needed_uniforms) {
+        const BuiltinVariable* builtin_info = BuiltinVariables::getInstance().getBuiltinInfo(uniform_name);
         if (uniform_name == "time") {
             uniforms << "uniform float time;\n";
         } else if (uniform_name == "resolution") {
             uniforms << "uniform vec2 resolution;\n";
+        } else if (uniform_name == "tileOffset") {
+            uniforms << "uniform vec2 tileOffset;\n";
+        } else if (builtin_info && builtin_info->glsl_type == "sampler2D") {
+            uniforms << "uniform sampler2D " << uniform_name << ";\n";
         } else {
             uniforms << "uniform float " << uniform_name << ";\n";
         }
@@ -301,12 +311,15 @@ std::vector<std::string> ShaderCodeGenerator::convertArgumentsForCall(const std:
 std::string ShaderCodeGenerator::generateWrapperFunction(
     const std::string& function_name,
     const std::vector<std::string>& user_arguments,
-    const FunctionOverload* target_overload) {
+    const FunctionOverload* target_overload,
+    const std::string& wrapper_name) {
     
     if (!target_overload) {
         return "";
     }
     
+    std::string name = wrapper_name.empty() ? function_name + "_wrapper" : wrapper_name;
+    
     // Find best overload that can accommodate all user arguments
     const FunctionOverload* best_overload = findBestOverloadForArguments(function_name, user_arguments);
     
@@ -315,7 +328,7 @@ std::string ShaderCodeGenerator::generateWrapperFunction(
         std::stringstream wrapper;
         
         // Generate wrapper function signature
-        wrapper << best_overload->returnType << " " << function_name << "_wrapper(";
+        wrapper << best_overload->returnType << " " << name << "(";
         for (size_t i = 0; i < user_arguments.size(); i++) {
             if (i > 0) wrapper << ", ";
             
@@ -349,7 +362,7 @@ std::string ShaderCodeGenerator::generateWrapperFunction(
         std::string target_type = target_overload->paramTypes[0];
         
         // Generate wrapper function signature
-        wrapper << target_overload->returnType << " " << function_name << "_wrapper(";
+        wrapper << target_overload->returnType << " " << name << "(";
         for (size_t i = 0; i < user_arguments.size(); i++) {
             if (i > 0) wrapper << ", ";
             
@@ -369,9 +382,46 @@ std::string ShaderCodeGenerator::generateWrapperFunction(
     return "";
 }
 
+//--------------------------------------------------------------
+std::string ShaderCodeGenerator::getWrapperSignature(
+    const std::string& function_name,
+    const std::vector<std::string>& user_arguments,
+    const FunctionOverload* target_overload) {
+    
+    if (!target_overload) {
+        return "";
+    }
+    
+    // Same overload choice as generateWrapperFunction; the body only depends on it and the argument types
+    const FunctionOverload* best_overload = findBestOverloadForArguments(function_name, user_arguments);
+    const FunctionOverload* overload = best_overload ? best_overload : target_overload;
+    
+    std::stringstream signature;
+    signature << function_name << "(";
+    for (size_t i = 0; i < overload->paramTypes.size(); i++) {
+        if (i > 0) signature << ",";
+        signature << overload->paramTypes[i];
+    }
+    signature << ")";
+    for (const auto& argument : user_arguments) {
+        signature << " " << parseArgument(argument).type;
+    }
+    return signature.str();
+}
+
 //--------------------------------------------------------------
 ExpressionInfo ShaderCodeGenerator::parseArgument(const std::string& argument) {
-    return expression_parser->parseExpression(argument);
+    ExpressionInfo info = expression_parser->parseExpression(argument);
+    auto type_it = variable_types.find(argument);
+    if (info.is_simple_var && type_it != variable_types.end()) {
+        info.type = type_it->second;
+    }
+    return info;
+}
+
+//--------------------------------------------------------------
+void ShaderCodeGenerator::setVariableTypes(const std::map<std::string, std::string>& types) {
+    variable_types = types;
 }
 
 //--------------------------------------------------------------
@@ -5,6 +5,7 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <map>
 
 /**
  * @class ShaderCodeGenerator
@@ -22,6 +23,9 @@ private:
     std::string default_vertex_shader; ///< Default vertex shader template
     std::string default_fragment_shader_template; ///< Fragment shader template with placeholders
     
+    // --- Type Overrides ---
+    std::map<std::string, std::string> variable_types; ///< GLSL types of known non-builtin variables
+    
 public:
     /**
      * @brief Constructs the ShaderCodeGenerator
@@ -78,9 +82,26 @@ public:
      * @param function_name Name of the function
      * @param user_arguments User-provided arguments
      * @param target_overload Target function overload to match
-     * @return GLSL wrapper function code
+     * @param wrapper_name Name of the wrapper, empty for "<function_name>_wrapper"
+     * @return GLSL wrapper function code, empty if the arguments need no wrapper
      */
     std::string generateWrapperFunction(
+        const std::string& function_name,
+        const std::vector<std::string>& user_arguments,
+        const FunctionOverload* target_overload,
+        const std::string& wrapper_name = ""
+    );
+    
+    /**
+     * @brief Gets the key identifying the wrapper generateWrapperFunction would emit
+     * @details Wrappers with the same key have the same code apart from their name,
+     *          so one definition can serve every call with that key.
+     * @param function_name Name of the function
+     * @param user_arguments User-provided arguments
+     * @param target_overload Target function overload to match
+     * @return "<function>(<overload parameter types>)<argument types>"
+     */
+    std::string getWrapperSignature(
         const std::string& function_name,
         const std::vector<std::string>& user_arguments,
         const FunctionOverload* target_overload
@@ -105,6 +126,14 @@ public:
      */
     ExpressionInfo parseArgument(const std::string& argument);
     
+    /**
+     * @brief Declares the GLSL types of variables that are not builtins
+     * @details Unknown variables are otherwise assumed to be floats, e.g. when typing wrapper
+     *          parameters. Used for the members of a graph's parameter block.
+     * @param types Variable name to GLSL type
+     */
+    void setVariableTypes(const std::map<std::string, std::string>& types);
+    
     // --- Template Management ---
     /**
      * @brief Initializes default shader templates
@@ -2,7 +2,9 @@
 #include "ShaderManager.h"
 #include "BuiltinVariables.h"
 #include "ExpressionParser.h"
+#include "ProgramBinaryCache.h"
 #include "ofLog.h"
+#include "../statsSystem/AllocationTracker.h"
 #include <algorithm>
 #include <sstream>
 #include <regex>
@@ -10,7 +12,8 @@
 //--------------------------------------------------------------
 ShaderCompositionEngine::ShaderCompositionEngine(PluginManager* pm)
     : plugin_manager(pm)
-    , debug_mode(true) {
+    , debug_mode(true)
+    , revision(0) {
     
     if (!plugin_manager) {
         ofLogError("ShaderCompositionEngine") << "PluginManager pointer is null";
@@ -28,6 +31,7 @@ ShaderCompositionEngine::~ShaderCompositionEngine() {
 //--------------------------------------------------------------
 std::string ShaderCompositionEngine::registerNode(const std::string& function_name, 
                                                   const std::vector<std::string>& arguments) {
+    AllocationScope allocation_scope(AllocationTag::COMPOSITION);
     if (debug_mode) {
         ofLogNotice("ShaderCompositionEngine") << "Registering node: " << function_name 
                                                << " with " << arguments.size() << " arguments";
@@ -37,27 +41,24 @@ std::string ShaderCompositionEngine::registerNode(const std::string& function_na
     }
     
     // Validate that the function exists in the plugin system or is a GLSL builtin
-    const GLSLFunction* function_metadata = plugin_manager->findFunction(function_name);
-    if (!function_metadata) {
-        // Check if it's a GLSL builtin function using FunctionDependencyAnalyzer
-        FunctionDependencyAnalyzer analyzer(plugin_manager);
-        
-        ClassifiedFunction classification = analyzer.classifyFunction(function_name);
-        if (classification.classification != FunctionClassification::GLSL_BUILTIN) {
-            ofLogError("ShaderCompositionEngine") << "Function '" << function_name << "' not found in plugins or GLSL builtins";
-            return "";
-        }
-        
-        if (debug_mode) {
-            ofLogNotice("ShaderCompositionEngine") << "Function '" << function_name << "' recognized as GLSL builtin";
-        }
+    if (!isFunctionAvailable(function_name)) {
+        ofLogError("ShaderCompositionEngine") << "Function '" << function_name << "' not found in plugins or GLSL builtins";
+        return "";
+    }
+    
+    // Function names are a closed vocabulary; a full symbol table fails the command
+    Symbol function_symbol(function_name);
+    if (function_symbol.empty()) {
+        ofLogError("ShaderCompositionEngine") << "Cannot intern function name: " << function_name;
+        return "";
     }
     
     // Generate unique node ID
-    std::string node_id = generateUniqueNodeId();
+    ShaderHandle node_id = generateUniqueNodeId();
     
     // Create composition node
-    auto node = std::make_unique<CompositionNode>(function_name, arguments, node_id);
+    auto node = std::make_unique<CompositionNode>(function_symbol, arguments, node_id);
+    node->revision = ++revision;
     
     // Store the node
     pending_nodes[node_id] = std::move(node);
@@ -66,37 +67,112 @@ std::string ShaderCompositionEngine::registerNode(const std::string& function_na
         ofLogNotice("ShaderCompositionEngine") << "Registered node with ID: " << node_id;
     }
     
-    return node_id;
+    return node_id.toString();
+}
+
+//--------------------------------------------------------------
+bool ShaderCompositionEngine::restoreNode(const std::string& node_id, const std::string& function_name,
+                                          const std::vector<std::string>& arguments, size_t slot_limit) {
+    AllocationScope allocation_scope(AllocationTag::COMPOSITION);
+    if (!isFunctionAvailable(function_name)) {
+        ofLogError("ShaderCompositionEngine") << "Function '" << function_name << "' not found in plugins or GLSL builtins";
+        return false;
+    }
+    
+    Symbol function_symbol(function_name);
+    if (function_symbol.empty()) {
+        ofLogError("ShaderCompositionEngine") << "Cannot intern function name: " << function_name;
+        return false;
+    }
+    
+    ShaderHandle handle = ShaderHandle::parse(node_id);
+    if (!ShaderRegistry::getInstance().reserve(handle, ShaderEntryKind::GRAPH_NODE, slot_limit)) {
+        ofLogError("ShaderCompositionEngine") << "Cannot restore node " << node_id << ", its ID is taken or out of bounds";
+        return false;
+    }
+    
+    auto node = std::make_unique<CompositionNode>(function_symbol, arguments, handle);
+    node->revision = ++revision;
+    pending_nodes[handle] = std::move(node);
+    return true;
+}
+
+//--------------------------------------------------------------
+bool ShaderCompositionEngine::updateNode(const std::string& node_id, const std::string& function_name,
+                                         const std::vector<std::string>& arguments) {
+    CompositionNode* found = findNode(ShaderHandle::parse(node_id));
+    if (!found) {
+        ofLogError("ShaderCompositionEngine") << "Node not found: " << node_id;
+        return false;
+    }
+    if (!isFunctionAvailable(function_name)) {
+        ofLogError("ShaderCompositionEngine") << "Function '" << function_name << "' not found in plugins or GLSL builtins";
+        return false;
+    }
+    
+    Symbol function_symbol(function_name);
+    if (function_symbol.empty()) {
+        ofLogError("ShaderCompositionEngine") << "Cannot intern function name: " << function_name;
+        return false;
+    }
+    
+    CompositionNode& node = *found;
+    evictCompiledGraphs(node.node_id);
+    if (node.function_name != function_symbol) {
+        node.compute_scale = 0.0f;
+    }
+    node.function_name = function_symbol;
+    node.arguments = arguments;
+    node.input_nodes.clear();
+    node.resolved_arguments.clear();
+    node.revision = ++revision;
+    
+    if (debug_mode) {
+        ofLogNotice("ShaderCompositionEngine") << "Updated node " << node_id << ": " << function_name;
+    }
+    return true;
+}
+
+//--------------------------------------------------------------
+bool ShaderCompositionEngine::isFunctionAvailable(const std::string& function_name) const {
+    if (plugin_manager->findFunction(function_name)) {
+        return true;
+    }
+    // Check if it's a GLSL builtin function using FunctionDependencyAnalyzer
+    FunctionDependencyAnalyzer analyzer(plugin_manager);
+    return analyzer.classifyFunction(function_name).classification == FunctionClassification::GLSL_BUILTIN;
 }
 
 //--------------------------------------------------------------
 bool ShaderCompositionEngine::hasNode(const std::string& node_id) const {
-    return pending_nodes.find(node_id) != pending_nodes.end();
+    return findNode(ShaderHandle::parse(node_id)) != nullptr;
 }
 
 //--------------------------------------------------------------
 const CompositionNode* ShaderCompositionEngine::getNode(const std::string& node_id) const {
-    auto it = pending_nodes.find(node_id);
-    if (it != pending_nodes.end()) {
-        return it->second.get();
-    }
-    return nullptr;
+    return findNode(ShaderHandle::parse(node_id));
 }
 
 //--------------------------------------------------------------
 std::shared_ptr<ShaderNode> ShaderCompositionEngine::compileGraph(const std::string& output_node_id) {
+    AllocationScope allocation_scope(AllocationTag::COMPOSITION);
     if (debug_mode) {
         ofLogNotice("ShaderCompositionEngine") << "Compiling graph for output node: " << output_node_id;
     }
     
     // Check if the output node exists
-    if (!hasNode(output_node_id)) {
+    ShaderHandle output_handle = ShaderHandle::parse(output_node_id);
+    if (!findNode(output_handle)) {
         ofLogError("ShaderCompositionEngine") << "Output node not found: " << output_node_id;
         return nullptr;
     }
     
     // Analyze dependencies to get the compilation order
-    std::vector<std::string> dependency_chain = analyzeDependencies(output_node_id);
+    std::vector<ShaderHandle> dependency_chain;
+    if (!topologicalSort(output_handle, dependency_chain)) {
+        ofLogError("ShaderCompositionEngine") << "Topological sort failed - missing reference or circular dependency";
+        dependency_chain.clear();
+    }
     if (dependency_chain.empty()) {
         ofLogError("ShaderCompositionEngine") << "Failed to analyze dependencies for node: " << output_node_id;
         return nullptr;
@@ -120,7 +196,8 @@ std::shared_ptr<ShaderNode> ShaderCompositionEngine::compileGraph(const std::str
     }
     
     // Generate unified shader code
-    std::string unified_code = generateUnifiedShaderCode(dependency_chain);
+    std::vector<GlslSourceRegion> regions;
+    std::string unified_code = generateUnifiedShaderCode(dependency_chain, &regions);
     if (unified_code.empty()) {
         ofLogError("ShaderCompositionEngine") << "Failed to generate unified shader code";
         return nullptr;
@@ -143,14 +220,24 @@ std::shared_ptr<ShaderNode> ShaderCompositionEngine::compileGraph(const std::str
     // In a full implementation, we'd need to integrate this with ShaderCodeGenerator
     compiled_shader->setCustomShaderCode(unified_code);
     
+    // Reject invalid code before a program object exists; a cached binary already linked once
+    GlslValidator validator;
+    ProgramBinaryCache& binary_cache = ProgramBinaryCache::getInstance();
+    bool has_binary = binary_cache.isEnabled() && binary_cache.contains(compiled_shader->getProgramCacheKey());
+    if (!has_binary && !validator.validate(unified_code, GL_FRAGMENT_SHADER, "", regions)) {
+        ofLogError("ShaderCompositionEngine") << "Generated shader for " << output_node_id
+                                              << " failed validation:\n" << validator.getErrorSummary();
+        return nullptr;
+    }
+    
     // Configure automatic uniforms based on arguments used in the dependency chain
     // This replicates the logic from ShaderManager::createShader()
     std::vector<std::string> all_arguments;
-    for (const auto& node_id : dependency_chain) {
-        auto node_it = pending_nodes.find(node_id);
-        if (node_it != pending_nodes.end()) {
-            const auto& node = node_it->second;
-            all_arguments.insert(all_arguments.end(), node->arguments.begin(), node->arguments.end());
+    for (ShaderHandle node_id : dependency_chain) {
+        const CompositionNode* node = findNode(node_id);
+        if (node) {
+            std::vector<std::string> arguments = resolvePortArguments(*node);
+            all_arguments.insert(all_arguments.end(), arguments.begin(), arguments.end());
         }
     }
     
@@ -210,9 +297,50 @@ std::shared_ptr<ShaderNode> ShaderCompositionEngine::compileGraph(const std::str
         compiled_shader->setAutoUpdateResolution(true);
     }
     
+    // Texture sources sampled by the nodes the fragment pass evaluates itself
+    std::vector<ShaderHandle> sampled_nodes;
+    for (ShaderHandle node_id : collectFragmentNodes(dependency_chain)) {
+        const CompositionNode* node = findNode(node_id);
+        if (node && node->compute_scale <= 0.0f) {
+            sampled_nodes.push_back(node_id);
+        }
+    }
+    for (const auto& sampler_name : collectTextureInputs(sampled_nodes)) {
+        compiled_shader->addTextureInput(sampler_name);
+    }
+    
+    // Parameter ports of the same nodes, in the layout generateUnifiedShaderCode declared
+    std::shared_ptr<ParameterBlock> parameter_block = buildParameterBlock(sampled_nodes);
+    if (!parameter_block->isEmpty()) {
+        compiled_shader->parameter_block = parameter_block;
+    }
+    
+    // Evaluate nodes with a compute variant into textures sampled by the fragment pass
+    for (ShaderHandle node_id : collectFragmentNodes(dependency_chain)) {
+        const CompositionNode* node = findNode(node_id);
+        if (!node || node->compute_scale <= 0.0f) {
+            continue;
+        }
+        
+        std::vector<GlslSourceRegion> compute_regions;
+        std::string compute_code = generateComputeShaderCode(node_id, &compute_regions);
+        if (!compute_code.empty() &&
+            !validator.validate(compute_code, GL_COMPUTE_SHADER, compiled_shader->metadata->source_directory_path, compute_regions)) {
+            ofLogError("ShaderCompositionEngine") << "Compute variant of node " << node_id
+                                                  << " failed validation:\n" << validator.getErrorSummary();
+            return nullptr;
+        }
+        auto field = std::make_shared<ComputeField>(node_id.toString() + "_field", node->compute_scale, node->compute_workgroup_size);
+        if (compute_code.empty() || !field->setup(compute_code, compiled_shader->metadata->source_directory_path)) {
+            ofLogError("ShaderCompositionEngine") << "Failed to compile compute variant of node: " << node_id;
+            return nullptr;
+        }
+        compiled_shader->addComputeField(field);
+    }
+    
     if (compiled_shader->compile()) {
         // Cache the successful compilation
-        cacheCompiledGraph(graph_key, compiled_shader);
+        cacheCompiledGraph(graph_key, compiled_shader, dependency_chain);
         
         if (debug_mode) {
             ofLogNotice("ShaderCompositionEngine") << "Successfully compiled unified graph";
@@ -227,23 +355,21 @@ std::shared_ptr<ShaderNode> ShaderCompositionEngine::compileGraph(const std::str
 
 //--------------------------------------------------------------
 std::vector<std::string> ShaderCompositionEngine::analyzeDependencies(const std::string& output_node_id) {
-    std::vector<std::string> sorted_nodes;
-    
-    // First resolve dependencies for all nodes
-    for (auto& [node_id, node] : pending_nodes) {
-        if (!resolveDependencies(node.get())) {
-            ofLogError("ShaderCompositionEngine") << "Failed to resolve dependencies for node: " << node_id;
-            return {};
-        }
-    }
+    std::vector<ShaderHandle> sorted_nodes;
     
-    // Perform topological sort
-    if (!topologicalSort(output_node_id, sorted_nodes)) {
-        ofLogError("ShaderCompositionEngine") << "Topological sort failed - circular dependency detected";
+    // Dependencies are resolved during the sort, so only nodes upstream of the output are
+    // visited and the cost does not grow with unrelated parts of the graph.
+    if (!topologicalSort(ShaderHandle::parse(output_node_id), sorted_nodes)) {
+        ofLogError("ShaderCompositionEngine") << "Topological sort failed - missing reference or circular dependency";
         return {};
     }
     
-    return sorted_nodes;
+    std::vector<std::string> node_ids;
+    node_ids.reserve(sorted_nodes.size());
+    for (ShaderHandle node_id : sorted_nodes) {
+        node_ids.push_back(node_id.toString());
+    }
+    return node_ids;
 }
 
 //--------------------------------------------------------------
@@ -257,8 +383,10 @@ std::shared_ptr<ShaderNode> ShaderCompositionEngine::getCachedCompiledGraph(cons
 
 //--------------------------------------------------------------
 void ShaderCompositionEngine::cacheCompiledGraph(const std::string& graph_key, 
-                                                 std::shared_ptr<ShaderNode> compiled_shader) {
+                                                 std::shared_ptr<ShaderNode> compiled_shader,
+                                                 const std::vector<ShaderHandle>& dependency_chain) {
     compiled_cache[graph_key] = compiled_shader;
+    cached_chains[graph_key] = dependency_chain;
     
     if (debug_mode) {
         ofLogNotice("ShaderCompositionEngine") << "Cached compiled graph: " << graph_key;
@@ -266,32 +394,132 @@ void ShaderCompositionEngine::cacheCompiledGraph(const std::string& graph_key,
 }
 
 //--------------------------------------------------------------
-std::string ShaderCompositionEngine::generateGraphKey(const std::vector<std::string>& dependency_chain) {
+std::string ShaderCompositionEngine::generateGraphKey(const std::vector<ShaderHandle>& dependency_chain) {
     std::stringstream ss;
     ss << "graph_";
     
     for (size_t i = 0; i < dependency_chain.size(); i++) {
         if (i > 0) ss << "_";
         
-        const CompositionNode* node = getNode(dependency_chain[i]);
+        const CompositionNode* node = findNode(dependency_chain[i]);
         if (node) {
-            ss << node->function_name << "(";
+            ss << node->function_name.getId() << "(";
+            // Length-prefixed, since arguments like vec2(1,2) contain commas themselves
             for (size_t j = 0; j < node->arguments.size(); j++) {
                 if (j > 0) ss << ",";
-                ss << node->arguments[j];
+                ss << node->arguments[j].size() << ":" << node->arguments[j];
             }
             ss << ")";
+            if (node->compute_scale > 0.0f) {
+                ss << "@compute" << node->compute_scale << "x" << node->compute_workgroup_size;
+            }
+            // Block members are named after the node, so graphs with ports are never shared
+            if (!collectParameterPorts(*node).empty()) {
+                ss << "#" << node->node_id.pack();
+            }
         }
     }
     
     return ss.str();
 }
 
+//--------------------------------------------------------------
+bool ShaderCompositionEngine::setComputeVariant(const std::string& node_id, float scale, int workgroup_size) {
+    CompositionNode* node = findNode(ShaderHandle::parse(node_id));
+    if (!node) {
+        ofLogError("ShaderCompositionEngine") << "Node not found: " << node_id;
+        return false;
+    }
+    if (scale < 0.0f || scale > 1.0f) {
+        ofLogError("ShaderCompositionEngine") << "Compute scale must be in [0, 1]: " << scale;
+        return false;
+    }
+    
+    // 8x8 = 64 invocations fills a wave64 or two warps and keeps the 2D footprint of a group compact
+    if (workgroup_size <= 0) {
+        workgroup_size = 8;
+    }
+    GLint max_invocations = 0;
+    glGetIntegerv(GL_MAX_COMPUTE_WORK_GROUP_INVOCATIONS, &max_invocations);
+    while (max_invocations > 0 && workgroup_size > 1 && workgroup_size * workgroup_size > max_invocations) {
+        workgroup_size /= 2;
+    }
+    
+    if (node->compute_scale != scale || node->compute_workgroup_size != workgroup_size) {
+        evictCompiledGraphs(node->node_id);
+    }
+    node->compute_scale = scale;
+    node->compute_workgroup_size = workgroup_size;
+    node->revision = ++revision;
+    
+    if (debug_mode && scale > 0.0f) {
+        ofLogNotice("ShaderCompositionEngine") << "Node " << node_id << " uses a compute variant at scale " << scale
+                                               << " with " << workgroup_size << "x" << workgroup_size << " workgroups";
+    } else if (debug_mode) {
+        ofLogNotice("ShaderCompositionEngine") << "Node " << node_id << " is evaluated in the fragment pass";
+    }
+    return true;
+}
+
+//--------------------------------------------------------------
+bool ShaderCompositionEngine::setParameter(const std::string& node_id, const std::string& port_name,
+                                           const std::vector<float>& values) {
+    CompositionNode* node = findNode(ShaderHandle::parse(node_id));
+    if (!node) {
+        ofLogError("ShaderCompositionEngine") << "Node not found: " << node_id;
+        return false;
+    }
+    
+    const ParameterPort* declared = nullptr;
+    std::vector<ParameterPort> ports = collectParameterPorts(*node);
+    for (const auto& port : ports) {
+        if (port.name == port_name) {
+            declared = &port;
+        }
+    }
+    if (!declared) {
+        ofLogError("ShaderCompositionEngine") << "Node " << node_id << " has no parameter port: " << port_name;
+        return false;
+    }
+    if (values.size() != 1 && values.size() != declared->default_value.size()) {
+        ofLogError("ShaderCompositionEngine") << "Port " << port_name << " of node " << node_id << " is a "
+                                              << declared->glsl_type << ", got " << values.size() << " values";
+        return false;
+    }
+    
+    // Only declared ports get here, so port names stay a closed vocabulary
+    Symbol port_symbol(port_name);
+    if (port_symbol.empty()) {
+        ofLogError("ShaderCompositionEngine") << "Cannot intern port name: " << port_name;
+        return false;
+    }
+    node->parameter_values[port_symbol] = values;
+    node->revision = ++revision;
+    for (const auto& [graph_key, compiled_shader] : compiled_cache) {
+        if (compiled_shader && compiled_shader->parameter_block) {
+            compiled_shader->parameter_block->setValue(node_id, port_name, values);
+        }
+    }
+    return true;
+}
+
+//--------------------------------------------------------------
+std::vector<ParameterPort> ShaderCompositionEngine::getParameterPorts(const std::string& node_id) const {
+    const CompositionNode* node = getNode(node_id);
+    if (!node) {
+        return {};
+    }
+    return collectParameterPorts(*node);
+}
+
 //--------------------------------------------------------------
 bool ShaderCompositionEngine::removeNode(const std::string& node_id) {
-    auto it = pending_nodes.find(node_id);
+    auto it = pending_nodes.find(ShaderHandle::parse(node_id));
     if (it != pending_nodes.end()) {
+        evictCompiledGraphs(it->first);
+        ShaderRegistry::getInstance().remove(it->first);
         pending_nodes.erase(it);
+        revision++;
         
         if (debug_mode) {
             ofLogNotice("ShaderCompositionEngine") << "Removed node: " << node_id;
@@ -301,11 +529,41 @@ bool ShaderCompositionEngine::removeNode(const std::string& node_id) {
     return false;
 }
 
+//--------------------------------------------------------------
+bool ShaderCompositionEngine::releaseCompiledGraph(const std::string& output_node_id) {
+    std::vector<ShaderHandle> dependency_chain;
+    if (!hasNode(output_node_id) || !topologicalSort(ShaderHandle::parse(output_node_id), dependency_chain)) {
+        return false;
+    }
+    std::string graph_key = generateGraphKey(dependency_chain);
+    cached_chains.erase(graph_key);
+    return compiled_cache.erase(graph_key) > 0;
+}
+
+//--------------------------------------------------------------
+void ShaderCompositionEngine::evictCompiledGraphs(ShaderHandle node_id) {
+    for (auto it = cached_chains.begin(); it != cached_chains.end();) {
+        if (std::find(it->second.begin(), it->second.end(), node_id) == it->second.end()) {
+            ++it;
+            continue;
+        }
+        compiled_cache.erase(it->first);
+        if (debug_mode) {
+            ofLogNotice("ShaderCompositionEngine") << "Evicted compiled graph: " << it->first;
+        }
+        it = cached_chains.erase(it);
+    }
+}
+
 //--------------------------------------------------------------
 void ShaderCompositionEngine::clearAll() {
+    for (const auto& [node_id, node] : pending_nodes) {
+        ShaderRegistry::getInstance().remove(node_id);
+    }
     pending_nodes.clear();
     compiled_cache.clear();
-    next_node_id = 1;
+    cached_chains.clear();
+    revision++;
     
     if (debug_mode) {
         ofLogNotice("ShaderCompositionEngine") << "Cleared all nodes and cache";
@@ -317,6 +575,21 @@ size_t ShaderCompositionEngine::getNodeCount() const {
     return pending_nodes.size();
 }
 
+//--------------------------------------------------------------
+std::vector<const CompositionNode*> ShaderCompositionEngine::getNodes() const {
+    std::vector<const CompositionNode*> nodes;
+    nodes.reserve(pending_nodes.size());
+    for (const auto& [node_id, node] : pending_nodes) {
+        nodes.push_back(node.get());
+    }
+    return nodes;
+}
+
+//--------------------------------------------------------------
+uint64_t ShaderCompositionEngine::getRevision() const {
+    return revision;
+}
+
 //--------------------------------------------------------------
 void ShaderCompositionEngine::printGraphInfo() const {
     ofLogNotice("ShaderCompositionEngine") << "=== Graph Information ===";
@@ -342,8 +615,32 @@ void ShaderCompositionEngine::setDebugMode(bool debug) {
 // ================================================================================
 
 //--------------------------------------------------------------
-std::string ShaderCompositionEngine::generateUniqueNodeId() {
-    return "shader_" + std::to_string(next_node_id++);
+ShaderHandle ShaderCompositionEngine::generateUniqueNodeId() {
+    return ShaderRegistry::getInstance().add(ShaderEntryKind::GRAPH_NODE);
+}
+
+//--------------------------------------------------------------
+CompositionNode* ShaderCompositionEngine::findNode(ShaderHandle node_id) const {
+    auto it = pending_nodes.find(node_id);
+    return it != pending_nodes.end() ? it->second.get() : nullptr;
+}
+
+//--------------------------------------------------------------
+std::vector<ParameterPort> ShaderCompositionEngine::collectParameterPorts(const CompositionNode& node) const {
+    std::vector<ParameterPort> ports;
+    for (const std::string& argument : node.arguments) {
+        ParameterPort port;
+        if (!ParameterBlock::isPortArgument(argument)) {
+            continue;
+        }
+        if (!ParameterBlock::parsePort(argument, port)) {
+            ofLogWarning("ShaderCompositionEngine") << "Invalid parameter port '" << argument << "' on node " << node.node_id;
+            continue;
+        }
+        port.node_id = node.node_id.toString();
+        ports.push_back(port);
+    }
+    return ports;
 }
 
 //--------------------------------------------------------------
@@ -363,7 +660,7 @@ bool ShaderCompositionEngine::resolveDependencies(CompositionNode* node) {
         
         // Look for shader_XXX patterns (with or without $)
         // Check if the entire argument is a shader reference or contains one
-        std::regex shader_ref_regex(R"((?:^|\$)(shader_\w+))");
+        static const std::regex shader_ref_regex(R"((?:^|\$)(shader_\w+))");
         std::smatch match;
         
         if (std::regex_search(arg, match, shader_ref_regex)) {
@@ -374,9 +671,9 @@ bool ShaderCompositionEngine::resolveDependencies(CompositionNode* node) {
             }
             
             // Find the referenced node
-            auto it = pending_nodes.find(referenced_id);
-            if (it != pending_nodes.end()) {
-                node->input_nodes.push_back(it->second.get());
+            CompositionNode* referenced = findNode(ShaderHandle::parse(referenced_id));
+            if (referenced) {
+                node->input_nodes.push_back(referenced);
                 node->is_external_dependency = true;
                 
                 if (debug_mode) {
@@ -394,34 +691,33 @@ bool ShaderCompositionEngine::resolveDependencies(CompositionNode* node) {
 }
 
 //--------------------------------------------------------------
-bool ShaderCompositionEngine::topologicalSort(const std::string& output_node_id, 
-                                              std::vector<std::string>& sorted_nodes) {
-    std::unordered_map<std::string, bool> visited;
-    std::unordered_map<std::string, bool> rec_stack;
-    
-    // Initialize visited map
-    for (const auto& [node_id, node] : pending_nodes) {
-        visited[node_id] = false;
-        rec_stack[node_id] = false;
-    }
+bool ShaderCompositionEngine::topologicalSort(ShaderHandle output_node_id, 
+                                              std::vector<ShaderHandle>& sorted_nodes) {
+    // Unvisited nodes read as false
+    std::unordered_map<ShaderHandle, bool> visited;
+    std::unordered_map<ShaderHandle, bool> rec_stack;
     
     return topologicalSortDFS(output_node_id, visited, rec_stack, sorted_nodes);
 }
 
 //--------------------------------------------------------------
-bool ShaderCompositionEngine::topologicalSortDFS(const std::string& node_id,
-                                                 std::unordered_map<std::string, bool>& visited,
-                                                 std::unordered_map<std::string, bool>& rec_stack,
-                                                 std::vector<std::string>& sorted_nodes) {
+bool ShaderCompositionEngine::topologicalSortDFS(ShaderHandle node_id,
+                                                 std::unordered_map<ShaderHandle, bool>& visited,
+                                                 std::unordered_map<ShaderHandle, bool>& rec_stack,
+                                                 std::vector<ShaderHandle>& sorted_nodes) {
     
     visited[node_id] = true;
     rec_stack[node_id] = true;
     
-    const CompositionNode* current_node = getNode(node_id);
+    CompositionNode* current_node = findNode(node_id);
     if (!current_node) {
         ofLogError("ShaderCompositionEngine") << "Node not found during DFS: " << node_id;
         return false;
     }
+    if (!resolveDependencies(current_node)) {
+        ofLogError("ShaderCompositionEngine") << "Failed to resolve dependencies for node: " << node_id;
+        return false;
+    }
     
     // Visit all dependencies first
     for (const CompositionNode* dep_node : current_node->input_nodes) {
@@ -443,7 +739,9 @@ bool ShaderCompositionEngine::topologicalSortDFS(const std::string& node_id,
 }
 
 //--------------------------------------------------------------
-std::string ShaderCompositionEngine::generateUnifiedShaderCode(const std::vector<std::string>& dependency_chain) {
+std::string ShaderCompositionEngine::generateUnifiedShaderCode(const std::vector<ShaderHandle>& dependency_chain,
+                                                               std::vector<GlslSourceRegion>* regions) {
+    AllocationScope allocation_scope(AllocationTag::CODEGEN);
     // This is a simplified implementation
     // In a full implementation, this would integrate with ShaderCodeGenerator
     // to produce properly optimized, unified GLSL code
@@ -455,46 +753,259 @@ std::string ShaderCompositionEngine::generateUnifiedShaderCode(const std::vector
     unified_code << "uniform vec2 resolution;\n";
     unified_code << "uniform float time;\n";
     unified_code << "uniform vec2 st;\n";
+    unified_code << "uniform vec2 tileOffset;\n";
     unified_code << "out vec4 fragColor;\n";
+    
+    // Nodes evaluated by compute shaders are sampled, everything only they use is dropped
+    std::vector<ShaderHandle> fragment_nodes = collectFragmentNodes(dependency_chain);
+    std::vector<ShaderHandle> called_nodes;
+    for (ShaderHandle node_id : fragment_nodes) {
+        const CompositionNode* node = findNode(node_id);
+        if (node && node->compute_scale > 0.0f) {
+            unified_code << "uniform sampler2D " << node_id << "_field;\n";
+        } else {
+            called_nodes.push_back(node_id);
+        }
+    }
+    for (const std::string& sampler_name : collectTextureInputs(called_nodes)) {
+        unified_code << "uniform sampler2D " << sampler_name << ";\n";
+    }
+    unified_code << buildParameterBlock(called_nodes)->generateDeclaration();
     unified_code << "\n";
     
+    EmittedDefinitions definitions;
+    appendNodeDefinitions(unified_code, called_nodes, definitions, regions);
+    
+    // Generate main function that executes the dependency chain
+    if (!fragment_nodes.empty()) {
+        unified_code << "void main() {\n";
+        unified_code << "    vec2 st = (gl_FragCoord.xy + tileOffset) / resolution.xy;\n";
+        
+        appendNodeCalls(unified_code, fragment_nodes, true, definitions, regions);
+        
+        // Use the final result
+        std::string final_var = fragment_nodes.back().toString() + "_result";
+        unified_code << "    fragColor = vec4(vec3(" << final_var << "), 1.0);\n";
+        unified_code << "}\n";
+    }
+    
+    std::string result = unified_code.str();
+    
+    if (debug_mode) {
+        ofLogNotice("ShaderCompositionEngine") << "Generated unified shader:\n" << result;
+    }
+    
+    return result;
+}
+
+//--------------------------------------------------------------
+std::string ShaderCompositionEngine::generateComputeShaderCode(ShaderHandle node_id, std::vector<GlslSourceRegion>* regions) {
+    const CompositionNode* node = findNode(node_id);
+    std::vector<ShaderHandle> sub_chain;
+    if (!node || !topologicalSort(node_id, sub_chain)) {
+        ofLogError("ShaderCompositionEngine") << "Cannot generate compute shader for node: " << node_id;
+        return "";
+    }
+    if (!collectTextureInputs(sub_chain).empty()) {
+        // Compute fields have no texture units for sources
+        ofLogError("ShaderCompositionEngine") << "Compute variants cannot sample texture sources: " << node_id;
+        return "";
+    }
+    if (!buildParameterBlock(sub_chain)->isEmpty()) {
+        // The parameter block is only bound for the fragment pass
+        ofLogError("ShaderCompositionEngine") << "Compute variants cannot read parameter ports: " << node_id;
+        return "";
+    }
+    
+    std::stringstream compute_code;
+    compute_code << "#version 430\n";
+    compute_code << "layout(local_size_x = " << node->compute_workgroup_size
+                 << ", local_size_y = " << node->compute_workgroup_size << ") in;\n";
+    compute_code << "layout(r32f, binding = 0) uniform writeonly image2D field;\n";
+    compute_code << "uniform vec2 resolution;\n";
+    compute_code << "uniform float time;\n";
+    compute_code << "\n";
+    
+    // The node's whole upstream chain is evaluated inline at the field resolution
+    EmittedDefinitions definitions;
+    appendNodeDefinitions(compute_code, sub_chain, definitions, regions);
+    
+    compute_code << "void main() {\n";
+    compute_code << "    ivec2 texel = ivec2(gl_GlobalInvocationID.xy);\n";
+    compute_code << "    ivec2 size = imageSize(field);\n";
+    compute_code << "    if (texel.x >= size.x || texel.y >= size.y) return;\n";
+    compute_code << "    vec2 st = (vec2(texel) + 0.5) / vec2(size);\n";
+    
+    appendNodeCalls(compute_code, sub_chain, false, definitions, regions);
+    
+    compute_code << "    imageStore(field, texel, vec4(" << node_id << "_result));\n";
+    compute_code << "}\n";
+    
+    std::string result = compute_code.str();
+    
+    if (debug_mode) {
+        ofLogNotice("ShaderCompositionEngine") << "Generated compute shader for " << node_id << ":\n" << result;
+    }
+    
+    return result;
+}
+
+//--------------------------------------------------------------
+std::vector<ShaderHandle> ShaderCompositionEngine::collectFragmentNodes(const std::vector<ShaderHandle>& dependency_chain) const {
+    if (dependency_chain.empty()) {
+        return {};
+    }
+    
+    // Walk back from the output; the inputs of compute nodes are evaluated in their compute shader
+    std::unordered_map<ShaderHandle, bool> needed;
+    std::vector<const CompositionNode*> pending = {findNode(dependency_chain.back())};
+    while (!pending.empty()) {
+        const CompositionNode* node = pending.back();
+        pending.pop_back();
+        if (!node || needed[node->node_id]) {
+            continue;
+        }
+        needed[node->node_id] = true;
+        if (node->compute_scale <= 0.0f) {
+            pending.insert(pending.end(), node->input_nodes.begin(), node->input_nodes.end());
+        }
+    }
+    
+    std::vector<ShaderHandle> fragment_nodes;
+    for (ShaderHandle node_id : dependency_chain) {
+        if (needed[node_id]) {
+            fragment_nodes.push_back(node_id);
+        }
+    }
+    return fragment_nodes;
+}
+
+//--------------------------------------------------------------
+std::vector<std::string> ShaderCompositionEngine::collectTextureInputs(const std::vector<ShaderHandle>& nodes) const {
+    std::vector<std::string> arguments;
+    for (ShaderHandle node_id : nodes) {
+        const CompositionNode* node = findNode(node_id);
+        if (node) {
+            std::vector<std::string> resolved = resolvePortArguments(*node);
+            arguments.insert(arguments.end(), resolved.begin(), resolved.end());
+        }
+    }
+    return BuiltinVariables::getInstance().findTextureInputs(arguments);
+}
+
+//--------------------------------------------------------------
+std::vector<std::string> ShaderCompositionEngine::resolvePortArguments(const CompositionNode& node) const {
+    std::vector<std::string> arguments;
+    arguments.reserve(node.arguments.size());
+    for (const std::string& argument : node.arguments) {
+        ParameterPort port;
+        if (ParameterBlock::isPortArgument(argument) && ParameterBlock::parsePort(argument, port)) {
+            arguments.push_back(ParameterBlock::getMemberName(node.node_id.toString(), port.name));
+        } else {
+            arguments.push_back(argument);
+        }
+    }
+    return arguments;
+}
+
+//--------------------------------------------------------------
+std::shared_ptr<ParameterBlock> ShaderCompositionEngine::buildParameterBlock(const std::vector<ShaderHandle>& nodes) const {
+    auto block = std::make_shared<ParameterBlock>();
+    for (ShaderHandle node_id : nodes) {
+        const CompositionNode* node = findNode(node_id);
+        if (!node) {
+            continue;
+        }
+        for (const auto& port : collectParameterPorts(*node)) {
+            block->addPort(port);
+        }
+        for (const auto& [port_name, values] : node->parameter_values) {
+            block->setValue(node_id.toString(), port_name.str(), values);
+        }
+    }
+    return block;
+}
+
+//--------------------------------------------------------------
+void ShaderCompositionEngine::appendNodeDefinitions(std::stringstream& unified_code, const std::vector<ShaderHandle>& nodes,
+                                                    EmittedDefinitions& definitions,
+                                                    std::vector<GlslSourceRegion>* regions) {
+    FunctionDependencyAnalyzer analyzer(plugin_manager);
+    ShaderCodeGenerator wrapper_generator(plugin_manager);
+    
     // Add function definitions for each node in the chain
-    for (const std::string& node_id : dependency_chain) {
-        const CompositionNode* node = getNode(node_id);
+    for (ShaderHandle node_id : nodes) {
+        const CompositionNode* node = findNode(node_id);
         if (!node) continue;
         
+        GlslSourceRegion region;
+        region.begin = static_cast<size_t>(static_cast<std::streamoff>(unified_code.tellp()));
+        region.node_id = node_id.toString();
+        region.arguments = resolvePortArguments(*node);
+        
         unified_code << "// Node: " << node_id << " (" << node->function_name << ")\n";
         
         // Classify the function to determine if it's a builtin or plugin function
-        FunctionDependencyAnalyzer analyzer(plugin_manager);
-        ClassifiedFunction classification = analyzer.classifyFunction(node->function_name);
+        ClassifiedFunction classification = analyzer.classifyFunction(node->function_name.str());
         
         if (classification.classification == FunctionClassification::PLUGIN_FUNCTION) {
             // Include the GLSL file - let OpenFrameworks handle dependencies
-            const GLSLFunction* function_metadata = plugin_manager->findFunction(node->function_name);
+            const GLSLFunction* function_metadata = plugin_manager->findFunction(node->function_name.str());
             if (function_metadata) {
-                unified_code << "#include \"plugins/lygia/" << function_metadata->filePath << "\"\n";
-                
-                // Generate wrapper function using existing ShaderCodeGenerator system
-                ShaderCodeGenerator temp_generator(plugin_manager);
+                std::string include_name = "plugins/lygia/" + function_metadata->filePath;
+                if (definitions.includes.insert(include_name).second) {
+                    region.include_name = include_name;
+                    unified_code << "#include \"" << include_name << "\"\n";
+                }
                 
-                // Find best overload first
-                const GLSLFunction* func_metadata = plugin_manager->findFunction(node->function_name);
-                if (func_metadata && !func_metadata->overloads.empty()) {
+                if (!function_metadata->overloads.empty()) {
                     // Use the first overload for now - in practice we'd select the best one
-                    const FunctionOverload* target_overload = &func_metadata->overloads[0];
+                    const FunctionOverload* target_overload = &function_metadata->overloads[0];
                     
-                    std::string wrapper_code = temp_generator.generateWrapperFunction(
-                        node->function_name, 
-                        node->arguments, 
-                        target_overload
-                    );
+                    // Parameter ports are passed as block members of their declared type
+                    std::map<std::string, std::string> port_types;
+                    for (const auto& port : collectParameterPorts(*node)) {
+                        port_types[ParameterBlock::getMemberName(port.node_id, port.name)] = port.glsl_type;
+                    }
+                    wrapper_generator.setVariableTypes(port_types);
                     
-                    if (!wrapper_code.empty()) {
-                        unified_code << wrapper_code << "\n";
-                        unified_code << "// Node: " << node_id << " wrapper generated\n\n";
+                    // Nodes whose arguments have the same types call the same wrapper
+                    std::string signature = wrapper_generator.getWrapperSignature(
+                        node->function_name.str(), region.arguments, target_overload);
+                    auto wrapper_it = definitions.wrappers.find(signature);
+                    if (wrapper_it != definitions.wrappers.end()) {
+                        definitions.callees[node_id] = wrapper_it->second;
+                        unified_code << "// Node: " << node_id << " uses " << wrapper_it->second << "\n\n";
                     } else {
-                        unified_code << "// Node: " << node_id << " (" << node->function_name << ") - wrapper generation failed\n\n";
+                        // Later signatures of a function get numbered wrappers
+                        std::string wrapper_name = node->function_name.str() + "_wrapper";
+                        size_t function_wrappers = 0;
+                        for (const auto& entry : definitions.wrappers) {
+                            if (entry.second.compare(0, wrapper_name.size(), wrapper_name) == 0) {
+                                function_wrappers++;
+                            }
+                        }
+                        if (function_wrappers > 0) {
+                            wrapper_name += "_" + std::to_string(function_wrappers);
+                        }
+                        
+                        std::string wrapper_code = wrapper_generator.generateWrapperFunction(
+                            node->function_name.str(), 
+                            region.arguments, 
+                            target_overload,
+                            wrapper_name
+                        );
+                        
+                        if (!wrapper_code.empty()) {
+                            unified_code << wrapper_code << "\n";
+                            unified_code << "// Node: " << node_id << " wrapper generated\n\n";
+                        } else {
+                            // The arguments already match the overload, so the function is called directly
+                            wrapper_name = node->function_name.str();
+                            unified_code << "// Node: " << node_id << " calls " << wrapper_name << " directly\n\n";
+                        }
+                        definitions.wrappers[signature] = wrapper_name;
+                        definitions.callees[node_id] = wrapper_name;
                     }
                 } else {
                     unified_code << "// Node: " << node_id << " (" << node->function_name << ") - no function metadata\n\n";
@@ -509,86 +1020,90 @@ std::string ShaderCompositionEngine::generateUnifiedShaderCode(const std::vector
             // Unknown function
             unified_code << "// Unknown function: " << node->function_name << "\n\n";
         }
+        
+        if (regions) {
+            region.end = static_cast<size_t>(static_cast<std::streamoff>(unified_code.tellp()));
+            regions->push_back(region);
+        }
     }
-    
-    // Generate main function that executes the dependency chain
-    if (!dependency_chain.empty()) {
-        unified_code << "void main() {\n";
-        unified_code << "    vec2 st = gl_FragCoord.xy / resolution.xy;\n";
+}
+
+//--------------------------------------------------------------
+void ShaderCompositionEngine::appendNodeCalls(std::stringstream& unified_code, const std::vector<ShaderHandle>& nodes,
+                                              bool sample_compute_nodes, const EmittedDefinitions& definitions,
+                                              std::vector<GlslSourceRegion>* regions) {
+    FunctionDependencyAnalyzer analyzer(plugin_manager);
+    
+    // Execute each node in the dependency chain
+    for (ShaderHandle node_id : nodes) {
+        const CompositionNode* node_data = findNode(node_id);
         
-        // Execute each node in the dependency chain
-        for (size_t i = 0; i < dependency_chain.size(); i++) {
-            const std::string& node_id = dependency_chain[i];
-            const CompositionNode* node_data = getNode(node_id);
-            
-            if (!node_data) {
-                if (debug_mode) {
-                    ofLogError("ShaderCompositionEngine") << "Node not found in main generation: " << node_id;
-                }
-                continue;
-            }
-            
-            // Classify function
-            FunctionDependencyAnalyzer analyzer(plugin_manager);
-            ClassifiedFunction classification = analyzer.classifyFunction(node_data->function_name);
-            
+        if (!node_data) {
             if (debug_mode) {
-                ofLogNotice("ShaderCompositionEngine") << "Generating call for: " 
-                                                       << node_data->function_name 
-                                                       << " -> classification " << (int)classification.classification;
-            }
-            
-            // Generate variable name for this result
-            std::string var_name = node_id + "_result";
-            
-            // Generate argument list - replace $shader_XXX with actual variable names
-            std::string arg_list;
-            for (size_t j = 0; j < node_data->arguments.size(); j++) {
-                if (j > 0) arg_list += ", ";
-                
-                std::string arg = node_data->arguments[j];
-                // Replace $shader_XXX references with variable names
-                if (arg.substr(0, 8) == "$shader_") {
-                    std::string ref_id = arg.substr(1); // Remove $
-                    arg_list += ref_id + "_result";
-                } else {
-                    arg_list += arg;
-                }
+                ofLogError("ShaderCompositionEngine") << "Node not found in main generation: " << node_id;
             }
+            continue;
+        }
+        
+        // Generate variable name for this result
+        std::string var_name = node_id.toString() + "_result";
+        
+        // Nodes with a compute variant were evaluated into a texture beforehand
+        if (sample_compute_nodes && node_data->compute_scale > 0.0f) {
+            unified_code << "    float " << var_name << " = texture(" << node_id << "_field, st).r;\n";
+            continue;
+        }
+        
+        // Classify function
+        ClassifiedFunction classification = analyzer.classifyFunction(node_data->function_name.str());
+        
+        if (debug_mode) {
+            ofLogNotice("ShaderCompositionEngine") << "Generating call for: " 
+                                                   << node_data->function_name 
+                                                   << " -> classification " << (int)classification.classification;
+        }
+        
+        // Generate argument list - replace $shader_XXX with actual variable names
+        std::vector<std::string> arguments = resolvePortArguments(*node_data);
+        std::string arg_list;
+        for (size_t j = 0; j < arguments.size(); j++) {
+            if (j > 0) arg_list += ", ";
             
-            // Generate the function call
-            if (classification.classification == FunctionClassification::PLUGIN_FUNCTION) {
-                // Use wrapper function for plugin functions
-                unified_code << "    float " << var_name << " = " 
-                           << node_data->function_name << "_wrapper(" << arg_list << ");\n";
-            } else if (classification.classification == FunctionClassification::GLSL_BUILTIN) {
-                // Direct call for GLSL builtin functions
-                unified_code << "    float " << var_name << " = " 
-                           << node_data->function_name << "(" << arg_list << ");\n";
-            } else {
-                // Unknown function - default to 0.0
-                unified_code << "    float " << var_name << " = 0.0; // Unknown function\n";
+            std::string& arg = arguments[j];
+            // Replace $shader_XXX references with variable names
+            if (arg.substr(0, 8) == "$shader_") {
+                std::string ref_id = arg.substr(1); // Remove $
+                arg = ref_id + "_result";
             }
+            arg_list += arg;
         }
         
-        // Use the final result
-        if (!dependency_chain.empty()) {
-            std::string final_var = dependency_chain.back() + "_result";
-            unified_code << "    fragColor = vec4(vec3(" << final_var << "), 1.0);\n";
+        GlslSourceRegion region;
+        region.begin = static_cast<size_t>(static_cast<std::streamoff>(unified_code.tellp()));
+        region.node_id = node_id.toString();
+        region.arguments = arguments;
+        
+        // Generate the function call
+        auto callee = definitions.callees.find(node_id);
+        if (classification.classification == FunctionClassification::PLUGIN_FUNCTION &&
+            callee != definitions.callees.end()) {
+            // Use the wrapper chosen for the node's signature
+            unified_code << "    float " << var_name << " = " 
+                       << callee->second << "(" << arg_list << ");\n";
+        } else if (classification.classification == FunctionClassification::GLSL_BUILTIN) {
+            // Direct call for GLSL builtin functions
+            unified_code << "    float " << var_name << " = " 
+                       << node_data->function_name << "(" << arg_list << ");\n";
         } else {
-            unified_code << "    fragColor = vec4(0.0, 0.0, 0.0, 1.0);\n";
+            // Unknown function - default to 0.0
+            unified_code << "    float " << var_name << " = 0.0; // Unknown function\n";
         }
         
-        unified_code << "}\n";
-    }
-    
-    std::string result = unified_code.str();
-    
-    if (debug_mode) {
-        ofLogNotice("ShaderCompositionEngine") << "Generated unified shader:\n" << result;
+        if (regions) {
+            region.end = static_cast<size_t>(static_cast<std::streamoff>(unified_code.tellp()));
+            regions->push_back(region);
+        }
     }
-    
-    return result;
 }
 
 //--------------------------------------------------------------
@@ -601,9 +1116,9 @@ std::string ShaderCompositionEngine::optimizeShaderCode(const std::string& shade
 }
 
 //--------------------------------------------------------------
-bool ShaderCompositionEngine::validateDependencyChain(const std::vector<std::string>& dependency_chain) {
-    for (const std::string& node_id : dependency_chain) {
-        if (!hasNode(node_id)) {
+bool ShaderCompositionEngine::validateDependencyChain(const std::vector<ShaderHandle>& dependency_chain) {
+    for (ShaderHandle node_id : dependency_chain) {
+        if (!findNode(node_id)) {
             ofLogError("ShaderCompositionEngine") << "Invalid node in dependency chain: " << node_id;
             return false;
         }
@@ -1,13 +1,19 @@
 #pragma once
 
 #include "ShaderNode.h"
+#include "SymbolTable.h"
+#include "ShaderRegistry.h"
 #include "../pluginSystem/PluginManager.h"
 #include "FunctionDependencyAnalyzer.h"
+#include "GlslValidator.h"
 #include "ofMain.h"
 #include <unordered_map>
+#include <map>
+#include <set>
 #include <vector>
 #include <string>
 #include <memory>
+#include <sstream>
 
 /**
  * @struct CompositionNode
@@ -16,22 +22,34 @@
  *          without creating actual shader programs until compilation time.
  */
 struct CompositionNode {
-    std::string function_name;                    ///< The GLSL function name
-    std::vector<std::string> arguments;           ///< Raw argument strings
+    Symbol function_name;                        ///< The GLSL function name
+    std::vector<std::string> arguments;          ///< Raw argument strings
     std::vector<CompositionNode*> input_nodes;    ///< Dependencies on other nodes
-    std::string node_id;                         ///< Unique identifier for this node
+    ShaderHandle node_id;                        ///< Unique identifier for this node
     
     // Resolved information (populated during dependency analysis)
-    std::vector<std::string> resolved_arguments;  ///< Arguments with $shader_XXX resolved
+    std::vector<std::string> resolved_arguments; ///< Arguments with $shader_XXX resolved
     bool is_external_dependency;                 ///< True if depends on external nodes
     
-    CompositionNode(const std::string& func_name, 
+    // Compute variant (see ShaderCompositionEngine::setComputeVariant)
+    float compute_scale;                         ///< Field resolution relative to the output, 0 for the fragment pass
+    int compute_workgroup_size;                  ///< Compute local size in x and y
+    
+    // Parameter ports (see ShaderCompositionEngine::setParameter)
+    std::unordered_map<Symbol, std::vector<float>> parameter_values; ///< Values set at runtime, by port name
+    
+    uint64_t revision;                           ///< Engine revision of the last change to this node
+    
+    CompositionNode(Symbol func_name, 
                    const std::vector<std::string>& args, 
-                   const std::string& id)
+                   ShaderHandle id)
         : function_name(func_name)
         , arguments(args)
         , node_id(id)
-        , is_external_dependency(false) {}
+        , is_external_dependency(false)
+        , compute_scale(0.0f)
+        , compute_workgroup_size(8)
+        , revision(0) {}
 };
 
 /**
@@ -60,6 +78,36 @@ public:
     std::string registerNode(const std::string& function_name, 
                             const std::vector<std::string>& arguments);
     
+    /**
+     * @brief Registers a node under an ID issued by an earlier run, e.g. from a session snapshot
+     * @param node_id The ID to reuse; its registry slot must be free
+     * @param function_name The GLSL function to use
+     * @param arguments Raw argument strings (may contain $shader_XXX references)
+     * @param slot_limit Node IDs whose index reaches this many registry slots are rejected
+     * @return True on success, false if the ID is taken or out of bounds or the function does not exist
+     */
+    bool restoreNode(const std::string& node_id, const std::string& function_name,
+                     const std::vector<std::string>& arguments, size_t slot_limit);
+    
+    /**
+     * @brief Replaces the function and arguments of a registered node
+     * @details The compute variant is kept if the function stays the same. Graphs containing
+     *          the node pick up the change the next time they are compiled.
+     * @param node_id The node to change
+     * @param function_name The GLSL function to use
+     * @param arguments Raw argument strings (may contain $shader_XXX references)
+     * @return True on success, false if the node or the function does not exist
+     */
+    bool updateNode(const std::string& node_id, const std::string& function_name,
+                    const std::vector<std::string>& arguments);
+    
+    /**
+     * @brief Checks if a function can be used by a node
+     * @param function_name The GLSL function name
+     * @return True if a plugin provides the function or it is a GLSL builtin
+     */
+    bool isFunctionAvailable(const std::string& function_name) const;
+    
     /**
      * @brief Checks if a node with the given ID exists
      * @param node_id The ID to check
@@ -92,6 +140,42 @@ public:
      */
     std::vector<std::string> analyzeDependencies(const std::string& output_node_id);
     
+    /**
+     * @brief Evaluates a node with a compute shader into a texture instead of per output pixel
+     * @details Intended for expensive, low-frequency nodes such as fbm or curl noise. The node
+     *          and its whole upstream chain are evaluated at scale * output resolution, and
+     *          downstream nodes sample the result with linear filtering. Takes effect the next
+     *          time a graph containing the node is compiled.
+     * @param node_id The node to change
+     * @param scale Field resolution relative to the output in (0, 1], 0 to use the fragment pass again
+     * @param workgroup_size Compute local size in x and y, 0 for the default of 8
+     * @return True on success, false if the node does not exist or the scale is invalid
+     */
+    bool setComputeVariant(const std::string& node_id, float scale, int workgroup_size = 0);
+    
+    // ================================================================================
+    // PARAMETER PORTS (OSC /param handling)
+    // ================================================================================
+    
+    /**
+     * @brief Sets a parameter port of a node without recompiling anything
+     * @details Ports are declared by node arguments of the form "@name[:type][=value]" and
+     *          packed into one uniform block per compiled graph. The value is kept for later
+     *          compilations and written into the block of every cached graph containing the node.
+     * @param node_id The node that declares the port
+     * @param port_name The port name
+     * @param values One value, broadcast to all components, or one per component
+     * @return True on success, false if the node has no such port or the value count does not match
+     */
+    bool setParameter(const std::string& node_id, const std::string& port_name, const std::vector<float>& values);
+    
+    /**
+     * @brief Gets the parameter ports a node declares
+     * @param node_id The node to inspect
+     * @return The ports with their default values, empty if the node has none
+     */
+    std::vector<ParameterPort> getParameterPorts(const std::string& node_id) const;
+    
     // ================================================================================
     // CACHE MANAGEMENT
     // ================================================================================
@@ -107,16 +191,20 @@ public:
      * @brief Stores a compiled graph in the cache
      * @param graph_key Unique key for the graph
      * @param compiled_shader The compiled shader to cache
+     * @param dependency_chain The nodes of the graph, so edits of any of them evict it
      */
     void cacheCompiledGraph(const std::string& graph_key, 
-                           std::shared_ptr<ShaderNode> compiled_shader);
+                           std::shared_ptr<ShaderNode> compiled_shader,
+                           const std::vector<ShaderHandle>& dependency_chain);
     
     /**
      * @brief Generates a unique key for a shader graph structure
+     * @details Built from symbol handles rather than text, so the key is short and cheap to
+     *          hash. Handles are stable for the lifetime of the process, like the cache itself.
      * @param dependency_chain Vector of node IDs in topological order
      * @return Unique string key for caching
      */
-    std::string generateGraphKey(const std::vector<std::string>& dependency_chain);
+    std::string generateGraphKey(const std::vector<ShaderHandle>& dependency_chain);
     
     // ================================================================================
     // UTILITY METHODS
@@ -129,6 +217,14 @@ public:
      */
     bool removeNode(const std::string& node_id);
     
+    /**
+     * @brief Drops the cached program of a graph so its GL resources can be freed
+     * @details The nodes stay registered; the program is destroyed once no one else holds it.
+     * @param output_node_id The ID of the final output node
+     * @return True if a cached program was dropped
+     */
+    bool releaseCompiledGraph(const std::string& output_node_id);
+    
     /**
      * @brief Clears all registered nodes and cache
      */
@@ -140,6 +236,18 @@ public:
      */
     size_t getNodeCount() const;
     
+    /**
+     * @brief Gets all registered nodes, in no particular order
+     */
+    std::vector<const CompositionNode*> getNodes() const;
+    
+    /**
+     * @brief Gets a counter that grows with every change to the registered nodes
+     * @details Covers registration, removal, updates, compute variants and parameter values,
+     *          so observers such as the session snapshot can skip unchanged graphs.
+     */
+    uint64_t getRevision() const;
+    
     /**
      * @brief Prints debug information about the current graph state
      */
@@ -158,23 +266,53 @@ private:
     
     PluginManager* plugin_manager;                ///< Reference to the plugin system
     bool debug_mode;                             ///< Debug logging flag
+    uint64_t revision;                           ///< Incremented by every node change, see getRevision()
     
-    // Node storage and management
-    std::unordered_map<std::string, std::unique_ptr<CompositionNode>> pending_nodes;
-    std::atomic<int> next_node_id{1};            ///< Counter for generating unique IDs
+    // Node storage and management, keyed by registry handle
+    std::unordered_map<ShaderHandle, std::unique_ptr<CompositionNode>> pending_nodes;
     
     // Caching system for compiled graphs
     std::unordered_map<std::string, std::shared_ptr<ShaderNode>> compiled_cache;
+    std::unordered_map<std::string, std::vector<ShaderHandle>> cached_chains; ///< Nodes of each cached graph
+    
+    /**
+     * @brief Drops the cached programs of every graph that contains a node
+     * @details Called when the node changes or is removed: its graphs get new keys, so the
+     *          programs under the old keys could never be looked up again.
+     * @param node_id The changed node
+     */
+    void evictCompiledGraphs(ShaderHandle node_id);
+    
+    /**
+     * @struct EmittedDefinitions
+     * @brief What one generated shader already defines, so every include and wrapper is emitted once
+     */
+    struct EmittedDefinitions {
+        std::set<std::string> includes;                     ///< Headers already #included
+        std::map<std::string, std::string> wrappers;        ///< Wrapper signature -> wrapper name
+        std::unordered_map<ShaderHandle, std::string> callees; ///< Node -> wrapper or function its call uses
+    };
     
     // ================================================================================
     // INTERNAL METHODS
     // ================================================================================
     
     /**
-     * @brief Generates a unique node ID
-     * @return New unique ID string
+     * @brief Reserves a node ID in the ShaderRegistry
+     * @return New unique handle
+     */
+    ShaderHandle generateUniqueNodeId();
+    
+    /**
+     * @brief Looks up a node by its handle
+     * @return Pointer to CompositionNode, nullptr if not found
      */
-    std::string generateUniqueNodeId();
+    CompositionNode* findNode(ShaderHandle node_id) const;
+    
+    /**
+     * @brief Gets the parameter ports a node declares
+     */
+    std::vector<ParameterPort> collectParameterPorts(const CompositionNode& node) const;
     
     /**
      * @brief Resolves shader references in arguments ($shader_XXX -> actual dependencies)
@@ -189,8 +327,8 @@ private:
      * @param sorted_nodes Output vector for the sorted node IDs
      * @return True if successful, false on circular dependency
      */
-    bool topologicalSort(const std::string& output_node_id, 
-                        std::vector<std::string>& sorted_nodes);
+    bool topologicalSort(ShaderHandle output_node_id, 
+                        std::vector<ShaderHandle>& sorted_nodes);
     
     /**
      * @brief Helper for topological sort using DFS
@@ -200,17 +338,74 @@ private:
      * @param sorted_nodes Output vector for sorted nodes
      * @return True if successful, false on circular dependency
      */
-    bool topologicalSortDFS(const std::string& node_id,
-                           std::unordered_map<std::string, bool>& visited,
-                           std::unordered_map<std::string, bool>& rec_stack,
-                           std::vector<std::string>& sorted_nodes);
+    bool topologicalSortDFS(ShaderHandle node_id,
+                           std::unordered_map<ShaderHandle, bool>& visited,
+                           std::unordered_map<ShaderHandle, bool>& rec_stack,
+                           std::vector<ShaderHandle>& sorted_nodes);
     
     /**
      * @brief Generates unified GLSL code from the dependency chain
      * @param dependency_chain Nodes in topological order
+     * @param regions Receives the source region of each node, for GlslValidator; may be null
      * @return Complete GLSL fragment shader code, empty on error
      */
-    std::string generateUnifiedShaderCode(const std::vector<std::string>& dependency_chain);
+    std::string generateUnifiedShaderCode(const std::vector<ShaderHandle>& dependency_chain,
+                                          std::vector<GlslSourceRegion>* regions = nullptr);
+    
+    /**
+     * @brief Generates the compute shader that evaluates a node into its field image
+     * @param node_id The node with a compute variant
+     * @param regions Receives the source region of each node, for GlslValidator; may be null
+     * @return Complete GLSL compute shader code, empty on error
+     */
+    std::string generateComputeShaderCode(ShaderHandle node_id, std::vector<GlslSourceRegion>* regions = nullptr);
+    
+    /**
+     * @brief Selects the nodes of a chain the fragment shader has to evaluate or sample
+     * @details Inputs of nodes with a compute variant are only needed by their compute shader.
+     * @param dependency_chain Nodes in topological order, output last
+     * @return The needed nodes, in the same order
+     */
+    std::vector<ShaderHandle> collectFragmentNodes(const std::vector<ShaderHandle>& dependency_chain) const;
+    
+    /**
+     * @brief Finds the texture sources referenced by the arguments of the given nodes
+     * @param nodes Node IDs
+     * @return The sampler names, sorted and without duplicates
+     */
+    std::vector<std::string> collectTextureInputs(const std::vector<ShaderHandle>& nodes) const;
+    
+    /**
+     * @brief Gets the arguments of a node with parameter ports replaced by their block members
+     */
+    std::vector<std::string> resolvePortArguments(const CompositionNode& node) const;
+    
+    /**
+     * @brief Packs the parameter ports of the given nodes into a block holding their current values
+     * @param nodes Node IDs, in declaration order
+     * @return The block, empty if none of the nodes declares a port
+     */
+    std::shared_ptr<ParameterBlock> buildParameterBlock(const std::vector<ShaderHandle>& nodes) const;
+    
+    /**
+     * @brief Emits the includes and wrapper functions of the given nodes
+     * @details Nodes sharing a plugin file share its #include, and nodes whose wrappers have
+     *          the same signature share one wrapper.
+     * @param definitions What the shader already defines; receives the callee of each node
+     * @param regions Receives one region per emitted node; may be null
+     */
+    void appendNodeDefinitions(std::stringstream& unified_code, const std::vector<ShaderHandle>& nodes,
+                               EmittedDefinitions& definitions, std::vector<GlslSourceRegion>* regions = nullptr);
+    
+    /**
+     * @brief Emits one 'float <node>_result' statement per node
+     * @param sample_compute_nodes True to read nodes with a compute variant from their field texture
+     * @param definitions The definitions appendNodeDefinitions emitted for the same nodes
+     * @param regions Receives one region per emitted call; may be null
+     */
+    void appendNodeCalls(std::stringstream& unified_code, const std::vector<ShaderHandle>& nodes,
+                         bool sample_compute_nodes, const EmittedDefinitions& definitions,
+                         std::vector<GlslSourceRegion>* regions = nullptr);
     
     /**
      * @brief Inlines function calls to eliminate intermediate steps
@@ -224,7 +419,7 @@ private:
      * @param dependency_chain The chain to validate
      * @return True if all nodes are valid, false otherwise
      */
-    bool validateDependencyChain(const std::vector<std::string>& dependency_chain);
+    bool validateDependencyChain(const std::vector<ShaderHandle>& dependency_chain);
     
     /**
      * @brief Loads the source code for a specific function from plugins
@@ -1,7 +1,10 @@
 #include "ShaderManager.h"
 #include "BuiltinVariables.h"
+#include "GlslValidator.h"
 #include "ofLog.h"
+#include "../statsSystem/AllocationTracker.h"
 #include <algorithm>
+#include <filesystem>
 #include <fstream>
 #include <regex>
 #include <set>
@@ -121,13 +124,11 @@ std::shared_ptr<ShaderNode> ShaderManager::createShader(
 	}
 	ofLogNotice("ShaderManager") << "Step 3: Loaded GLSL function code (length: " << glsl_function_code.length() << ")";
 
-	shader_node->glsl_function_code = glsl_function_code;
-
 	// Set the source directory path to allow ofShader to resolve #includes.
 	std::string glsl_file_path = resolveGLSLFilePath(plugin_name, function_metadata->filePath);
 	size_t last_slash = glsl_file_path.find_last_of('/');
 	if (last_slash != std::string::npos) {
-		shader_node->source_directory_path = glsl_file_path.substr(0, last_slash);
+		shader_node->metadata->source_directory_path = glsl_file_path.substr(0, last_slash);
 	}
 
 	// Generate the final shader source code using the new code generator.
@@ -140,7 +141,21 @@ std::shared_ptr<ShaderNode> ShaderManager::createShader(
 	std::string vertex_code = code_generator->generateVertexShader();
 	std::string fragment_code = code_generator->generateFragmentShader(glsl_function_code, function_name, arguments);
 
+	// Reject invalid code before a program object exists; the whole source belongs to this function
+	GlslSourceRegion region;
+	region.end = fragment_code.size();
+	region.node_id = function_name;
+	region.arguments = arguments;
+	GlslValidator validator;
+	if (!validator.validate(fragment_code, GL_FRAGMENT_SHADER, shader_node->metadata->source_directory_path, {region})) {
+		ofLogError("ShaderManager") << "Generated shader failed validation:\n" << validator.getErrorSummary();
+		return createErrorShader(function_name, arguments, "GLSL validation failed: " + validator.getErrorSummary());
+	}
+
 	shader_node->setShaderCode(vertex_code, fragment_code);
+	for (const auto& sampler_name : builtins.findTextureInputs(arguments)) {
+		shader_node->addTextureInput(sampler_name);
+	}
 
 	// Compile the shader.
 	if (!shader_node->compile()) {
@@ -203,9 +218,9 @@ std::shared_ptr<ShaderNode> ShaderManager::createShader(
 	if (debug_mode) {
 		ofLogNotice("ShaderManager") << "Successfully created shader: " << cache_key;
 		std::cout << "=== VERTEX SHADER ===" << std::endl;
-		std::cout << shader_node->vertex_shader_code << std::endl;
+		std::cout << vertex_code << std::endl;
 		std::cout << "=== FRAGMENT SHADER ===" << std::endl;
-		std::cout << shader_node->fragment_shader_code << std::endl;
+		std::cout << fragment_code << std::endl;
 		std::cout << "===================" << std::endl;
 	}
 
@@ -214,6 +229,7 @@ std::shared_ptr<ShaderNode> ShaderManager::createShader(
 
 //--------------------------------------------------------------
 std::string ShaderManager::loadGLSLFunction(const GLSLFunction * function_metadata, const std::string & plugin_name) {
+	AllocationScope allocation_scope(AllocationTag::PLUGIN_LOOKUP);
 	if (!function_metadata) {
 		ofLogError("ShaderManager") << "Function metadata is null";
 		return "";
@@ -248,6 +264,38 @@ std::string ShaderManager::resolveGLSLFilePath(const std::string & plugin_name,
 	return full_path;
 }
 
+//--------------------------------------------------------------
+std::set<std::string> ShaderManager::collectIncludedFiles(const std::string& code, const std::string& directory) {
+	static const std::regex include_regex(R"re(^\s*#\s*include\s*"([^"]+)")re");
+
+	std::set<std::string> files;
+	std::vector<std::pair<std::string, std::string>> pending = {{code, directory}};
+	while (!pending.empty()) {
+		auto [source, source_directory] = std::move(pending.back());
+		pending.pop_back();
+
+		std::istringstream lines(source);
+		std::string line;
+		while (std::getline(lines, line)) {
+			std::smatch match;
+			if (!std::regex_search(line, match, include_regex)) {
+				continue;
+			}
+			std::string path = std::filesystem::path(ofFilePath::join(source_directory, match[1].str())).lexically_normal().string();
+			if (files.count(path)) {
+				continue;
+			}
+			ofBuffer buffer = ofBufferFromFile(path);
+			if (buffer.size() == 0) {
+				continue;
+			}
+			files.insert(path);
+			pending.emplace_back(buffer.getText(), ofFilePath::getEnclosingDirectory(path, false));
+		}
+	}
+	return files;
+}
+
 //--------------------------------------------------------------
 std::string ShaderManager::readFileContent(const std::string & file_path) {
 	ofBuffer buffer = ofBufferFromFile(file_path);
@@ -556,19 +604,13 @@ std::string ShaderManager::generateWrapperFunction(
 	return wrapper.str();
 }
 
-//--------------------------------------------------------------
-std::string ShaderManager::generateUniqueId() {
-    return std::to_string(next_shader_id++);
-}
-
 //--------------------------------------------------------------
 std::string ShaderManager::createShaderWithId(const std::string& function_name, 
                                               const std::vector<std::string>& arguments) {
     auto shader = createShader(function_name, arguments);
     
     if (shader && shader->isReady()) {
-        std::string shader_id = generateUniqueId();
-        active_shaders[shader_id] = shader;
+        std::string shader_id = ShaderRegistry::getInstance().add(ShaderEntryKind::PROGRAM, shader).toString();
         
         if (debug_mode) {
             ofLogNotice("ShaderManager") << "Created shader with ID: " << shader_id 
@@ -584,9 +626,9 @@ std::string ShaderManager::createShaderWithId(const std::string& function_name,
 
 //--------------------------------------------------------------
 std::shared_ptr<ShaderNode> ShaderManager::getShaderById(const std::string& shader_id) {
-    auto it = active_shaders.find(shader_id);
-    if (it != active_shaders.end()) {
-        return it->second;
+    auto shader = ShaderRegistry::getInstance().getShader(ShaderHandle::parse(shader_id));
+    if (shader) {
+        return shader;
     }
     ofLogWarning("ShaderManager") << "Shader not found with ID: " << shader_id;
     return nullptr;
@@ -594,9 +636,10 @@ std::shared_ptr<ShaderNode> ShaderManager::getShaderById(const std::string& shad
 
 //--------------------------------------------------------------
 bool ShaderManager::removeShaderById(const std::string& shader_id) {
-    auto it = active_shaders.find(shader_id);
-    if (it != active_shaders.end()) {
-        active_shaders.erase(it);
+    ShaderRegistry& registry = ShaderRegistry::getInstance();
+    ShaderHandle handle = ShaderHandle::parse(shader_id);
+    if (registry.contains(handle, ShaderEntryKind::PROGRAM)) {
+        registry.remove(handle);
         if (debug_mode) {
             ofLogNotice("ShaderManager") << "Removed shader with ID: " << shader_id;
         }
@@ -610,8 +653,8 @@ bool ShaderManager::removeShaderById(const std::string& shader_id) {
 //--------------------------------------------------------------
 std::vector<std::string> ShaderManager::getAllActiveShaderIds() {
     std::vector<std::string> ids;
-    for (const auto& pair : active_shaders) {
-        ids.push_back(pair.first);
+    for (ShaderHandle handle : ShaderRegistry::getInstance().getHandles(ShaderEntryKind::PROGRAM)) {
+        ids.push_back(handle.toString());
     }
     return ids;
 }
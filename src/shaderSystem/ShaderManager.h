@@ -1,5 +1,6 @@
 #pragma once
 #include "ShaderNode.h"
+#include "ShaderRegistry.h"
 #include "ShaderCodeGenerator.h"
 #include "ExpressionParser.h"
 #include "BuiltinVariables.h"
@@ -10,6 +11,7 @@
 #include <memory>
 #include <string>
 #include <vector>
+#include <set>
 #include <atomic>
 
 /**
@@ -33,11 +35,7 @@ private:
     /// A cache for shader nodes, using a key generated from the function name and arguments.
     std::unordered_map<std::string, std::shared_ptr<ShaderNode>> shader_cache;
     
-    // --- ID-based Management System ---
-    /// A map of currently active shaders, managed by a unique ID.
-    std::unordered_map<std::string, std::shared_ptr<ShaderNode>> active_shaders;
-    /// An atomic counter to generate unique IDs for shaders.
-    std::atomic<int> next_shader_id{0};
+    // Shaders created with an ID live in the ShaderRegistry, shared with the composition engine
     
 public:
     /**
@@ -68,6 +66,7 @@ public:
     // --- ID-based Management ---
     /**
      * @brief Creates a shader, assigns it a unique ID, and registers it.
+     * @details The ID is the text form of a ShaderRegistry handle.
      * @param function_name The name of the GLSL function.
      * @param arguments The arguments for the function.
      * @return A unique shader ID string on success, or an empty string on failure.
@@ -78,7 +77,7 @@ public:
     /**
      * @brief Retrieves a shader by its unique ID.
      * @param shader_id The ID of the shader to find.
-     * @return A shared_ptr to the ShaderNode if found, otherwise nullptr.
+     * @return A shared_ptr to the ShaderNode if found, otherwise nullptr, also for stale IDs.
      */
     std::shared_ptr<ShaderNode> getShaderById(const std::string& shader_id);
     
@@ -158,6 +157,15 @@ public:
      * @return The absolute path to the GLSL file.
      */
     std::string resolveGLSLFilePath(const std::string& plugin_name, const std::string& function_file_path);
+
+    /**
+     * @brief Collects the files a shader source pulls in through quoted #include directives.
+     * @details Includes are resolved relative to the including file, like ofShader does.
+     * @param code The shader source.
+     * @param directory The directory the source's own includes are resolved against.
+     * @return The normalized paths of all transitively included files that exist.
+     */
+    static std::set<std::string> collectIncludedFiles(const std::string& code, const std::string& directory);
     
     /**
      * @brief Generates a unique cache key from a function name and its arguments.
@@ -196,11 +204,6 @@ public:
     
 private:
     // --- Internal Helper Methods ---
-    /**
-     * @brief Generates a new unique ID for a shader.
-     * @return A unique ID string.
-     */
-    std::string generateUniqueId();
     
     
     /**
@@ -1,19 +1,149 @@
 #include "ShaderNode.h"
+#include "ProgramBinaryCache.h"
 #include "ofLog.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <regex>
+#include <set>
+#include <sstream>
+
+namespace {
+
+const int kMaxIncludeDepth = 32;
+
+/// Inlines the files included by code, each once.
+bool expandIncludes(const std::string& code, const std::string& directory,
+                    std::set<std::string>& included, std::string& output, int depth) {
+    if (depth > kMaxIncludeDepth) {
+        ofLogError("ShaderNode") << "Include depth limit exceeded in " << directory;
+        return false;
+    }
+
+    // The directives ofShader resolves: #include "file" and #pragma include "file"
+    static const std::regex include_regex(R"re(^\s*#\s*(?:pragma\s+)?include\s*["<]([^">]+)[">])re");
+
+    std::istringstream lines(code);
+    std::string line;
+    while (std::getline(lines, line)) {
+        std::smatch match;
+        if (!std::regex_search(line, match, include_regex)) {
+            output += line;
+            output += '\n';
+            continue;
+        }
+
+        std::string path = std::filesystem::path(ofFilePath::join(directory, match[1].str())).lexically_normal().string();
+        if (!included.insert(path).second) {
+            continue;
+        }
+        ofBuffer buffer = ofBufferFromFile(path);
+        if (buffer.size() == 0) {
+            ofLogError("ShaderNode") << "Cannot read include: " << path;
+            return false;
+        }
+        if (!expandIncludes(buffer.getText(), ofFilePath::getEnclosingDirectory(path, false), included, output, depth + 1)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// Gets the info log of a shader or program object.
+std::string getInfoLog(GLuint object, bool is_program) {
+    GLint length = 0;
+    if (is_program) {
+        glGetProgramiv(object, GL_INFO_LOG_LENGTH, &length);
+    } else {
+        glGetShaderiv(object, GL_INFO_LOG_LENGTH, &length);
+    }
+    std::string log(std::max(length, 1), '\0');
+    if (is_program) {
+        glGetProgramInfoLog(object, length, nullptr, &log[0]);
+    } else {
+        glGetShaderInfoLog(object, length, nullptr, &log[0]);
+    }
+    log.resize(std::strlen(log.c_str()));
+    return log;
+}
+
+/// Compiles one stage with its includes expanded, 0 on failure.
+GLuint compileStage(GLenum type, const std::string& source, const std::string& directory, Symbol function_name) {
+    std::set<std::string> included;
+    std::string expanded;
+    if (!expandIncludes(source, directory, included, expanded, 0)) {
+        return 0;
+    }
+
+    GLuint shader = glCreateShader(type);
+    const char* text = expanded.c_str();
+    GLint length = static_cast<GLint>(expanded.size());
+    glShaderSource(shader, 1, &text, &length);
+    glCompileShader(shader);
+
+    GLint status = GL_FALSE;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+    if (status != GL_TRUE) {
+        ofLogError("ShaderNode") << (type == GL_VERTEX_SHADER ? "Vertex" : "Fragment") << " shader of '"
+                                 << function_name << "' failed to compile:\n" << getInfoLog(shader, false);
+        glDeleteShader(shader);
+        return 0;
+    }
+    return shader;
+}
+
+/// Links two compiled stages and detaches them again, 0 on failure.
+GLuint linkProgram(GLuint vertex, GLuint fragment, bool retrievable, Symbol function_name) {
+    GLuint linked = glCreateProgram();
+    if (retrievable) {
+        glProgramParameteri(linked, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+    glAttachShader(linked, vertex);
+    glAttachShader(linked, fragment);
+    glLinkProgram(linked);
+    glDetachShader(linked, vertex);
+    glDetachShader(linked, fragment);
+
+    GLint status = GL_FALSE;
+    glGetProgramiv(linked, GL_LINK_STATUS, &status);
+    if (status != GL_TRUE) {
+        ofLogError("ShaderNode") << "Program of '" << function_name << "' failed to link:\n" << getInfoLog(linked, true);
+        glDeleteProgram(linked);
+        return 0;
+    }
+    return linked;
+}
+
+} // namespace
+
+//--------------------------------------------------------------
+LinkedProgram::~LinkedProgram() {
+    if (id) {
+        glDeleteProgram(id);
+    }
+}
 
 //--------------------------------------------------------------
 ShaderNode::ShaderNode() 
-    : is_compiled(false), has_error(false), auto_update_time(false), auto_update_resolution(false),
-      node_state(ShaderNodeState::CREATED), is_connected_to_output(false) {
-    creation_timestamp = getCurrentTimestamp();
+    : auto_update_time(false), auto_update_resolution(false),
+      is_compiled(false), has_error(false), node_state(ShaderNodeState::CREATED), is_connected_to_output(false),
+      metadata(std::make_unique<ShaderNodeMetadata>()) {
+    metadata->creation_time = time(nullptr);
 }
 
 //--------------------------------------------------------------
 ShaderNode::ShaderNode(const std::string& func_name, const std::vector<std::string>& args)
-    : function_name(func_name), arguments(args), auto_update_time(false), auto_update_resolution(false),
-      is_compiled(false), has_error(false), node_state(ShaderNodeState::CREATED), is_connected_to_output(false) {
-    shader_key = generateShaderKey();
-    creation_timestamp = getCurrentTimestamp();
+    : ShaderNode(Symbol(func_name), args) {
+}
+
+//--------------------------------------------------------------
+ShaderNode::ShaderNode(Symbol func_name, const std::vector<std::string>& args)
+    : function_name(func_name), auto_update_time(false), auto_update_resolution(false),
+      is_compiled(false), has_error(false), node_state(ShaderNodeState::CREATED), is_connected_to_output(false),
+      metadata(std::make_unique<ShaderNodeMetadata>()) {
+    metadata->arguments = args;
+    metadata->shader_key = generateShaderKey();
+    metadata->creation_time = time(nullptr);
 }
 
 //--------------------------------------------------------------
@@ -25,29 +155,64 @@ ShaderNode::~ShaderNode() {
 bool ShaderNode::compile() {
     setState(ShaderNodeState::COMPILING);
     
-    if (vertex_shader_code.empty() || fragment_shader_code.empty()) {
-        setError("Shader code not set before compilation");
+    if (!metadata->sources.isAvailable()) {
+        setError(metadata->sources.isDropped() ? "Shader code was released after the previous link"
+                                               : "Shader code not set before compilation");
         return false;
     }
     
     try {
         // Clean up any previously loaded shader.
-        if (compiled_shader.isLoaded()) {
-            compiled_shader.unload();
+        releaseProgram();
+        
+        // A binary linked from the same sources in an earlier run skips compilation entirely
+        ProgramBinaryCache& binary_cache = ProgramBinaryCache::getInstance();
+        bool use_binary_cache = binary_cache.isEnabled();
+        uint64_t compile_start = ofGetElapsedTimeMicros();
+        GLuint program_id = 0;
+        if (use_binary_cache) {
+            program_id = binary_cache.load(getProgramCacheKey());
         }
         
-        // Setup the shader from source. Providing the source directory path allows
-        // ofShader to correctly handle #include directives with relative paths.
-        bool success = compiled_shader.setupShaderFromSource(GL_VERTEX_SHADER, vertex_shader_code, source_directory_path) &&
-                       compiled_shader.setupShaderFromSource(GL_FRAGMENT_SHADER, fragment_shader_code, source_directory_path) &&
-                       compiled_shader.linkProgram();
+        bool success = program_id != 0;
+        uint64_t link_start = ofGetElapsedTimeMicros();
+        if (!success) {
+            // The stages are deleted right after linking, so the driver drops its copies of the
+            // sources and metadata->sources holds the only one that may stay resident
+            // Same fallback as ofShader for sources without a directory
+            const std::string& directory = metadata->source_directory_path.empty() ? ofToDataPath("", true)
+                                                                                    : metadata->source_directory_path;
+            GLuint vertex = compileStage(GL_VERTEX_SHADER, metadata->sources.getVertex(), directory, function_name);
+            GLuint fragment = vertex ? compileStage(GL_FRAGMENT_SHADER, metadata->sources.getFragment(), directory, function_name) : 0;
+            link_start = ofGetElapsedTimeMicros();
+            if (vertex && fragment) {
+                program_id = linkProgram(vertex, fragment, use_binary_cache, function_name);
+            }
+            if (vertex) {
+                glDeleteShader(vertex);
+            }
+            if (fragment) {
+                glDeleteShader(fragment);
+            }
+            success = program_id != 0;
+            if (success && use_binary_cache) {
+                binary_cache.store(getProgramCacheKey(), program_id);
+            }
+        }
+        metadata->compile_milliseconds = (link_start - compile_start) / 1000.0f;
+        metadata->link_milliseconds = (ofGetElapsedTimeMicros() - link_start) / 1000.0f;
         
         if (success) {
+            program = adoptProgram(program_id);
             is_compiled = true;
             has_error = false;
-            error_message.clear();
+            metadata->error_message.clear();
+            size_t resident_before = metadata->sources.getResidentBytes();
+            metadata->sources.release();
             setState(ShaderNodeState::IDLE);  // Set to idle after successful compilation
-            ofLogNotice("ShaderNode") << "Successfully compiled shader for function: " << function_name;
+            ofLogNotice("ShaderNode") << "Successfully compiled shader for function: " << function_name
+                                      << " (sources " << resident_before << " -> "
+                                      << metadata->sources.getResidentBytes() << " bytes resident)";
             return true;
         } else {
             setError("Failed to compile or link shader program");
@@ -60,24 +225,73 @@ bool ShaderNode::compile() {
 }
 
 //--------------------------------------------------------------
-void ShaderNode::cleanup() {
-    if (compiled_shader.isLoaded()) {
-        compiled_shader.unload();
+bool ShaderNode::reload() {
+    if (!metadata->sources.isAvailable()) {
+        ofLogError("ShaderNode") << "Cannot reload '" << function_name
+                                 << "', its sources were dropped after linking (see --sources)";
+        return false;
     }
+
+    // Compile into a scratch node so a broken edit does not take down the running program
+    ShaderNode candidate(function_name, metadata->arguments);
+    candidate.metadata->sources.set(metadata->sources.getVertex(), metadata->sources.getFragment());
+    candidate.metadata->source_directory_path = metadata->source_directory_path;
+    candidate.compute_fields = compute_fields;
+    candidate.texture_inputs = texture_inputs;
+    candidate.parameter_block = parameter_block;
+    if (!candidate.compile()) {
+        ofLogError("ShaderNode") << "Reload of '" << function_name << "' failed, keeping the previous program";
+        return false;
+    }
+
+    // The candidate linked with the same fields and parameter block, so its program replaces ours as is
+    program = candidate.program;
+    metadata->program_cache_key = candidate.metadata->program_cache_key;
+    metadata->compile_milliseconds = candidate.metadata->compile_milliseconds;
+    metadata->link_milliseconds = candidate.metadata->link_milliseconds;
+    is_compiled = true;
+    has_error = false;
+    metadata->error_message.clear();
+    return true;
+}
+
+//--------------------------------------------------------------
+void ShaderNode::cleanup() {
+    releaseProgram();
     is_compiled = false;
     has_error = false;
-    error_message.clear();
+    metadata->error_message.clear();
+}
+
+//--------------------------------------------------------------
+void ShaderNode::releaseProgram() {
+    program.reset();
 }
 
 //--------------------------------------------------------------
 bool ShaderNode::isReady() const {
-    return is_compiled && !has_error && compiled_shader.isLoaded();
+    return is_compiled && !has_error && getProgramId() != 0;
+}
+
+//--------------------------------------------------------------
+GLuint ShaderNode::getProgramId() const {
+    return program ? program->id : 0;
+}
+
+//--------------------------------------------------------------
+const std::string& ShaderNode::getProgramCacheKey() {
+    if (metadata->program_cache_key.empty() && metadata->sources.isAvailable()) {
+        metadata->program_cache_key = ProgramBinaryCache::makeKey(metadata->sources.getVertex(),
+                                                                  metadata->sources.getFragment(),
+                                                                  metadata->source_directory_path);
+    }
+    return metadata->program_cache_key;
 }
 
 //--------------------------------------------------------------
 std::string ShaderNode::generateShaderKey() const {
-    std::string key = function_name;
-    for (const auto& arg : arguments) {
+    std::string key = function_name.str();
+    for (const std::string& arg : metadata->arguments) {
         key += "_" + arg;
     }
     return key;
@@ -85,23 +299,24 @@ std::string ShaderNode::generateShaderKey() const {
 
 //--------------------------------------------------------------
 void ShaderNode::setShaderCode(const std::string& vertex, const std::string& fragment) {
-    vertex_shader_code = vertex;
-    fragment_shader_code = fragment;
+    metadata->sources.set(vertex, fragment);
+    metadata->program_cache_key.clear();
 }
 
 //--------------------------------------------------------------
 void ShaderNode::setCustomShaderCode(const std::string& custom_code) {
-    // Set a minimal vertex shader for 2D rendering
-    vertex_shader_code = R"(
+    // Attribute-less fullscreen triangle, drawn by FullscreenPass with an empty VAO
+    static const std::string fullscreen_vertex = R"(
 #version 330 core
-layout (location = 0) in vec3 aPos;
 void main() {
-    gl_Position = vec4(aPos, 1.0);
+    vec2 position = vec2(float((gl_VertexID << 1) & 2), float(gl_VertexID & 2));
+    gl_Position = vec4(position * 2.0 - 1.0, 0.0, 1.0);
 }
 )";
     
     // Use the provided custom fragment shader code
-    fragment_shader_code = custom_code;
+    metadata->sources.set(fullscreen_vertex, custom_code);
+    metadata->program_cache_key.clear();
     
     ofLogNotice("ShaderNode") << "Set custom shader code (" << custom_code.length() << " characters)";
 }
@@ -109,7 +324,7 @@ void main() {
 //--------------------------------------------------------------
 void ShaderNode::setError(const std::string& error) {
     has_error = true;
-    error_message = error;
+    metadata->error_message = error;
     is_compiled = false;
     ofLogError("ShaderNode") << "Error in shader '" << function_name << "': " << error;
 }
@@ -118,37 +333,37 @@ void ShaderNode::setError(const std::string& error) {
 void ShaderNode::printDebugInfo() const {
     ofLogNotice("ShaderNode") << "=== Shader Node Debug Info ===";
     ofLogNotice("ShaderNode") << "Function: " << function_name;
-    ofLogNotice("ShaderNode") << "Arguments: " << ofJoinString(arguments, ", ");
-    ofLogNotice("ShaderNode") << "Shader Key: " << shader_key;
+    ofLogNotice("ShaderNode") << "Arguments: " << ofJoinString(metadata->arguments, ", ");
+    ofLogNotice("ShaderNode") << "Shader Key: " << metadata->shader_key;
     ofLogNotice("ShaderNode") << "Status: " << getStatusString();
     if (has_error) {
-        ofLogNotice("ShaderNode") << "Error: " << error_message;
+        ofLogNotice("ShaderNode") << "Error: " << metadata->error_message;
     }
-    ofLogNotice("ShaderNode") << "Vertex Shader Length: " << vertex_shader_code.length();
-    ofLogNotice("ShaderNode") << "Fragment Shader Length: " << fragment_shader_code.length();
+    ofLogNotice("ShaderNode") << "Source Length: " << metadata->sources.getSourceBytes()
+                              << " (" << metadata->sources.getResidentBytes() << " bytes resident)";
 }
 
 //--------------------------------------------------------------
 std::string ShaderNode::getStatusString() const {
     if (has_error) return "ERROR";
     if (is_compiled) return "COMPILED";
-    if (!vertex_shader_code.empty() && !fragment_shader_code.empty()) return "READY_TO_COMPILE";
+    if (metadata->sources.isAvailable()) return "READY_TO_COMPILE";
     return "NOT_READY";
 }
 
 //--------------------------------------------------------------
 void ShaderNode::setFloatUniform(const std::string& name, float value) {
-    float_uniforms[name] = value;
-    if (is_compiled && compiled_shader.isLoaded()) {
-        compiled_shader.setUniform1f(name, value);
+    metadata->float_uniforms[name] = value;
+    if (isReady()) {
+        glProgramUniform1f(getProgramId(), glGetUniformLocation(getProgramId(), name.c_str()), value);
     }
 }
 
 //--------------------------------------------------------------
 void ShaderNode::setVec2Uniform(const std::string& name, const ofVec2f& value) {
-    vec2_uniforms[name] = value;
-    if (is_compiled && compiled_shader.isLoaded()) {
-        compiled_shader.setUniform2f(name, value.x, value.y);
+    metadata->vec2_uniforms[name] = value;
+    if (isReady()) {
+        glProgramUniform2f(getProgramId(), glGetUniformLocation(getProgramId(), name.c_str()), value.x, value.y);
     }
 }
 
@@ -169,34 +384,79 @@ void ShaderNode::updateUniforms() {
     }
     
     // Update all user-defined float uniforms.
-    for (const auto& [name, value] : float_uniforms) {
-        compiled_shader.setUniform1f(name, value);
+    GLuint program = getProgramId();
+    for (const auto& [name, value] : metadata->float_uniforms) {
+        glProgramUniform1f(program, glGetUniformLocation(program, name.c_str()), value);
     }
     
     // Update all user-defined vec2 uniforms.
-    for (const auto& [name, value] : vec2_uniforms) {
-        compiled_shader.setUniform2f(name, value.x, value.y);
+    for (const auto& [name, value] : metadata->vec2_uniforms) {
+        glProgramUniform2f(program, glGetUniformLocation(program, name.c_str()), value.x, value.y);
     }
-    
-    // Update any automatic uniforms as well.
-    updateAutoUniforms();
 }
 
 //--------------------------------------------------------------
-void ShaderNode::updateAutoUniforms() {
-    if (!isReady()) {
-        return;
-    }
-    
+void ShaderNode::updateAutoUniforms(const LinkedProgram& linked, float width, float height, float time,
+                                    float tile_offset_x, float tile_offset_y) const {
     // Update the time uniform if enabled.
-    if (auto_update_time) {
-        compiled_shader.setUniform1f("time", ofGetElapsedTimef());
+    if (auto_update_time && linked.time_location >= 0) {
+        glUniform1f(linked.time_location, time);
     }
     
     // Update the resolution uniform if enabled.
-    if (auto_update_resolution) {
-        compiled_shader.setUniform2f("resolution", ofGetWidth(), ofGetHeight());
+    if (auto_update_resolution && linked.resolution_location >= 0) {
+        glUniform2f(linked.resolution_location, width, height);
+    }
+
+    // 'st' is computed from gl_FragCoord + tileOffset, so tiles of a larger output line up.
+    if (linked.tile_offset_location >= 0) {
+        glUniform2f(linked.tile_offset_location, tile_offset_x, tile_offset_y);
+    }
+}
+
+//--------------------------------------------------------------
+std::shared_ptr<const LinkedProgram> ShaderNode::adoptProgram(GLuint program_id) const {
+    auto linked = std::make_shared<LinkedProgram>();
+    linked->id = program_id;
+    linked->time_location = glGetUniformLocation(program_id, "time");
+    linked->resolution_location = glGetUniformLocation(program_id, "resolution");
+    linked->tile_offset_location = glGetUniformLocation(program_id, "tileOffset");
+
+    // Sampler units never change, so they are set once instead of every draw.
+    for (size_t i = 0; i < compute_fields.size(); ++i) {
+        GLint location = glGetUniformLocation(program_id, compute_fields[i]->getSamplerName().c_str());
+        if (location >= 0) {
+            glProgramUniform1i(program_id, location, static_cast<GLint>(1 + i));
+        }
+    }
+    for (size_t i = 0; i < texture_inputs.size(); ++i) {
+        GLint location = glGetUniformLocation(program_id, texture_inputs[i].c_str());
+        if (location >= 0) {
+            glProgramUniform1i(program_id, location, static_cast<GLint>(getTextureInputUnit(i)));
+        }
     }
+    if (parameter_block) {
+        GLuint block_index = glGetUniformBlockIndex(program_id, ParameterBlock::block_name);
+        if (block_index != GL_INVALID_INDEX) {
+            glUniformBlockBinding(program_id, block_index, ParameterBlock::binding_point);
+        }
+    }
+    return linked;
+}
+
+//--------------------------------------------------------------
+void ShaderNode::addTextureInput(const std::string& sampler_name) {
+    texture_inputs.push_back(sampler_name);
+}
+
+//--------------------------------------------------------------
+GLuint ShaderNode::getTextureInputUnit(size_t index) const {
+    return static_cast<GLuint>(1 + compute_fields.size() + index);
+}
+
+//--------------------------------------------------------------
+void ShaderNode::addComputeField(std::shared_ptr<ComputeField> field) {
+    compute_fields.push_back(field);
 }
 
 // ================================================================================
@@ -257,7 +517,7 @@ std::string ShaderNode::getDetailedStatus() const {
     
     status << "=== Shader Node Status ===\n";
     status << "Function: " << function_name << "\n";
-    status << "Created: " << creation_timestamp << "\n";
+    status << "Created: " << getCreationTimestamp() << "\n";
     
     // State information
     switch (node_state) {
@@ -275,7 +535,7 @@ std::string ShaderNode::getDetailedStatus() const {
             break;
         case ShaderNodeState::ERROR:
             status << "State: ERROR\n";
-            status << "Error: " << error_message << "\n";
+            status << "Error: " << metadata->error_message << "\n";
             break;
     }
     
@@ -285,6 +545,7 @@ std::string ShaderNode::getDetailedStatus() const {
     status << "Connected to Output: " << (is_connected_to_output ? "Yes" : "No") << "\n";
     
     // Arguments
+    const std::vector<std::string>& arguments = metadata->arguments;
     if (!arguments.empty()) {
         status << "Arguments: ";
         for (size_t i = 0; i < arguments.size(); i++) {
@@ -295,17 +556,16 @@ std::string ShaderNode::getDetailedStatus() const {
     }
     
     // Uniforms
-    if (!float_uniforms.empty() || !vec2_uniforms.empty()) {
-        status << "Uniforms: " << (float_uniforms.size() + vec2_uniforms.size()) << " total\n";
+    if (!metadata->float_uniforms.empty() || !metadata->vec2_uniforms.empty()) {
+        status << "Uniforms: " << (metadata->float_uniforms.size() + metadata->vec2_uniforms.size()) << " total\n";
     }
     
     return status.str();
 }
 
 //--------------------------------------------------------------
-std::string ShaderNode::getCurrentTimestamp() const {
-    time_t now = time(0);
-    char* dt = ctime(&now);
+std::string ShaderNode::getCreationTimestamp() const {
+    char* dt = ctime(&metadata->creation_time);
     std::string timestamp(dt);
     // Remove newline at end
     if (!timestamp.empty() && timestamp.back() == '\n') {
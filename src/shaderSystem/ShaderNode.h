@@ -1,9 +1,14 @@
 #pragma once
 #include "ofMain.h"
+#include "ComputeField.h"
+#include "ParameterBlock.h"
+#include "ShaderSources.h"
+#include "SymbolTable.h"
 #include <vector>
 #include <string>
 #include <memory>
 #include <map>
+#include <ctime>
 
 /**
  * @enum ShaderNodeState
@@ -17,41 +22,80 @@ enum class ShaderNodeState {
     ERROR           ///< Compilation or runtime error occurred
 };
 
+/**
+ * @struct ShaderNodeMetadata
+ * @brief The authoring side of a ShaderNode, which the render loop never touches.
+ */
+struct ShaderNodeMetadata {
+    std::vector<std::string> arguments;  ///< The arguments passed to the function.
+    std::string shader_key;              ///< A unique key generated for caching purposes.
+    ShaderSources sources;               ///< The generated sources, released after linking.
+    std::string source_directory_path;   ///< The directory path of the source GLSL file, for resolving #includes.
+    std::string program_cache_key;       ///< ProgramBinaryCache key of the sources, kept after they are released.
+    std::map<std::string, float> float_uniforms;    ///< A map of user-defined float uniforms.
+    std::map<std::string, ofVec2f> vec2_uniforms;   ///< A map of user-defined vec2 uniforms.
+    std::string error_message;           ///< The error message, if any.
+    float compile_milliseconds = 0.0f;   ///< CPU time of the last stage compilation.
+    float link_milliseconds = 0.0f;      ///< CPU time of the last program link.
+    time_t creation_time = 0;            ///< When the node was created, formatted on demand.
+};
+
+/**
+ * @struct LinkedProgram
+ * @brief A linked GL program and the locations of its automatic uniforms.
+ * @details Never changed once a ShaderNode has made it current: reload() links a new one
+ *          instead, so render snapshots that captured the previous program keep drawing it.
+ *          The GL program is deleted with the last reference, on the thread that drops it.
+ */
+struct LinkedProgram {
+    GLuint id = 0;                       ///< The program object.
+    GLint time_location = -1;            ///< Location of 'time', -1 if inactive.
+    GLint resolution_location = -1;      ///< Location of 'resolution', -1 if inactive.
+    GLint tile_offset_location = -1;     ///< Location of 'tileOffset', -1 if inactive.
+
+    LinkedProgram() = default;
+    LinkedProgram(const LinkedProgram&) = delete;
+    LinkedProgram& operator=(const LinkedProgram&) = delete;
+    ~LinkedProgram();
+};
+
 /**
  * @struct ShaderNode
  * @brief  Represents a single, dynamically generated shader instance.
  * @details This struct manages the entire lifecycle of a shader created from a
- *          GLSL function. It holds the source code, the compiled ofShader object,
- *          uniforms, and state information like compilation status and errors.
+ *          GLSL function. The fields read while drawing are stored inline; sources,
+ *          arguments, user uniforms and diagnostics live in a separately allocated
+ *          ShaderNodeMetadata, so a cached program is a compact handle once its
+ *          sources are released after linking.
  */
 struct ShaderNode {
-    // --- Metadata ---
-    std::string function_name;           ///< The name of the root GLSL function used.
-    std::vector<std::string> arguments;  ///< The arguments passed to the function.
-    std::string shader_key;              ///< A unique key generated for caching purposes.
-    
-    // --- Shader Source Code ---
-    std::string vertex_shader_code;      ///< The generated vertex shader source code.
-    std::string fragment_shader_code;    ///< The generated fragment shader source code.
-    std::string glsl_function_code;      ///< The original GLSL function code loaded from a plugin.
-    std::string source_directory_path;   ///< The directory path of the source GLSL file, for resolving #includes.
+    // --- Identity ---
+    Symbol function_name;                ///< The name of the root GLSL function used.
     
     // --- Compiled Object ---
-    ofShader compiled_shader;            ///< The compiled and linked openFrameworks shader object.
+    std::shared_ptr<const LinkedProgram> program; ///< Compiled or restored from the ProgramBinaryCache; null if none.
     
-    // --- Uniform Management ---
-    std::map<std::string, float> float_uniforms;    ///< A map of user-defined float uniforms.
-    std::map<std::string, ofVec2f> vec2_uniforms;   ///< A map of user-defined vec2 uniforms.
+    // --- Automatic Uniforms ---
     bool auto_update_time;               ///< If true, the built-in 'time' uniform will be updated automatically.
     bool auto_update_resolution;         ///< If true, the built-in 'resolution' uniform will be updated automatically.
     
+    // --- Compute Fields ---
+    std::vector<std::shared_ptr<ComputeField>> compute_fields; ///< Fields evaluated by compute shaders and sampled here, in dispatch order.
+    
+    // --- Texture Inputs ---
+    std::vector<std::string> texture_inputs; ///< Texture sources sampled by name, on the units after the compute fields.
+    
+    // --- Parameter Ports ---
+    std::shared_ptr<ParameterBlock> parameter_block; ///< Parameter ports of a composed graph, null if it has none.
+    
     // --- State Management ---
     bool is_compiled;                    ///< True if the shader has been successfully compiled and linked.
     bool has_error;                      ///< True if an error occurred during generation or compilation.
-    std::string error_message;           ///< The error message, if any.
     ShaderNodeState node_state;          ///< Current state of the shader node
     bool is_connected_to_output;         ///< True if connected to global output
-    std::string creation_timestamp;      ///< When this node was created
+    
+    // --- Authoring Metadata ---
+    std::unique_ptr<ShaderNodeMetadata> metadata; ///< Cold data, never null.
     
     /**
      * @brief Default constructor.
@@ -65,6 +109,13 @@ struct ShaderNode {
      */
     ShaderNode(const std::string& func_name, const std::vector<std::string>& args);
     
+    /**
+     * @brief Constructs a ShaderNode from an already interned function name.
+     * @param func_name The name of the GLSL function.
+     * @param args The arguments for the function.
+     */
+    ShaderNode(Symbol func_name, const std::vector<std::string>& args);
+    
     /**
      * @brief Destructor.
      */
@@ -73,20 +124,53 @@ struct ShaderNode {
     // --- Lifecycle Methods ---
     /**
      * @brief Compiles the vertex and fragment shader code into a usable shader program.
+     * @details With the ProgramBinaryCache enabled, a binary linked from the same sources in an
+     *          earlier run is used instead of compiling, and newly linked programs are stored.
+     *          Stages are built from raw GL shader objects, which are deleted after linking so
+     *          the driver does not keep its own copy of the sources. On success the sources
+     *          are released according to ShaderSources::getRetention().
      * @return True on success, false on failure.
      */
     bool compile();
 
+    /**
+     * @brief Recompiles the current sources, e.g. after an included file changed.
+     * @details Unlike compile(), the previous program stays in use if compilation fails.
+     *          On success 'program' points to a new LinkedProgram; the previous one lives on
+     *          while render snapshots reference it. Fails if the sources were dropped after linking.
+     * @return True if the new program replaced the previous one.
+     */
+    bool reload();
+
     /**
      * @brief Cleans up resources, unloading the shader from the GPU.
      */
     void cleanup();
 
+    /**
+     * @brief Drops the node's program, whether it was compiled or restored from a binary.
+     * @details The GL program is deleted once no render snapshot references it either.
+     */
+    void releaseProgram();
+
     /**
      * @brief Checks if the shader is compiled and ready to be used for rendering.
      * @return True if the shader is ready, false otherwise.
      */
     bool isReady() const;
+
+    /**
+     * @brief Gets the GL program object of the compiled shader.
+     * @return The program handle, or 0 if the shader is not loaded.
+     */
+    GLuint getProgramId() const;
+
+    /**
+     * @brief Gets the ProgramBinaryCache key of the current sources.
+     * @details Computed on first use and kept after the sources are released.
+     * @return The key, or an empty string if no sources were set.
+     */
+    const std::string& getProgramCacheKey();
     
     // --- Utility Methods ---
     /**
@@ -152,10 +236,10 @@ struct ShaderNode {
     std::string getDetailedStatus() const;
     
     /**
-     * @brief Gets current timestamp as string
-     * @return Current timestamp
+     * @brief Gets the creation time as a string
+     * @return Creation timestamp
      */
-    std::string getCurrentTimestamp() const;
+    std::string getCreationTimestamp() const;
     
     // --- Uniform Management Methods ---
     /**
@@ -191,8 +275,43 @@ struct ShaderNode {
 
     /**
      * @brief Updates only the automatic uniforms (time, resolution) on the GPU.
+     * @details Uses the cached uniform locations, so no string lookups happen per frame.
+     *          The program must be bound.
+     * @param linked The node's current program or one captured from it earlier.
+     * @param width The render target width used for 'resolution'.
+     * @param height The render target height used for 'resolution'.
+     * @param time The value for 'time' in seconds, usually taken from a FrameClock.
+     * @param tile_offset_x Horizontal pixel offset of the current tile within the full output.
+     * @param tile_offset_y Vertical pixel offset of the current tile within the full output.
+     */
+    void updateAutoUniforms(const LinkedProgram& linked, float width, float height, float time,
+                            float tile_offset_x = 0.0f, float tile_offset_y = 0.0f) const;
+
+    /**
+     * @brief Takes ownership of a newly linked program and looks up its automatic uniforms.
+     * @details Also assigns texture unit 1 + i to the sampler of compute field i, followed
+     *          by one unit per texture input, and binds the parameter block to its binding point.
+     * @param program_id The linked program object.
+     */
+    std::shared_ptr<const LinkedProgram> adoptProgram(GLuint program_id) const;
+
+    /**
+     * @brief Adds a texture source sampled by this shader. Must be called before compile().
+     * @param sampler_name The sampler uniform, which is also the texture source name.
+     */
+    void addTextureInput(const std::string& sampler_name);
+
+    /**
+     * @brief Gets the texture unit of a texture input.
+     * @param index The index into texture_inputs.
+     */
+    GLuint getTextureInputUnit(size_t index) const;
+
+    /**
+     * @brief Adds a compute field sampled by this shader. Must be called before compile().
+     * @param field The compiled field.
      */
-    void updateAutoUniforms();
+    void addComputeField(std::shared_ptr<ComputeField> field);
     
     // --- Debugging Methods ---
     /**
@@ -0,0 +1,195 @@
+#include "ShaderRegistry.h"
+#include "ShaderNode.h"
+#include <algorithm>
+#include <charconv>
+
+namespace {
+
+/// Parses a decimal uint32_t filling [first, last) exactly.
+bool parseIndex(const char* first, const char* last, uint32_t& value) {
+    auto result = std::from_chars(first, last, value);
+    return first != last && result.ec == std::errc() && result.ptr == last;
+}
+
+} // namespace
+
+//--------------------------------------------------------------
+uint64_t ShaderHandle::pack() const {
+    return (static_cast<uint64_t>(generation) << 32) | index;
+}
+
+//--------------------------------------------------------------
+ShaderHandle ShaderHandle::unpack(uint64_t value) {
+    ShaderHandle handle;
+    handle.index = static_cast<uint32_t>(value & 0xffffffffu);
+    handle.generation = static_cast<uint32_t>(value >> 32);
+    return handle;
+}
+
+//--------------------------------------------------------------
+std::string ShaderHandle::toString() const {
+    return "shader_" + std::to_string(index) + "_" + std::to_string(generation);
+}
+
+//--------------------------------------------------------------
+ShaderHandle ShaderHandle::parse(const std::string& text) {
+    static const std::string prefix = "shader_";
+    size_t separator = text.rfind('_');
+    if (text.compare(0, prefix.size(), prefix) != 0 || separator < prefix.size()) {
+        return ShaderHandle();
+    }
+
+    ShaderHandle handle;
+    const char* data = text.data();
+    if (!parseIndex(data + prefix.size(), data + separator, handle.index) ||
+        !parseIndex(data + separator + 1, data + text.size(), handle.generation)) {
+        return ShaderHandle();
+    }
+    return handle;
+}
+
+//--------------------------------------------------------------
+std::ostream& operator<<(std::ostream& stream, ShaderHandle handle) {
+    return stream << "shader_" << handle.index << "_" << handle.generation;
+}
+
+//--------------------------------------------------------------
+ShaderRegistry& ShaderRegistry::getInstance() {
+    static ShaderRegistry instance;
+    return instance;
+}
+
+//--------------------------------------------------------------
+ShaderHandle ShaderRegistry::add(ShaderEntryKind kind, std::shared_ptr<ShaderNode> shader) {
+    std::lock_guard<std::mutex> lock(mutex);
+    uint32_t index;
+    if (!free_slots.empty()) {
+        index = free_slots.back();
+        takeFreeSlot(index);
+    } else {
+        index = static_cast<uint32_t>(slots.size());
+        slots.emplace_back();
+    }
+
+    Slot& slot = slots[index];
+    ShaderHandle handle;
+    handle.index = index;
+    handle.generation = slot.generation;
+
+    slot.occupied = true;
+    slot.kind = kind;
+    slot.shader = std::move(shader);
+    live_count++;
+    return handle;
+}
+
+//--------------------------------------------------------------
+bool ShaderRegistry::reserve(ShaderHandle handle, ShaderEntryKind kind, size_t slot_limit) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (handle.isNull() || handle.index >= std::max(slots.size(), slot_limit)) {
+        return false;
+    }
+    // Slots skipped on the way are free for add()
+    while (slots.size() <= handle.index) {
+        slots.emplace_back();
+        pushFreeSlot(static_cast<uint32_t>(slots.size() - 1));
+    }
+
+    Slot& slot = slots[handle.index];
+    // An older generation could make a handle freed in this process valid again
+    if (slot.occupied || handle.generation < slot.generation) {
+        return false;
+    }
+    takeFreeSlot(handle.index);
+
+    slot.generation = handle.generation;
+    slot.occupied = true;
+    slot.kind = kind;
+    slot.shader.reset();
+    live_count++;
+    return true;
+}
+
+//--------------------------------------------------------------
+bool ShaderRegistry::remove(ShaderHandle handle) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!findSlot(handle)) {
+        return false;
+    }
+
+    Slot& slot = slots[handle.index];
+    slot.occupied = false;
+    slot.shader.reset();
+    // Generation 0 marks null handles, so it is skipped on wrap-around
+    slot.generation = slot.generation == UINT32_MAX ? 1 : slot.generation + 1;
+    pushFreeSlot(handle.index);
+    live_count--;
+    return true;
+}
+
+//--------------------------------------------------------------
+bool ShaderRegistry::contains(ShaderHandle handle, ShaderEntryKind kind) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    const Slot* slot = findSlot(handle);
+    return slot && slot->kind == kind;
+}
+
+//--------------------------------------------------------------
+std::shared_ptr<ShaderNode> ShaderRegistry::getShader(ShaderHandle handle) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    const Slot* slot = findSlot(handle);
+    return slot ? slot->shader : nullptr;
+}
+
+//--------------------------------------------------------------
+std::vector<ShaderHandle> ShaderRegistry::getHandles(ShaderEntryKind kind) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<ShaderHandle> handles;
+    for (uint32_t i = 0; i < slots.size(); ++i) {
+        if (slots[i].occupied && slots[i].kind == kind) {
+            ShaderHandle handle;
+            handle.index = i;
+            handle.generation = slots[i].generation;
+            handles.push_back(handle);
+        }
+    }
+    return handles;
+}
+
+//--------------------------------------------------------------
+size_t ShaderRegistry::size() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return live_count;
+}
+
+//--------------------------------------------------------------
+size_t ShaderRegistry::getSlotCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return slots.size();
+}
+
+//--------------------------------------------------------------
+void ShaderRegistry::pushFreeSlot(uint32_t index) {
+    slots[index].free_position = static_cast<uint32_t>(free_slots.size());
+    free_slots.push_back(index);
+}
+
+//--------------------------------------------------------------
+void ShaderRegistry::takeFreeSlot(uint32_t index) {
+    // The last entry moves into the gap, so reserve() does not scan the free list
+    uint32_t position = slots[index].free_position;
+    uint32_t moved = free_slots.back();
+    free_slots[position] = moved;
+    slots[moved].free_position = position;
+    free_slots.pop_back();
+    slots[index].free_position = UINT32_MAX;
+}
+
+//--------------------------------------------------------------
+const ShaderRegistry::Slot* ShaderRegistry::findSlot(ShaderHandle handle) const {
+    if (handle.index >= slots.size()) {
+        return nullptr;
+    }
+    const Slot& slot = slots[handle.index];
+    return slot.occupied && slot.generation == handle.generation ? &slot : nullptr;
+}
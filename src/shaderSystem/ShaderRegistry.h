@@ -0,0 +1,174 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+struct ShaderNode;
+
+/**
+ * @struct ShaderHandle
+ * @brief A generational 64-bit handle into the ShaderRegistry.
+ * @details The low 32 bits index a slot, the high 32 bits hold the generation the slot had
+ *          when the handle was issued. Freeing a slot bumps its generation, so a handle
+ *          kept after /free is rejected instead of reaching whatever reuses the slot.
+ *
+ *          On the wire a handle is either the packed value as an OSC int64, or its text
+ *          form "shader_<index>_<generation>", which is also how nodes reference each
+ *          other in arguments ("$shader_3_1").
+ */
+struct ShaderHandle {
+    uint32_t index = 0;         ///< Slot index.
+    uint32_t generation = 0;    ///< Slot generation; 0 is never issued.
+
+    bool isNull() const { return generation == 0; }
+    bool operator==(const ShaderHandle& other) const { return index == other.index && generation == other.generation; }
+    bool operator!=(const ShaderHandle& other) const { return !(*this == other); }
+
+    /**
+     * @brief Packs the handle into 64 bits, generation high.
+     */
+    uint64_t pack() const;
+
+    /**
+     * @brief Unpacks a handle from pack().
+     */
+    static ShaderHandle unpack(uint64_t value);
+
+    /**
+     * @brief Gets the text form, "shader_<index>_<generation>".
+     */
+    std::string toString() const;
+
+    /**
+     * @brief Parses the text form.
+     * @return The handle, or a null handle if the text is not a shader ID.
+     */
+    static ShaderHandle parse(const std::string& text);
+};
+
+/**
+ * @brief Writes the text form of a handle.
+ */
+std::ostream& operator<<(std::ostream& stream, ShaderHandle handle);
+
+namespace std {
+template <>
+struct hash<ShaderHandle> {
+    size_t operator()(ShaderHandle handle) const noexcept { return std::hash<uint64_t>()(handle.pack()); }
+};
+}
+
+/**
+ * @enum ShaderEntryKind
+ * @brief What a registry slot holds.
+ */
+enum class ShaderEntryKind {
+    PROGRAM,        ///< A shader compiled immediately by ShaderManager.
+    GRAPH_NODE      ///< A deferred node of the ShaderCompositionEngine.
+};
+
+/**
+ * @class ShaderRegistry
+ * @brief The single registry of shader IDs, shared by ShaderManager and ShaderCompositionEngine.
+ * @details A slot map: handles index a slot vector directly, so lookups are O(1) without
+ *          hashing the ID, and freed slots are reused through a free list. Both creation
+ *          paths allocate their IDs here, so an ID names the same shader in every layer.
+ *          The composition engine keeps its node data itself and only reserves the ID.
+ */
+class ShaderRegistry {
+public:
+    /**
+     * @brief Gets the singleton instance of the registry.
+     */
+    static ShaderRegistry& getInstance();
+
+    ShaderRegistry(const ShaderRegistry&) = delete;
+    ShaderRegistry& operator=(const ShaderRegistry&) = delete;
+
+    /**
+     * @brief Allocates a handle.
+     * @param kind What the slot holds.
+     * @param shader The program of a PROGRAM slot, null for graph nodes.
+     */
+    ShaderHandle add(ShaderEntryKind kind, std::shared_ptr<ShaderNode> shader = nullptr);
+
+    /**
+     * @brief Occupies the slot of a handle issued by an earlier run, e.g. when restoring a session.
+     * @details Only works for slots that are free and have not been used with a newer generation.
+     * @param slot_limit The slot vector is not grown past this many slots, so an index read
+     *        from a damaged or hostile file cannot allocate billions of slots.
+     * @return False if the handle is null, lies beyond the limit or its slot is taken.
+     */
+    bool reserve(ShaderHandle handle, ShaderEntryKind kind, size_t slot_limit);
+
+    /**
+     * @brief Frees a slot; the handle and all copies of it become stale.
+     * @return False if the handle is stale or null.
+     */
+    bool remove(ShaderHandle handle);
+
+    /**
+     * @brief Checks whether a handle is live and of the given kind.
+     */
+    bool contains(ShaderHandle handle, ShaderEntryKind kind) const;
+
+    /**
+     * @brief Gets the program of a live PROGRAM handle.
+     * @return The program, or nullptr if the handle is stale or not a program.
+     */
+    std::shared_ptr<ShaderNode> getShader(ShaderHandle handle) const;
+
+    /**
+     * @brief Gets the live handles of one kind, in slot order.
+     */
+    std::vector<ShaderHandle> getHandles(ShaderEntryKind kind) const;
+
+    /**
+     * @brief Gets the number of live handles.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Gets the number of slots, live or free.
+     */
+    size_t getSlotCount() const;
+
+private:
+    /**
+     * @struct Slot
+     * @brief One entry of the slot map.
+     */
+    struct Slot {
+        uint32_t generation = 1;                ///< Generation of the current or next occupant.
+        bool occupied = false;
+        ShaderEntryKind kind = ShaderEntryKind::PROGRAM;
+        std::shared_ptr<ShaderNode> shader;     ///< Program of a PROGRAM slot.
+        uint32_t free_position = UINT32_MAX;    ///< Position in free_slots, UINT32_MAX while occupied.
+    };
+
+    ShaderRegistry() = default;
+
+    /**
+     * @brief Appends a free slot to the free list.
+     */
+    void pushFreeSlot(uint32_t index);
+
+    /**
+     * @brief Removes a slot from anywhere in the free list in O(1).
+     */
+    void takeFreeSlot(uint32_t index);
+
+    /**
+     * @brief Gets the slot a live handle points to, nullptr if the handle is stale.
+     */
+    const Slot* findSlot(ShaderHandle handle) const;
+
+    mutable std::mutex mutex;           ///< Guards the slots.
+    std::vector<Slot> slots;            ///< Indexed by ShaderHandle::index.
+    std::vector<uint32_t> free_slots;   ///< Free slot indices, mostly reused last in first out.
+    size_t live_count = 0;              ///< Number of occupied slots.
+};
@@ -0,0 +1,158 @@
+#include "ShaderSources.h"
+#include "ofLog.h"
+
+#ifdef GE_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+std::atomic<SourceRetention> ShaderSources::retention(SourceRetention::DROP);
+
+namespace {
+
+/// Replaces a string with an empty one, returning its heap block instead of keeping the capacity.
+void freeString(std::string& text) {
+    std::string().swap(text);
+}
+
+#ifdef GE_HAVE_ZSTD
+/// Fast level: sources are compressed once per link, on the render thread.
+constexpr int compression_level = 3;
+
+bool compressString(const std::string& text, std::string& compressed) {
+    compressed.resize(ZSTD_compressBound(text.size()));
+    size_t size = ZSTD_compress(&compressed[0], compressed.size(), text.data(), text.size(), compression_level);
+    if (ZSTD_isError(size)) {
+        return false;
+    }
+    compressed.resize(size);
+    compressed.shrink_to_fit();
+    return true;
+}
+#endif
+
+} // namespace
+
+//--------------------------------------------------------------
+void ShaderSources::setRetention(SourceRetention policy) {
+    if (policy == SourceRetention::COMPRESS && !isCompressionAvailable()) {
+        ofLogNotice("ShaderSources") << "Built without zstd, shader sources are kept uncompressed";
+    }
+    retention = policy;
+}
+
+//--------------------------------------------------------------
+SourceRetention ShaderSources::getRetention() {
+    return retention;
+}
+
+//--------------------------------------------------------------
+bool ShaderSources::parseRetention(const std::string& name, SourceRetention& policy) {
+    if (name == "drop") {
+        policy = SourceRetention::DROP;
+    } else if (name == "keep") {
+        policy = SourceRetention::KEEP;
+    } else if (name == "compress") {
+        policy = SourceRetention::COMPRESS;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+//--------------------------------------------------------------
+bool ShaderSources::isCompressionAvailable() {
+#ifdef GE_HAVE_ZSTD
+    return true;
+#else
+    return false;
+#endif
+}
+
+//--------------------------------------------------------------
+void ShaderSources::set(const std::string& vertex, const std::string& fragment) {
+    vertex_code = vertex;
+    fragment_code = fragment;
+    vertex_size = vertex.size();
+    fragment_size = fragment.size();
+    storage = Storage::PLAIN;
+}
+
+//--------------------------------------------------------------
+std::string ShaderSources::getVertex() const {
+    return unpack(vertex_code, vertex_size);
+}
+
+//--------------------------------------------------------------
+std::string ShaderSources::getFragment() const {
+    return unpack(fragment_code, fragment_size);
+}
+
+//--------------------------------------------------------------
+bool ShaderSources::isAvailable() const {
+    return (storage == Storage::PLAIN || storage == Storage::COMPRESSED) && vertex_size > 0 && fragment_size > 0;
+}
+
+//--------------------------------------------------------------
+bool ShaderSources::isDropped() const {
+    return storage == Storage::DROPPED;
+}
+
+//--------------------------------------------------------------
+void ShaderSources::release() {
+    if (storage != Storage::PLAIN) {
+        return;
+    }
+
+    SourceRetention policy = retention;
+    if (policy == SourceRetention::DROP) {
+        freeString(vertex_code);
+        freeString(fragment_code);
+        storage = Storage::DROPPED;
+        return;
+    }
+
+#ifdef GE_HAVE_ZSTD
+    if (policy == SourceRetention::COMPRESS) {
+        std::string vertex_compressed;
+        std::string fragment_compressed;
+        if (!compressString(vertex_code, vertex_compressed) || !compressString(fragment_code, fragment_compressed)) {
+            ofLogError("ShaderSources") << "Compressing shader sources failed, keeping them uncompressed";
+            return;
+        }
+        vertex_code.swap(vertex_compressed);
+        fragment_code.swap(fragment_compressed);
+        storage = Storage::COMPRESSED;
+    }
+#endif
+}
+
+//--------------------------------------------------------------
+size_t ShaderSources::getSourceBytes() const {
+    return vertex_size + fragment_size;
+}
+
+//--------------------------------------------------------------
+size_t ShaderSources::getResidentBytes() const {
+    return vertex_code.capacity() + fragment_code.capacity();
+}
+
+//--------------------------------------------------------------
+std::string ShaderSources::unpack(const std::string& stored, size_t size) const {
+    if (storage == Storage::PLAIN) {
+        return stored;
+    }
+#ifdef GE_HAVE_ZSTD
+    if (storage == Storage::COMPRESSED) {
+        std::string text(size, '\0');
+        size_t result = ZSTD_decompress(&text[0], text.size(), stored.data(), stored.size());
+        if (ZSTD_isError(result) || result != size) {
+            ofLogError("ShaderSources") << "Decompressing shader source failed";
+            return "";
+        }
+        return text;
+    }
+#else
+    (void)size;
+#endif
+    return "";
+}
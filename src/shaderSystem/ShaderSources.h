@@ -0,0 +1,111 @@
+#pragma once
+#include <atomic>
+#include <string>
+
+/**
+ * @enum SourceRetention
+ * @brief What happens to the GLSL sources of a shader once its program is linked.
+ */
+enum class SourceRetention {
+    DROP,           ///< Free the sources; the program can no longer be reloaded or instrumented.
+    KEEP,           ///< Keep the sources as plain text.
+    COMPRESS        ///< Keep the sources zstd-compressed, or as plain text without GE_HAVE_ZSTD.
+};
+
+/**
+ * @class ShaderSources
+ * @brief The vertex and fragment sources of a ShaderNode, released after a successful link.
+ * @details Generated fragments inline whole plugin files, so the sources are by far the
+ *          largest part of a cached shader, yet only hot reload and heatmap instrumentation
+ *          read them again. release() applies the process-wide retention policy once the
+ *          program is linked. Compressed sources are inflated on every get, which is only
+ *          done on those rare debugging paths.
+ */
+class ShaderSources {
+public:
+    /**
+     * @brief Sets the retention policy applied by release().
+     */
+    static void setRetention(SourceRetention policy);
+
+    /**
+     * @brief Gets the retention policy applied by release().
+     */
+    static SourceRetention getRetention();
+
+    /**
+     * @brief Parses "drop", "keep" or "compress".
+     * @return False if the name is not a policy.
+     */
+    static bool parseRetention(const std::string& name, SourceRetention& policy);
+
+    /**
+     * @brief Checks whether COMPRESS actually compresses in this build.
+     */
+    static bool isCompressionAvailable();
+
+    /**
+     * @brief Replaces the sources with plain text.
+     */
+    void set(const std::string& vertex, const std::string& fragment);
+
+    /**
+     * @brief Gets the vertex source, or an empty string if there is none.
+     */
+    std::string getVertex() const;
+
+    /**
+     * @brief Gets the fragment source, or an empty string if there is none.
+     */
+    std::string getFragment() const;
+
+    /**
+     * @brief Checks whether both sources are set and were not dropped.
+     */
+    bool isAvailable() const;
+
+    /**
+     * @brief Checks whether the sources were dropped by release().
+     */
+    bool isDropped() const;
+
+    /**
+     * @brief Applies the retention policy, called after the program is linked.
+     */
+    void release();
+
+    /**
+     * @brief Gets the size of the sources as text, also after they were released.
+     */
+    size_t getSourceBytes() const;
+
+    /**
+     * @brief Gets the bytes currently held, compressed or not.
+     */
+    size_t getResidentBytes() const;
+
+private:
+    /**
+     * @enum Storage
+     * @brief How the sources are currently held.
+     */
+    enum class Storage {
+        EMPTY,
+        PLAIN,
+        COMPRESSED,
+        DROPPED
+    };
+
+    /**
+     * @brief Gets one source as plain text.
+     */
+    std::string unpack(const std::string& stored, size_t size) const;
+
+    static std::atomic<SourceRetention> retention;  ///< Policy of release(), DROP by default.
+
+    Storage storage = Storage::EMPTY;
+    std::string vertex_code;        ///< Vertex source, plain or compressed.
+    std::string fragment_code;      ///< Fragment source, plain or compressed.
+    size_t vertex_size = 0;         ///< Length of the plain vertex source.
+    size_t fragment_size = 0;       ///< Length of the plain fragment source.
+};
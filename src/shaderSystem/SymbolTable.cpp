@@ -0,0 +1,90 @@
+#include "SymbolTable.h"
+#include "ofLog.h"
+
+//--------------------------------------------------------------
+Symbol::Symbol(const std::string& text)
+    : id(SymbolTable::getInstance().intern(text).id) {
+}
+
+//--------------------------------------------------------------
+Symbol Symbol::find(const std::string& text) {
+    return SymbolTable::getInstance().find(text);
+}
+
+//--------------------------------------------------------------
+const std::string& Symbol::str() const {
+    return SymbolTable::getInstance().getString(*this);
+}
+
+//--------------------------------------------------------------
+std::ostream& operator<<(std::ostream& stream, Symbol symbol) {
+    return stream << symbol.str();
+}
+
+//--------------------------------------------------------------
+SymbolTable& SymbolTable::getInstance() {
+    static SymbolTable instance;
+    return instance;
+}
+
+//--------------------------------------------------------------
+SymbolTable::SymbolTable()
+    : count(0)
+    , byte_size(0) {
+    for (auto& chunk : chunks) {
+        chunk.store(nullptr);
+    }
+    // Symbol 0 is the empty string, so default symbols need no lookup
+    intern("");
+}
+
+//--------------------------------------------------------------
+Symbol SymbolTable::intern(const std::string& text) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = ids.find(text);
+    if (it != ids.end()) {
+        return Symbol(it->second);
+    }
+
+    uint32_t id = count.load(std::memory_order_relaxed);
+    uint32_t chunk_index = id >> chunk_bits;
+    if (chunk_index >= max_chunks) {
+        ofLogError("SymbolTable") << "Symbol table is full, cannot intern: " << text;
+        return Symbol();
+    }
+    if (!chunks[chunk_index].load(std::memory_order_relaxed)) {
+        owned_chunks.emplace_back(new std::string[chunk_size]);
+        chunks[chunk_index].store(owned_chunks.back().get(), std::memory_order_release);
+    }
+
+    std::string& stored = chunks[chunk_index].load(std::memory_order_relaxed)[id & (chunk_size - 1)];
+    stored = text;
+    ids.emplace(std::string_view(stored), id);
+    byte_size += text.size();
+    count.store(id + 1, std::memory_order_release);
+    return Symbol(id);
+}
+
+//--------------------------------------------------------------
+Symbol SymbolTable::find(const std::string& text) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = ids.find(text);
+    return it != ids.end() ? Symbol(it->second) : Symbol();
+}
+
+//--------------------------------------------------------------
+const std::string& SymbolTable::getString(Symbol symbol) const {
+    const std::string* chunk = chunks[symbol.id >> chunk_bits].load(std::memory_order_acquire);
+    return chunk[symbol.id & (chunk_size - 1)];
+}
+
+//--------------------------------------------------------------
+size_t SymbolTable::size() const {
+    return count.load(std::memory_order_acquire);
+}
+
+//--------------------------------------------------------------
+size_t SymbolTable::getByteSize() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return byte_size;
+}
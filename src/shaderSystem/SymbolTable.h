@@ -0,0 +1,125 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @class Symbol
+ * @brief An interned string: a 32-bit handle with O(1) equality and hashing.
+ * @details Only closed vocabularies are interned: function names and parameter port names,
+ *          which are bounded by the loaded plugins. Interned text is never freed, so node
+ *          IDs (ShaderHandle) and free-form argument strings are kept out of the table.
+ *          The default symbol is the empty string. Ordering compares handles, not text.
+ */
+class Symbol {
+public:
+    Symbol() : id(0) {}
+
+    /**
+     * @brief Interns a string.
+     * @details Yields the empty symbol if the table is full; callers fail their command then,
+     *          since the empty symbol would make the name collide with "".
+     */
+    explicit Symbol(const std::string& text);
+
+    /**
+     * @brief Looks up a string without interning it, e.g. for a name received over OSC.
+     * @return The symbol, or the empty symbol if the string was never interned.
+     */
+    static Symbol find(const std::string& text);
+
+    /**
+     * @brief Gets the interned text, valid for the lifetime of the process.
+     */
+    const std::string& str() const;
+
+    uint32_t getId() const { return id; }
+    bool empty() const { return id == 0; }
+
+    bool operator==(Symbol other) const { return id == other.id; }
+    bool operator!=(Symbol other) const { return id != other.id; }
+    bool operator<(Symbol other) const { return id < other.id; }
+
+private:
+    friend class SymbolTable;
+    explicit Symbol(uint32_t symbol_id) : id(symbol_id) {}
+
+    uint32_t id;    ///< Index into SymbolTable, 0 for the empty string.
+};
+
+std::ostream& operator<<(std::ostream& stream, Symbol symbol);
+
+namespace std {
+template <>
+struct hash<Symbol> {
+    size_t operator()(Symbol symbol) const noexcept { return symbol.getId(); }
+};
+}
+
+/**
+ * @class SymbolTable
+ * @brief A singleton that stores each distinct string once for the lifetime of the process.
+ * @details Strings live in fixed-size chunks that are never moved or freed, so str() is a
+ *          lock-free index into a chunk and references stay valid forever. Interning takes
+ *          a mutex and is safe from any thread; a symbol handed to another thread through
+ *          the usual synchronization can be read there without locking.
+ */
+class SymbolTable {
+public:
+    /**
+     * @brief Gets the singleton instance of the symbol table.
+     */
+    static SymbolTable& getInstance();
+
+    SymbolTable(const SymbolTable&) = delete;
+    SymbolTable& operator=(const SymbolTable&) = delete;
+
+    /**
+     * @brief Interns a string, returning the existing symbol if it is known.
+     * @return The symbol, or the empty symbol if the table is full.
+     */
+    Symbol intern(const std::string& text);
+
+    /**
+     * @brief Looks up a string without interning it.
+     * @return The symbol, or the empty symbol if the string is unknown.
+     */
+    Symbol find(const std::string& text) const;
+
+    /**
+     * @brief Gets the text of a symbol.
+     */
+    const std::string& getString(Symbol symbol) const;
+
+    /**
+     * @brief Gets the number of interned strings, including the empty string.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Gets the number of bytes of interned text.
+     */
+    size_t getByteSize() const;
+
+private:
+    static constexpr uint32_t chunk_bits = 12;                  ///< 4096 strings per chunk.
+    static constexpr uint32_t chunk_size = 1u << chunk_bits;
+    static constexpr uint32_t max_chunks = 1024;                ///< Room for 4M distinct strings.
+
+    SymbolTable();
+
+    mutable std::mutex mutex;                                           ///< Guards interning.
+    std::array<std::atomic<std::string*>, max_chunks> chunks;           ///< String storage, indexed by symbol id.
+    std::vector<std::unique_ptr<std::string[]>> owned_chunks;           ///< Owns the chunks.
+    std::unordered_map<std::string_view, uint32_t> ids;                 ///< Views into the chunks.
+    std::atomic<uint32_t> count;                                        ///< Number of interned strings.
+    size_t byte_size;                                                   ///< Interned text in bytes.
+};
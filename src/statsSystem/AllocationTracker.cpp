@@ -0,0 +1,217 @@
+#include "AllocationTracker.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+/// Per-thread counters, plain fields so operator new never touches a lock or an atomic here.
+struct ThreadCounters {
+    AllocationTag tag;
+    uint64_t allocations[AllocationTracker::tag_count];
+    uint64_t frees[AllocationTracker::tag_count];
+    uint64_t bytes[AllocationTracker::tag_count];
+    int64_t live_bytes;
+    int64_t peak_bytes;
+};
+
+/// Process-wide counters of one tag.
+struct GlobalCounters {
+    std::atomic<uint64_t> allocations;
+    std::atomic<uint64_t> frees;
+    std::atomic<uint64_t> bytes;
+    std::atomic<int64_t> live_bytes;
+    std::atomic<int64_t> peak_bytes;
+};
+
+// Both are zero-initialized before any dynamic initializer runs, so allocations made
+// during static initialization are already counted.
+thread_local ThreadCounters thread_counters = {};
+GlobalCounters global_counters[AllocationTracker::tag_count];
+
+const char* const tag_names[AllocationTracker::tag_count] = {
+    "untagged", "plugin", "expression", "codegen", "composition", "osc", "render"
+};
+
+#ifdef GE_TRACK_ALLOCATIONS
+/// Prefix of every counted block; keeps the user pointer aligned like malloc's.
+struct alignas(alignof(std::max_align_t)) BlockHeader {
+    size_t size;
+    AllocationTag tag;
+};
+
+void recordAllocation(AllocationTag tag, size_t size) {
+    size_t index = static_cast<size_t>(tag);
+    ThreadCounters& local = thread_counters;
+    local.allocations[index]++;
+    local.bytes[index] += size;
+    local.live_bytes += static_cast<int64_t>(size);
+    local.peak_bytes = std::max(local.peak_bytes, local.live_bytes);
+
+    GlobalCounters& global = global_counters[index];
+    global.allocations.fetch_add(1, std::memory_order_relaxed);
+    global.bytes.fetch_add(size, std::memory_order_relaxed);
+    int64_t live = global.live_bytes.fetch_add(static_cast<int64_t>(size), std::memory_order_relaxed) + static_cast<int64_t>(size);
+    int64_t peak = global.peak_bytes.load(std::memory_order_relaxed);
+    while (live > peak && !global.peak_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+    }
+}
+
+void recordFree(AllocationTag tag, size_t size) {
+    size_t index = static_cast<size_t>(tag);
+    ThreadCounters& local = thread_counters;
+    local.frees[index]++;
+    local.live_bytes -= static_cast<int64_t>(size);
+
+    GlobalCounters& global = global_counters[index];
+    global.frees.fetch_add(1, std::memory_order_relaxed);
+    global.live_bytes.fetch_sub(static_cast<int64_t>(size), std::memory_order_relaxed);
+}
+
+void* trackedAllocate(size_t size) {
+    void* block = std::malloc(sizeof(BlockHeader) + size);
+    if (!block) {
+        return nullptr;
+    }
+    BlockHeader* header = static_cast<BlockHeader*>(block);
+    header->size = size;
+    header->tag = thread_counters.tag;
+    recordAllocation(header->tag, size);
+    return header + 1;
+}
+
+void* trackedAllocateOrThrow(size_t size) {
+    for (;;) {
+        if (void* pointer = trackedAllocate(size)) {
+            return pointer;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+void trackedFree(void* pointer) {
+    if (!pointer) {
+        return;
+    }
+    BlockHeader* header = static_cast<BlockHeader*>(pointer) - 1;
+    recordFree(header->tag, header->size);
+    std::free(header);
+}
+#endif
+
+} // namespace
+
+#ifdef GE_TRACK_ALLOCATIONS
+void* operator new(size_t size) { return trackedAllocateOrThrow(size); }
+void* operator new[](size_t size) { return trackedAllocateOrThrow(size); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return trackedAllocate(size); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return trackedAllocate(size); }
+void operator delete(void* pointer) noexcept { trackedFree(pointer); }
+void operator delete[](void* pointer) noexcept { trackedFree(pointer); }
+void operator delete(void* pointer, size_t) noexcept { trackedFree(pointer); }
+void operator delete[](void* pointer, size_t) noexcept { trackedFree(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { trackedFree(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { trackedFree(pointer); }
+#endif
+
+//--------------------------------------------------------------
+bool AllocationTracker::isEnabled() {
+#ifdef GE_TRACK_ALLOCATIONS
+    return true;
+#else
+    return false;
+#endif
+}
+
+//--------------------------------------------------------------
+const char* AllocationTracker::getTagName(AllocationTag tag) {
+    size_t index = static_cast<size_t>(tag);
+    return index < tag_count ? tag_names[index] : "unknown";
+}
+
+//--------------------------------------------------------------
+AllocationCounters AllocationTracker::getCounters(AllocationTag tag) {
+    AllocationCounters counters;
+    size_t index = static_cast<size_t>(tag);
+    if (index >= tag_count) {
+        return counters;
+    }
+    const GlobalCounters& global = global_counters[index];
+    counters.allocations = global.allocations.load(std::memory_order_relaxed);
+    counters.frees = global.frees.load(std::memory_order_relaxed);
+    counters.bytes = global.bytes.load(std::memory_order_relaxed);
+    counters.live_bytes = global.live_bytes.load(std::memory_order_relaxed);
+    counters.peak_bytes = global.peak_bytes.load(std::memory_order_relaxed);
+    return counters;
+}
+
+//--------------------------------------------------------------
+void AllocationTracker::resetPeaks() {
+    for (GlobalCounters& global : global_counters) {
+        global.peak_bytes.store(global.live_bytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+}
+
+//--------------------------------------------------------------
+AllocationTag AllocationTracker::getCurrentTag() {
+    return thread_counters.tag;
+}
+
+//--------------------------------------------------------------
+AllocationScope::AllocationScope(AllocationTag tag)
+    : previous(thread_counters.tag) {
+    thread_counters.tag = tag;
+}
+
+//--------------------------------------------------------------
+AllocationScope::~AllocationScope() {
+    thread_counters.tag = previous;
+}
+
+//--------------------------------------------------------------
+AllocationRequestScope::AllocationRequestScope()
+    : start_live_bytes(thread_counters.live_bytes)
+    , outer_peak_bytes(thread_counters.peak_bytes) {
+    std::copy(std::begin(thread_counters.allocations), std::end(thread_counters.allocations), start_allocations.begin());
+    std::copy(std::begin(thread_counters.frees), std::end(thread_counters.frees), start_frees.begin());
+    std::copy(std::begin(thread_counters.bytes), std::end(thread_counters.bytes), start_bytes.begin());
+    // The request's peak is measured from where the thread stands now
+    thread_counters.peak_bytes = thread_counters.live_bytes;
+}
+
+//--------------------------------------------------------------
+AllocationRequestScope::~AllocationRequestScope() {
+    thread_counters.peak_bytes = std::max(outer_peak_bytes, thread_counters.peak_bytes);
+}
+
+//--------------------------------------------------------------
+AllocationCounters AllocationRequestScope::getTotal() const {
+    AllocationCounters total;
+    for (size_t i = 0; i < AllocationTracker::tag_count; ++i) {
+        AllocationCounters counters = getCounters(static_cast<AllocationTag>(i));
+        total.allocations += counters.allocations;
+        total.frees += counters.frees;
+        total.bytes += counters.bytes;
+    }
+    total.live_bytes = thread_counters.live_bytes - start_live_bytes;
+    total.peak_bytes = thread_counters.peak_bytes - start_live_bytes;
+    return total;
+}
+
+//--------------------------------------------------------------
+AllocationCounters AllocationRequestScope::getCounters(AllocationTag tag) const {
+    AllocationCounters counters;
+    size_t index = static_cast<size_t>(tag);
+    if (index >= AllocationTracker::tag_count) {
+        return counters;
+    }
+    counters.allocations = thread_counters.allocations[index] - start_allocations[index];
+    counters.frees = thread_counters.frees[index] - start_frees[index];
+    counters.bytes = thread_counters.bytes[index] - start_bytes[index];
+    return counters;
+}
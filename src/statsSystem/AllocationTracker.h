@@ -0,0 +1,124 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @enum AllocationTag
+ * @brief The subsystem heap allocations are attributed to.
+ */
+enum class AllocationTag : uint8_t {
+    UNTAGGED,       ///< Outside any AllocationScope.
+    PLUGIN_LOOKUP,  ///< Function lookup and GLSL loading in the plugin system.
+    EXPRESSION,     ///< Argument expression parsing.
+    CODEGEN,        ///< Shader source generation.
+    COMPOSITION,    ///< Graph registration and compilation.
+    OSC,            ///< Receiving and queueing OSC messages.
+    RENDER,         ///< Everything drawn in a frame.
+    COUNT
+};
+
+/**
+ * @struct AllocationCounters
+ * @brief Allocation counts and sizes of one tag, or of one request.
+ */
+struct AllocationCounters {
+    uint64_t allocations = 0;   ///< Number of operator new calls.
+    uint64_t frees = 0;         ///< Number of operator delete calls.
+    uint64_t bytes = 0;         ///< Total bytes requested.
+    int64_t live_bytes = 0;     ///< Bytes allocated and not yet freed.
+    int64_t peak_bytes = 0;     ///< Largest live_bytes since the last reset.
+};
+
+/**
+ * @class AllocationTracker
+ * @brief Opt-in accounting of heap allocations per subsystem.
+ * @details When built with GE_TRACK_ALLOCATIONS the global operator new and delete are
+ *          replaced by counting versions that prefix each block with its size and the tag
+ *          of the innermost AllocationScope of the allocating thread. Without the flag no
+ *          operator is replaced, scopes only set a thread-local byte and every counter
+ *          stays zero. Over-aligned allocations are not counted.
+ */
+class AllocationTracker {
+public:
+    static constexpr size_t tag_count = static_cast<size_t>(AllocationTag::COUNT);
+
+    /**
+     * @brief Checks whether this build counts allocations.
+     */
+    static bool isEnabled();
+
+    /**
+     * @brief Gets the name used for a tag in stats, e.g. "codegen".
+     */
+    static const char* getTagName(AllocationTag tag);
+
+    /**
+     * @brief Gets the process-wide counters of a tag.
+     * @details Memory freed under another tag than it was allocated with is credited back
+     *          to the allocating tag, so live_bytes is exact per tag.
+     */
+    static AllocationCounters getCounters(AllocationTag tag);
+
+    /**
+     * @brief Restarts the peaks of all tags from their current live bytes.
+     */
+    static void resetPeaks();
+
+    /**
+     * @brief Gets the tag of the calling thread.
+     */
+    static AllocationTag getCurrentTag();
+};
+
+/**
+ * @class AllocationScope
+ * @brief Attributes the allocations of the calling thread to a tag until it goes out of scope.
+ * @details Scopes nest; the innermost one wins, so expression parsing inside code
+ *          generation counts as expression parsing.
+ */
+class AllocationScope {
+public:
+    explicit AllocationScope(AllocationTag tag);
+    ~AllocationScope();
+
+    AllocationScope(const AllocationScope&) = delete;
+    AllocationScope& operator=(const AllocationScope&) = delete;
+
+private:
+    AllocationTag previous;     ///< Tag restored on destruction.
+};
+
+/**
+ * @class AllocationRequestScope
+ * @brief Measures what the calling thread allocates between construction and a query.
+ * @details Used to attribute allocations to a single request such as one /create, or to
+ *          a batch of benchmark frames. Only allocations of the calling thread are seen.
+ */
+class AllocationRequestScope {
+public:
+    AllocationRequestScope();
+    ~AllocationRequestScope();
+
+    AllocationRequestScope(const AllocationRequestScope&) = delete;
+    AllocationRequestScope& operator=(const AllocationRequestScope&) = delete;
+
+    /**
+     * @brief Gets the allocations since construction, over all tags.
+     * @details peak_bytes is the largest growth of the thread's live bytes since construction.
+     */
+    AllocationCounters getTotal() const;
+
+    /**
+     * @brief Gets the allocations since construction under one tag.
+     * @details Only allocations, frees and bytes are filled in.
+     */
+    AllocationCounters getCounters(AllocationTag tag) const;
+
+private:
+    std::array<uint64_t, AllocationTracker::tag_count> start_allocations;  ///< Thread counts at construction.
+    std::array<uint64_t, AllocationTracker::tag_count> start_frees;        ///< Thread frees at construction.
+    std::array<uint64_t, AllocationTracker::tag_count> start_bytes;        ///< Thread bytes at construction.
+    int64_t start_live_bytes;       ///< Thread live bytes at construction.
+    int64_t outer_peak_bytes;       ///< Thread peak restored on destruction.
+};
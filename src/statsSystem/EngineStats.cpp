@@ -0,0 +1,46 @@
+#include "EngineStats.h"
+#include <algorithm>
+
+//--------------------------------------------------------------
+EngineStats::EngineStats()
+    : smoothing(0.05) {
+}
+
+//--------------------------------------------------------------
+void EngineStats::record(const std::string& name, double value) {
+    Entry& entry = entries[name];
+    entry.last = value;
+    entry.average = (entry.samples == 0) ? value : entry.average + (value - entry.average) * smoothing;
+    entry.maximum = (entry.samples == 0) ? value : std::max(entry.maximum, value);
+    entry.samples++;
+}
+
+//--------------------------------------------------------------
+const EngineStats::Entry* EngineStats::get(const std::string& name) const {
+    auto it = entries.find(name);
+    return (it != entries.end()) ? &it->second : nullptr;
+}
+
+//--------------------------------------------------------------
+std::vector<std::pair<std::string, double>> EngineStats::getAverages() const {
+    std::vector<std::pair<std::string, double>> averages;
+    averages.reserve(entries.size());
+    for (const auto& pair : entries) {
+        averages.emplace_back(pair.first, pair.second.average);
+    }
+    return averages;
+}
+
+//--------------------------------------------------------------
+void EngineStats::reset() {
+    entries.clear();
+}
+
+//--------------------------------------------------------------
+void EngineStats::logReport() const {
+    ofLogNotice("EngineStats") << "=== Engine Stats (last / avg / max) ===";
+    for (const auto& pair : entries) {
+        ofLogNotice("EngineStats") << "  " << pair.first << ": " << pair.second.last
+                                   << " / " << pair.second.average << " / " << pair.second.maximum;
+    }
+}
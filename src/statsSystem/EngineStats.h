@@ -0,0 +1,64 @@
+#pragma once
+#include "ofMain.h"
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @class EngineStats
+ * @brief A small registry of named per-frame measurements reported over OSC.
+ * @details Subsystems record values under dotted names such as "tap.readback_ms".
+ *          For each name the last value, an exponential moving average and the
+ *          maximum since the last reset are kept. The whole set can be queried with
+ *          the "/stats" OSC command or logged.
+ */
+class EngineStats {
+public:
+    /**
+     * @struct Entry
+     * @brief The aggregated state of one measurement.
+     */
+    struct Entry {
+        double last = 0.0;      ///< The most recently recorded value.
+        double average = 0.0;   ///< Exponential moving average of recorded values.
+        double maximum = 0.0;   ///< Largest value since the last reset.
+        uint64_t samples = 0;   ///< Number of values recorded since the last reset.
+    };
+
+    EngineStats();
+
+    /**
+     * @brief Records a value for a measurement, creating it on first use.
+     * @param name The dotted measurement name.
+     * @param value The value to record.
+     */
+    void record(const std::string& name, double value);
+
+    /**
+     * @brief Gets a measurement.
+     * @param name The dotted measurement name.
+     * @return A pointer to the entry, or nullptr if nothing was recorded under the name.
+     */
+    const Entry* get(const std::string& name) const;
+
+    /**
+     * @brief Gets the average of every measurement, sorted by name.
+     * @return A list of (name, average) pairs.
+     */
+    std::vector<std::pair<std::string, double>> getAverages() const;
+
+    /**
+     * @brief Clears all measurements.
+     */
+    void reset();
+
+    /**
+     * @brief Logs every measurement as last / average / maximum.
+     */
+    void logReport() const;
+
+private:
+    std::map<std::string, Entry> entries; ///< Measurements by name.
+    double smoothing;                     ///< Weight of a new sample in the moving average.
+};